@@ -36,6 +36,10 @@ CONFIG(with_tests) {
     SUBDIRS += ../tests/MEGASyncUnitTests
 }
 
+CONFIG(with_benchmarks) {
+    SUBDIRS += ../tests/MEGASyncBenchmarks
+}
+
 CONFIG(with_tools) {
     SUBDIRS += MEGASync/mega/contrib/QtCreator/MEGACli
     SUBDIRS += MEGASync/mega/contrib/QtCreator/MEGASimplesync
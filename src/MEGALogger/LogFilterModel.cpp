@@ -0,0 +1,211 @@
+#include "LogFilterModel.h"
+
+#include <algorithm>
+#include <vector>
+
+LogFilterModel::LogFilterModel(LogRingModel *source, QObject *parent) :
+    QAbstractTableModel(parent),
+    mSource(source),
+    mColumn(LogRingModel::COLUMN_MESSAGE),
+    mSyntax(QRegExp::FixedString),
+    mCaseSensitivity(Qt::CaseInsensitive),
+    mScanPosition(0)
+{
+    connect(mSource, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(onSourceRowsAboutToBeInserted(QModelIndex,int,int)));
+    connect(mSource, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(onSourceRowsInserted(QModelIndex,int,int)));
+    connect(mSource, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(mSource, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(onSourceRowsRemoved(QModelIndex,int,int)));
+    connect(mSource, SIGNAL(modelAboutToBeReset()), this, SLOT(onSourceAboutToBeReset()));
+    connect(mSource, SIGNAL(modelReset()), this, SLOT(onSourceReset()));
+
+    mScanTimer.setInterval(0);
+    connect(&mScanTimer, SIGNAL(timeout()), this, SLOT(scanStep()));
+}
+
+int LogFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+    return isPassthrough() ? mSource->rowCount() : static_cast<int>(mMatches.size());
+}
+
+int LogFilterModel::columnCount(const QModelIndex &parent) const
+{
+    return mSource->columnCount(parent);
+}
+
+QVariant LogFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+
+    int sourceRow = isPassthrough() ? index.row() : mSource->rowOfSequence(mMatches[index.row()]);
+    return mSource->data(mSource->index(sourceRow, index.column()), role);
+}
+
+QVariant LogFilterModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    return mSource->headerData(section, orientation, role);
+}
+
+void LogFilterModel::setFilter(int column, const QString &pattern, QRegExp::PatternSyntax syntax, Qt::CaseSensitivity caseSensitivity)
+{
+    bool refinement = !isPassthrough() && !isScanning()
+            && column == mColumn && caseSensitivity == mCaseSensitivity
+            && syntax == QRegExp::FixedString && mSyntax == QRegExp::FixedString
+            && pattern.contains(mPattern, caseSensitivity);
+
+    mColumn = column;
+    mPattern = pattern;
+    mSyntax = syntax;
+    mCaseSensitivity = caseSensitivity;
+    mRegExp = QRegExp(pattern, caseSensitivity, syntax);
+    mUtf8Pattern = (syntax == QRegExp::FixedString && caseSensitivity == Qt::CaseSensitive && column == LogRingModel::COLUMN_MESSAGE)
+            ? pattern.toUtf8() : QByteArray();
+
+    beginResetModel();
+    mScanTimer.stop();
+    if (isPassthrough())
+    {
+        mMatches.clear();
+    }
+    else if (refinement)
+    {
+        // Everything that matches the new pattern matched the previous one
+        mMatches.erase(std::remove_if(mMatches.begin(), mMatches.end(), [this](quint64 sequence) {
+            return !matches(sequence);
+        }), mMatches.end());
+    }
+    else
+    {
+        mMatches.clear();
+        mScanPosition = mSource->firstSequence();
+        mScanTimer.start();
+    }
+    endResetModel();
+}
+
+bool LogFilterModel::isScanning() const
+{
+    return mScanTimer.isActive();
+}
+
+void LogFilterModel::onSourceRowsAboutToBeInserted(const QModelIndex &, int first, int last)
+{
+    if (isPassthrough())
+    {
+        beginInsertRows(QModelIndex(), first, last);
+    }
+}
+
+void LogFilterModel::onSourceRowsInserted(const QModelIndex &, int first, int last)
+{
+    if (isPassthrough())
+    {
+        endInsertRows();
+    }
+    else if (!isScanning())
+    {
+        // While scanning, the new rows are reached by the scan
+        quint64 firstSequence = mSource->firstSequence();
+        appendMatches(firstSequence + first, firstSequence + last + 1);
+    }
+}
+
+void LogFilterModel::onSourceRowsAboutToBeRemoved(const QModelIndex &, int first, int last)
+{
+    if (isPassthrough())
+    {
+        beginRemoveRows(QModelIndex(), first, last);
+        return;
+    }
+
+    // The source only evicts from the front
+    Q_ASSERT(first == 0);
+    quint64 end = mSource->firstSequence() + last + 1;
+    auto evicted = std::lower_bound(mMatches.begin(), mMatches.end(), end) - mMatches.begin();
+    if (evicted)
+    {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(evicted) - 1);
+        mMatches.erase(mMatches.begin(), mMatches.begin() + evicted);
+        endRemoveRows();
+    }
+}
+
+void LogFilterModel::onSourceRowsRemoved(const QModelIndex &, int, int)
+{
+    if (isPassthrough())
+    {
+        endRemoveRows();
+    }
+    mScanPosition = std::max(mScanPosition, mSource->firstSequence());
+}
+
+void LogFilterModel::onSourceAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void LogFilterModel::onSourceReset()
+{
+    mMatches.clear();
+    mScanPosition = mSource->firstSequence();
+    endResetModel();
+}
+
+void LogFilterModel::scanStep()
+{
+    quint64 end = std::min(mSource->endSequence(), mScanPosition + SCAN_ROWS_PER_STEP);
+    appendMatches(mScanPosition, end);
+    mScanPosition = end;
+
+    if (mScanPosition == mSource->endSequence())
+    {
+        mScanTimer.stop();
+        emit scanFinished();
+    }
+}
+
+bool LogFilterModel::isPassthrough() const
+{
+    return mPattern.isEmpty();
+}
+
+bool LogFilterModel::matches(quint64 sequence) const
+{
+    if (!mUtf8Pattern.isEmpty())
+    {
+        return mSource->message(sequence).contains(mUtf8Pattern);
+    }
+
+    QString text = mSource->text(sequence, mColumn);
+    if (mSyntax == QRegExp::FixedString)
+    {
+        return text.contains(mPattern, mCaseSensitivity);
+    }
+    return mRegExp.indexIn(text) >= 0;
+}
+
+void LogFilterModel::appendMatches(quint64 begin, quint64 end)
+{
+    std::vector<quint64> found;
+    for (quint64 sequence = begin; sequence < end; sequence++)
+    {
+        if (matches(sequence))
+        {
+            found.push_back(sequence);
+        }
+    }
+
+    if (!found.empty())
+    {
+        int first = static_cast<int>(mMatches.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(found.size()) - 1);
+        mMatches.insert(mMatches.end(), found.begin(), found.end());
+        endInsertRows();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef LOGFILTERMODEL_H
+#define LOGFILTERMODEL_H
+
+#include "LogRingModel.h"
+
+#include <QAbstractTableModel>
+#include <QRegExp>
+#include <QTimer>
+
+#include <deque>
+
+/**
+ * @brief Filtered view of a LogRingModel
+ *
+ * Shows the rows of a LogRingModel that match a filter, without rescanning the whole buffer on every change.
+ *
+ * The matches are kept as sequence numbers of the source: appended rows are tested as they arrive and the
+ * evicted ones are dropped from the front. A fixed string filter that only gets longer is applied to the
+ * current matches; any other change rescans the buffer in steps of SCAN_ROWS_PER_STEP rows, so the view stays
+ * responsive. Without filter, the rows are passed through.
+ */
+class LogFilterModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static const int SCAN_ROWS_PER_STEP = 200000;
+
+    explicit LogFilterModel(LogRingModel *source, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setFilter(int column, const QString &pattern, QRegExp::PatternSyntax syntax, Qt::CaseSensitivity caseSensitivity);
+    bool isScanning() const;
+
+signals:
+    void scanFinished();
+
+private slots:
+    void onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+    void scanStep();
+
+private:
+    bool isPassthrough() const;
+    bool matches(quint64 sequence) const;
+    void appendMatches(quint64 begin, quint64 end);
+
+    LogRingModel *mSource;
+    std::deque<quint64> mMatches;
+
+    int mColumn;
+    QString mPattern;
+    QRegExp::PatternSyntax mSyntax;
+    Qt::CaseSensitivity mCaseSensitivity;
+    mutable QRegExp mRegExp;
+    // Set for case sensitive fixed strings on the messages, which are matched on the raw UTF-8
+    QByteArray mUtf8Pattern;
+
+    quint64 mScanPosition;
+    QTimer mScanTimer;
+};
+
+#endif // LOGFILTERMODEL_H
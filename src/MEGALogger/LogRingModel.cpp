@@ -0,0 +1,301 @@
+#include "LogRingModel.h"
+
+#include <QBrush>
+#include <QDateTime>
+
+LogRingModel::LogRingModel(QObject *parent) :
+    QAbstractTableModel(parent),
+    mHead(0),
+    mCount(0),
+    mFirstSequence(0),
+    mDroppedRecords(0),
+    mEvictedRecords(0)
+{
+    // Thread 0 is the empty name, used by the gap rows
+    internThread(std::string());
+
+    mAppendTimer.setSingleShot(true);
+    mAppendTimer.setInterval(APPEND_INTERVAL_MS);
+    connect(&mAppendTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+int LogRingModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mCount;
+}
+
+int LogRingModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant LogRingModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= mCount)
+    {
+        return QVariant();
+    }
+
+    quint64 sequence = mFirstSequence + index.row();
+    if (role == Qt::DisplayRole)
+    {
+        return text(sequence, index.column());
+    }
+
+    if (role == Qt::ForegroundRole)
+    {
+        switch (row(sequence).level)
+        {
+        case 0:
+        case 1:
+            return QBrush(Qt::red);
+        case 2:
+            return QBrush(Qt::darkYellow);
+        case LEVEL_GAP:
+            return QBrush(Qt::gray);
+        }
+    }
+    return QVariant();
+}
+
+QVariant LogRingModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+
+    switch (section)
+    {
+    case COLUMN_TIMESTAMP:
+        return tr("Timestamp");
+    case COLUMN_LEVEL:
+        return tr("Level");
+    case COLUMN_THREAD:
+        return tr("Thread");
+    case COLUMN_MESSAGE:
+        return tr("Message");
+    }
+    return QVariant();
+}
+
+void LogRingModel::append(const LogStream::Record &record)
+{
+    Row newRow;
+    newRow.timestampUs = static_cast<qint64>(record.timestampUs);
+    newRow.level = record.level;
+    newRow.thread = internThread(record.thread);
+    newRow.message = QByteArray(record.message.data(), static_cast<int>(record.message.size()));
+    mPending.append(newRow);
+
+    if (!mAppendTimer.isActive())
+    {
+        mAppendTimer.start();
+    }
+}
+
+void LogRingModel::appendGap(quint64 droppedRecords)
+{
+    mDroppedRecords += droppedRecords;
+
+    Row newRow;
+    newRow.timestampUs = mPending.isEmpty() ? (mCount ? row(endSequence() - 1).timestampUs : 0)
+                                            : mPending.last().timestampUs;
+    newRow.level = LEVEL_GAP;
+    newRow.thread = 0;
+    newRow.message = QByteArray::number(droppedRecords);
+    mPending.append(newRow);
+
+    if (!mAppendTimer.isActive())
+    {
+        mAppendTimer.start();
+    }
+}
+
+void LogRingModel::flush()
+{
+    mAppendTimer.stop();
+    if (mPending.isEmpty())
+    {
+        return;
+    }
+
+    // Pending records that would be evicted right away are never shown
+    if (mPending.size() > MAX_ROWS)
+    {
+        int extra = mPending.size() - MAX_ROWS;
+        mPending.remove(0, extra);
+        mEvictedRecords += extra;
+    }
+
+    int evict = qMax(0, mCount + mPending.size() - MAX_ROWS);
+    if (evict)
+    {
+        beginRemoveRows(QModelIndex(), 0, evict - 1);
+        for (int i = 0; i < evict; i++)
+        {
+            // Releases the messages now instead of when the slot is reused
+            mRows[(mHead + i) % MAX_ROWS].message.clear();
+        }
+        mHead = (mHead + evict) % MAX_ROWS;
+        mCount -= evict;
+        mFirstSequence += evict;
+        mEvictedRecords += evict;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), mCount, mCount + mPending.size() - 1);
+    for (int i = 0; i < mPending.size(); i++)
+    {
+        int position = (mHead + mCount) % MAX_ROWS;
+        if (position == mRows.size())
+        {
+            mRows.append(mPending.at(i));
+        }
+        else
+        {
+            mRows[position] = mPending.at(i);
+        }
+        mCount++;
+    }
+    mPending.clear();
+    endInsertRows();
+
+    emit rowsAppended();
+}
+
+void LogRingModel::clear()
+{
+    beginResetModel();
+    mAppendTimer.stop();
+    mRows.clear();
+    mPending.clear();
+    // Sequence numbers are never reused
+    mFirstSequence += mCount;
+    mHead = 0;
+    mCount = 0;
+    mDroppedRecords = 0;
+    mEvictedRecords = 0;
+    endResetModel();
+}
+
+quint64 LogRingModel::firstSequence() const
+{
+    return mFirstSequence;
+}
+
+quint64 LogRingModel::endSequence() const
+{
+    return mFirstSequence + mCount;
+}
+
+int LogRingModel::rowOfSequence(quint64 sequence) const
+{
+    return static_cast<int>(sequence - mFirstSequence);
+}
+
+QString LogRingModel::text(quint64 sequence, int column) const
+{
+    const Row &r = row(sequence);
+    switch (column)
+    {
+    case COLUMN_TIMESTAMP:
+    {
+        QDateTime time = QDateTime::fromMSecsSinceEpoch(r.timestampUs / 1000, Qt::UTC);
+        return time.toString(QString::fromUtf8("MM/dd-HH:mm:ss."))
+                + QString::fromUtf8("%1").arg(r.timestampUs % 1000000, 6, 10, QChar::fromLatin1('0'));
+    }
+    case COLUMN_LEVEL:
+        return levelName(r.level);
+    case COLUMN_THREAD:
+        return QString::fromUtf8(mThreadNames.at(r.thread));
+    case COLUMN_MESSAGE:
+        if (r.level == LEVEL_GAP)
+        {
+            return tr("<%1 records dropped by MEGAsync>").arg(QString::fromUtf8(r.message));
+        }
+        return QString::fromUtf8(r.message);
+    }
+    return QString();
+}
+
+const QByteArray &LogRingModel::message(quint64 sequence) const
+{
+    return row(sequence).message;
+}
+
+quint64 LogRingModel::droppedRecords() const
+{
+    return mDroppedRecords;
+}
+
+quint64 LogRingModel::evictedRecords() const
+{
+    return mEvictedRecords;
+}
+
+LogStream::Record LogRingModel::record(quint64 sequence) const
+{
+    const Row &r = row(sequence);
+    LogStream::Record result;
+    result.timestampUs = static_cast<uint64_t>(r.timestampUs);
+    result.level = r.level;
+    const QByteArray &thread = mThreadNames.at(r.thread);
+    result.thread.assign(thread.constData(), static_cast<size_t>(thread.size()));
+    result.message.assign(r.message.constData(), static_cast<size_t>(r.message.size()));
+    return result;
+}
+
+bool LogRingModel::isGap(quint64 sequence) const
+{
+    return row(sequence).level == LEVEL_GAP;
+}
+
+QString LogRingModel::levelName(quint8 level)
+{
+    // Same names as in the MEGAsync log files
+    switch (level)
+    {
+    case 0:
+        return QString::fromUtf8("CRIT");
+    case 1:
+        return QString::fromUtf8("ERR");
+    case 2:
+        return QString::fromUtf8("WARN");
+    case 3:
+        return QString::fromUtf8("INFO");
+    case 4:
+        return QString::fromUtf8("DBG");
+    case 5:
+        return QString::fromUtf8("DTL");
+    case LEVEL_GAP:
+        return QString::fromUtf8("GAP");
+    }
+    return QString::number(level);
+}
+
+const LogRingModel::Row &LogRingModel::row(quint64 sequence) const
+{
+    return mRows.at((mHead + rowOfSequence(sequence)) % MAX_ROWS);
+}
+
+quint16 LogRingModel::internThread(const std::string &name)
+{
+    QByteArray key(name.data(), static_cast<int>(name.size()));
+    auto it = mThreadIds.constFind(key);
+    if (it != mThreadIds.constEnd())
+    {
+        return it.value();
+    }
+
+    if (mThreadNames.size() > 0xFFFF)
+    {
+        // Out of ids, which would need tens of thousands of threads; shown without name
+        return 0;
+    }
+
+    quint16 id = static_cast<quint16>(mThreadNames.size());
+    mThreadNames.append(key);
+    mThreadIds.insert(key, id);
+    return id;
+}
@@ -0,0 +1,103 @@
+#ifndef LOGRINGMODEL_H
+#define LOGRINGMODEL_H
+
+#include "LogStreamProtocol.h"
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief Ring buffer of the last log records
+ *
+ * Keeps the last MAX_ROWS log records in a ring buffer and exposes them as a table.
+ *
+ * Rows are stored compactly (the thread names are interned) and the cells are only formatted when the view
+ * asks for them. The records are appended in batches every APPEND_INTERVAL_MS; the oldest ones are evicted
+ * once the buffer is full. Every row keeps a sequence number that does not change while it is in the buffer,
+ * so other models can refer to it.
+ */
+class LogRingModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        COLUMN_TIMESTAMP = 0,
+        COLUMN_LEVEL,
+        COLUMN_THREAD,
+        COLUMN_MESSAGE,
+        COLUMN_COUNT
+    };
+
+    // Level of the rows that mark records dropped by the sender
+    static const quint8 LEVEL_GAP = 0xFF;
+
+    static const int MAX_ROWS = 2000000;
+    static const int APPEND_INTERVAL_MS = 100;
+
+    explicit LogRingModel(QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void append(const LogStream::Record &record);
+    void appendGap(quint64 droppedRecords);
+    void clear();
+
+    quint64 firstSequence() const;
+    quint64 endSequence() const;
+    int rowOfSequence(quint64 sequence) const;
+    QString text(quint64 sequence, int column) const;
+    // The raw UTF-8 message, to match fixed strings without conversions
+    const QByteArray &message(quint64 sequence) const;
+
+    quint64 droppedRecords() const;
+    quint64 evictedRecords() const;
+
+    // For saving the rows
+    LogStream::Record record(quint64 sequence) const;
+    bool isGap(quint64 sequence) const;
+
+    static QString levelName(quint8 level);
+
+public slots:
+    // Applies the pending records now instead of waiting for the timer
+    void flush();
+
+signals:
+    // Emitted after every batch
+    void rowsAppended();
+
+private:
+    struct Row
+    {
+        qint64 timestampUs;
+        quint8 level;
+        quint16 thread;
+        QByteArray message;
+    };
+
+    const Row &row(quint64 sequence) const;
+    quint16 internThread(const std::string &name);
+
+    QVector<Row> mRows;
+    int mHead;
+    int mCount;
+    quint64 mFirstSequence;
+    QVector<Row> mPending;
+    QTimer mAppendTimer;
+
+    QVector<QByteArray> mThreadNames;
+    QHash<QByteArray, quint16> mThreadIds;
+
+    quint64 mDroppedRecords;
+    quint64 mEvictedRecords;
+};
+
+#endif // LOGRINGMODEL_H
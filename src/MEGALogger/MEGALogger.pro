@@ -10,13 +10,21 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = MEGAlogger
 TEMPLATE = app
+CONFIG += c++11
 
 
+INCLUDEPATH += ../MEGASync/control
+
 SOURCES += main.cpp \
-    MegaDebugServer.cpp
+    MegaDebugServer.cpp \
+    LogRingModel.cpp \
+    LogFilterModel.cpp
 
 HEADERS  += \
-    MegaDebugServer.h
+    MegaDebugServer.h \
+    LogRingModel.h \
+    LogFilterModel.h \
+    ../MEGASync/control/LogStreamProtocol.h
 
 FORMS    += \
     MegaDebugServer.ui
@@ -1,12 +1,10 @@
 #include "MegaDebugServer.h"
 #include "ui_MegaDebugServer.h"
-#include <iostream>
 
-#define MEGA_LOGGER "MEGA_LOGGER"
-#define ENABLE_MEGASYNC_LOGS "MEGA_ENABLE_LOGS"
-#define MAX_LOG_MESSAGES 16384
+#include <QDateTime>
+#include <QScrollBar>
 
-using namespace std;
+#define SAVE_CHUNK_SIZE (1024 * 1024)
 
 MegaDebugServer::MegaDebugServer(QWidget *parent) :
     QMainWindow(parent),
@@ -18,127 +16,128 @@ MegaDebugServer::MegaDebugServer(QWidget *parent) :
     ui->statusBar->showMessage("Ready");
     megaSyncClient = NULL;
     megaServer = NULL;
-    debugDataModel = NULL;
-    debugProxyModel = NULL;
-    reader = NULL;
+    followNewRows = true;
 
     ui->filterTypeComboBox->addItem("Regular Expression", QRegExp::RegExp);
     ui->filterTypeComboBox->addItem("Wildcard", QRegExp::Wildcard);
     ui->filterTypeComboBox->addItem("Fixed string", QRegExp::FixedString);
+    ui->filterTypeComboBox->setCurrentIndex(2);
 
     ui->columnComboBox->addItem("Timestamp");
-    ui->columnComboBox->addItem("Message Type");
+    ui->columnComboBox->addItem("Level");
+    ui->columnComboBox->addItem("Thread");
     ui->columnComboBox->addItem("Message");
+    ui->columnComboBox->setCurrentIndex(LogRingModel::COLUMN_MESSAGE);
 
-    connect(ui->filterPatternLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterTextRegExp()));
-    connect(ui->filterTypeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(filterTextRegExp()));
-    connect(ui->columnComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(filterColumn()));
-    connect(ui->caseSensitivecheckBox, SIGNAL(toggled(bool)), this, SLOT(filterCaseSensitive()));
-    connect(&timer, SIGNAL(timeout()), this, SLOT(tryConnect()));
+    logModel = new LogRingModel(this);
+    filterModel = new LogFilterModel(logModel, this);
+    ui->messagesTreeView->setModel(filterModel);
+    ui->messagesTreeView->setColumnWidth(LogRingModel::COLUMN_TIMESTAMP, 160);
+    ui->messagesTreeView->setColumnWidth(LogRingModel::COLUMN_LEVEL, 60);
+    ui->messagesTreeView->setColumnWidth(LogRingModel::COLUMN_THREAD, 120);
+
+    connect(ui->filterPatternLineEdit, SIGNAL(textChanged(QString)), this, SLOT(applyFilter()));
+    connect(ui->filterTypeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(applyFilter()));
+    connect(ui->columnComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(applyFilter()));
+    connect(ui->caseSensitivecheckBox, SIGNAL(toggled(bool)), this, SLOT(applyFilter()));
+
+    connect(filterModel, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(beforeRowsShown()));
+    connect(filterModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(afterRowsShown()));
+    connect(filterModel, SIGNAL(scanFinished()), this, SLOT(updateStatus()));
+    connect(logModel, SIGNAL(rowsAppended()), this, SLOT(updateStatus()));
 
     connect(ui->actionSave, SIGNAL(triggered()), this, SLOT(saveToFile()));
     connect(ui->actionLoad, SIGNAL(triggered()), this, SLOT(loadFromFile()));
     connect(ui->actionClear, SIGNAL(triggered()), this, SLOT(clearDebugWindow()));
     connect(ui->actionStop, SIGNAL(triggered()), this, SLOT(startstop()));
 
-    debugDataModel = new QStandardItemModel(0, 3, this);
-    debugDataModel->setHeaderData(0, Qt::Horizontal,QString::fromUtf8("Timestamp"), Qt::DisplayRole);
-    debugDataModel->setHeaderData(1, Qt::Horizontal,QString::fromUtf8("Message Type"), Qt::DisplayRole);
-    debugDataModel->setHeaderData(2, Qt::Horizontal,QString::fromUtf8("Message"), Qt::DisplayRole);
-
-    debugProxyModel = new QSortFilterProxyModel;
-    debugProxyModel->setSourceModel(debugDataModel);
-    ui->messagesTreeView->setModel(debugProxyModel);
-
-    ui->messagesTreeView->sortByColumn(1, Qt::AscendingOrder);
-    ui->messagesTreeView->resizeColumnToContents(0);
-    ui->messagesTreeView->resizeColumnToContents(1);
-    ui->messagesTreeView->resizeColumnToContents(2);
-
     setWindowTitle(tr("MEGAsync Debug Window"));
     startstop();
 }
 
 void MegaDebugServer::clientConnected()
 {
-    timer.stop();
-
-    ui->actionSave->setEnabled(false);
-    ui->actionLoad->setEnabled(false);
-    ui->statusBar->showMessage(tr("Connected"));
-
+    // Only the last connection is kept
     for (;;)
     {
-        megaSyncClient = megaServer->nextPendingConnection();
+        QLocalSocket *pending = megaServer->nextPendingConnection();
         if (!megaServer->hasPendingConnections())
         {
+            if (megaSyncClient)
+            {
+                megaSyncClient->disconnect(this);
+                megaSyncClient->abort();
+                megaSyncClient->deleteLater();
+            }
+            megaSyncClient = pending;
             break;
         }
 
-        megaSyncClient->disconnectFromServer();
-        megaSyncClient->deleteLater();
+        pending->abort();
+        pending->deleteLater();
     }
-    reader = new QXmlStreamReader(megaSyncClient);
+    parser.reset();
 
     connect(megaSyncClient, SIGNAL(readyRead()), this, SLOT(readDebugMsg()));
-    connect(megaSyncClient, SIGNAL(disconnected()), this, SLOT(disconnected()));
-    connect(megaSyncClient, SIGNAL(error(QLocalSocket::LocalSocketError)), SLOT(disconnected()));
+    connect(megaSyncClient, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    updateStatus();
 }
 
-void MegaDebugServer::parseReader(QXmlStreamReader *reader)
-{    
-    do
+bool MegaDebugServer::parseFrames(LogStream::FrameParser &frameParser, const char *data, size_t size)
+{
+    frameParser.feed(data, size);
+
+    LogStream::Record record;
+    uint64_t dropped = 0;
+    for (;;)
     {
-        QXmlStreamReader::TokenType token = reader->readNext();
-        if (token == QXmlStreamReader::StartElement && reader->name() == "log")
+        switch (frameParser.next(record, dropped))
         {
-            QXmlStreamAttributes attr = reader->attributes();
-            DebugRow dr;
-            dr.timeStamp = attr.value(QString::fromUtf8("timestamp")).toString();
-            dr.messageType = attr.value(QString::fromUtf8("type")).toString();
-            dr.content = attr.value(QString::fromUtf8("content")).toString();
-            appendDebugRow(&dr);
+        case LogStream::FrameParser::LOG_RECORD:
+            logModel->append(record);
+            break;
+        case LogStream::FrameParser::DROPPED_RECORDS:
+            logModel->appendGap(dropped);
+            break;
+        case LogStream::FrameParser::NEED_MORE_DATA:
+            return true;
+        case LogStream::FrameParser::PROTOCOL_ERROR:
+            return false;
         }
-    } while (!reader->error());
+    }
 }
 
 void MegaDebugServer::readDebugMsg()
 {
-    parseReader(reader);
+    QByteArray data = megaSyncClient->readAll();
+    if (!parseFrames(parser, data.constData(), static_cast<size_t>(data.size())))
+    {
+        ui->statusBar->showMessage(tr("Invalid data received, disconnected"));
+        megaSyncClient->abort();
+    }
 }
 
-void MegaDebugServer::appendDebugRow(DebugRow *dr)
+void MegaDebugServer::clientDisconnected()
 {
-    int index = debugDataModel->rowCount();
-
-    if (index >= MAX_LOG_MESSAGES)
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (client && client == megaSyncClient)
     {
-        QList<QStandardItem*> items = debugDataModel->takeRow(0);
-        for (int i = 0; i < items.size(); i++)
-        {
-            delete items[i];
-        }
-        index--;
+        // Keeps the records that were on the way
+        logModel->flush();
+        megaSyncClient->deleteLater();
+        megaSyncClient = NULL;
+        updateStatus();
     }
-
-    QStandardItem *ts = new QStandardItem(dr->timeStamp);
-    QStandardItem *mt = new QStandardItem(dr->messageType);
-    QStandardItem *c = new QStandardItem(dr->content);
-
-    debugDataModel->setItem(index, 0, ts);
-    debugDataModel->setItem(index, 1, mt);
-    debugDataModel->setItem(index, 2, c);
-
-    ui->messagesTreeView->scrollToBottom();
 }
 
 void MegaDebugServer::startstop()
 {
     if (!megaServer)
     {
-        QLocalServer::removeServer(MEGA_LOGGER);
+        QString serverName = QString::fromUtf8(LogStream::SERVER_NAME);
+        QLocalServer::removeServer(serverName);
         megaServer = new QLocalServer();
-        if (!megaServer->listen(MEGA_LOGGER))
+        if (!megaServer->listen(serverName))
         {
             ui->statusBar->showMessage("Error starting server");
             megaServer->deleteLater();
@@ -147,62 +146,89 @@ void MegaDebugServer::startstop()
         }
 
         connect(megaServer,SIGNAL(newConnection()),this,SLOT(clientConnected()));
-        ui->actionSave->setEnabled(false);
         ui->actionLoad->setEnabled(false);
-        ui->statusBar->showMessage("Ready");
         ui->actionStop->setText(tr("Stop"));
-
-        timer.setSingleShot(false);
-        timer.setInterval(1000);
-        timer.start();
-        tryConnect();
+        updateStatus();
     }
     else
     {
-        disconnected();
+        stop();
     }
 }
 
-void MegaDebugServer::disconnected()
+void MegaDebugServer::stop()
 {
     if (megaServer)
     {
-        delete reader;
+        if (megaSyncClient)
+        {
+            megaSyncClient->disconnect(this);
+            megaSyncClient->abort();
+            megaSyncClient->deleteLater();
+            megaSyncClient = NULL;
+        }
+        logModel->flush();
         megaServer->deleteLater();
-        reader = NULL;
         megaServer = NULL;
-        megaSyncClient = NULL;
-        ui->actionSave->setEnabled(true);
         ui->actionLoad->setEnabled(true);
-        ui->statusBar->showMessage(tr("Disconnected"));
         ui->actionStop->setText(tr("Start"));
-        timer.stop();
+        updateStatus();
     }
 }
 
-void MegaDebugServer::tryConnect()
+void MegaDebugServer::applyFilter()
 {
-    client.connectToServer(ENABLE_MEGASYNC_LOGS);
+    QRegExp::PatternSyntax syntax = QRegExp::PatternSyntax(ui->filterTypeComboBox->itemData(ui->filterTypeComboBox->currentIndex()).toInt());
+    Qt::CaseSensitivity caseSensitivity = ui->caseSensitivecheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    filterModel->setFilter(ui->columnComboBox->currentIndex(), ui->filterPatternLineEdit->text(), syntax, caseSensitivity);
+    updateStatus();
 }
 
-void MegaDebugServer::filterTextRegExp()
+void MegaDebugServer::beforeRowsShown()
 {
-    qDebug() << ui->filterTypeComboBox->itemData(ui->filterTypeComboBox->currentIndex()).toInt();
-    QRegExp::PatternSyntax syntax = QRegExp::PatternSyntax(ui->filterTypeComboBox->itemData(ui->filterTypeComboBox->currentIndex()).toInt());
-    Qt::CaseSensitivity caseSensitivity = ui->caseSensitivecheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
-    QRegExp regExp(ui->filterPatternLineEdit->text(), caseSensitivity, syntax);
-    qDebug() << regExp;
-    debugProxyModel->setFilterRegExp(regExp);
+    // Only follows the new rows if the view is already at the bottom
+    QScrollBar *scrollBar = ui->messagesTreeView->verticalScrollBar();
+    followNewRows = scrollBar->value() == scrollBar->maximum();
 }
 
-void MegaDebugServer::filterColumn()
+void MegaDebugServer::afterRowsShown()
 {
-    debugProxyModel->setFilterKeyColumn(ui->columnComboBox->currentIndex());
+    if (followNewRows)
+    {
+        ui->messagesTreeView->scrollToBottom();
+    }
 }
 
-void MegaDebugServer::filterCaseSensitive()
+void MegaDebugServer::updateStatus()
 {
-    debugProxyModel->setSortCaseSensitivity(ui->caseSensitivecheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    QString state;
+    if (!megaServer)
+    {
+        state = tr("Stopped");
+    }
+    else if (megaSyncClient)
+    {
+        state = tr("Connected");
+    }
+    else
+    {
+        state = tr("Waiting for MEGAsync (started with MEGA_LOG_STREAM set)");
+    }
+
+    QString message = tr("%1 - %2 rows, %3 shown").arg(state).arg(logModel->rowCount()).arg(filterModel->rowCount());
+    if (filterModel->isScanning())
+    {
+        message += tr(" (filtering)");
+    }
+    if (logModel->droppedRecords())
+    {
+        message += tr(", %1 dropped by MEGAsync").arg(logModel->droppedRecords());
+    }
+    if (logModel->evictedRecords())
+    {
+        message += tr(", %1 discarded").arg(logModel->evictedRecords());
+    }
+    ui->statusBar->showMessage(message);
 }
 
 void MegaDebugServer::saveToFile()
@@ -223,34 +249,55 @@ void MegaDebugServer::saveToFile()
         return;
     }
 
-    QByteArray ba;
-    QXmlStreamWriter xmlWriterLog(&ba);
-    QDataStream out(&file);
-    out.setVersion(QDataStream::Qt_4_8);
-    qint32 n(debugDataModel->rowCount());
-
-    /* Writes a document start with the XML version number. */
-    xmlWriterLog.writeStartDocument();
-    xmlWriterLog.writeStartElement("MEGA");
-    for (int i = 0; i < n; i++)
+    // Same format as the live stream
+    logModel->flush();
+    std::string buffer(LogStream::HANDSHAKE, LogStream::HANDSHAKE_SIZE);
+    for (quint64 sequence = logModel->firstSequence(); sequence < logModel->endSequence(); sequence++)
     {
-        xmlWriterLog.writeStartElement("log");
-        //Add timestamp and value
-        xmlWriterLog.writeAttribute("timestamp", debugDataModel->item(i,0)->text());
-        //Add type and value
-        xmlWriterLog.writeAttribute("type", debugDataModel->item(i,1)->text());
-        //Add content and value
-        xmlWriterLog.writeAttribute("content", debugDataModel->item(i,2)->text());
-        xmlWriterLog.writeEndElement();
+        if (logModel->isGap(sequence))
+        {
+            LogStream::appendDroppedFrame(buffer, logModel->message(sequence).toULongLong());
+        }
+        else
+        {
+            LogStream::appendLogFrame(buffer, logModel->record(sequence));
+        }
+
+        if (buffer.size() >= SAVE_CHUNK_SIZE)
+        {
+            file.write(buffer.data(), static_cast<qint64>(buffer.size()));
+            buffer.clear();
+        }
     }
+    file.write(buffer.data(), static_cast<qint64>(buffer.size()));
 
-    //Close tags
-    xmlWriterLog.writeEndElement();
-    xmlWriterLog.writeEndDocument();
-    out << qCompress(ba);
+    if (!file.flush())
+    {
+        QMessageBox::information(this, tr("Unable to save file"), file.errorString());
+    }
     file.close();
 }
 
+void MegaDebugServer::parseLegacyReader(QXmlStreamReader *reader)
+{
+    // The old format only had the time of the day
+    QDateTime today(QDate::currentDate(), QTime(0, 0), Qt::UTC);
+    do
+    {
+        QXmlStreamReader::TokenType token = reader->readNext();
+        if (token == QXmlStreamReader::StartElement && reader->name() == "log")
+        {
+            QXmlStreamAttributes attr = reader->attributes();
+            QTime time = QTime::fromString(attr.value(QString::fromUtf8("timestamp")).toString(), QString::fromUtf8("HH:mm:ss"));
+
+            LogStream::Record record;
+            record.timestampUs = static_cast<uint64_t>(today.addMSecs(time.isValid() ? time.msecsSinceStartOfDay() : 0).toMSecsSinceEpoch()) * 1000;
+            record.level = static_cast<uint8_t>(attr.value(QString::fromUtf8("type")).toString().toInt());
+            record.message = attr.value(QString::fromUtf8("content")).toString().toUtf8().toStdString();
+            logModel->append(record);
+        }
+    } while (!reader->error());
+}
 
 void MegaDebugServer::loadFromFile()
 {
@@ -272,23 +319,43 @@ void MegaDebugServer::loadFromFile()
 
     clearDebugWindow();
 
-    QDataStream in(&file);
-    QByteArray ba;
-    in >> ba;
+    QByteArray header = file.peek(static_cast<qint64>(LogStream::HANDSHAKE_SIZE));
+    if (header == QByteArray(LogStream::HANDSHAKE, static_cast<int>(LogStream::HANDSHAKE_SIZE)))
+    {
+        LogStream::FrameParser fileParser;
+        bool valid = true;
+        while (valid && !file.atEnd())
+        {
+            QByteArray chunk = file.read(SAVE_CHUNK_SIZE);
+            valid = parseFrames(fileParser, chunk.constData(), static_cast<size_t>(chunk.size()));
+        }
+        if (!valid)
+        {
+            QMessageBox::information(this, tr("Unable to load file"), tr("The file is damaged, only part of it was loaded"));
+        }
+    }
+    else
+    {
+        // Files saved by previous versions: compressed XML
+        QDataStream in(&file);
+        QByteArray ba;
+        in >> ba;
 
-    QXmlStreamReader xmlLoad(qUncompress(ba));
-    parseReader(&xmlLoad);
+        QXmlStreamReader xmlLoad(qUncompress(ba));
+        parseLegacyReader(&xmlLoad);
+    }
     file.close();
+    logModel->flush();
 }
 
 void MegaDebugServer::clearDebugWindow()
 {
-    debugDataModel->removeRows(0,debugDataModel->rowCount());
+    logModel->clear();
+    updateStatus();
 }
+
 MegaDebugServer::~MegaDebugServer()
 {
-    disconnected();
-    delete debugDataModel;
-    delete debugProxyModel;
+    stop();
     delete ui;
 }
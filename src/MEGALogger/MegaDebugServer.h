@@ -5,20 +5,13 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QObject>
-#include <QSortFilterProxyModel>
-#include <QStandardItemModel>
 #include <QXmlStreamReader>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QTimer>
 
-struct DebugRow
-{
-    QString timeStamp;
-    QString messageType;
-    QString content;
-
-};
+#include "LogFilterModel.h"
+#include "LogRingModel.h"
+#include "LogStreamProtocol.h"
 
 namespace Ui {
 class MegaDebugServer;
@@ -37,32 +30,32 @@ private:
     Ui::MegaDebugServer *ui;
     QLocalServer *megaServer;
     QLocalSocket *megaSyncClient;
-    QXmlStreamReader *reader;
-    QLocalSocket client;
+    LogStream::FrameParser parser;
 
-    QSortFilterProxyModel *debugProxyModel;
-    QStandardItemModel *debugDataModel;
-    QTimer timer;
+    LogRingModel *logModel;
+    LogFilterModel *filterModel;
+    bool followNewRows;
 
 private slots:
     void clientConnected();
     void readDebugMsg();
     void startstop();
-    void disconnected();
-    void tryConnect();
+    void clientDisconnected();
+    void stop();
 
-    void filterTextRegExp();
-    void filterColumn();
-    void filterCaseSensitive();
-
-    void appendDebugRow(DebugRow *);
+    void applyFilter();
+    void beforeRowsShown();
+    void afterRowsShown();
+    void updateStatus();
 
     void saveToFile();
     void loadFromFile();
     void clearDebugWindow();
 
-public:
-    void parseReader(QXmlStreamReader *);
+private:
+    // Returns false if the data is not valid
+    bool parseFrames(LogStream::FrameParser &frameParser, const char *data, size_t size);
+    void parseLegacyReader(QXmlStreamReader *reader);
 
 };
 
@@ -4,9 +4,8 @@
 #include "FolderTransferEvents.h"
 
 #include <QObject>
-#include <QTimer>
-#include <mutex>
 
+//The updates are already throttled by the FolderTransferListener, so they are forwarded as they come
 class BlockingStageProgressController : public QObject
 {
     Q_OBJECT
@@ -15,17 +14,9 @@ public:
     BlockingStageProgressController();
 
     void update(const FolderTransferUpdateEvent &event);
-    void stopUiUpdating();
 
 signals:
     void updateUi(const FolderTransferUpdateEvent& event);
-
-private:
-    FolderTransferUpdateEvent data;
-
-    std::mutex dataMutex;
-    QTimer uiUpdatingTimer;
-    const unsigned int updateThresholdInMs = 100;
 };
 
 #endif // BlockingStageProgressController_H
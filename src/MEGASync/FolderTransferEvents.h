@@ -12,6 +12,11 @@ struct FolderTransferUpdateEvent
     uint32_t filecount;
     QString transferName;
     std::string appData;
+
+    //Progress of the current stage: scanned entries or created folders per second, and remaining
+    //seconds (-1 while unknown)
+    double entriesPerSecond = 0.0;
+    long long remainingSeconds = -1;
 };
 
 #endif // FOLDERTRANSFEREVENT_H
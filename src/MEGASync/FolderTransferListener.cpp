@@ -2,13 +2,28 @@
 
 #include "Utilities.h"
 
+#include <QtMath>
+
+namespace
+{
+//Weight of the last measure in the smoothed throughput
+const double THROUGHPUT_SMOOTHING = 0.3;
+}
 
 FolderTransferListener::FolderTransferListener()
-    : QObject(nullptr)
+    : QObject(nullptr),
+      mFolderCount(0),
+      mCreatedFolderCount(0),
+      mFileCount(0),
+      mUpdatePending(false),
+      mProgressStage(mega::MegaTransfer::STAGE_NONE),
+      mProgressEntries(0),
+      mEntriesPerSecond(0.0)
 {
     qRegisterMetaType<FolderTransferUpdateEvent>("FolderTransferUpdateEvent");
 
-    mProcessTimer.start(300);
+    mProcessTimer.setSingleShot(true);
+    mProcessTimer.setInterval(PROCESS_INTERVAL_MS);
     connect(&mProcessTimer, &QTimer::timeout, this, &FolderTransferListener::processEvent);
 }
 
@@ -19,23 +34,59 @@ void FolderTransferListener::onFolderTransferUpdate(mega::MegaApi *, mega::MegaT
 {
     if(!transfer->isSyncTransfer() && !transfer->isBackupTransfer())
     {
-        FolderTransferUpdateEvent event;
-        event.stage = stage;
-
-        event.foldercount = foldercount;
-        event.createdfoldercount = createdfoldercount;
-        event.filecount = filecount;
-
         if(stage >= mega::MegaTransfer::STAGE_TRANSFERRING_FILES)
         {
+            FolderTransferUpdateEvent event;
+            event.stage = stage;
+
+            event.foldercount = foldercount;
+            event.createdfoldercount = createdfoldercount;
+            event.filecount = filecount;
+
             event.appData = std::string(transfer->getAppData());
             event.transferName = Utilities::getNodePath(transfer);
             emit folderTransferUpdated(event);
         }
         else
         {
-            QMutexLocker lock(&mLock);
-            mEventsReceivedMap.insert(transfer->getTag(), event);
+            bool startTimer(false);
+
+            {
+                QMutexLocker lock(&mLock);
+
+                //Replace the previous counters of the transfer in the totals
+                auto counters = mCountersByTag.find(transfer->getTag());
+                if(counters != mCountersByTag.end())
+                {
+                    mFolderCount -= counters->foldercount;
+                    mCreatedFolderCount -= counters->createdfoldercount;
+                    mFileCount -= counters->filecount;
+
+                    if(--mTagsByStage[counters->stage] == 0)
+                    {
+                        mTagsByStage.remove(counters->stage);
+                    }
+                }
+                else
+                {
+                    counters = mCountersByTag.insert(transfer->getTag(), Counters());
+                }
+
+                *counters = Counters{stage, foldercount, createdfoldercount, filecount};
+                mFolderCount += foldercount;
+                mCreatedFolderCount += createdfoldercount;
+                mFileCount += filecount;
+                mTagsByStage[stage]++;
+
+                startTimer = !mUpdatePending;
+                mUpdatePending = true;
+            }
+
+            //The timer lives in the GUI thread
+            if(startTimer)
+            {
+                QMetaObject::invokeMethod(&mProcessTimer, "start", Qt::QueuedConnection);
+            }
         }
     }
 }
@@ -44,35 +95,73 @@ void FolderTransferListener::onFolderTransferUpdate(mega::MegaApi *, mega::MegaT
 void FolderTransferListener::reset()
 {
     QMutexLocker lock(&mLock);
-    mEventsReceivedMap.clear();
-    mEventsToProcessMap.clear();
+    mCountersByTag.clear();
+    mTagsByStage.clear();
+    mFolderCount = 0;
+    mCreatedFolderCount = 0;
+    mFileCount = 0;
+    mUpdatePending = false;
+    mProcessTimer.stop();
+
+    mProgressStage = mega::MegaTransfer::STAGE_NONE;
+    mProgressEntries = 0;
+    mEntriesPerSecond = 0.0;
 }
 
 void FolderTransferListener::processEvent()
 {
-    auto folderCount(0);
-    auto fileCount(0);
-    auto createFolderCount(0);
+    FolderTransferUpdateEvent eventToSend;
 
-    mLock.lock();
-    mEventsToProcessMap = mEventsReceivedMap;
-    mLock.unlock();
-
-    if(!mEventsToProcessMap.isEmpty())
     {
-        auto eventToSend = mEventsToProcessMap.first();
+        QMutexLocker lock(&mLock);
+        mUpdatePending = false;
 
-        foreach(auto event, mEventsToProcessMap)
+        if(mTagsByStage.isEmpty())
         {
-            folderCount += event.foldercount;
-            fileCount += event.filecount;
-            createFolderCount += event.createdfoldercount;
+            return;
         }
 
-        eventToSend.foldercount = folderCount;
-        eventToSend.filecount = fileCount;
-        eventToSend.createdfoldercount = createFolderCount;
+        //The earliest stage of the folders is the one shown
+        eventToSend.stage = mTagsByStage.firstKey();
+        eventToSend.foldercount = static_cast<uint32_t>(mFolderCount);
+        eventToSend.createdfoldercount = static_cast<uint32_t>(mCreatedFolderCount);
+        eventToSend.filecount = static_cast<uint32_t>(mFileCount);
+    }
+
+    updateStageProgress(eventToSend);
+    emit folderTransferUpdated(eventToSend);
+}
 
-        emit folderTransferUpdated(eventToSend);
+//Scanning has no known total, so only the folder creation gets a remaining time
+void FolderTransferListener::updateStageProgress(FolderTransferUpdateEvent& event)
+{
+    const quint64 entries(event.stage == mega::MegaTransfer::STAGE_CREATE_TREE
+                          ? event.createdfoldercount
+                          : static_cast<quint64>(event.foldercount) + event.filecount);
+
+    if(event.stage != mProgressStage || entries < mProgressEntries)
+    {
+        mProgressStage = event.stage;
+        mProgressEntries = entries;
+        mEntriesPerSecond = 0.0;
+        mProgressTime.start();
+        return;
+    }
+
+    const qint64 elapsedMs(mProgressTime.restart());
+    if(elapsedMs > 0)
+    {
+        const double entriesPerSecond((entries - mProgressEntries) * 1000.0 / elapsedMs);
+        mEntriesPerSecond = mEntriesPerSecond > 0.0
+                ? THROUGHPUT_SMOOTHING * entriesPerSecond + (1.0 - THROUGHPUT_SMOOTHING) * mEntriesPerSecond
+                : entriesPerSecond;
+    }
+    mProgressEntries = entries;
+
+    event.entriesPerSecond = mEntriesPerSecond;
+    if(event.stage == mega::MegaTransfer::STAGE_CREATE_TREE && mEntriesPerSecond > 0.0
+            && event.foldercount >= event.createdfoldercount)
+    {
+        event.remainingSeconds = qCeil((event.foldercount - event.createdfoldercount) / mEntriesPerSecond);
     }
 }
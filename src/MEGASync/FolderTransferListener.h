@@ -4,16 +4,26 @@
 #include "FolderTransferEvents.h"
 #include <megaapi.h>
 
-#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMap>
+#include <QTimer>
 #include <QObject>
 #include <QMutex>
 
+/**
+ * @brief Aggregates the scanning and folder creation progress of the folder transfers
+ *
+ * The totals are updated on each SDK event, and the aggregated event is emitted at most every
+ * PROCESS_INTERVAL_MS, only when something has changed. While nothing is scanning no timer runs.
+ */
 class FolderTransferListener : public QObject, public mega::MegaTransferListener
 {
 Q_OBJECT
 
 public:
+    static const int PROCESS_INTERVAL_MS = 300;
+
     FolderTransferListener();
 
     void onFolderTransferUpdate(mega::MegaApi *api, mega::MegaTransfer *transfer, int stage, uint32_t foldercount, uint32_t createdfoldercount, uint32_t filecount, const char*, const char*);
@@ -24,11 +34,31 @@ signals:
 
 private:
     void processEvent();
+    void updateStageProgress(FolderTransferUpdateEvent& event);
 
-    QMap<int, FolderTransferUpdateEvent> mEventsReceivedMap;
-    QMap<int, FolderTransferUpdateEvent> mEventsToProcessMap;
+    struct Counters
+    {
+        int stage;
+        uint32_t foldercount;
+        uint32_t createdfoldercount;
+        uint32_t filecount;
+    };
+
+    //Last counters received by tag, and their totals
+    QHash<int, Counters> mCountersByTag;
+    QMap<int, int> mTagsByStage;
+    quint64 mFolderCount;
+    quint64 mCreatedFolderCount;
+    quint64 mFileCount;
+    bool mUpdatePending;
     QTimer mProcessTimer;
     QMutex mLock;
+
+    //Only used from the GUI thread
+    int mProgressStage;
+    quint64 mProgressEntries;
+    double mEntriesPerSecond;
+    QElapsedTimer mProgressTime;
 };
 
 #endif // TRANSFERLISTENER_H
@@ -139,6 +139,9 @@ DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
 !CONFIG(building_tests) {
     SOURCES += $$PWD/main.cpp
 }
+else {
+    DEFINES += BUILDING_TESTS
+}
 
 SOURCES += $$PWD/MegaApplication.cpp \
     $$PWD/TransferQuota.cpp \
@@ -6,6 +6,7 @@
 #include "control/Utilities.h"
 #include "control/CrashHandler.h"
 #include "control/ExportProcessor.h"
+#include "control/StartupTracer.h"
 #include "EventUpdater.h"
 #include "platform/Platform.h"
 #include "OverQuotaDialog.h"
@@ -23,6 +24,7 @@
 #include "DialogOpener.h"
 #include "PowerOptions.h"
 #include "DateTimeFormatter.h"
+#include "SyntheticEventGenerator.h"
 
 #include "mega/types.h"
 
@@ -70,6 +72,8 @@ QString MegaApplication::dataPath = QString();
 QString MegaApplication::lastNotificationError = QString();
 
 constexpr auto openUrlClusterMaxElapsedTime = std::chrono::seconds(5);
+// Folder links that can be resolved at the same time
+constexpr int FOLDER_LINK_API_POOL_SIZE = 3;
 
 void MegaApplication::loadDataPath()
 {
@@ -223,6 +227,9 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
 
     mThreadPool = ThreadPoolSingleton::getInstance();
 
+    //Non critical startup work, run once the tray icon is visible
+    mDeferredInit = new DeferredInitQueue(QDir(dataPath).filePath(QString::fromUtf8("startup_trace.json")), this);
+
     updateAvailable = false;
     networkConnectivity = true;
     trayIcon = nullptr;
@@ -318,7 +325,9 @@ MegaApplication::MegaApplication(int &argc, char **argv) :
     mCurrency.reset();
     mStorageOverquotaDialog = nullptr;
     mTransferManager = nullptr;
-    cleaningSchedulerExecution = 0;
+    mAppState = nullptr;
+    mWakeUpScheduler = nullptr;
+    mNetworkWatcher = nullptr;
     lastUserActivityExecution = 0;
     lastTsBusinessWarning = 0;
     lastTsErrorMessageShown = 0;
@@ -440,11 +449,19 @@ void MegaApplication::initialize()
     qRegisterMetaType<QQueue<QString> >("QQueueQString");
     qRegisterMetaTypeStreamOperators<QQueue<QString> >("QQueueQString");
 
+    mDeferredInit->enqueue(DeferredInitQueue::PRIORITY_HIGH, "warm up icon cache", []()
+    {
+        Utilities::warmUpIconCache();
+    });
+
     preferences = Preferences::instance();
     connect(preferences.get(), SIGNAL(stateChanged()), this, SLOT(changeState()));
     connect(preferences.get(), SIGNAL(updated(int)), this, SLOT(showUpdatedMessage(int)),
             Qt::DirectConnection); // Use direct connection to make sure 'updated' and 'prevVersions' are set as needed
-    preferences->initialize(dataPath);
+    {
+        StartupTracer::Span span("load preferences");
+        preferences->initialize(dataPath);
+    }
 
     model = SyncInfo::instance();
 
@@ -500,6 +517,24 @@ void MegaApplication::initialize()
     megaApiFolders = new MegaApi(Preferences::CLIENT_KEY, basePath.toUtf8().constData(), Preferences::USER_AGENT.toUtf8().constData());
     megaApiFolders->disableGfxFeatures(mDisableGfx);
 
+    //Resumes the deletion of the debris folders left by the previous session, if any
+    mDebrisCollector.reset(new DebrisCollector(QDir(dataPath).filePath(QString::fromUtf8("debris_gc.queue"))));
+
+    //Extra instances to resolve several folder links at once. Each one has its own cache folder
+    mFolderLinkApiPool.reset(new FolderLinkApiPool(megaApiFolders, [this](int index) -> MegaApi*
+    {
+        QString instancePath = QDir(dataPath).filePath(QString::fromUtf8("folderlinks/%1").arg(index));
+        if (!QDir().mkpath(instancePath))
+        {
+            return nullptr;
+        }
+
+        auto api = new MegaApi(Preferences::CLIENT_KEY, QDir::toNativeSeparators(instancePath + QString::fromUtf8("/")).toUtf8().constData(),
+                               Preferences::USER_AGENT.toUtf8().constData());
+        api->disableGfxFeatures(mDisableGfx);
+        return api;
+    }, FOLDER_LINK_API_POOL_SIZE));
+
     MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromLatin1("Graphics processing %1")
                  .arg(mDisableGfx ? QLatin1String("disabled")
                                   : QLatin1String("enabled"))
@@ -511,7 +546,10 @@ void MegaApplication::initialize()
     long long newPayLoadLogSize = 10240;
     megaApi->log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Establishing max payload log size: %1").arg(newPayLoadLogSize).toUtf8().constData());
     megaApi->setMaxPayloadLogSize(newPayLoadLogSize);
-    megaApiFolders->setMaxPayloadLogSize(newPayLoadLogSize);
+    mFolderLinkApiPool->applySetting(QString::fromUtf8("maxPayloadLogSize"), [newPayLoadLogSize](MegaApi* api)
+    {
+        api->setMaxPayloadLogSize(newPayLoadLogSize);
+    });
 
     QString stagingPath = QDir(dataPath).filePath(QString::fromUtf8("megasync.staging"));
     QFile fstagingPath(stagingPath);
@@ -521,7 +559,10 @@ void MegaApplication::initialize()
         QString apiURL = settings.value(QString::fromUtf8("apiurl"), QString::fromUtf8("https://staging.api.mega.co.nz/")).toString();
         QString disablepkp = settings.value(QString::fromUtf8("disablepkp"), QString::fromUtf8("0")).toString();
         megaApi->changeApiUrl(apiURL.toUtf8(), disablepkp == QString::fromUtf8("1"));
-        megaApiFolders->changeApiUrl(apiURL.toUtf8());
+        mFolderLinkApiPool->applySetting(QString::fromUtf8("apiUrl"), [apiURL](MegaApi* api)
+        {
+            api->changeApiUrl(apiURL.toUtf8());
+        });
 
         QMegaMessageBox::MessageBoxInfo msgInfo;
         msgInfo.title = MegaSyncApp->getMEGAString();
@@ -548,7 +589,11 @@ void MegaApplication::initialize()
              .arg(Preferences::VERSION_CODE).arg(Preferences::BUILD_ID).arg(QString::fromUtf8(megaApi->getUserAgent())).toUtf8().constData());
 
     megaApi->setLanguage(currentLanguageCode.toUtf8().constData());
-    megaApiFolders->setLanguage(currentLanguageCode.toUtf8().constData());
+    const QByteArray languageCode(currentLanguageCode.toUtf8());
+    mFolderLinkApiPool->applySetting(QString::fromUtf8("language"), [languageCode](MegaApi* api)
+    {
+        api->setLanguage(languageCode.constData());
+    });
     setMaxConnections(MegaTransfer::TYPE_UPLOAD,   preferences->parallelUploadConnections());
     setMaxConnections(MegaTransfer::TYPE_DOWNLOAD, preferences->parallelDownloadConnections());
     setUseHttpsOnly(preferences->usingHttpsOnly());
@@ -560,6 +605,14 @@ void MegaApplication::initialize()
 
     delegateListener = new MEGASyncDelegateListener(megaApi, this, this);
     megaApi->addListener(delegateListener);
+
+    // Load-driver mode: synthetic alerts, node and folder transfer updates on top of the SDK ones
+    if (auto loadDriver = SyntheticEventGenerator::create(QCoreApplication::arguments(), megaApi))
+    {
+        loadDriver->addListener(delegateListener);
+        loadDriver->addTransferListener(mFolderTransferListener.get());
+    }
+
     uploader = new MegaUploader(megaApi, mFolderTransferListener);
     downloader = new MegaDownloader(megaApi, mFolderTransferListener);
     connect(uploader, &MegaUploader::startingTransfers, this, &MegaApplication::startingUpload);
@@ -653,13 +706,19 @@ void MegaApplication::initialize()
     mTransferQuota = std::make_shared<TransferQuota>(mOsNotifications);
     connect(mTransferQuota.get(), &TransferQuota::waitTimeIsOver, this, &MegaApplication::updateStatesAfterTransferOverQuotaTimeHasExpired);
 
-    periodicTasksTimer = new QTimer(this);
-    periodicTasksTimer->start(Preferences::STATE_REFRESH_INTERVAL_MS);
-    connect(periodicTasksTimer, SIGNAL(timeout()), this, SLOT(periodicTasks()));
+    mAppState = new AppStateStore([this](){return probeActivity();}, [this](){return computeTrayState();}, this);
+    connect(mAppState, &AppStateStore::activityChanged, this, &MegaApplication::onActivityChanged);
+    connect(mAppState, &AppStateStore::trayStateChanged, this, &MegaApplication::applyTrayState);
 
-    networkCheckTimer = new QTimer(this);
-    networkCheckTimer->start(Preferences::NETWORK_REFRESH_INTERVAL_MS);
-    connect(networkCheckTimer, SIGNAL(timeout()), this, SLOT(checkNetworkInterfaces()));
+    mWakeUpScheduler = new WakeUpScheduler(this);
+    connect(mAppState, &AppStateStore::busyChanged, this, [this](bool busy){mWakeUpScheduler->setIdle(!busy);});
+    mWakeUpScheduler->setIdle(!mAppState->activity().isBusy());
+
+    mNetworkWatcher = new NetworkChangeWatcher(this);
+    connect(mNetworkWatcher, &NetworkChangeWatcher::networkChanged, this, [this](){scheduleNetworkCheck(0);});
+    connect(mNetworkWatcher, &NetworkChangeWatcher::failed, this, [this](){scheduleNetworkCheck();});
+    mNetworkWatcher->start();
+    scheduleMaintenanceTasks();
 
     // SDK locker code for testing purposes
     if (Preferences::MUTEX_STEALER_MS && Preferences::MUTEX_STEALER_PERIOD_MS)
@@ -712,6 +771,10 @@ void MegaApplication::initialize()
     }
 
     mTransfersModel = new TransfersModel(nullptr);
+    if (auto loadDriver = SyntheticEventGenerator::instance())
+    {
+        loadDriver->start();
+    }
 
     connect(mTransfersModel.data(), &TransfersModel::transfersCountUpdated, this, &MegaApplication::onTransfersModelUpdate);
 
@@ -779,11 +842,12 @@ void MegaApplication::setTrayIconFromTheme(QString icon)
 }
 #endif
 
-void MegaApplication::updateTrayIcon()
+AppStateStore::TrayState MegaApplication::computeTrayState()
 {
-    if (appfinished || !trayIcon)
+    AppStateStore::TrayState state;
+    if (appfinished || !megaApi)
     {
-        return;
+        return state;
     }
 
     QString tooltipState;
@@ -829,12 +893,6 @@ void MegaApplication::updateTrayIcon()
 
         icon = icons["warning"];
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
     }
     else if (blockState)
     {
@@ -842,12 +900,6 @@ void MegaApplication::updateTrayIcon()
 
         icon = icons["alert"];
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
     }
     else if (model->hasUnattendedDisabledSyncs({MegaSync::TYPE_TWOWAY, MegaSync::TYPE_BACKUP}))
     {
@@ -867,12 +919,6 @@ void MegaApplication::updateTrayIcon()
 
         icon = icons["alert"];
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
 
     }
     else if (!megaApi->isLoggedIn())
@@ -881,39 +927,21 @@ void MegaApplication::updateTrayIcon()
         {
             tooltipState = tr("Logging in");
             icon = icons["synching"];
-    #ifdef __APPLE__
-            if (!scanningTimer->isActive())
-            {
-                scanningAnimationIndex = 1;
-                scanningTimer->start();
-            }
-    #endif
+            state.animated = true;
         }
         else
         {
             tooltipState = tr("You are not logged in");
             icon = icons["uptodate"];
 
-    #ifdef __APPLE__
-            if (scanningTimer->isActive())
-            {
-                scanningTimer->stop();
-            }
-    #endif
         }
     }
     else if (!nodescurrent || !getRootNode())
     {
         tooltipState = tr("Fetching file list...");
         icon = icons["synching"];
+        state.animated = true;
 
-#ifdef __APPLE__
-        if (!scanningTimer->isActive())
-        {
-            scanningAnimationIndex = 1;
-            scanningTimer->start();
-        }
-#endif
     }
     else if (paused)
     {
@@ -930,12 +958,6 @@ void MegaApplication::updateTrayIcon()
             icon = icons["paused"];
         }
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
     }
     else if (indexing || waiting || syncing || transferring)
     {
@@ -957,14 +979,7 @@ void MegaApplication::updateTrayIcon()
         }
 
         icon = icons["synching"];
-
-#ifdef __APPLE__
-        if (!scanningTimer->isActive())
-        {
-            scanningAnimationIndex = 1;
-            scanningTimer->start();
-        }
-#endif
+        state.animated = true;
     }
     else
     {
@@ -981,16 +996,7 @@ void MegaApplication::updateTrayIcon()
             icon = icons["uptodate"];
         }
 
-#ifdef __APPLE__
-        if (scanningTimer->isActive())
-        {
-            scanningTimer->stop();
-        }
-#endif
-        if (reboot)
-        {
-            rebootApplication();
-        }
+        state.idle = true;
     }
 
     if (!networkConnectivity)
@@ -1007,6 +1013,51 @@ void MegaApplication::updateTrayIcon()
         tooltip += QString::fromUtf8("\n") + tr("Update available!");
     }
 
+    state.icon = icon;
+    state.tooltip = tooltip;
+    return state;
+}
+
+void MegaApplication::updateTrayIcon(bool force)
+{
+    if (mAppState)
+    {
+        mAppState->refreshTrayState(force);
+    }
+}
+
+void MegaApplication::applyTrayState(const AppStateStore::TrayState& state)
+{
+    if (appfinished)
+    {
+        return;
+    }
+
+    if (!trayIcon)
+    {
+        // The store already recorded the state: createTrayIcon() applies it again
+        return;
+    }
+
+#ifdef __APPLE__
+    if (state.animated && !scanningTimer->isActive())
+    {
+        scanningAnimationIndex = 1;
+        scanningTimer->start();
+    }
+    else if (!state.animated && scanningTimer->isActive())
+    {
+        scanningTimer->stop();
+    }
+#endif
+
+    if (state.idle && reboot)
+    {
+        rebootApplication();
+    }
+
+    const QString& icon (state.icon);
+    const QString& tooltip (state.tooltip);
     if (!icon.isEmpty())
     {
 #ifndef __APPLE__
@@ -1098,6 +1149,8 @@ void MegaApplication::start()
 #endif
     trayIcon->setToolTip(QCoreApplication::applicationName() + QString::fromUtf8(" ") + Preferences::VERSION_STRING + QString::fromUtf8("\n") + tr("Logging in"));
     trayIcon->show();
+    StartupTracer::instant("tray icon shown");
+    mDeferredInit->start();
 
     if (!preferences->lastExecutionTime())
     {
@@ -1143,11 +1196,20 @@ void MegaApplication::start()
             preferences->setInstallationTime(QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000);
         }
 
-        startUpdateTask();
+        mDeferredInit->enqueue(DeferredInitQueue::PRIORITY_NORMAL, "start update task", [this]()
+        {
+            startUpdateTask();
+        });
         QString language = preferences->language();
         changeLanguage(language);
 
-        initLocalServer();
+        mDeferredInit->enqueue(DeferredInitQueue::PRIORITY_HIGH, "start local servers", [this]()
+        {
+            if (!appfinished)
+            {
+                initLocalServer();
+            }
+        });
         if (updated)
         {
             megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE, "MEGAsync update", false, nullptr);
@@ -1619,6 +1681,7 @@ void MegaApplication::applyStorageState(int state, bool doNotAskForUserStats)
             appliedStorageState = storageState;
             emit storageStateChanged(appliedStorageState);
             checkOverStorageStates();
+            updateTrayIcon();
         }
     }
 }
@@ -2112,80 +2175,113 @@ void MegaApplication::checkOverQuotaStates()
     mTransferQuota->checkQuotaAndAlerts();
 }
 
-void MegaApplication::periodicTasks()
+void MegaApplication::scheduleMaintenanceTasks()
 {
-    if (appfinished)
+    const qint64 interval (Preferences::STATE_REFRESH_INTERVAL_MS);
+
+    mWakeUpScheduler->schedule(QString::fromUtf8("cleanLocalCaches"), Preferences::MIN_UPDATE_CLEANING_INTERVAL_MS,
+                               WakeUpScheduler::FIXED_INTERVAL, [this]()
     {
-        return;
-    }
+        if (!appfinished)
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Cleaning local cache folders");
+            cleanLocalCaches();
+        }
+    }, interval);
 
-    if (!cleaningSchedulerExecution || ((QDateTime::currentMSecsSinceEpoch() - cleaningSchedulerExecution) > Preferences::MIN_UPDATE_CLEANING_INTERVAL_MS))
+    mWakeUpScheduler->schedule(QString::fromUtf8("localServer"), interval, WakeUpScheduler::BACKOFF_WHEN_IDLE, [this]()
     {
-        cleaningSchedulerExecution = QDateTime::currentMSecsSinceEpoch();
-        MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Cleaning local cache folders");
-        cleanLocalCaches();
-    }
+        if (!appfinished)
+        {
+            initLocalServer();
+        }
+    });
 
-    if (queuedUserStats[0] || queuedUserStats[1] || queuedUserStats[2])
+    mWakeUpScheduler->schedule(QString::fromUtf8("maintenance"), 6 * interval, WakeUpScheduler::BACKOFF_WHEN_IDLE, [this]()
     {
-        bool storage = queuedUserStats[0], transfer = queuedUserStats[1], pro = queuedUserStats[2];
-        queuedUserStats[0] = queuedUserStats[1] = queuedUserStats[2] = false;
-        updateUserStats(storage, transfer, pro, false, -1);
-    }
+        if (appfinished || !megaApi)
+        {
+            return;
+        }
 
-    initLocalServer();
+        HTTPServer::checkAndPurgeRequests();
 
-    static int counter = 0;
-    counter++;
-    if (megaApi)
-    {
-        if (!(counter % 6))
+        if (checkupdate)
         {
-            HTTPServer::checkAndPurgeRequests();
+            checkupdate = false;
+            megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE_OK, "MEGAsync updated OK", false, nullptr);
+        }
 
-            if (checkupdate)
-            {
-                checkupdate = false;
-                megaApi->sendEvent(AppStatsEvents::EVENT_UPDATE_OK, "MEGAsync updated OK", false, nullptr);
-            }
+        checkMemoryUsage();
+        mThreadPool->push([=]()
+        {//thread pool function
+            megaApi->update();
 
-            checkMemoryUsage();
-            mThreadPool->push([=]()
-            {//thread pool function
-                megaApi->update();
+            Utilities::queueFunctionInAppThread([=]()
+            {//queued function
+                checkOverStorageStates();
+                checkOverQuotaStates();
+            });//end of queued function
 
-                Utilities::queueFunctionInAppThread([=]()
-                {//queued function
-                    checkOverStorageStates();
-                    checkOverQuotaStates();
-                });//end of queued function
+        });// end of thread pool function
 
-            });// end of thread pool function
-        }
+        // Safety net for state changes not reported by any callback
+        mAppState->inputChanged();
+    });
 
-        onGlobalSyncStateChanged(megaApi);
+    mWakeUpScheduler->schedule(QString::fromUtf8("trayIcon"), interval, WakeUpScheduler::BACKOFF_WHEN_IDLE, [this]()
+    {
+        if (appfinished || !trayIcon)
+        {
+            return;
+        }
 
         if (isLinux)
         {
-            updateTrayIcon();
+            // Some desktops lose the icon, so it is set again even if it did not change
+            applyTrayState(mAppState->trayState());
         }
+        trayIcon->show();
+    });
 
-        if (isLinux && blockState && !(counter%10))
+#ifdef Q_OS_LINUX
+    if (getenv("XDG_CURRENT_DESKTOP") && !strcmp(getenv("XDG_CURRENT_DESKTOP"),"XFCE"))
+    {
+        mWakeUpScheduler->scheduleOnce(QString::fromUtf8("xfceTrayIcon"), 4 * interval, [this]()
         {
-            whyAmIBlocked(true);
-        }
+            if (!appfinished && trayIcon)
+            {
+                trayIcon->hide();
+                trayIcon->show();
+            }
+        });
     }
 
-    if (trayIcon)
+    mWakeUpScheduler->schedule(QString::fromUtf8("whyAmIBlocked"), 10 * interval, WakeUpScheduler::FIXED_INTERVAL, [this]()
     {
-#ifdef Q_OS_LINUX
-        if (counter==4 && getenv("XDG_CURRENT_DESKTOP") && !strcmp(getenv("XDG_CURRENT_DESKTOP"),"XFCE"))
+        if (!appfinished && megaApi && blockState)
         {
-            trayIcon->hide();
+            whyAmIBlocked(true);
         }
+    });
 #endif
-        trayIcon->show();
-    }
+
+    scheduleNetworkCheck();
+}
+
+// Polled less often when the changes are notified by the watcher
+void MegaApplication::scheduleNetworkCheck(qint64 delayMs)
+{
+    const qint64 interval (mNetworkWatcher && mNetworkWatcher->isActive() ? Preferences::NETWORK_FALLBACK_REFRESH_INTERVAL_MS
+                                                                          : Preferences::NETWORK_REFRESH_INTERVAL_MS);
+    mWakeUpScheduler->schedule(QString::fromUtf8("network"), interval, WakeUpScheduler::FIXED_INTERVAL, [this]()
+    {
+        if (!appfinished)
+        {
+            checkNetworkInterfaces();
+            updateTrayIcon();
+        }
+    }, delayMs);
 }
 
 void MegaApplication::cleanAll()
@@ -2205,8 +2301,7 @@ void MegaApplication::cleanAll()
     qInstallMessageHandler(0);
 #endif
 
-    periodicTasksTimer->stop();
-    networkCheckTimer->stop();
+    mWakeUpScheduler->stop();
     stopUpdateTask();
     Platform::getInstance()->stopShellDispatcher();
 
@@ -2236,6 +2331,7 @@ void MegaApplication::cleanAll()
     uploader = nullptr;
     delete downloader;
     downloader = nullptr;
+    delete SyntheticEventGenerator::instance();
     delete delegateListener;
     delegateListener = nullptr;
     mPricing.reset();
@@ -2265,6 +2361,9 @@ void MegaApplication::cleanAll()
     delete megaApi;
     megaApi = nullptr;
 
+    mDebrisCollector.reset();
+
+    mFolderLinkApiPool.reset();
     delete megaApiFolders;
     megaApiFolders = nullptr;
 
@@ -3000,7 +3099,7 @@ QList<QNetworkInterface> MegaApplication::findNewNetworkInterfaces()
         QNetworkInterface::InterfaceFlags flags = networkInterface.flags();
         if (isActiveNetworkInterface(interfaceName, flags))
         {
-            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Active network interface: %1").arg(interfaceName).toUtf8().constData());
+            MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Active network interface: %1").arg(interfaceName).toUtf8().constData());
 
             const int numActiveIPs = countActiveIps(networkInterface.addressEntries());
             if (numActiveIPs > 0)
@@ -3011,7 +3110,7 @@ QList<QNetworkInterface> MegaApplication::findNewNetworkInterfaces()
         }
         else
         {
-            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Ignored network interface: %1 Flags: %2")
+            MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Ignored network interface: %1 Flags: %2")
                          .arg(interfaceName)
                          .arg(QString::number(flags)).toUtf8().constData());
         }
@@ -3021,77 +3120,49 @@ QList<QNetworkInterface> MegaApplication::findNewNetworkInterfaces()
 
 bool MegaApplication::checkNetworkInterfaces(const QList<QNetworkInterface> &newNetworkInterfaces) const
 {
-    bool disconnect = false;
-    for (const auto& networkInterface : newNetworkInterfaces)
+    const auto oldAddresses = networkAddresses(activeNetworkInterfaces);
+    const auto newAddresses = networkAddresses(newNetworkInterfaces);
+    if (oldAddresses == newAddresses)
     {
-        disconnect |= checkNetworkInterface(networkInterface);
+        return false;
     }
-    return disconnect;
-}
 
-bool MegaApplication::checkNetworkInterface(const QNetworkInterface &newNetworkInterface) const
-{
-    bool disconnect = false;
-    auto interfaceIt = std::find_if(activeNetworkInterfaces.begin(), activeNetworkInterfaces.end(), [&newNetworkInterface](const QNetworkInterface& currentInterface){
-        return (currentInterface.name() == newNetworkInterface.name());
-    });
-
-    if (interfaceIt == activeNetworkInterfaces.end())
+    for (const auto& address : newAddresses)
     {
-        //New interface
-        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("New working network interface detected (%1)").arg(newNetworkInterface.humanReadableName()).toUtf8().constData());
-        disconnect = true;
-    }
-    else
-    {
-        disconnect |= checkNetworkAddresses(*interfaceIt, newNetworkInterface);
+        if (!oldAddresses.contains(address))
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("New IP detected (%1) for interface %2")
+                         .arg(obfuscateIfNecessary(address.second)).arg(address.first).toUtf8().constData());
+        }
     }
-    return disconnect;
-}
 
-bool MegaApplication::checkNetworkAddresses(const QNetworkInterface& oldNetworkInterface, const QNetworkInterface &newNetworkInterface) const
-{
-    bool disconnect = false;
-    const auto newAddresses = newNetworkInterface.addressEntries();
-    if (newAddresses.size() != oldNetworkInterface.addressEntries().size())
-    {
-        MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Local IP change detected");
-        disconnect = true;
-    }
-    else
+    for (const auto& address : oldAddresses)
     {
-        for (const auto& newAddress : newAddresses)
+        if (!newAddresses.contains(address))
         {
-            disconnect |= checkIpAddress(newAddress.ip(), oldNetworkInterface.addressEntries(), newNetworkInterface.name());
+            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("IP removed (%1) from interface %2")
+                         .arg(obfuscateIfNecessary(address.second)).arg(address.first).toUtf8().constData());
         }
     }
-    return disconnect;
+    return true;
 }
 
-bool MegaApplication::checkIpAddress(const QHostAddress& ip, const QList<QNetworkAddressEntry>& oldAddresses, const QString& newNetworkInterfaceName) const
+// IPv4 and IPv6 addresses with the name of their interface
+QSet<QPair<QString, QHostAddress>> MegaApplication::networkAddresses(const QList<QNetworkInterface>& networkInterfaces)
 {
-    bool disconnect = false;
-    switch (ip.protocol())
+    QSet<QPair<QString, QHostAddress>> addresses;
+    for (const auto& networkInterface : networkInterfaces)
     {
-        case QAbstractSocket::IPv4Protocol:
-        case QAbstractSocket::IPv6Protocol:
+        for (const auto& address : networkInterface.addressEntries())
         {
-            auto addressIt = std::find_if(oldAddresses.begin(), oldAddresses.end(), [&ip](const QNetworkAddressEntry& address){
-               return address.ip().toString() == ip.toString();
-            });
-
-            if (addressIt == oldAddresses.end())
+            const QHostAddress ip (address.ip());
+            if (ip.protocol() == QAbstractSocket::IPv4Protocol || ip.protocol() == QAbstractSocket::IPv6Protocol)
             {
-                //New IP
-                const QString addressToLog = obfuscateIfNecessary(ip);
-                MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("New IP detected (%1) for interface %2").arg(addressToLog).arg(newNetworkInterfaceName).toUtf8().constData());
-                disconnect = true;
+                addresses.insert(qMakePair(networkInterface.name(), ip));
             }
         }
-        default:
-            break;
     }
-    return disconnect;
+    return addresses;
 }
 
 bool MegaApplication::isActiveNetworkInterface(const QString& interfaceName, const QNetworkInterface::InterfaceFlags flags)
@@ -3155,7 +3226,7 @@ void MegaApplication::logIpAddress(const char* message, const QHostAddress &ipAd
 {
     const QString logMessage = QString::fromUtf8(message) + QString::fromUtf8(": %1");
     const QString addressToLog = obfuscateIfNecessary(ipAddress);
-    MegaApi::log(MegaApi::LOG_LEVEL_INFO, logMessage.arg(addressToLog).toUtf8().constData());
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, logMessage.arg(addressToLog).toUtf8().constData());
 }
 
 QString MegaApplication::obfuscateIfNecessary(const QHostAddress &ipAddress) const
@@ -3224,7 +3295,7 @@ void MegaApplication::reconnectIfNecessary(const bool disconnected, const QList<
     }
     else
     {
-        MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Local network adapters haven't changed");
+        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Local network adapters haven't changed");
     }
 }
 
@@ -3249,7 +3320,6 @@ void MegaApplication::startUpload(const QString& rawLocalPath, MegaNode* target,
 void MegaApplication::cancelScanningStage()
 {
     mBlockingBatch.cancelTransfer();
-    transferProgressController.stopUiUpdating();
 }
 
 void MegaApplication::transferBatchFinished(unsigned long long appDataId, bool fromCancellation)
@@ -3263,7 +3333,6 @@ void MegaApplication::transferBatchFinished(unsigned long long appDataId, bool f
         if (mBlockingBatch.isBlockingStageFinished() || mBlockingBatch.isCancelled())
         {
             scanStageController.stopDelayedScanStage(fromCancellation);
-            transferProgressController.stopUiUpdating();
             mFolderTransferListener->reset();
         }
     }
@@ -3631,7 +3700,10 @@ void MegaApplication::unlink(bool keepLogs)
     mQueringWhyAmIBlocked = false;
     whyamiblockedPeriodicPetition = false;
     megaApi->logout(true, nullptr);
-    megaApiFolders->setAccountAuth(nullptr);
+    mFolderLinkApiPool->forEachApi([](MegaApi* api)
+    {
+        api->setAccountAuth(nullptr);
+    });
     DialogOpener::closeAllDialogs();
     Platform::getInstance()->notifyAllSyncFoldersRemoved();
 
@@ -3659,6 +3731,7 @@ void MegaApplication::cleanLocalCaches(bool all)
     if (all || preferences->cleanerDaysLimit())
     {
         int timeLimitDays = preferences->cleanerDaysLimitValue();
+        QStringList expiredCaches;
         for (auto syncPath : model->getLocalFolders(SyncInfo::AllHandledSyncTypes))
         {
             if (!syncPath.isEmpty())
@@ -3678,12 +3751,15 @@ void MegaApplication::cleanLocalCaches(bool all)
                         QDateTime creationTime(cacheFolder.created());
                         if (all || (creationTime.isValid() && creationTime.daysTo(QDateTime::currentDateTime()) > timeLimitDays) )
                         {
-                            Utilities::removeRecursively(cacheFolder.canonicalFilePath());
+                            expiredCaches.append(cacheFolder.canonicalFilePath());
                         }
                     }
                 }
             }
         }
+
+        // Deleted in the background, the debris can be very large
+        mDebrisCollector->collect(expiredCaches);
     }
 }
 
@@ -3973,11 +4049,35 @@ void MegaApplication::applyProxySettings()
     }
 
     megaApi->setProxySettings(proxySettings);
-    megaApiFolders->setProxySettings(proxySettings);
+
+    //The proxy is deleted here, so the folder link instances created later get a copy of it
+    const int proxyType(proxySettings->getProxyType());
+    const QByteArray proxyUrl(proxySettings->getProxyURL());
+    const bool proxyCredentials(proxySettings->credentialsNeeded());
+    const QByteArray proxyUsername(proxyCredentials ? proxySettings->getUsername() : nullptr);
+    const QByteArray proxyPassword(proxyCredentials ? proxySettings->getPassword() : nullptr);
+    mFolderLinkApiPool->applySetting(QString::fromUtf8("proxy"), [=](MegaApi* api)
+    {
+        MegaProxy folderProxySettings;
+        folderProxySettings.setProxyType(proxyType);
+        if (!proxyUrl.isEmpty())
+        {
+            folderProxySettings.setProxyURL(proxyUrl.constData());
+        }
+        if (proxyCredentials)
+        {
+            folderProxySettings.setCredentials(proxyUsername.constData(), proxyPassword.constData());
+        }
+        api->setProxySettings(&folderProxySettings);
+    });
+
     delete proxySettings;
     QNetworkProxy::setApplicationProxy(proxy);
     megaApi->retryPendingConnections(true, true);
-    megaApiFolders->retryPendingConnections(true, true);
+    mFolderLinkApiPool->forEachApi([](MegaApi* api)
+    {
+        api->retryPendingConnections(true, true);
+    });
 }
 
 void MegaApplication::showUpdatedMessage(int lastVersion)
@@ -4062,7 +4162,7 @@ void MegaApplication::clearUserAttributes()
         QFile::remove(pathToAvatar);
     }
 
-    UserAttributes::UserAttributesManager::instance().reset();
+    UserAttributes::UserAttributesManager::instance().clearPersistentCache();
 }
 
 void MegaApplication::clearViewedTransfers()
@@ -4353,13 +4453,8 @@ void MegaApplication::onTransfersModelUpdate()
         infoDialog->updateDialogState();
     }
 
-    auto TransfersStats = mTransfersModel->getTransfersCount();
-    //If there are no pending transfers, reset the statics and update the state of the tray icon
-    if (!TransfersStats.pendingDownloads
-            && !TransfersStats.pendingUploads)
-    {
-        onGlobalSyncStateChanged(megaApi);
-    }
+    //The pending transfers are part of the application state
+    onGlobalSyncStateChanged(megaApi);
 }
 
 void MegaApplication::fetchNodes(QString email)
@@ -4512,6 +4607,18 @@ void MegaApplication::updateUserStats(bool storage, bool transfer, bool pro, boo
         if (storage)  queuedUserStats[0] = true;
         if (transfer) queuedUserStats[1] = true;
         if (pro)      queuedUserStats[2] = true;
+
+        // Retried when the oldest of the requests is old enough
+        qint64 delay (qMax<qint64>(1000, Preferences::MIN_UPDATE_STATS_INTERVAL - (QDateTime::currentMSecsSinceEpoch() - lastRequest)));
+        mWakeUpScheduler->scheduleOnce(QString::fromUtf8("userStats"), delay, [this]()
+        {
+            if (queuedUserStats[0] || queuedUserStats[1] || queuedUserStats[2])
+            {
+                bool storage = queuedUserStats[0], transfer = queuedUserStats[1], pro = queuedUserStats[2];
+                queuedUserStats[0] = queuedUserStats[1] = queuedUserStats[2] = false;
+                updateUserStats(storage, transfer, pro, false, -1);
+            }
+        });
     }
 }
 
@@ -4766,7 +4873,7 @@ void MegaApplication::onPasteMegaLinksDialogFinish(QPointer<PasteMegaLinksDialog
 
         //We prefer to use a raw pointer to avoid crashes if the app is closed while the link is still being imported
         //If the app is closed while the link is being imported, there is a memory leak but nothing else
-        auto linkProcessor = new LinkProcessor(linkList, MegaSyncApp->getMegaApi(), MegaSyncApp->getMegaApiFolders());
+        auto linkProcessor = new LinkProcessor(linkList, MegaSyncApp->getMegaApi(), MegaSyncApp->getFolderLinkApiPool());
 
         //Open the import dialog
         auto importDialog = new ImportMegaLinksDialog(linkProcessor);
@@ -4942,7 +5049,7 @@ void MegaApplication::streamActionClicked()
     mTransferQuota->checkStreamingAlertDismissed([this](int result){
         if(result == QDialog::Rejected)
         {
-            auto streamSelector = new StreamingFromMegaDialog(megaApi, megaApiFolders);
+            auto streamSelector = new StreamingFromMegaDialog(megaApi, mFolderLinkApiPool.get());
             connect(mTransferQuota.get(), &TransferQuota::waitTimeIsOver, streamSelector, &StreamingFromMegaDialog::updateStreamingState);
             DialogOpener::showDialog<StreamingFromMegaDialog>(streamSelector);
         }
@@ -5113,6 +5220,7 @@ void MegaApplication::createTrayIcon()
 
     if (isLinux)
     {
+        updateTrayIcon(true);
         return;
     }
 
@@ -5140,6 +5248,9 @@ void MegaApplication::createTrayIcon()
         scanningTimer->start();
     }
 #endif
+
+    // The placeholder above replaced the current state, which did not change in the store
+    updateTrayIcon(true);
 }
 
 void MegaApplication::processUploads()
@@ -5640,6 +5751,7 @@ void MegaApplication::onUpdateCompleted()
 #endif
 
     updateAvailable = false;
+    updateTrayIcon();
 
     if (infoDialogMenu)
     {
@@ -5662,6 +5774,7 @@ void MegaApplication::onUpdateAvailable(bool requested)
     }
 
     updateAvailable = true;
+    updateTrayIcon();
 
     if (infoDialogMenu)
     {
@@ -6475,6 +6588,7 @@ void MegaApplication::onEvent(MegaApi*, MegaEvent* event)
                 blockState = eventNumber;
                 emit blocked();
                 blockStateSet = true;
+                updateTrayIcon();
                 if (preferences->logged())
                 {
                     preferences->setBlockedState(blockState);
@@ -6523,6 +6637,7 @@ void MegaApplication::onEvent(MegaApi*, MegaEvent* event)
     else if (event->getType() == MegaEvent::EVENT_NODES_CURRENT)
     {
         nodescurrent = true;
+        updateTrayIcon();
     }
     else if (event->getType() == MegaEvent::EVENT_STORAGE)
     {
@@ -6863,7 +6978,8 @@ void MegaApplication::onRequestFinish(MegaApi*, MegaRequest *request, MegaError*
 
                      DialogOpener::closeAllDialogs();
                      start();
-                     periodicTasks();
+                     mWakeUpScheduler->runAll();
+                     onGlobalSyncStateChanged(megaApi);
                  }
              });
         });
@@ -7323,6 +7439,7 @@ void MegaApplication::onRequestFinish(MegaApi*, MegaRequest *request, MegaError*
             blockState = MegaApi::ACCOUNT_NOT_BLOCKED;
             emit unblocked();
             blockStateSet = true;
+            updateTrayIcon();
             if (preferences->logged())
             {
                 preferences->setBlockedState(blockState);
@@ -7490,25 +7607,10 @@ void MegaApplication::onTransferFinish(MegaApi* , MegaTransfer *transfer, MegaEr
         }
 #endif
 
-        filePath = QDir::fromNativeSeparators(filePath);
-
-        auto typeIt (SyncInfo::AllHandledSyncTypes.constBegin());
-        while (type == MegaSync::SyncType::TYPE_UNKNOWN
-               && typeIt != SyncInfo::AllHandledSyncTypes.constEnd())
+        auto syncSetting (model->getSyncSettingByLocalPath(filePath));
+        if (syncSetting && SyncInfo::AllHandledSyncTypes.contains(syncSetting->getType()))
         {
-            const auto syncsPaths (model->getLocalFolders(*typeIt));
-            auto pathIt (syncsPaths.constBegin());
-            while (type == MegaSync::SyncType::TYPE_UNKNOWN
-                   && pathIt != syncsPaths.constEnd())
-            {
-                QString syncDir (QDir::fromNativeSeparators(*pathIt) + QLatin1Char('/'));
-                if (filePath.startsWith(syncDir))
-                {
-                    type = *typeIt;
-                }
-                pathIt++;
-            }
-            typeIt++;
+            type = syncSetting->getType();
         }
 
         // Now emit an event if necessary
@@ -7798,93 +7900,64 @@ void MegaApplication::onReloadNeeded(MegaApi*)
     //Simply set the crashed flag to force a filesystem reload in the next execution.
 }
 
-void MegaApplication::onGlobalSyncStateChangedTimeout()
+void MegaApplication::onGlobalSyncStateChanged(MegaApi*)
 {
-    onGlobalSyncStateChangedImpl(NULL, true);
+    if (!appfinished && mAppState)
+    {
+        mAppState->inputChanged();
+    }
 }
 
-void MegaApplication::onGlobalSyncStateChanged(MegaApi* api)
+// Runs on the thread pool
+AppStateStore::Activity MegaApplication::probeActivity()
 {
-    onGlobalSyncStateChangedImpl(api, false);
-}
+    AppStateStore::Activity activity;
 
-void MegaApplication::onGlobalSyncStateChangedImpl(MegaApi *, bool timeout)
-{
-    if (appfinished)
+    auto model = getTransfersModel();
+    if (appfinished || !megaApi || !model)
     {
-        return;
+        return activity;
     }
 
-    // don't execute too often or the dialog locks up, eg. queueing a folder with 1k items for upload/download
-    if (timeout)
-    {
-        onGlobalSyncStateChangedTimer.reset();
-    }
-    else
-    {
-        if (!onGlobalSyncStateChangedTimer)
-        {
-            onGlobalSyncStateChangedTimer.reset(new QTimer(this));
-            connect(onGlobalSyncStateChangedTimer.get(), SIGNAL(timeout()), this, SLOT(onGlobalSyncStateChangedTimeout()));
+    activity.indexing = megaApi->isScanning();
+    activity.waiting = megaApi->isWaiting();
+    activity.syncing = megaApi->isSyncing();
 
-            onGlobalSyncStateChangedTimer->setSingleShot(true);
-            onGlobalSyncStateChangedTimer->setInterval(200);
-            onGlobalSyncStateChangedTimer->start();
-        }
-        return;
-    }
-
-    if (megaApi && infoDialog)
-    {
-        mThreadPool->push([this]() {
-
-        auto model = getTransfersModel();
-        if (!megaApi || !model)
-        {
-            return;
-        }
-
-        indexing = megaApi->isScanning();
-        waiting = megaApi->isWaiting();
-        syncing = megaApi->isSyncing();
-
-        auto transferCount = model->getTransfersCount();
-        transferring = transferCount.pendingUploads || transferCount.pendingDownloads;
-
-        Utilities::queueFunctionInAppThread([=](){
-
-            if (!infoDialog)
-            {
-                return;
-            }
-
-            int pendingUploads = transferCount.pendingUploads;
-            int pendingDownloads = transferCount.pendingDownloads;
-
-            if (pendingUploads)
-            {
-                MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Pending uploads: %1").arg(pendingUploads).toUtf8().constData());
-            }
+    auto transferCount = model->getTransfersCount();
+    activity.pendingUploads = transferCount.pendingUploads;
+    activity.pendingDownloads = transferCount.pendingDownloads;
+    activity.transferring = transferCount.pendingUploads || transferCount.pendingDownloads;
+    return activity;
+}
 
-            if (pendingDownloads)
-            {
-                MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Pending downloads: %1").arg(pendingDownloads).toUtf8().constData());
-            }
+void MegaApplication::onActivityChanged(const AppStateStore::Activity& activity)
+{
+    indexing = activity.indexing;
+    waiting = activity.waiting;
+    syncing = activity.syncing;
+    transferring = activity.transferring;
 
-            infoDialog->setIndexing(indexing);
-            infoDialog->setWaiting(waiting);
-            infoDialog->setSyncing(syncing);
-            infoDialog->setTransferring(transferring);
-            infoDialog->updateDialogState();
-            });
+    if (activity.pendingUploads)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Pending uploads: %1").arg(activity.pendingUploads).toUtf8().constData());
+    }
 
-       });
+    if (activity.pendingDownloads)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Pending downloads: %1").arg(activity.pendingDownloads).toUtf8().constData());
     }
 
     MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Current state. Paused = %1 Indexing = %2 Waiting = %3 Syncing = %4")
                  .arg(paused).arg(indexing).arg(waiting).arg(syncing).toUtf8().constData());
 
-    updateTrayIcon();
+    if (infoDialog)
+    {
+        infoDialog->setIndexing(indexing);
+        infoDialog->setWaiting(waiting);
+        infoDialog->setSyncing(syncing);
+        infoDialog->setTransferring(transferring);
+        infoDialog->updateDialogState();
+    }
 }
 
 void MegaApplication::onSyncStateChanged(MegaApi *api, MegaSync *sync)
@@ -33,6 +33,12 @@
 #include "control/UpdateTask.h"
 #include "control/MegaSyncLogger.h"
 #include "control/ThreadPool.h"
+#include "control/FolderLinkApiPool.h"
+#include "control/DebrisCollector.h"
+#include "control/DeferredInitQueue.h"
+#include "control/AppStateStore.h"
+#include "control/WakeUpScheduler.h"
+#include "control/NetworkChangeWatcher.h"
 #include "control/Utilities.h"
 #include "syncs/control/SyncInfo.h"
 #include "syncs/control/SyncController.h"
@@ -102,7 +108,7 @@ public:
     static QString applicationDataPath();
     QString getCurrentLanguageCode();
     void changeLanguage(QString languageCode);
-    void updateTrayIcon();
+    void updateTrayIcon(bool force = false);
     void repositionInfoDialog();
 
     QString getFormattedDateByCurrentLanguage(const QDateTime& datetime, QLocale::FormatType format = QLocale::FormatType::LongFormat) const;
@@ -127,7 +133,6 @@ public:
     void onSyncDeleted(mega::MegaApi *api, mega::MegaSync *sync) override;
 
     virtual void onCheckDeferredPreferencesSync(bool timeout);
-    void onGlobalSyncStateChangedImpl(mega::MegaApi* api, bool timeout);
 
     void showAddSyncError(mega::MegaRequest *request, mega::MegaError* e, QString localpath, QString remotePath = QString());
     void showAddSyncError(int errorCode, QString localpath, QString remotePath = QString());
@@ -140,6 +145,12 @@ public:
 
     mega::MegaApi *getMegaApi() { return megaApi; }
     mega::MegaApi *getMegaApiFolders() { return megaApiFolders; }
+    FolderLinkApiPool *getFolderLinkApiPool() { return mFolderLinkApiPool.get(); }
+    DebrisCollector *getDebrisCollector() { return mDebrisCollector.get(); }
+    DeferredInitQueue *getDeferredInitQueue() { return mDeferredInit; }
+#ifdef BUILDING_TESTS
+    void setMegaApi(mega::MegaApi *api) { megaApi = api; }
+#endif
     std::unique_ptr<mega::MegaApiLock> megaApiLock;
 
     QString getMEGAString(){return QLatin1String("MEGA");}
@@ -286,7 +297,6 @@ public slots:
     void checkMemoryUsage();
     void checkOverStorageStates();
     void checkOverQuotaStates();
-    void periodicTasks();
     void cleanAll();
     void onInstallUpdateClicked();
     void onAboutClicked();
@@ -323,7 +333,6 @@ public slots:
     void transferBatchFinished(unsigned long long appDataId, bool fromCancellation);
     void renewLocalSSLcert();
     void onHttpServerConnectionError();
-    void onGlobalSyncStateChangedTimeout();
     void onCheckDeferredPreferencesSyncTimeout();
     void updateStatesAfterTransferOverQuotaTimeHasExpired();
 #ifdef __APPLE__
@@ -334,6 +343,8 @@ private slots:
     void registerUserActivity();
     void PSAseen(int id);
     void onSyncStateChanged(std::shared_ptr<SyncSettings> syncSettings);
+    void onActivityChanged(const AppStateStore::Activity& activity);
+    void applyTrayState(const AppStateStore::TrayState& state);
     void onSyncDeleted(std::shared_ptr<SyncSettings> syncSettings);
     void onSyncDisabled(std::shared_ptr<SyncSettings> syncSetting);
     void showSingleSyncDisabledNotification(std::shared_ptr<SyncSettings> syncSetting);
@@ -367,6 +378,10 @@ protected:
     void startHttpServer();
     void startHttpsServer();
     void initLocalServer();
+    void scheduleMaintenanceTasks();
+    void scheduleNetworkCheck(qint64 delayMs = -1);
+    AppStateStore::Activity probeActivity();
+    AppStateStore::TrayState computeTrayState();
     void refreshStorageUIs();
     void manageBusinessStatus(int64_t event);
     void requestUserData(); //groups user attributes retrieving, getting PSA, ... to be retrieved after login in
@@ -423,7 +438,6 @@ protected:
 #endif
 
     QTimer *connectivityTimer;
-    std::unique_ptr<QTimer> onGlobalSyncStateChangedTimer;
     std::unique_ptr<QTimer> onDeferredPreferencesSyncTimer;
     QTimer proExpirityTimer;
     int scanningAnimationIndex;
@@ -434,6 +448,12 @@ protected:
     SyncInfo *model;
     mega::MegaApi *megaApi;
     mega::MegaApi *megaApiFolders;
+    std::unique_ptr<FolderLinkApiPool> mFolderLinkApiPool;
+    std::unique_ptr<DebrisCollector> mDebrisCollector;
+    DeferredInitQueue *mDeferredInit;
+    AppStateStore *mAppState;
+    WakeUpScheduler *mWakeUpScheduler;
+    NetworkChangeWatcher *mNetworkWatcher;
     QFilterAlertsModel *notificationsProxyModel;
     QAlertsModel *notificationsModel;
     MegaAlertDelegate *notificationsDelegate;
@@ -460,7 +480,6 @@ protected:
     int queuedStorageUserStatsReason;
     long long userStatsLastRequest[3];
     bool inflightUserStats[3];
-    long long cleaningSchedulerExecution;
     long long lastUserActivityExecution;
     long long lastTsBusinessWarning;
     long long lastTsErrorMessageShown;
@@ -477,8 +496,6 @@ protected:
     mega::QTMegaListener *delegateListener;
     MegaUploader *uploader;
     MegaDownloader *downloader;
-    QTimer *periodicTasksTimer;
-    QTimer *networkCheckTimer;
     QTimer *infoDialogTimer;
     QTimer *firstTransferTimer;
     std::unique_ptr<std::thread> mMutexStealerThread;
@@ -556,9 +573,7 @@ private:
 
     QList<QNetworkInterface> findNewNetworkInterfaces();
     bool checkNetworkInterfaces(const QList<QNetworkInterface>& newNetworkInterfaces) const;
-    bool checkNetworkInterface(const QNetworkInterface& newNetworkInterface) const;
-    bool checkNetworkAddresses(const QNetworkInterface& oldNetworkInterface, const QNetworkInterface &newNetworkInterface) const;
-    bool checkIpAddress(const QHostAddress& ip, const QList<QNetworkAddressEntry>& oldAddresses, const QString& newNetworkInterfaceName) const;
+    static QSet<QPair<QString, QHostAddress>> networkAddresses(const QList<QNetworkInterface>& networkInterfaces);
     static bool isActiveNetworkInterface(const QString& interfaceName, const QNetworkInterface::InterfaceFlags flags);
     int countActiveIps(const QList<QNetworkAddressEntry>& addresses) const;
     static bool isLocalIpv4(const QString& address);
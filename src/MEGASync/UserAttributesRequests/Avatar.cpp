@@ -107,6 +107,30 @@ AttributeRequest::RequestInfo Avatar::fillRequestInfo()
     return ret;
 }
 
+// Only the path of the picture is cached: without it, the letter comes from the cached full name
+bool Avatar::getValueToCache(int attribute, QByteArray& value) const
+{
+    if(attribute == mega::MegaApi::USER_ATTR_AVATAR && mUseImgFile && !mIconPath.isEmpty())
+    {
+        value = mIconPath.toUtf8();
+        return true;
+    }
+    return false;
+}
+
+bool Avatar::restoreCachedValue(int attribute, const QByteArray& value)
+{
+    QString iconPath (QString::fromUtf8(value));
+    if(attribute == mega::MegaApi::USER_ATTR_AVATAR && QFile::exists(iconPath))
+    {
+        mIconPath = iconPath;
+        mUseImgFile = true;
+        mIcon.clear();
+        return true;
+    }
+    return false;
+}
+
 void Avatar::requestAttribute()
 {
     requestUserAttribute(mega::MegaApi::USER_ATTR_AVATAR);
@@ -24,6 +24,8 @@ public:
     void onRequestFinish(mega::MegaApi *, mega::MegaRequest *incoming_request, mega::MegaError *e) override;
     void requestAttribute() override;
     RequestInfo fillRequestInfo() override;
+    bool getValueToCache(int attribute, QByteArray& value) const override;
+    bool restoreCachedValue(int attribute, const QByteArray& value) override;
 
     const QPixmap& getPixmap(const int& size) const;
 
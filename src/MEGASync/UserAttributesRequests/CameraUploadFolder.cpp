@@ -45,6 +45,8 @@ AttributeRequest::RequestInfo CameraUploadFolder::fillRequestInfo()
         MegaSyncApp->getMegaApi()->getCameraUploadsFolderSecondary();
     };
     QSharedPointer<ParamInfo> acameraParamInfo(new ParamInfo(cameraRequestFunc, QList<int>()<<mega::MegaError::API_OK));
+    //Primary and secondary folders are answered under the same attribute
+    acameraParamInfo->mExpectedAnswers = 2;
     ParamInfoMap paramInfo({{mega::MegaApi::USER_ATTR_CAMERA_UPLOADS_FOLDER, acameraParamInfo}});
     RequestInfo ret(paramInfo, QMap<int64_t, int>({{mega::MegaUser::CHANGE_TYPE_CAMERA_UPLOADS_FOLDER, mega::MegaApi::USER_ATTR_CAMERA_UPLOADS_FOLDER}}));
     return ret;
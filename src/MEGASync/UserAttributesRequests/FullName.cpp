@@ -79,6 +79,36 @@ AttributeRequest::RequestInfo FullName::fillRequestInfo()
     return ret;
 }
 
+bool FullName::getValueToCache(int attribute, QByteArray& value) const
+{
+    if(attribute == mega::MegaApi::USER_ATTR_FIRSTNAME)
+    {
+        value = mFirstName.toUtf8();
+        return true;
+    }
+    else if(attribute == mega::MegaApi::USER_ATTR_LASTNAME)
+    {
+        value = mLastName.toUtf8();
+        return true;
+    }
+    return false;
+}
+
+bool FullName::restoreCachedValue(int attribute, const QByteArray& value)
+{
+    if(attribute == mega::MegaApi::USER_ATTR_FIRSTNAME)
+    {
+        mFirstName = QString::fromUtf8(value);
+        return true;
+    }
+    else if(attribute == mega::MegaApi::USER_ATTR_LASTNAME)
+    {
+        mLastName = QString::fromUtf8(value);
+        return true;
+    }
+    return false;
+}
+
 QString FullName::getFullName() const
 {
     if(!isAttributeReady() || (mFirstName.isEmpty() && mLastName.isEmpty()))
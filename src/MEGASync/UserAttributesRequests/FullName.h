@@ -17,6 +17,8 @@ public:
     void onRequestFinish(mega::MegaApi *, mega::MegaRequest *incoming_request, mega::MegaError *e) override;
     void requestAttribute() override;
     RequestInfo fillRequestInfo() override;
+    bool getValueToCache(int attribute, QByteArray& value) const override;
+    bool restoreCachedValue(int attribute, const QByteArray& value) override;
 
     QString getFullName() const;    
     //In order to use in Rich Text labels (otherwise some characters may be interpreted as HMTL)
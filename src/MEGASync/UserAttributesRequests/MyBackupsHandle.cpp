@@ -75,6 +75,28 @@ AttributeRequest::RequestInfo MyBackupsHandle::fillRequestInfo()
     return ret;
 }
 
+bool MyBackupsHandle::getValueToCache(int attribute, QByteArray& value) const
+{
+    if(attribute == mega::MegaApi::USER_ATTR_MY_BACKUPS_FOLDER && isAttributeReady())
+    {
+        value = QByteArray::number(static_cast<qulonglong>(mMyBackupsFolderHandle));
+        return true;
+    }
+    return false;
+}
+
+bool MyBackupsHandle::restoreCachedValue(int attribute, const QByteArray& value)
+{
+    bool ok(false);
+    mega::MegaHandle handle (value.toULongLong(&ok));
+    if(attribute == mega::MegaApi::USER_ATTR_MY_BACKUPS_FOLDER && ok && handle != mega::INVALID_HANDLE)
+    {
+        onMyBackupsFolderReady(handle);
+        return true;
+    }
+    return false;
+}
+
 mega::MegaHandle MyBackupsHandle::getMyBackupsHandle() const
 {
     return mMyBackupsFolderHandle;
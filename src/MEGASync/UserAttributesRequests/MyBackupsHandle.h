@@ -22,6 +22,8 @@ public:
     void onRequestFinish(mega::MegaApi *, mega::MegaRequest *incoming_request, mega::MegaError *error) override;
     void requestAttribute() override;
     RequestInfo fillRequestInfo() override;
+    bool getValueToCache(int attribute, QByteArray& value) const override;
+    bool restoreCachedValue(int attribute, const QByteArray& value) override;
 
     bool isAttributeReady() const override;
 
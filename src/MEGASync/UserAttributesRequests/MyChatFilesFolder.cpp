@@ -39,6 +39,28 @@ AttributeRequest::RequestInfo MyChatFilesFolder::fillRequestInfo()
     return ret;
 }
 
+bool MyChatFilesFolder::getValueToCache(int attribute, QByteArray& value) const
+{
+    if(attribute == mega::MegaApi::USER_ATTR_MY_CHAT_FILES_FOLDER && isAttributeReady())
+    {
+        value = QByteArray::number(static_cast<qulonglong>(mMyChatFilesFolderHandle));
+        return true;
+    }
+    return false;
+}
+
+bool MyChatFilesFolder::restoreCachedValue(int attribute, const QByteArray& value)
+{
+    bool ok(false);
+    mega::MegaHandle handle (value.toULongLong(&ok));
+    if(attribute == mega::MegaApi::USER_ATTR_MY_CHAT_FILES_FOLDER && ok && handle != mega::INVALID_HANDLE)
+    {
+        mMyChatFilesFolderHandle = handle;
+        return true;
+    }
+    return false;
+}
+
 bool MyChatFilesFolder::isAttributeReady() const
 {
     return mMyChatFilesFolderHandle != mega::INVALID_HANDLE;
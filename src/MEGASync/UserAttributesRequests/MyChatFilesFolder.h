@@ -18,6 +18,8 @@ public:
     void onRequestFinish(mega::MegaApi *, mega::MegaRequest *incoming_request, mega::MegaError *e) override;
     void requestAttribute() override;
     AttributeRequest::RequestInfo fillRequestInfo() override;
+    bool getValueToCache(int attribute, QByteArray& value) const override;
+    bool restoreCachedValue(int attribute, const QByteArray& value) override;
 
     bool isAttributeReady() const override;
     const mega::MegaHandle& getMyChatFilesFolderHandle() const;
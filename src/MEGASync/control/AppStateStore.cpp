@@ -0,0 +1,110 @@
+#include "AppStateStore.h"
+#include "Utilities.h"
+
+#include <QPointer>
+
+bool AppStateStore::Activity::isBusy() const
+{
+    return indexing || waiting || syncing || transferring;
+}
+
+bool AppStateStore::Activity::operator==(const Activity& other) const
+{
+    return indexing == other.indexing && waiting == other.waiting && syncing == other.syncing
+            && transferring == other.transferring && pendingUploads == other.pendingUploads
+            && pendingDownloads == other.pendingDownloads;
+}
+
+bool AppStateStore::TrayState::operator==(const TrayState& other) const
+{
+    return icon == other.icon && tooltip == other.tooltip && animated == other.animated && idle == other.idle;
+}
+
+AppStateStore::AppStateStore(ActivityProbe activityProbe, TrayStateFunction trayStateFunction, QObject* parent)
+    : QObject(parent),
+      mActivityProbe(activityProbe),
+      mTrayStateFunction(trayStateFunction),
+      mProbing(false),
+      mRefreshPending(false)
+{
+    mRefreshTimer.setSingleShot(true);
+    mRefreshTimer.setInterval(REFRESH_DELAY_MS);
+    connect(&mRefreshTimer, &QTimer::timeout, this, &AppStateStore::refresh);
+}
+
+void AppStateStore::inputChanged()
+{
+    if (mProbing)
+    {
+        // The probe may have read the inputs before this change
+        mRefreshPending = true;
+    }
+    else if (!mRefreshTimer.isActive())
+    {
+        mRefreshTimer.start();
+    }
+}
+
+void AppStateStore::refreshTrayState(bool force)
+{
+    TrayState trayState(mTrayStateFunction());
+    if (force || trayState != mTrayState)
+    {
+        mTrayState = trayState;
+        emit trayStateChanged(mTrayState);
+    }
+}
+
+const AppStateStore::Activity& AppStateStore::activity() const
+{
+    return mActivity;
+}
+
+const AppStateStore::TrayState& AppStateStore::trayState() const
+{
+    return mTrayState;
+}
+
+void AppStateStore::refresh()
+{
+    mProbing = true;
+
+    QPointer<AppStateStore> store(this);
+    auto probe(mActivityProbe);
+    ThreadPoolSingleton::getInstance()->push([store, probe]()
+    {//thread pool function
+        Activity activity(probe());
+        Utilities::queueFunctionInAppThread([store, activity]()
+        {//queued function
+            if (store)
+            {
+                store->onActivityProbed(activity);
+            }
+        });//end of queued function
+    });// end of thread pool function
+}
+
+void AppStateStore::onActivityProbed(const Activity& activity)
+{
+    mProbing = false;
+
+    if (activity != mActivity)
+    {
+        bool wasBusy(mActivity.isBusy());
+        mActivity = activity;
+        emit activityChanged(mActivity);
+
+        if (wasBusy != mActivity.isBusy())
+        {
+            emit busyChanged(mActivity.isBusy());
+        }
+    }
+
+    refreshTrayState();
+
+    if (mRefreshPending)
+    {
+        mRefreshPending = false;
+        mRefreshTimer.start();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef APPSTATESTORE_H
+#define APPSTATESTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+/**
+ * @brief State of the application shown to the user
+ *
+ * Keeps the state of the application shown to the user (activity, tray icon and tooltip) and notifies it only
+ * when it changes.
+ *
+ * The SDK callbacks and the transfers model report that an input changed with inputChanged(). Changes are
+ * coalesced for REFRESH_DELAY_MS, then the activity is probed once on the thread pool and the tray state is
+ * recomputed with the function provided by the application. Nothing is polled.
+ */
+class AppStateStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int REFRESH_DELAY_MS = 200;
+
+    struct Activity
+    {
+        bool indexing = false;
+        bool waiting = false;
+        bool syncing = false;
+        bool transferring = false;
+        int pendingUploads = 0;
+        int pendingDownloads = 0;
+
+        bool isBusy() const;
+        bool operator==(const Activity& other) const;
+        bool operator!=(const Activity& other) const {return !(*this == other);}
+    };
+
+    struct TrayState
+    {
+        QString icon;
+        QString tooltip;
+        // Working icon, animated on macOS
+        bool animated = false;
+        // Nothing left to do, so a pending restart can be applied
+        bool idle = false;
+
+        bool operator==(const TrayState& other) const;
+        bool operator!=(const TrayState& other) const {return !(*this == other);}
+    };
+
+    // The probe runs on the thread pool
+    using ActivityProbe = std::function<Activity()>;
+    using TrayStateFunction = std::function<TrayState()>;
+
+    AppStateStore(ActivityProbe activityProbe, TrayStateFunction trayStateFunction, QObject* parent = nullptr);
+
+    void inputChanged();
+    // For the inputs of the tray state read on the main thread: recomputes it right away.
+    // With force, the state is emitted even if it did not change, e.g. when the tray icon
+    // was recreated or could not be updated before
+    void refreshTrayState(bool force = false);
+    const Activity& activity() const;
+    const TrayState& trayState() const;
+
+signals:
+    void activityChanged(const AppStateStore::Activity& activity);
+    void busyChanged(bool busy);
+    void trayStateChanged(const AppStateStore::TrayState& state);
+
+private slots:
+    void refresh();
+
+private:
+    void onActivityProbed(const Activity& activity);
+
+    ActivityProbe mActivityProbe;
+    TrayStateFunction mTrayStateFunction;
+    QTimer mRefreshTimer;
+    Activity mActivity;
+    TrayState mTrayState;
+    bool mProbing;
+    bool mRefreshPending;
+};
+
+#endif // APPSTATESTORE_H
@@ -0,0 +1,337 @@
+#include "BinaryPatch.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <cstring>
+
+constexpr quint32 BinaryPatch::FORMAT_VERSION;
+constexpr int BinaryPatch::DEFAULT_BLOCK_SIZE;
+constexpr int BinaryPatch::CHUNK_SIZE;
+
+namespace
+{
+const char PATCH_MAGIC[] = {'M', 'E', 'G', 'A', 'P', 'T', 'C', 'H'};
+constexpr quint32 HASH_MULTIPLIER{31};
+// Base offsets kept per block hash. Bounds the time spent on highly repetitive files
+constexpr int MAX_CANDIDATES_PER_HASH{8};
+
+quint32 blockHash(const char* data, int size)
+{
+    quint32 hash{0};
+    for (int i = 0; i < size; ++i)
+    {
+        hash = hash * HASH_MULTIPLIER + static_cast<unsigned char>(data[i]);
+    }
+    return hash;
+}
+}
+
+BinaryPatch::Result BinaryPatch::apply(QIODevice* base, QIODevice* patch, QIODevice* output)
+{
+    char magic[sizeof(PATCH_MAGIC)];
+    if (!readExact(patch, magic, sizeof(magic)) || memcmp(magic, PATCH_MAGIC, sizeof(magic)))
+    {
+        return Result::INVALID_HEADER;
+    }
+
+    quint64 version;
+    quint64 targetSize;
+    if (!readUInt64(patch, version) || version != FORMAT_VERSION || !readUInt64(patch, targetSize))
+    {
+        return Result::INVALID_HEADER;
+    }
+
+    QByteArray buffer(CHUNK_SIZE, Qt::Uninitialized);
+    quint64 written{0};
+    while (true)
+    {
+        char operation;
+        if (!readExact(patch, &operation, 1))
+        {
+            return Result::CORRUPT_PATCH;
+        }
+
+        if (operation == OP_END)
+        {
+            break;
+        }
+
+        if (operation == OP_COPY)
+        {
+            quint64 offset;
+            quint64 size;
+            if (!readUInt64(patch, offset) || !readUInt64(patch, size))
+            {
+                return Result::CORRUPT_PATCH;
+            }
+
+            if (offset + size > static_cast<quint64>(base->size()) || offset + size < offset
+                    || !base->seek(static_cast<qint64>(offset)))
+            {
+                return Result::CORRUPT_PATCH;
+            }
+
+            while (size)
+            {
+                qint64 chunk = static_cast<qint64>(qMin<quint64>(size, CHUNK_SIZE));
+                if (!readExact(base, buffer.data(), chunk))
+                {
+                    return Result::READ_ERROR;
+                }
+                if (!writeExact(output, buffer.constData(), chunk))
+                {
+                    return Result::WRITE_ERROR;
+                }
+                size -= chunk;
+                written += chunk;
+            }
+        }
+        else if (operation == OP_INSERT)
+        {
+            quint64 size;
+            if (!readUInt64(patch, size))
+            {
+                return Result::CORRUPT_PATCH;
+            }
+
+            while (size)
+            {
+                qint64 chunk = static_cast<qint64>(qMin<quint64>(size, CHUNK_SIZE));
+                if (!readExact(patch, buffer.data(), chunk))
+                {
+                    return Result::CORRUPT_PATCH;
+                }
+                if (!writeExact(output, buffer.constData(), chunk))
+                {
+                    return Result::WRITE_ERROR;
+                }
+                size -= chunk;
+                written += chunk;
+            }
+        }
+        else
+        {
+            return Result::CORRUPT_PATCH;
+        }
+
+        if (written > targetSize)
+        {
+            return Result::SIZE_MISMATCH;
+        }
+    }
+
+    return written == targetSize ? Result::OK : Result::SIZE_MISMATCH;
+}
+
+bool BinaryPatch::create(const QByteArray& base, const QByteArray& target, QIODevice* patch, int blockSize)
+{
+    if (blockSize <= 0)
+    {
+        return false;
+    }
+
+    if (!writeExact(patch, PATCH_MAGIC, sizeof(PATCH_MAGIC))
+            || !writeUInt64(patch, FORMAT_VERSION)
+            || !writeUInt64(patch, static_cast<quint64>(target.size())))
+    {
+        return false;
+    }
+
+    // Index every aligned block of the base file
+    QHash<quint32, QVector<int>> baseBlocks;
+    for (int offset = 0; offset + blockSize <= base.size(); offset += blockSize)
+    {
+        auto& candidates = baseBlocks[blockHash(base.constData() + offset, blockSize)];
+        if (candidates.size() < MAX_CANDIDATES_PER_HASH)
+        {
+            candidates.append(offset);
+        }
+    }
+
+    // Weight of the byte leaving the rolling window
+    quint32 outWeight{1};
+    for (int i = 1; i < blockSize; ++i)
+    {
+        outWeight *= HASH_MULTIPLIER;
+    }
+
+    const char* targetData = target.constData();
+    const int targetSize = target.size();
+    int literalStart{0};
+    int position{0};
+    quint32 hash = targetSize >= blockSize ? blockHash(targetData, blockSize) : 0;
+
+    while (position + blockSize <= targetSize)
+    {
+        int matchOffset{-1};
+        int matchSize{0};
+        auto candidates = baseBlocks.constFind(hash);
+        if (candidates != baseBlocks.constEnd())
+        {
+            for (int candidate : candidates.value())
+            {
+                if (memcmp(base.constData() + candidate, targetData + position, static_cast<size_t>(blockSize)))
+                {
+                    continue;
+                }
+
+                int size{blockSize};
+                while (position + size < targetSize && candidate + size < base.size()
+                       && targetData[position + size] == base.at(candidate + size))
+                {
+                    ++size;
+                }
+
+                if (size > matchSize)
+                {
+                    matchOffset = candidate;
+                    matchSize = size;
+                }
+            }
+        }
+
+        if (matchOffset < 0)
+        {
+            if (position + blockSize < targetSize)
+            {
+                hash = (hash - static_cast<unsigned char>(targetData[position]) * outWeight) * HASH_MULTIPLIER
+                        + static_cast<unsigned char>(targetData[position + blockSize]);
+            }
+            ++position;
+            continue;
+        }
+
+        // Grow the match backwards over the pending literal bytes
+        while (position > literalStart && matchOffset > 0
+               && targetData[position - 1] == base.at(matchOffset - 1))
+        {
+            --position;
+            --matchOffset;
+            ++matchSize;
+        }
+
+        if (!writeInsert(patch, targetData + literalStart, position - literalStart)
+                || !writeCopy(patch, static_cast<quint64>(matchOffset), static_cast<quint64>(matchSize)))
+        {
+            return false;
+        }
+
+        position += matchSize;
+        literalStart = position;
+        if (position + blockSize <= targetSize)
+        {
+            hash = blockHash(targetData + position, blockSize);
+        }
+    }
+
+    if (!writeInsert(patch, targetData + literalStart, targetSize - literalStart))
+    {
+        return false;
+    }
+
+    const char end{OP_END};
+    return writeExact(patch, &end, 1);
+}
+
+QString BinaryPatch::resultToString(BinaryPatch::Result result)
+{
+    switch (result)
+    {
+        case Result::OK:
+            return QString::fromUtf8("OK");
+        case Result::INVALID_HEADER:
+            return QString::fromUtf8("Invalid patch header");
+        case Result::CORRUPT_PATCH:
+            return QString::fromUtf8("Corrupt patch");
+        case Result::READ_ERROR:
+            return QString::fromUtf8("Error reading base file");
+        case Result::WRITE_ERROR:
+            return QString::fromUtf8("Error writing patched file");
+        case Result::SIZE_MISMATCH:
+            return QString::fromUtf8("Patched file size mismatch");
+    }
+    return QString();
+}
+
+bool BinaryPatch::readExact(QIODevice* device, char* data, qint64 size)
+{
+    while (size > 0)
+    {
+        qint64 read = device->read(data, size);
+        if (read <= 0)
+        {
+            if (read == 0 && device->isSequential() && device->waitForReadyRead(-1))
+            {
+                continue;
+            }
+            return false;
+        }
+        data += read;
+        size -= read;
+    }
+    return true;
+}
+
+bool BinaryPatch::writeExact(QIODevice* device, const char* data, qint64 size)
+{
+    while (size > 0)
+    {
+        qint64 written = device->write(data, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool BinaryPatch::readUInt64(QIODevice* device, quint64& value)
+{
+    unsigned char bytes[8];
+    if (!readExact(device, reinterpret_cast<char*>(bytes), sizeof(bytes)))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    return true;
+}
+
+bool BinaryPatch::writeUInt64(QIODevice* device, quint64 value)
+{
+    char bytes[8];
+    for (int i = 7; i >= 0; --i)
+    {
+        bytes[i] = static_cast<char>(value & 0xFF);
+        value >>= 8;
+    }
+    return writeExact(device, bytes, sizeof(bytes));
+}
+
+bool BinaryPatch::writeInsert(QIODevice* patch, const char* data, qint64 size)
+{
+    if (size <= 0)
+    {
+        return true;
+    }
+
+    const char operation{OP_INSERT};
+    return writeExact(patch, &operation, 1)
+            && writeUInt64(patch, static_cast<quint64>(size))
+            && writeExact(patch, data, size);
+}
+
+bool BinaryPatch::writeCopy(QIODevice* patch, quint64 offset, quint64 size)
+{
+    const char operation{OP_COPY};
+    return writeExact(patch, &operation, 1)
+            && writeUInt64(patch, offset)
+            && writeUInt64(patch, size);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+/**
+ * @brief Creates and applies binary delta patches between two versions of a file
+ *
+ * A patch is a header (magic, format version and size of the target file) followed by a list of operations
+ * that rebuild the target from the base file: COPY a range of the base file or INSERT literal bytes carried
+ * by the patch. Patches are applied in streaming mode, reading the patch sequentially and the base file with
+ * random access, so memory usage is bounded by the chunk size whatever the size of the files. Patches are
+ * only created by the client tests: the update generator doesn't emit them yet, so the patch section of the
+ * update manifest is built separately.
+ */
+class BinaryPatch
+{
+public:
+    enum class Result
+    {
+        OK,
+        INVALID_HEADER,
+        CORRUPT_PATCH,
+        READ_ERROR,
+        WRITE_ERROR,
+        SIZE_MISMATCH
+    };
+
+    static constexpr quint32 FORMAT_VERSION{1};
+    static constexpr int DEFAULT_BLOCK_SIZE{64};
+    static constexpr int CHUNK_SIZE{64 * 1024};
+
+    // base must be open and seekable, patch and output can be sequential devices
+    static Result apply(QIODevice* base, QIODevice* patch, QIODevice* output);
+
+    // Generates the patch that rebuilds target from base. Only used by tests for now.
+    static bool create(const QByteArray& base, const QByteArray& target, QIODevice* patch,
+                       int blockSize = DEFAULT_BLOCK_SIZE);
+
+    static QString resultToString(Result result);
+
+private:
+    enum Operation : char
+    {
+        OP_COPY = 'C',
+        OP_INSERT = 'I',
+        OP_END = 'E'
+    };
+
+    static bool readExact(QIODevice* device, char* data, qint64 size);
+    static bool writeExact(QIODevice* device, const char* data, qint64 size);
+    static bool readUInt64(QIODevice* device, quint64& value);
+    static bool writeUInt64(QIODevice* device, quint64 value);
+    static bool writeInsert(QIODevice* patch, const char* data, qint64 size);
+    static bool writeCopy(QIODevice* patch, quint64 offset, quint64 size);
+};
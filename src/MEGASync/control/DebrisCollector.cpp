@@ -0,0 +1,290 @@
+#include "DebrisCollector.h"
+#include "DirectoryWalker.h"
+
+#include "megaapi.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#elif defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace mega;
+
+namespace
+{
+// The rate is enforced over slices of this length, so the deletion is paced instead of bursty
+const int SLICE_MS = 100;
+const int SLICES_PER_SECOND = 1000 / SLICE_MS;
+const int PROGRESS_INTERVAL_MS = 1000;
+}
+
+DebrisCollector::DebrisCollector(const QString& queueFilePath)
+    : QObject(nullptr),
+      mThread(new QThread()),
+      mQueueFilePath(queueFilePath),
+      mStopping(false),
+      mCollecting(false),
+      mBytesReclaimed(0),
+      mFilesReclaimed(0),
+      mSliceFiles(0),
+      mSliceBytes(0)
+{
+    loadQueue();
+    moveToThread(mThread);
+    mThread->start(QThread::IdlePriority);
+
+    if (!mQueue.isEmpty())
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                     QString::fromUtf8("Debris collector: resuming the deletion of %1 folders")
+                     .arg(mQueue.size()).toUtf8().constData());
+        QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+    }
+}
+
+DebrisCollector::~DebrisCollector()
+{
+    // The pending folders stay in the queue file
+    mStopping = true;
+    mThread->quit();
+    mThread->wait();
+    delete mThread;
+}
+
+void DebrisCollector::collect(const QStringList& folders)
+{
+    bool added(false);
+    {
+        QMutexLocker lock(&mQueueMutex);
+        foreach (auto folder, folders)
+        {
+            if (!folder.isEmpty() && !mQueue.contains(folder))
+            {
+                mQueue.append(folder);
+                added = true;
+            }
+        }
+    }
+
+    if (added)
+    {
+        saveQueue();
+        QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+    }
+}
+
+bool DebrisCollector::isCollecting() const
+{
+    return mCollecting;
+}
+
+void DebrisCollector::processQueue()
+{
+    lowerIoPriority();
+
+    mCollecting = true;
+    mBytesReclaimed = 0;
+    mFilesReclaimed = 0;
+    mSliceFiles = 0;
+    mSliceBytes = 0;
+    mSliceTimer.start();
+    mProgressTimer.start();
+
+    while (!mStopping)
+    {
+        QString folder;
+        {
+            QMutexLocker lock(&mQueueMutex);
+            if (mQueue.isEmpty())
+            {
+                break;
+            }
+            folder = mQueue.first();
+        }
+
+        if (!removeFolder(folder))
+        {
+            if (mStopping)
+            {
+                break;
+            }
+
+            // Not retried until it is queued again, so an undeletable entry can't stall the queue
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING,
+                         QString::fromUtf8("Debris collector: unable to remove %1 completely")
+                         .arg(folder).toUtf8().constData());
+        }
+
+        {
+            QMutexLocker lock(&mQueueMutex);
+            mQueue.removeOne(folder);
+        }
+        saveQueue();
+    }
+
+    mCollecting = false;
+
+    if (mFilesReclaimed)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                     QString::fromUtf8("Debris collector: %1 files and %2 bytes reclaimed")
+                     .arg(mFilesReclaimed).arg(mBytesReclaimed).toUtf8().constData());
+        emit finished(mBytesReclaimed, mFilesReclaimed);
+    }
+}
+
+bool DebrisCollector::removeFolder(const QString& folder)
+{
+    // Daily debris entries are usually folders, but files can end up there too
+    const QFileInfo info(folder);
+    if (info.isSymLink() || info.isFile())
+    {
+        removeEntry(info);
+        return !QFileInfo(folder).exists() && !QFileInfo(folder).isSymLink();
+    }
+
+    if (!DirectoryWalker::walk(folder, [this](const QFileInfo& info) { return removeEntry(info); }))
+    {
+        return false;
+    }
+    return QDir().rmdir(folder) || !QFileInfo::exists(folder);
+}
+
+// Entries that can't be removed are skipped, the folder removal reports them
+bool DebrisCollector::removeEntry(const QFileInfo& info)
+{
+    if (mStopping)
+    {
+        return false;
+    }
+
+    const QString path(info.absoluteFilePath());
+    if (info.isDir() && !info.isSymLink())
+    {
+        QDir().rmdir(path);
+        return true;
+    }
+
+    const long long size(info.isSymLink() ? 0 : info.size());
+    bool removed = QFile::remove(path);
+    if (!removed && !info.isSymLink() && !info.isWritable())
+    {
+        QFile::setPermissions(path, info.permissions() | QFile::WriteOwner | QFile::WriteUser);
+        removed = QFile::remove(path);
+    }
+
+    if (removed)
+    {
+        mFilesReclaimed++;
+        mBytesReclaimed += size;
+        throttle(size);
+    }
+    return true;
+}
+
+void DebrisCollector::throttle(long long bytes)
+{
+    mSliceFiles++;
+    mSliceBytes += bytes;
+
+    if (mSliceFiles >= MAX_FILES_PER_SECOND / SLICES_PER_SECOND
+            || mSliceBytes >= MAX_BYTES_PER_SECOND / SLICES_PER_SECOND)
+    {
+        const qint64 elapsed(mSliceTimer.elapsed());
+        if (elapsed < SLICE_MS)
+        {
+            QThread::msleep(static_cast<unsigned long>(SLICE_MS - elapsed));
+        }
+    }
+
+    if (mSliceTimer.elapsed() >= SLICE_MS)
+    {
+        mSliceFiles = 0;
+        mSliceBytes = 0;
+        mSliceTimer.restart();
+    }
+
+    if (mProgressTimer.elapsed() >= PROGRESS_INTERVAL_MS)
+    {
+        mProgressTimer.restart();
+        emit progress(mBytesReclaimed, mFilesReclaimed);
+    }
+}
+
+void DebrisCollector::saveQueue()
+{
+    QStringList queue;
+    {
+        QMutexLocker lock(&mQueueMutex);
+        queue = mQueue;
+    }
+
+    if (queue.isEmpty())
+    {
+        QFile::remove(mQueueFilePath);
+        return;
+    }
+
+    QSaveFile file(mQueueFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR,
+                     QString::fromUtf8("Debris collector: unable to write %1: %2")
+                     .arg(mQueueFilePath, file.errorString()).toUtf8().constData());
+        return;
+    }
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    foreach (auto folder, queue)
+    {
+        out << folder << QLatin1Char('\n');
+    }
+    out.flush();
+    file.commit();
+}
+
+void DebrisCollector::loadQueue()
+{
+    QFile file(mQueueFilePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd())
+    {
+        const QString folder(in.readLine().trimmed());
+        if (!folder.isEmpty() && !mQueue.contains(folder))
+        {
+            mQueue.append(folder);
+        }
+    }
+}
+
+// Lowers the I/O priority of the calling thread, so the deletion yields to any other disk access
+void DebrisCollector::lowerIoPriority()
+{
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__APPLE__)
+    setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#elif defined(Q_OS_LINUX)
+    // ioprio_set(IOPRIO_WHO_PROCESS, calling thread, IOPRIO_CLASS_IDLE), not wrapped by glibc
+    const int IOPRIO_WHO_PROCESS = 1;
+    const int IOPRIO_CLASS_IDLE = 3;
+    const int IOPRIO_CLASS_SHIFT = 13;
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#endif
+}
@@ -0,0 +1,69 @@
+#ifndef DEBRISCOLLECTOR_H
+#define DEBRISCOLLECTOR_H
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+
+#include <atomic>
+
+/**
+ * @brief Background deletion of the local debris folders
+ *
+ * Deletes local debris folders in a background thread with low I/O priority and a bounded deletion rate, so
+ * cleaning a large debris neither blocks the application nor saturates the disk.
+ *
+ * The folders pending deletion are saved to a file, and an interrupted collection resumes when the collector
+ * is created again.
+ */
+class DebrisCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_FILES_PER_SECOND = 500;
+    static const long long MAX_BYTES_PER_SECOND = 256LL * 1024 * 1024;
+
+    explicit DebrisCollector(const QString& queueFilePath);
+    ~DebrisCollector();
+
+    // Queues folders for deletion; the ones already queued are ignored. Thread safe
+    void collect(const QStringList& folders);
+    bool isCollecting() const;
+
+signals:
+    // Emitted from the collector thread, at most once per second while deleting
+    void progress(long long bytesReclaimed, long long filesReclaimed);
+    void finished(long long bytesReclaimed, long long filesReclaimed);
+
+private slots:
+    void processQueue();
+
+private:
+    bool removeFolder(const QString& folder);
+    bool removeEntry(const QFileInfo& info);
+    void throttle(long long bytes);
+    void saveQueue();
+    void loadQueue();
+    static void lowerIoPriority();
+
+    QThread* mThread;
+    QString mQueueFilePath;
+    mutable QMutex mQueueMutex;
+    QStringList mQueue;
+    std::atomic<bool> mStopping;
+    std::atomic<bool> mCollecting;
+
+    // Only used from the collector thread
+    long long mBytesReclaimed;
+    long long mFilesReclaimed;
+    QElapsedTimer mSliceTimer;
+    int mSliceFiles;
+    long long mSliceBytes;
+    QElapsedTimer mProgressTimer;
+};
+
+#endif // DEBRISCOLLECTOR_H
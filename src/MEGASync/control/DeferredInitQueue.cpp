@@ -0,0 +1,74 @@
+#include "DeferredInitQueue.h"
+#include "StartupTracer.h"
+
+#include <QTimer>
+
+#include <algorithm>
+
+DeferredInitQueue::DeferredInitQueue(const QString& traceFilePath, QObject* parent)
+    : QObject(parent),
+      mTraceFilePath(traceFilePath),
+      mStarted(false),
+      mScheduled(false)
+{
+}
+
+void DeferredInitQueue::enqueue(Priority priority, const char* name, std::function<void()> task)
+{
+    // Kept sorted; tasks with the same priority run in the order they were queued
+    auto position = std::upper_bound(mTasks.begin(), mTasks.end(), priority, [](Priority value, const Task& task)
+    {
+        return value < task.priority;
+    });
+    mTasks.insert(position, Task{priority, name, std::move(task)});
+
+    if (mStarted)
+    {
+        scheduleNext();
+    }
+}
+
+void DeferredInitQueue::start()
+{
+    if (mStarted)
+    {
+        return;
+    }
+
+    mStarted = true;
+    StartupTracer::instant("deferred init started");
+    scheduleNext();
+}
+
+bool DeferredInitQueue::isStarted() const
+{
+    return mStarted;
+}
+
+void DeferredInitQueue::runNext()
+{
+    mScheduled = false;
+    if (mTasks.isEmpty())
+    {
+        StartupTracer::instant("deferred init finished");
+        StartupTracer::finish(mTraceFilePath);
+        return;
+    }
+
+    Task task = mTasks.takeFirst();
+    {
+        StartupTracer::Span span(task.name);
+        task.run();
+    }
+    scheduleNext();
+}
+
+// Back to the event loop between tasks, so pending events are not delayed by the whole queue
+void DeferredInitQueue::scheduleNext()
+{
+    if (!mScheduled)
+    {
+        mScheduled = true;
+        QTimer::singleShot(0, this, &DeferredInitQueue::runNext);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef DEFERREDINITQUEUE_H
+#define DEFERREDINITQUEUE_H
+
+#include <QObject>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief Queue of the deferred startup work
+ *
+ * Runs the startup work that is not needed to show the tray icon later, one task per event loop iteration so
+ * the application stays responsive, in priority order.
+ *
+ * Tasks queued before start() wait for it; the ones queued afterwards run as soon as possible. Each task is
+ * traced with the startup tracer, and the trace is written when the queue runs out for the first time.
+ */
+class DeferredInitQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority
+    {
+        PRIORITY_HIGH = 0,
+        PRIORITY_NORMAL,
+        PRIORITY_LOW
+    };
+
+    DeferredInitQueue(const QString& traceFilePath, QObject* parent = nullptr);
+
+    // name must be a string literal, it is kept for the trace
+    void enqueue(Priority priority, const char* name, std::function<void()> task);
+    void start();
+    bool isStarted() const;
+
+private slots:
+    void runNext();
+
+private:
+    struct Task
+    {
+        Priority priority;
+        const char* name;
+        std::function<void()> run;
+    };
+
+    void scheduleNext();
+
+    QVector<Task> mTasks;
+    QString mTraceFilePath;
+    bool mStarted;
+    bool mScheduled;
+};
+
+#endif // DEFERREDINITQUEUE_H
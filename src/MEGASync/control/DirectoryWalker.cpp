@@ -0,0 +1,43 @@
+#include "DirectoryWalker.h"
+
+#include <QDirIterator>
+
+bool DirectoryWalker::walk(const QString& root, const Visitor& visitor)
+{
+    if(root.isEmpty())
+    {
+        return true;
+    }
+
+    // Streamed, so huge directories are not listed in memory at once
+    QDirIterator it(root, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    while(it.hasNext())
+    {
+        it.next();
+        const QFileInfo info(it.fileInfo());
+        if(info.isDir() && !info.isSymLink() && !walk(info.absoluteFilePath(), visitor))
+        {
+            return false;
+        }
+
+        if(!visitor(info))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+long long DirectoryWalker::totalSize(const QString& root)
+{
+    long long size(0);
+    walk(root, [&size](const QFileInfo& info)
+    {
+        if(info.isFile())
+        {
+            size += info.size();
+        }
+        return true;
+    });
+    return size;
+}
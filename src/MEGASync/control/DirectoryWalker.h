@@ -0,0 +1,30 @@
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include <QFileInfo>
+#include <QString>
+
+#include <functional>
+
+/**
+ * @brief Walker of the local directory trees
+ *
+ * Visits every entry under a local directory, hidden ones included, without following symbolic links to
+ * directories.
+ *
+ * Directories are visited after their contents, so a visitor can remove each entry as it goes.
+ */
+class DirectoryWalker
+{
+public:
+    // Returns false to stop the walk
+    using Visitor = std::function<bool(const QFileInfo& info)>;
+
+    // The root itself is not visited. Returns false if the visitor stopped the walk
+    static bool walk(const QString& root, const Visitor& visitor);
+
+    // Sum of the sizes of the files under root
+    static long long totalSize(const QString& root);
+};
+
+#endif // DIRECTORYWALKER_H
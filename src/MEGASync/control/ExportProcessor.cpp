@@ -1,8 +1,39 @@
 #include "ExportProcessor.h"
+#include "FingerprintCache.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
 
 using namespace mega;
 using namespace std;
 
+namespace
+{
+// Computes the fingerprint of a local file, reusing the cached one if the file did not change
+QByteArray computeFingerprint(MegaApi *megaApi, const QString& filePath, const string& localPath)
+{
+    QFileInfo info(filePath);
+    const qint64 size = info.size();
+    const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+
+    FingerprintCache& cache = FingerprintCache::instance();
+    QByteArray fingerprint = cache.find(filePath, size, lastModified);
+    if (fingerprint.isEmpty())
+    {
+        const char *fpLocal = megaApi->getFingerprint(localPath.c_str());
+        fingerprint = QByteArray(fpLocal);
+        delete [] fpLocal;
+        if (info.exists())
+        {
+            cache.insert(filePath, size, lastModified, fingerprint);
+        }
+    }
+    return fingerprint;
+}
+}
+
 ExportProcessor::ExportProcessor(MegaApi *megaApi, QStringList fileList) : QObject()
 {
     this->megaApi = megaApi;
@@ -10,6 +41,8 @@ ExportProcessor::ExportProcessor(MegaApi *megaApi, QStringList fileList) : QObje
     this->mode = MODE_PATHS;
 
     currentIndex = 0;
+    pendingFingerprints = 0;
+    nextExportIndex = 0;
     remainingNodes = fileList.size();
     importSuccess = 0;
     importFailed = 0;
@@ -24,6 +57,8 @@ ExportProcessor::ExportProcessor(MegaApi *megaApi, QList<MegaHandle> handleList)
     this->mode = MODE_HANDLES;
 
     currentIndex = 0;
+    pendingFingerprints = 0;
+    nextExportIndex = 0;
     remainingNodes = handleList.size();
     importSuccess = 0;
     importFailed = 0;
@@ -33,6 +68,7 @@ ExportProcessor::ExportProcessor(MegaApi *megaApi, QList<MegaHandle> handleList)
 
 ExportProcessor::~ExportProcessor()
 {
+    qDeleteAll(nodesToExport);
     delete delegateListener;
 }
 
@@ -45,11 +81,14 @@ void ExportProcessor::requestLinks()
         return;
     }
 
+    nodesToExport.fill(NULL, size);
+    resolvedNodes.fill(false, size);
     for (int i = 0; i < size; i++)
     {
         MegaNode *node = NULL;
         if (mode == MODE_PATHS)
         {
+            QString filePath = fileList[i];
     #ifdef WIN32
             if (!fileList[i].startsWith(QString::fromAscii("\\\\")))
             {
@@ -64,17 +103,79 @@ void ExportProcessor::requestLinks()
             node = megaApi->getSyncedNode(&tmpPath);
             if (!node)
             {
-                const char *fpLocal = megaApi->getFingerprint(tmpPath.c_str());
-                node = megaApi->getNodeByFingerprint(fpLocal);
-                delete [] fpLocal;
+                // Reading the whole file can take long, the link is exported when its fingerprint is ready
+                fingerprintLater(i, filePath, tmpPath);
+                continue;
             }
         }
         else
         {
             node = megaApi->getNodeByHandle(handleList[i]);
         }
-        megaApi->exportNode(node, delegateListener);
-        delete node;
+        resolveNode(i, node);
+    }
+}
+
+// Nodes are exported in the order of the list, so the links keep the order of the selection
+void ExportProcessor::resolveNode(int index, MegaNode *node)
+{
+    nodesToExport[index] = node;
+    resolvedNodes.setBit(index);
+
+    while (nextExportIndex < resolvedNodes.size() && resolvedNodes.testBit(nextExportIndex))
+    {
+        exportNode(nodesToExport[nextExportIndex]);
+        nodesToExport[nextExportIndex] = NULL;
+        nextExportIndex++;
+    }
+}
+
+void ExportProcessor::exportNode(MegaNode *node)
+{
+    // A missing node is reported as failed by the request
+    megaApi->exportNode(node, delegateListener);
+    delete node;
+}
+
+void ExportProcessor::fingerprintLater(int index, const QString& filePath, const string& localPath)
+{
+    pendingFingerprints++;
+
+    auto watcher = new QFutureWatcher<QByteArray>(this);
+    connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher, index]()
+    {
+        onFingerprintReady(index, watcher->result());
+        watcher->deleteLater();
+    });
+
+    MegaApi *api = megaApi;
+    watcher->setFuture(QtConcurrent::run(fingerprintPool(), [api, filePath, localPath]() -> QByteArray
+    {
+        return computeFingerprint(api, filePath, localPath);
+    }));
+}
+
+QThreadPool *ExportProcessor::fingerprintPool()
+{
+    static QThreadPool pool;
+    static bool initialized = false;
+    if (!initialized)
+    {
+        pool.setMaxThreadCount(MAX_FINGERPRINT_THREADS);
+        initialized = true;
+    }
+    return &pool;
+}
+
+void ExportProcessor::onFingerprintReady(int index, const QByteArray& fingerprint)
+{
+    MegaNode *node = fingerprint.isEmpty() ? NULL : megaApi->getNodeByFingerprint(fingerprint.constData());
+    resolveNode(index, node);
+
+    pendingFingerprints--;
+    if (!pendingFingerprints)
+    {
+        FingerprintCache::instance().save();
     }
 }
 
@@ -1,7 +1,10 @@
 #ifndef EXPORTPROCESSOR_H
 #define EXPORTPROCESSOR_H
 
+#include <QBitArray>
 #include <QStringList>
+#include <QThreadPool>
+#include <QVector>
 #include <megaapi.h>
 #include <QTMegaRequestListener.h>
 
@@ -28,6 +31,15 @@ protected:
         MODE_HANDLES
     };
 
+    // Files not synced are fingerprinted in the background, a few at a time
+    static const int MAX_FINGERPRINT_THREADS = 4;
+
+    void resolveNode(int index, mega::MegaNode *node);
+    void exportNode(mega::MegaNode *node);
+    void fingerprintLater(int index, const QString& filePath, const std::string& localPath);
+    void onFingerprintReady(int index, const QByteArray& fingerprint);
+    static QThreadPool *fingerprintPool();
+
     mega::MegaApi *megaApi;
     QStringList fileList;
     QList<mega::MegaHandle> handleList;
@@ -38,6 +50,11 @@ protected:
     int importSuccess;
     int importFailed;
     int mode;
+    int pendingFingerprints;
+    // Nodes found out of order wait here until the previous ones are exported
+    QVector<mega::MegaNode*> nodesToExport;
+    QBitArray resolvedNodes;
+    int nextExportIndex;
     mega::QTMegaRequestListener *delegateListener;
 };
 
@@ -0,0 +1,337 @@
+#ifndef FILEEXTENSIONTABLE_H
+#define FILEEXTENSIONTABLE_H
+
+#include "Utilities.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Maps a file extension to its file type and icon without allocations
+ *
+ * The table is a perfect hash (hash and displace): the extension hash picks a bucket, and the displacement
+ * stored for that bucket sends every extension of the bucket to its own slot. A lookup is two hashes of the
+ * lowercased extension and a single comparison. The table is built on first use: searching the displacements
+ * takes too many steps to be evaluated at compile time.
+ */
+namespace FileExtensionTable
+{
+enum class Icon : uint8_t
+{
+    GENERIC,
+    THREE_D,
+    AFTER_EFFECTS,
+    AUDIO,
+    CAD,
+    COMPRESSED,
+    WEB_LANG,
+    FOLDER,
+    EXCEL,
+    EXECUTABLE,
+    FONT,
+    IMAGE,
+    ILLUSTRATOR,
+    INDESIGN,
+    WEB_DATA,
+    PDF,
+    PHOTOSHOP,
+    POWERPOINT,
+    PREMIERE,
+    RAW,
+    SPREADSHEET,
+    TORRENT,
+    DMG,
+    TEXT,
+    VECTOR,
+    VIDEO,
+    WORD,
+    OPEN_OFFICE,
+    SKETCH,
+    EXPERIENCE_DESIGN,
+    PAGES,
+    NUMBERS,
+    KEYNOTE,
+    ICONS_COUNT
+};
+
+// Indexed by Icon
+constexpr const char* ICON_NAMES[] = {
+    "generic.png", "3D.png", "aftereffects.png", "audio.png", "cad.png", "compressed.png", "web_lang.png",
+    "folder.png", "excel.png", "executable.png", "font.png", "image.png", "illustrator.png", "indesign.png",
+    "web_data.png", "pdf.png", "photoshop.png", "powerpoint.png", "premiere.png", "raw.png", "spreadsheet.png",
+    "torrent.png", "dmg.png", "text.png", "vector.png", "video.png", "word.png", "openoffice.png", "sketch.png",
+    "experiencedesign.png", "pages.png", "numbers.png", "keynote.png"
+};
+static_assert(sizeof(ICON_NAMES) / sizeof(ICON_NAMES[0]) == static_cast<size_t>(Icon::ICONS_COUNT),
+              "Every icon needs a name");
+
+constexpr Utilities::FileType iconFileType(Icon icon)
+{
+    return (icon == Icon::AUDIO) ? Utilities::FileType::TYPE_AUDIO
+         : (icon == Icon::VIDEO) ? Utilities::FileType::TYPE_VIDEO
+         : (icon == Icon::COMPRESSED || icon == Icon::TORRENT || icon == Icon::DMG
+            || icon == Icon::EXPERIENCE_DESIGN || icon == Icon::SKETCH) ? Utilities::FileType::TYPE_ARCHIVE
+         : (icon == Icon::TEXT || icon == Icon::OPEN_OFFICE || icon == Icon::PDF || icon == Icon::WORD
+            || icon == Icon::POWERPOINT || icon == Icon::PAGES || icon == Icon::NUMBERS || icon == Icon::KEYNOTE
+            || icon == Icon::WEB_DATA || icon == Icon::EXCEL) ? Utilities::FileType::TYPE_DOCUMENT
+         : (icon == Icon::IMAGE || icon == Icon::ILLUSTRATOR || icon == Icon::PHOTOSHOP || icon == Icon::RAW
+            || icon == Icon::VECTOR) ? Utilities::FileType::TYPE_IMAGE
+         : Utilities::FileType::TYPE_OTHER;
+}
+
+struct Extension
+{
+    const char* name;
+    Icon icon;
+};
+
+// Lowercase ASCII only
+constexpr Extension EXTENSIONS[] = {
+    {"3ds", Icon::THREE_D}, {"3dm", Icon::THREE_D}, {"max", Icon::THREE_D}, {"obj", Icon::THREE_D},
+    {"aep", Icon::AFTER_EFFECTS}, {"aet", Icon::AFTER_EFFECTS},
+    {"mp3", Icon::AUDIO}, {"wav", Icon::AUDIO}, {"3ga", Icon::AUDIO}, {"aif", Icon::AUDIO}, {"aiff", Icon::AUDIO},
+    {"flac", Icon::AUDIO}, {"iff", Icon::AUDIO}, {"ogg", Icon::AUDIO}, {"m4a", Icon::AUDIO}, {"wma", Icon::AUDIO},
+    {"dxf", Icon::CAD}, {"dwg", Icon::CAD},
+    {"zip", Icon::COMPRESSED}, {"rar", Icon::COMPRESSED}, {"tgz", Icon::COMPRESSED}, {"gz", Icon::COMPRESSED},
+    {"bz2", Icon::COMPRESSED}, {"tbz", Icon::COMPRESSED}, {"tar", Icon::COMPRESSED}, {"7z", Icon::COMPRESSED},
+    {"sitx", Icon::COMPRESSED},
+    {"sql", Icon::WEB_LANG}, {"accdb", Icon::WEB_LANG}, {"db", Icon::WEB_LANG}, {"dbf", Icon::WEB_LANG},
+    {"mdb", Icon::WEB_LANG}, {"pdb", Icon::WEB_LANG}, {"php", Icon::WEB_LANG}, {"php3", Icon::WEB_LANG},
+    {"php4", Icon::WEB_LANG}, {"php5", Icon::WEB_LANG}, {"phtml", Icon::WEB_LANG}, {"inc", Icon::WEB_LANG},
+    {"asp", Icon::WEB_LANG}, {"pl", Icon::WEB_LANG}, {"cgi", Icon::WEB_LANG}, {"py", Icon::WEB_LANG},
+    {"folder", Icon::FOLDER},
+    {"xls", Icon::EXCEL}, {"xlsx", Icon::EXCEL}, {"xlt", Icon::EXCEL}, {"xltm", Icon::EXCEL},
+    {"exe", Icon::EXECUTABLE}, {"com", Icon::EXECUTABLE}, {"bin", Icon::EXECUTABLE}, {"apk", Icon::EXECUTABLE},
+    {"app", Icon::EXECUTABLE}, {"msi", Icon::EXECUTABLE}, {"cmd", Icon::EXECUTABLE}, {"gadget", Icon::EXECUTABLE},
+    {"fnt", Icon::FONT}, {"otf", Icon::FONT}, {"ttf", Icon::FONT}, {"fon", Icon::FONT},
+    {"gif", Icon::IMAGE}, {"tiff", Icon::IMAGE}, {"bmp", Icon::IMAGE}, {"png", Icon::IMAGE}, {"tga", Icon::IMAGE},
+    {"jpg", Icon::IMAGE}, {"jpeg", Icon::IMAGE}, {"heic", Icon::IMAGE}, {"webp", Icon::IMAGE},
+    {"ai", Icon::ILLUSTRATOR}, {"ait", Icon::ILLUSTRATOR},
+    {"indd", Icon::INDESIGN},
+    {"jar", Icon::WEB_DATA}, {"java", Icon::WEB_DATA}, {"class", Icon::WEB_DATA}, {"html", Icon::WEB_DATA},
+    {"xml", Icon::WEB_DATA}, {"shtml", Icon::WEB_DATA}, {"dhtml", Icon::WEB_DATA}, {"js", Icon::WEB_DATA},
+    {"css", Icon::WEB_DATA},
+    {"pdf", Icon::PDF},
+    {"abr", Icon::PHOTOSHOP}, {"psb", Icon::PHOTOSHOP}, {"psd", Icon::PHOTOSHOP},
+    {"pps", Icon::POWERPOINT}, {"ppt", Icon::POWERPOINT}, {"pptx", Icon::POWERPOINT},
+    {"prproj", Icon::PREMIERE}, {"ppj", Icon::PREMIERE},
+    {"tif", Icon::RAW}, {"3fr", Icon::RAW}, {"arw", Icon::RAW}, {"bay", Icon::RAW}, {"cr2", Icon::RAW},
+    {"dcr", Icon::RAW}, {"dng", Icon::RAW}, {"fff", Icon::RAW}, {"mef", Icon::RAW}, {"mrw", Icon::RAW},
+    {"nef", Icon::RAW}, {"pef", Icon::RAW}, {"rw2", Icon::RAW}, {"srf", Icon::RAW}, {"orf", Icon::RAW},
+    {"rwl", Icon::RAW}, {"ari", Icon::RAW}, {"braw", Icon::RAW}, {"crw", Icon::RAW}, {"cr3", Icon::RAW},
+    {"cap", Icon::RAW}, {"dcs", Icon::RAW}, {"drf", Icon::RAW}, {"eip", Icon::RAW}, {"erf", Icon::RAW},
+    {"gpr", Icon::RAW}, {"iiq", Icon::RAW}, {"k25", Icon::RAW}, {"kdc", Icon::RAW}, {"mdc", Icon::RAW},
+    {"mos", Icon::RAW}, {"nrw", Icon::RAW}, {"obm", Icon::RAW}, {"ptx", Icon::RAW}, {"pxn", Icon::RAW},
+    {"r3d", Icon::RAW}, {"raf", Icon::RAW}, {"raw", Icon::RAW}, {"rwz", Icon::RAW}, {"sr2", Icon::RAW},
+    {"srw", Icon::RAW}, {"x3f", Icon::RAW},
+    {"ots", Icon::SPREADSHEET}, {"gsheet", Icon::SPREADSHEET}, {"nb", Icon::SPREADSHEET}, {"xlr", Icon::SPREADSHEET},
+    {"torrent", Icon::TORRENT},
+    {"dmg", Icon::DMG},
+    {"txt", Icon::TEXT}, {"rtf", Icon::TEXT}, {"ans", Icon::TEXT}, {"ascii", Icon::TEXT}, {"log", Icon::TEXT},
+    {"wpd", Icon::TEXT},
+    {"svgz", Icon::VECTOR}, {"svg", Icon::VECTOR}, {"cdr", Icon::VECTOR}, {"eps", Icon::VECTOR},
+    {"mkv", Icon::VIDEO}, {"webm", Icon::VIDEO}, {"avi", Icon::VIDEO}, {"mp4", Icon::VIDEO}, {"m4v", Icon::VIDEO},
+    {"mpg", Icon::VIDEO}, {"mpeg", Icon::VIDEO}, {"mov", Icon::VIDEO}, {"3g2", Icon::VIDEO}, {"3gp", Icon::VIDEO},
+    {"asf", Icon::VIDEO}, {"wmv", Icon::VIDEO}, {"flv", Icon::VIDEO}, {"vob", Icon::VIDEO},
+    {"doc", Icon::WORD}, {"docx", Icon::WORD}, {"dotx", Icon::WORD}, {"wps", Icon::WORD},
+    {"ods", Icon::OPEN_OFFICE}, {"odt", Icon::OPEN_OFFICE}, {"odp", Icon::OPEN_OFFICE}, {"odb", Icon::OPEN_OFFICE},
+    {"odg", Icon::OPEN_OFFICE},
+    {"sketch", Icon::SKETCH},
+    {"xd", Icon::EXPERIENCE_DESIGN},
+    {"pages", Icon::PAGES},
+    {"numbers", Icon::NUMBERS},
+    {"key", Icon::KEYNOTE}
+};
+
+constexpr int EXTENSIONS_COUNT = sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]);
+constexpr int MAX_EXTENSION_LENGTH = 7;
+constexpr int SLOTS_COUNT = 256;
+constexpr int BUCKETS_COUNT = 64;
+constexpr uint32_t NO_SLOT = 0xFFFF;
+static_assert(EXTENSIONS_COUNT <= SLOTS_COUNT, "Not enough slots for the extensions");
+
+// FNV-1a, seeded with the displacement. Callers lowercase the characters
+constexpr uint32_t hashStep(uint32_t hash, uint32_t character)
+{
+    return (hash ^ character) * 16777619u;
+}
+
+constexpr uint32_t hashFinish(uint32_t hash)
+{
+    return hash ^ (hash >> 15);
+}
+
+constexpr uint32_t hashSeed(uint32_t seed)
+{
+    return 2166136261u ^ (seed * 0x9E3779B9u);
+}
+
+constexpr uint32_t hashAscii(const char* text, uint32_t seed)
+{
+    uint32_t hash = hashSeed(seed);
+    for (int i = 0; text[i]; ++i)
+    {
+        hash = hashStep(hash, static_cast<unsigned char>(text[i]));
+    }
+    return hashFinish(hash);
+}
+
+constexpr int length(const char* text)
+{
+    int size = 0;
+    while (text[size])
+    {
+        ++size;
+    }
+    return size;
+}
+
+struct Table
+{
+    uint16_t displacements[BUCKETS_COUNT] = {};
+    uint16_t slots[SLOTS_COUNT] = {};
+    bool valid = false;
+};
+
+// Buckets are placed from the fullest one, trying displacements until all their extensions land
+// in free slots
+inline Table buildTable()
+{
+    Table table;
+    for (int slot = 0; slot < SLOTS_COUNT; ++slot)
+    {
+        table.slots[slot] = NO_SLOT;
+    }
+
+    int bucketSizes[BUCKETS_COUNT] = {};
+    for (int i = 0; i < EXTENSIONS_COUNT; ++i)
+    {
+        ++bucketSizes[hashAscii(EXTENSIONS[i].name, 0) % BUCKETS_COUNT];
+        if (length(EXTENSIONS[i].name) > MAX_EXTENSION_LENGTH)
+        {
+            return table;
+        }
+    }
+
+    bool placed[BUCKETS_COUNT] = {};
+    for (int round = 0; round < BUCKETS_COUNT; ++round)
+    {
+        int bucket = 0;
+        for (int candidate = 1; candidate < BUCKETS_COUNT; ++candidate)
+        {
+            if (!placed[candidate] && (placed[bucket] || bucketSizes[candidate] > bucketSizes[bucket]))
+            {
+                bucket = candidate;
+            }
+        }
+        placed[bucket] = true;
+        if (!bucketSizes[bucket])
+        {
+            continue;
+        }
+
+        bool found = false;
+        for (uint32_t displacement = 1; displacement < 0xFFFF && !found; ++displacement)
+        {
+            found = true;
+            uint32_t used[EXTENSIONS_COUNT] = {};
+            int usedCount = 0;
+            for (int i = 0; i < EXTENSIONS_COUNT && found; ++i)
+            {
+                if (hashAscii(EXTENSIONS[i].name, 0) % BUCKETS_COUNT != static_cast<uint32_t>(bucket))
+                {
+                    continue;
+                }
+
+                uint32_t slot = hashAscii(EXTENSIONS[i].name, displacement) % SLOTS_COUNT;
+                found = table.slots[slot] == NO_SLOT;
+                for (int j = 0; j < usedCount && found; ++j)
+                {
+                    found = used[j] != slot;
+                }
+                used[usedCount++] = slot;
+            }
+
+            if (found)
+            {
+                table.displacements[bucket] = static_cast<uint16_t>(displacement);
+                for (int i = 0; i < EXTENSIONS_COUNT; ++i)
+                {
+                    if (hashAscii(EXTENSIONS[i].name, 0) % BUCKETS_COUNT == static_cast<uint32_t>(bucket))
+                    {
+                        table.slots[hashAscii(EXTENSIONS[i].name, displacement) % SLOTS_COUNT] = static_cast<uint16_t>(i);
+                    }
+                }
+            }
+        }
+
+        if (!found)
+        {
+            return table;
+        }
+    }
+
+    table.valid = true;
+    return table;
+}
+
+inline const Table& table()
+{
+    static const Table builtTable = buildTable();
+    Q_ASSERT_X(builtTable.valid, "FileExtensionTable", "No perfect hash found, change the table sizes");
+    return builtTable;
+}
+
+// Looks up an extension given as UTF-16 code units, in any case. Returns nullptr if unknown
+template <typename Char>
+const Extension* find(const Char* extension, int size)
+{
+    if (size <= 0 || size > MAX_EXTENSION_LENGTH)
+    {
+        return nullptr;
+    }
+
+    const Table& lookupTable = table();
+    if (!lookupTable.valid)
+    {
+        return nullptr;
+    }
+
+    char lowercase[MAX_EXTENSION_LENGTH];
+    uint32_t bucketHash = hashSeed(0);
+    for (int i = 0; i < size; ++i)
+    {
+        const uint32_t character = static_cast<uint32_t>(extension[i]);
+        if (character >= 0x80)
+        {
+            return nullptr;
+        }
+        lowercase[i] = static_cast<char>((character >= 'A' && character <= 'Z') ? character + ('a' - 'A') : character);
+        bucketHash = hashStep(bucketHash, static_cast<unsigned char>(lowercase[i]));
+    }
+
+    uint32_t slotHash = hashSeed(lookupTable.displacements[hashFinish(bucketHash) % BUCKETS_COUNT]);
+    for (int i = 0; i < size; ++i)
+    {
+        slotHash = hashStep(slotHash, static_cast<unsigned char>(lowercase[i]));
+    }
+
+    const uint16_t index = lookupTable.slots[hashFinish(slotHash) % SLOTS_COUNT];
+    if (index == NO_SLOT)
+    {
+        return nullptr;
+    }
+
+    const Extension& candidate = EXTENSIONS[index];
+    for (int i = 0; i < size; ++i)
+    {
+        if (candidate.name[i] != lowercase[i])
+        {
+            return nullptr;
+        }
+    }
+    return candidate.name[size] ? nullptr : &candidate;
+}
+}
+
+#endif // FILEEXTENSIONTABLE_H
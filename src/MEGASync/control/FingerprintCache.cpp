@@ -0,0 +1,160 @@
+#include "FingerprintCache.h"
+#include "MegaApplication.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace
+{
+const quint32 FILE_MAGIC = 0x4D465043;
+const quint32 FILE_VERSION = 1;
+}
+
+FingerprintCache& FingerprintCache::instance()
+{
+    static FingerprintCache cache;
+    return cache;
+}
+
+FingerprintCache::FingerprintCache()
+    : mUseCounter(0),
+      mLoaded(false),
+      mDirty(false)
+{
+}
+
+QByteArray FingerprintCache::find(const QString& path, qint64 size, qint64 lastModified)
+{
+    QMutexLocker lock(&mMutex);
+    load();
+
+    auto it = mEntries.find(path);
+    if(it == mEntries.end() || it->size != size || it->lastModified != lastModified)
+    {
+        return QByteArray();
+    }
+
+    it->lastUse = ++mUseCounter;
+    return it->fingerprint;
+}
+
+void FingerprintCache::insert(const QString& path, qint64 size, qint64 lastModified, const QByteArray& fingerprint)
+{
+    if(fingerprint.isEmpty())
+    {
+        return;
+    }
+
+    QMutexLocker lock(&mMutex);
+    load();
+
+    mEntries.insert(path, Entry{size, lastModified, fingerprint, ++mUseCounter});
+    mDirty = true;
+
+    if(mEntries.size() > MAX_ENTRIES)
+    {
+        evict();
+    }
+}
+
+void FingerprintCache::save()
+{
+    QMutexLocker lock(&mMutex);
+    if(!mDirty || mFilePath.isEmpty())
+    {
+        return;
+    }
+
+    QSaveFile file(mFilePath);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Fingerprint cache: unable to write %1: %2")
+                           .arg(mFilePath, file.errorString()).toUtf8().constData());
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << FILE_MAGIC << FILE_VERSION << static_cast<quint32>(mEntries.size());
+    for(auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it)
+    {
+        stream << it.key() << it->size << it->lastModified << it->fingerprint << it->lastUse;
+    }
+
+    if(stream.status() == QDataStream::Ok && file.commit())
+    {
+        mDirty = false;
+    }
+}
+
+void FingerprintCache::load()
+{
+    if(mLoaded)
+    {
+        return;
+    }
+    mLoaded = true;
+
+    mFilePath = MegaApplication::applicationDataPath() + QDir::separator() + QString::fromLatin1("fingerprints.dat");
+    QFile file(mFilePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic(0);
+    quint32 version(0);
+    quint32 count(0);
+    stream >> magic >> version >> count;
+    if(magic != FILE_MAGIC || version != FILE_VERSION)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING, "Fingerprint cache: unknown file format, discarded");
+        return;
+    }
+
+    for(quint32 index = 0; index < count && stream.status() == QDataStream::Ok; ++index)
+    {
+        QString path;
+        Entry entry;
+        stream >> path >> entry.size >> entry.lastModified >> entry.fingerprint >> entry.lastUse;
+        if(stream.status() == QDataStream::Ok)
+        {
+            mEntries.insert(path, entry);
+            mUseCounter = std::max(mUseCounter, entry.lastUse);
+        }
+    }
+}
+
+// Drops the least recently used quarter, so the eviction does not run on every insertion
+void FingerprintCache::evict()
+{
+    QVector<quint64> uses;
+    uses.reserve(mEntries.size());
+    foreach(auto& entry, mEntries)
+    {
+        uses.append(entry.lastUse);
+    }
+
+    auto threshold = uses.begin() + uses.size() / 4;
+    std::nth_element(uses.begin(), threshold, uses.end());
+    const quint64 minUse(*threshold);
+
+    for(auto it = mEntries.begin(); it != mEntries.end();)
+    {
+        if(it->lastUse < minUse)
+        {
+            it = mEntries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef FINGERPRINTCACHE_H
+#define FINGERPRINTCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Cache of the SDK fingerprints of the local files
+ *
+ * Remembers the SDK fingerprints of local files by path, size and modification time, so files that did not
+ * change are not read again to compute them.
+ *
+ * Thread safe. The entries are loaded from disk on first use and written back with save(); the least recently
+ * used ones are dropped when there are more than MAX_ENTRIES.
+ */
+class FingerprintCache
+{
+public:
+    static const int MAX_ENTRIES = 20000;
+
+    static FingerprintCache& instance();
+
+    // Empty if the file is not cached or it changed since it was cached
+    QByteArray find(const QString& path, qint64 size, qint64 lastModified);
+    void insert(const QString& path, qint64 size, qint64 lastModified, const QByteArray& fingerprint);
+    void save();
+
+private:
+    struct Entry
+    {
+        qint64 size;
+        qint64 lastModified;
+        QByteArray fingerprint;
+        quint64 lastUse;
+    };
+
+    FingerprintCache();
+
+    void load();
+    void evict();
+
+    QMutex mMutex;
+    QHash<QString, Entry> mEntries;
+    QString mFilePath;
+    quint64 mUseCounter;
+    bool mLoaded;
+    bool mDirty;
+};
+
+#endif // FINGERPRINTCACHE_H
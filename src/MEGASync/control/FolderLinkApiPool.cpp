@@ -0,0 +1,101 @@
+#include "FolderLinkApiPool.h"
+
+#include <algorithm>
+
+FolderLinkApiPool::FolderLinkApiPool(mega::MegaApi* primaryApi, Factory factory, int maxSize)
+    : mFactory(factory),
+      mMaxSize(std::max(1, maxSize)),
+      mDelegateListener(new mega::QTMegaRequestListener(primaryApi, this))
+{
+    mApis.append(primaryApi);
+    mInUse.append(false);
+}
+
+FolderLinkApiPool::~FolderLinkApiPool()
+{
+    //The primary instance belongs to the application
+    for(int index = 1; index < mApis.size(); ++index)
+    {
+        delete mApis.at(index);
+    }
+}
+
+mega::MegaApi* FolderLinkApiPool::acquire()
+{
+    int index = mInUse.indexOf(false);
+    if(index < 0)
+    {
+        if(mApis.size() >= mMaxSize)
+        {
+            return nullptr;
+        }
+
+        auto api = mFactory(mApis.size());
+        if(!api)
+        {
+            return nullptr;
+        }
+
+        foreach(auto setting, mSettings)
+        {
+            setting(api);
+        }
+
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO,
+                           QString::fromUtf8("Folder link API pool: instance %1 created").arg(mApis.size()).toUtf8().constData());
+        index = mApis.size();
+        mApis.append(api);
+        mInUse.append(false);
+    }
+
+    mInUse[index] = true;
+    return mApis.at(index);
+}
+
+void FolderLinkApiPool::release(mega::MegaApi* api)
+{
+    auto index = mApis.indexOf(api);
+    if(index >= 0 && mInUse.at(index))
+    {
+        mInUse[index] = false;
+        emit apiReleased();
+    }
+}
+
+void FolderLinkApiPool::releaseAfterLogout(mega::MegaApi* api)
+{
+    auto index = mApis.indexOf(api);
+    if(index >= 0 && mInUse.at(index))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO,
+                           QString::fromUtf8("Folder link API pool: logging out instance %1 before releasing it").arg(index).toUtf8().constData());
+        api->localLogout(mDelegateListener.get());
+    }
+}
+
+void FolderLinkApiPool::onRequestFinish(mega::MegaApi* api, mega::MegaRequest* request, mega::MegaError*)
+{
+    if(request->getType() == mega::MegaRequest::TYPE_LOGOUT)
+    {
+        release(api);
+    }
+}
+
+int FolderLinkApiPool::maxSize() const
+{
+    return mMaxSize;
+}
+
+void FolderLinkApiPool::applySetting(const QString& key, Action setting)
+{
+    mSettings.insert(key, setting);
+    forEachApi(setting);
+}
+
+void FolderLinkApiPool::forEachApi(Action action)
+{
+    foreach(auto api, mApis)
+    {
+        action(api);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef FOLDERLINKAPIPOOL_H
+#define FOLDERLINKAPIPOOL_H
+
+#include "megaapi.h"
+#include "QTMegaRequestListener.h"
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief Pool of MegaApi instances to resolve folder links
+ *
+ * Lends MegaApi instances to resolve folder links, so several folder links can be logged in at the same time.
+ * The first instance is the application one; the others are created on demand up to the maximum size and kept
+ * until the pool is destroyed. The settings applied to the pool are also applied to the instances created
+ * later.
+ */
+class FolderLinkApiPool : public QObject, public mega::MegaRequestListener
+{
+    Q_OBJECT
+
+public:
+    using Factory = std::function<mega::MegaApi*(int index)>;
+    using Action = std::function<void(mega::MegaApi*)>;
+
+    FolderLinkApiPool(mega::MegaApi* primaryApi, Factory factory, int maxSize);
+    ~FolderLinkApiPool();
+
+    // nullptr if all the instances are in use
+    mega::MegaApi* acquire();
+    void release(mega::MegaApi* api);
+    // For an instance with a request still running: it stays in use until it is logged out, so the
+    // request does not finish while another user holds it
+    void releaseAfterLogout(mega::MegaApi* api);
+    int maxSize() const;
+
+    // Applied to the existing and future instances. A setting replaces the previous one with the same key
+    void applySetting(const QString& key, Action setting);
+    // Only applied to the existing instances
+    void forEachApi(Action action);
+
+    void onRequestFinish(mega::MegaApi* api, mega::MegaRequest* request, mega::MegaError* e) override;
+
+signals:
+    void apiReleased();
+
+private:
+    QVector<mega::MegaApi*> mApis;
+    QVector<bool> mInUse;
+    QMap<QString, Action> mSettings;
+    Factory mFactory;
+    int mMaxSize;
+    std::unique_ptr<mega::QTMegaRequestListener> mDelegateListener;
+};
+
+#endif // FOLDERLINKAPIPOOL_H
@@ -0,0 +1,291 @@
+#include "IconCache.h"
+
+#include "Utilities.h"
+#include "megaapi.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QIconEngine>
+#include <QImageReader>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+#include <QtConcurrent/QtConcurrent>
+
+#include <cmath>
+
+namespace
+{
+const int MAX_RESOURCE_SCALE = 3;
+
+/// Draws the icon with the pixmaps of the shared cache. QIcon asks for pixmaps in device pixels, so
+/// they are requested with a device pixel ratio of 1
+class CachedIconEngine : public QIconEngine
+{
+public:
+    CachedIconEngine(const QString& resource, const QString& disabledResource)
+        : mResource(resource),
+          mDisabledResource(disabledResource)
+    {
+    }
+
+    void paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state) override
+    {
+        const qreal ratio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+        painter->drawPixmap(rect, pixmap(rect.size() * ratio, mode, state));
+    }
+
+    QPixmap pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state) override
+    {
+        const bool disabledResource = mode == QIcon::Disabled && !mDisabledResource.isEmpty();
+        return IconCache::instance().getPixmap(disabledResource ? mDisabledResource : mResource,
+                                               size, 1.0, disabledResource ? QIcon::Normal : mode, state);
+    }
+
+    QSize actualSize(const QSize& size, QIcon::Mode, QIcon::State) override
+    {
+        QSize naturalSize = IconCache::resourceSize(mResource);
+        if (naturalSize.isEmpty())
+        {
+            return QSize();
+        }
+        return (naturalSize.width() > size.width() || naturalSize.height() > size.height())
+                ? naturalSize.scaled(size, Qt::KeepAspectRatio) : naturalSize;
+    }
+
+    QIconEngine* clone() const override
+    {
+        return new CachedIconEngine(mResource, mDisabledResource);
+    }
+
+    QString key() const override
+    {
+        return QLatin1String("IconCache");
+    }
+
+private:
+    QString mResource;
+    QString mDisabledResource;
+};
+
+// "name.png" -> "name@2x.png"
+QString scaledResourceName(const QString& resource, int scale)
+{
+    const int suffixStart = resource.lastIndexOf(QLatin1Char('.'));
+    if (scale <= 1 || suffixStart < 0)
+    {
+        return resource;
+    }
+    return resource.left(suffixStart) + QString::fromLatin1("@%1x").arg(scale) + resource.mid(suffixStart);
+}
+}
+
+bool IconCache::Key::operator==(const IconCache::Key& other) const
+{
+    return resource == other.resource && size == other.size && qFuzzyCompare(devicePixelRatio, other.devicePixelRatio)
+            && mode == other.mode && state == other.state;
+}
+
+uint qHash(const IconCache::Key& key, uint seed)
+{
+    return qHash(key.resource, seed) ^ qHash(key.size.width() << 16 | key.size.height(), seed)
+            ^ qHash(qRound(key.devicePixelRatio * 100), seed) ^ qHash(key.mode << 4 | key.state, seed);
+}
+
+IconCache::IconCache()
+    : mPixmaps(DEFAULT_MAX_BYTES),
+      mHits(0),
+      mMisses(0)
+{
+}
+
+IconCache& IconCache::instance()
+{
+    static IconCache cache;
+    return cache;
+}
+
+QIcon IconCache::getIcon(const QString& resource, const QString& disabledResource)
+{
+    const QString iconKey = disabledResource.isEmpty() ? resource : resource + QLatin1Char('|') + disabledResource;
+    QMutexLocker lock(&mMutex);
+    auto icon = mIcons.constFind(iconKey);
+    if (icon != mIcons.constEnd())
+    {
+        return icon.value();
+    }
+    return mIcons.insert(iconKey, QIcon(new CachedIconEngine(resource, disabledResource))).value();
+}
+
+QPixmap IconCache::getPixmap(const QString& resource, const QSize& size, qreal devicePixelRatio,
+                             QIcon::Mode mode, QIcon::State state)
+{
+    const Key key{resource, size, devicePixelRatio, mode, state};
+    bool logStatsNow(false);
+    {
+        QMutexLocker lock(&mMutex);
+        logStatsNow = (mHits + mMisses + 1) % STATS_LOG_INTERVAL == 0;
+        if (QPixmap* pixmap = mPixmaps.object(key))
+        {
+            ++mHits;
+            QPixmap result(*pixmap);
+            lock.unlock();
+            if (logStatsNow)
+            {
+                logStats();
+            }
+            return result;
+        }
+        ++mMisses;
+    }
+
+    QPixmap pixmap;
+    if (mode == QIcon::Normal || mode == QIcon::Active)
+    {
+        pixmap = QPixmap::fromImage(rasterize(resource, size * devicePixelRatio));
+    }
+    else
+    {
+        // Same look as a QIcon without a pixmap for the mode
+        QPixmap normal = getPixmap(resource, size, devicePixelRatio, QIcon::Normal, state);
+        QStyleOption option;
+        option.palette = QApplication::palette();
+        pixmap = QApplication::style()->generatedIconPixmap(mode, normal, &option);
+    }
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+
+    insert(key, pixmap);
+    if (logStatsNow)
+    {
+        logStats();
+    }
+    return pixmap;
+}
+
+void IconCache::warmUp(const QStringList& resources, const QList<QSize>& sizes, qreal devicePixelRatio)
+{
+    QtConcurrent::run([resources, sizes, devicePixelRatio]()
+    {
+        QList<QPair<Key, QImage>> images;
+        for (const auto& resource : resources)
+        {
+            // An empty size list warms the resources at their natural size
+            const QList<QSize> resourceSizes = sizes.isEmpty() ? QList<QSize>{resourceSize(resource)} : sizes;
+            for (const auto& size : resourceSizes)
+            {
+                // Warmed as QIcon asks for them, in device pixels
+                const QSize pixelSize = size * devicePixelRatio;
+                images.append(qMakePair(Key{resource, pixelSize, 1.0, QIcon::Normal, QIcon::Off},
+                                        rasterize(resource, pixelSize)));
+            }
+        }
+
+        Utilities::queueFunctionInAppThread([images]()
+        {
+            auto& cache = IconCache::instance();
+            for (const auto& image : images)
+            {
+                if (!image.second.isNull())
+                {
+                    cache.insert(image.first, QPixmap::fromImage(image.second));
+                }
+            }
+            cache.logStats();
+        });
+    });
+}
+
+void IconCache::setMaxBytes(int maxBytes)
+{
+    QMutexLocker lock(&mMutex);
+    mPixmaps.setMaxCost(maxBytes);
+}
+
+void IconCache::clear()
+{
+    QMutexLocker lock(&mMutex);
+    mPixmaps.clear();
+}
+
+IconCache::Stats IconCache::getStats()
+{
+    QMutexLocker lock(&mMutex);
+    Stats stats;
+    stats.hits = mHits;
+    stats.misses = mMisses;
+    stats.pixmaps = mPixmaps.count();
+    stats.bytes = mPixmaps.totalCost();
+    return stats;
+}
+
+void IconCache::logStats()
+{
+    const Stats stats = getStats();
+    const quint64 lookups = stats.hits + stats.misses;
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG,
+                       QString::fromUtf8("Icon cache: %1 hits / %2 misses (%3% hit rate), %4 pixmaps, %5 KB")
+                       .arg(stats.hits).arg(stats.misses)
+                       .arg(lookups ? (100 * stats.hits) / lookups : 0)
+                       .arg(stats.pixmaps).arg(stats.bytes / 1024).toUtf8().constData());
+}
+
+QSize IconCache::resourceSize(const QString& resource)
+{
+    static QMutex sizesMutex;
+    static QHash<QString, QSize> sizes;
+
+    QMutexLocker lock(&sizesMutex);
+    auto size = sizes.constFind(resource);
+    if (size != sizes.constEnd())
+    {
+        return size.value();
+    }
+    return sizes.insert(resource, QImageReader(resource).size()).value();
+}
+
+// Picks the @Nx variant closest to the requested size and scales it down if needed. Vector images
+// are rendered at the requested size, bitmaps are never scaled up
+QImage IconCache::rasterize(const QString& resource, const QSize& pixelSize)
+{
+    const QSize naturalSize = resourceSize(resource);
+    if (naturalSize.isEmpty() || pixelSize.isEmpty())
+    {
+        return QImage();
+    }
+
+    const bool vector = QFileInfo(resource).suffix().compare(QLatin1String("svg"), Qt::CaseInsensitive) == 0;
+    QImageReader reader;
+    if (vector)
+    {
+        reader.setFileName(resource);
+        reader.setScaledSize(naturalSize.scaled(pixelSize, Qt::KeepAspectRatio));
+    }
+    else
+    {
+        int scale = qBound(1, static_cast<int>(std::ceil(static_cast<double>(pixelSize.width()) / naturalSize.width())),
+                           MAX_RESOURCE_SCALE);
+        while (scale > 1 && !QFileInfo::exists(scaledResourceName(resource, scale)))
+        {
+            --scale;
+        }
+        reader.setFileName(scaledResourceName(resource, scale));
+    }
+
+    QImage image = reader.read();
+    if (!vector && (image.width() > pixelSize.width() || image.height() > pixelSize.height()))
+    {
+        image = image.scaled(pixelSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+int IconCache::pixmapBytes(const QPixmap& pixmap)
+{
+    return qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8);
+}
+
+void IconCache::insert(const IconCache::Key& key, const QPixmap& pixmap)
+{
+    QMutexLocker lock(&mMutex);
+    mPixmaps.insert(key, new QPixmap(pixmap), pixmapBytes(pixmap));
+}
@@ -0,0 +1,83 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QMutex>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Single cache for the icons and pixmaps loaded from resources by all the views
+ *
+ * Icons returned by getIcon share one QIconEngine, which takes every pixmap from a size-bounded LRU cache
+ * keyed by (resource, size, device pixel ratio, mode, state). Icons drawn at several DPRs or sizes are
+ * rasterized once per combination, whatever the number of views or widgets using them. Images can be
+ * rasterized off the GUI thread during startup with warmUp.
+ */
+class IconCache
+{
+public:
+    struct Stats
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int pixmaps = 0;
+        int bytes = 0;
+    };
+
+    static const int DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+    // A stats line is written to the debug log each time this number of lookups is reached
+    static const int STATS_LOG_INTERVAL = 5000;
+
+    static IconCache& instance();
+
+    // Icon drawn from resource. disabledResource replaces the generated disabled look if given
+    QIcon getIcon(const QString& resource, const QString& disabledResource = QString());
+
+    // size is in device independent pixels. The returned pixmap has devicePixelRatio set
+    QPixmap getPixmap(const QString& resource, const QSize& size, qreal devicePixelRatio,
+                      QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off);
+
+    // Rasterizes the resources in a worker thread. Pixmaps are created in the GUI thread when ready
+    void warmUp(const QStringList& resources, const QList<QSize>& sizes, qreal devicePixelRatio);
+
+    void setMaxBytes(int maxBytes);
+    void clear();
+    Stats getStats();
+    void logStats();
+
+    // Natural size of the resource in device independent pixels
+    static QSize resourceSize(const QString& resource);
+
+private:
+    struct Key
+    {
+        QString resource;
+        QSize size;
+        qreal devicePixelRatio;
+        int mode;
+        int state;
+
+        bool operator==(const Key& other) const;
+    };
+    friend uint qHash(const Key& key, uint seed);
+
+    IconCache();
+
+    static QImage rasterize(const QString& resource, const QSize& pixelSize);
+    static int pixmapBytes(const QPixmap& pixmap);
+    void insert(const Key& key, const QPixmap& pixmap);
+
+    QMutex mMutex;
+    QCache<Key, QPixmap> mPixmaps;
+    QHash<QString, QIcon> mIcons;
+    quint64 mHits;
+    quint64 mMisses;
+};
+
+#endif // ICONCACHE_H
@@ -2,37 +2,66 @@
 #include "Utilities.h"
 #include "Preferences.h"
 #include "MegaApplication.h"
+#include "FolderLinkApiPool.h"
 #include <QDir>
 #include <QDateTime>
 #include <QApplication>
+#include <QPair>
+#include <QSet>
 
 using namespace mega;
 
-LinkProcessor::LinkProcessor(QStringList linkList, MegaApi *megaApi, MegaApi *megaApiFolders)
-    : mParentHandler(nullptr),
-      mRequestCounter(0)
+namespace
+{
+// Requests in flight while resolving links, folder links included
+const int MAX_LINK_REQUESTS_IN_FLIGHT = 16;
+}
+
+LinkProcessor::LinkProcessor(QStringList linkList, MegaApi *megaApi, FolderLinkApiPool *folderLinkApiPool)
+    : mFolderLinkApiPool(folderLinkApiPool),
+      mParentHandler(nullptr),
+      mRequestCounter(0),
+      mLinkRequestsInFlight(0)
 {
     this->megaApi = megaApi;
-    this->megaApiFolders = megaApiFolders;
     this->linkList = linkList;
     for (int i = 0; i < linkList.size(); i++)
     {
         linkSelected.append(false);
         mLinkNode.append(nullptr);
         linkError.append(MegaError::API_ENOENT);
+        mLinkResolved.append(false);
     }
 
     importParentFolder = mega::INVALID_HANDLE;
-    currentIndex = 0;
+    mNextLinkToRequest = 0;
+    mResolvedLinks = 0;
     remainingNodes = 0;
     importSuccess = 0;
     importFailed = 0;
 
     delegateListener = new QTMegaRequestListener(megaApi, this);
+
+    if (mFolderLinkApiPool)
+    {
+        //Other processors may be holding the instances
+        connect(mFolderLinkApiPool, &FolderLinkApiPool::apiReleased, this, &LinkProcessor::requestPendingLinks);
+    }
 }
 
 LinkProcessor::~LinkProcessor()
 {
+    //Only the instances whose login or fetchNodes is still running are left
+    foreach (auto api, mFolderLinkByApi.keys())
+    {
+        api->removeRequestListener(delegateListener);
+        mFolderLinkByApi.remove(api);
+        if (mFolderLinkApiPool)
+        {
+            mFolderLinkApiPool->releaseAfterLogout(api);
+        }
+    }
+
     delete delegateListener;
 }
 
@@ -51,6 +80,11 @@ int LinkProcessor::getError(int id)
     return linkError[id];
 }
 
+bool LinkProcessor::isResolved(int id) const
+{
+    return mLinkResolved.at(id);
+}
+
 std::shared_ptr<MegaNode> LinkProcessor::getNode(int id)
 {
     return mLinkNode[id];
@@ -61,29 +95,22 @@ int LinkProcessor::size() const
     return linkList.size();
 }
 
-void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e)
+void LinkProcessor::onRequestFinish(MegaApi* api, MegaRequest* request, MegaError* e)
 {
     if (request->getType() == MegaRequest::TYPE_GET_PUBLIC_NODE)
     {
-        if (e->getErrorCode() != MegaError::API_OK)
+        const QString link(QString::fromUtf8(request->getLink()));
+        auto id = mFileLinksInFlight.value(link, -1);
+        if (id >= 0)
         {
-            mLinkNode[currentIndex].reset();
-        }
-        else
-        {
-            mLinkNode[currentIndex] = std::shared_ptr<mega::MegaNode>(request->getPublicMegaNode());
-        }
+            mFileLinksInFlight.remove(link, id);
 
-        linkError[currentIndex] = e->getErrorCode();
-        currentIndex++;
-        emit onLinkInfoAvailable(currentIndex-1);
-        if (currentIndex == linkList.size())
-        {
-            emit onLinkInfoRequestFinish();
-        }
-        else
-        {
-            requestLinkInfo();
+            std::shared_ptr<mega::MegaNode> node;
+            if (e->getErrorCode() == MegaError::API_OK)
+            {
+                node.reset(request->getPublicMegaNode());
+            }
+            onLinkResolved(id, node, e->getErrorCode());
         }
     }
     else if (request->getType() == MegaRequest::TYPE_CREATE_FOLDER)
@@ -110,83 +137,69 @@ void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e
     }
     else if (request->getType() == MegaRequest::TYPE_LOGIN)
     {
-        if (e->getErrorCode() == MegaError::API_OK)
-        {
-            mRequestCounter++;
-            megaApiFolders->fetchNodes(this);
-        }
-        else
+        auto id = mFolderLinkByApi.value(api, -1);
+        if (id >= 0)
         {
-            mLinkNode[currentIndex].reset();
-            linkError[currentIndex] = e->getErrorCode();
-            currentIndex++;
-            emit onLinkInfoAvailable(currentIndex - 1);
-            if (currentIndex == linkList.size())
+            if (e->getErrorCode() == MegaError::API_OK)
             {
-                emit onLinkInfoRequestFinish();
+                mRequestCounter++;
+                api->fetchNodes(delegateListener);
             }
             else
             {
-                requestLinkInfo();
+                releaseFolderApi(api);
+                onLinkResolved(id, nullptr, e->getErrorCode());
             }
         }
     }
     else if (request->getType() == MegaRequest::TYPE_FETCH_NODES)
     {
-        if (e->getErrorCode() == MegaError::API_OK)
+        auto id = mFolderLinkByApi.value(api, -1);
+        if (id >= 0)
         {
-            std::unique_ptr<MegaNode> rootNode(nullptr);
-            QString currentStr = linkList[currentIndex];
-            QString splitSeparator;
-
-            if (currentStr.count(QChar::fromAscii('!')) == 3)
-            {
-                splitSeparator = QString::fromUtf8("!");
-            }
-            else if (currentStr.count(QChar::fromAscii('!')) == 2
-                     && currentStr.count(QChar::fromAscii('?')) == 1)
-            {
-                splitSeparator = QString::fromUtf8("?");
-            }
-            else if (currentStr.count(QString::fromUtf8("/folder/")) == 2)
-            {
-                splitSeparator = QString::fromUtf8("/folder/");
-            }
-            else if (currentStr.count(QString::fromUtf8("/folder/")) == 1
-                     && currentStr.count(QString::fromUtf8("/file/")) == 1)
+            std::shared_ptr<mega::MegaNode> linkNode;
+            if (e->getErrorCode() == MegaError::API_OK)
             {
-                splitSeparator = QString::fromUtf8("/file/");
-            }
+                std::unique_ptr<MegaNode> rootNode(nullptr);
+                QString currentStr = linkList[id];
+                QString splitSeparator;
 
-            if (splitSeparator.isEmpty())
-            {
-                rootNode.reset(megaApiFolders->getRootNode());
-            }
-            else
-            {
-                QStringList linkparts = currentStr.split(splitSeparator, QString::KeepEmptyParts);
-                MegaHandle handle = MegaApi::base64ToHandle(linkparts.last().toUtf8().constData());
-                rootNode.reset(megaApiFolders->getNodeByHandle(handle));
-            }
+                if (currentStr.count(QChar::fromAscii('!')) == 3)
+                {
+                    splitSeparator = QString::fromUtf8("!");
+                }
+                else if (currentStr.count(QChar::fromAscii('!')) == 2
+                         && currentStr.count(QChar::fromAscii('?')) == 1)
+                {
+                    splitSeparator = QString::fromUtf8("?");
+                }
+                else if (currentStr.count(QString::fromUtf8("/folder/")) == 2)
+                {
+                    splitSeparator = QString::fromUtf8("/folder/");
+                }
+                else if (currentStr.count(QString::fromUtf8("/folder/")) == 1
+                         && currentStr.count(QString::fromUtf8("/file/")) == 1)
+                {
+                    splitSeparator = QString::fromUtf8("/file/");
+                }
 
-            Preferences::instance()->setLastPublicHandle(request->getNodeHandle(), MegaApi::AFFILIATE_TYPE_FILE_FOLDER);
-            mLinkNode[currentIndex] = std::shared_ptr<mega::MegaNode>(megaApiFolders->authorizeNode(rootNode.get()));
-        }
-        else
-        {
-            mLinkNode[currentIndex].reset();
-        }
+                if (splitSeparator.isEmpty())
+                {
+                    rootNode.reset(api->getRootNode());
+                }
+                else
+                {
+                    QStringList linkparts = currentStr.split(splitSeparator, QString::KeepEmptyParts);
+                    MegaHandle handle = MegaApi::base64ToHandle(linkparts.last().toUtf8().constData());
+                    rootNode.reset(api->getNodeByHandle(handle));
+                }
 
-        linkError[currentIndex] = e->getErrorCode();
-        currentIndex++;
-        emit onLinkInfoAvailable(currentIndex-1);
-        if (currentIndex == linkList.size())
-        {
-            emit onLinkInfoRequestFinish();
-        }
-        else
-        {
-            requestLinkInfo();
+                Preferences::instance()->setLastPublicHandle(request->getNodeHandle(), MegaApi::AFFILIATE_TYPE_FILE_FOLDER);
+                linkNode.reset(api->authorizeNode(rootNode.get()));
+            }
+
+            releaseFolderApi(api);
+            onLinkResolved(id, linkNode, e->getErrorCode());
         }
     }
 
@@ -200,28 +213,95 @@ void LinkProcessor::onRequestFinish(MegaApi*, MegaRequest* request, MegaError* e
 
 void LinkProcessor::requestLinkInfo()
 {
-    if (currentIndex < 0 || currentIndex >= linkList.size())
+    requestPendingLinks();
+}
+
+void LinkProcessor::requestPendingLinks()
+{
+    //Folder links that were waiting for an API instance go first, so they keep their turn
+    while (!mPendingFolderLinks.isEmpty() && mLinkRequestsInFlight < MAX_LINK_REQUESTS_IN_FLIGHT)
     {
-        return;
+        if (!requestFolderLink(mPendingFolderLinks.head()))
+        {
+            break;
+        }
+        mPendingFolderLinks.dequeue();
     }
 
-    QString link = linkList[currentIndex];
-    if (link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/#F!"))
-            || link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/folder/")))
+    while (mNextLinkToRequest < linkList.size() && mLinkRequestsInFlight < MAX_LINK_REQUESTS_IN_FLIGHT)
     {
-        std::unique_ptr<char []> authToken(megaApi->getAccountAuth());
-        if (authToken)
+        const int id(mNextLinkToRequest++);
+        const QString& link = linkList.at(id);
+        if (isFolderLink(link))
         {
-            megaApiFolders->setAccountAuth(authToken.get());
+            //File links behind it do not need to wait for an API instance
+            if (!mPendingFolderLinks.isEmpty() || !requestFolderLink(id))
+            {
+                mPendingFolderLinks.enqueue(id);
+            }
         }
+        else
+        {
+            mLinkRequestsInFlight++;
+            mRequestCounter++;
+            mFileLinksInFlight.insert(link, id);
+            megaApi->getPublicNode(link.toUtf8().constData(), delegateListener);
+        }
+    }
+}
 
-        mRequestCounter++;
-        megaApiFolders->loginToFolder(link.toUtf8().constData(), delegateListener);
+bool LinkProcessor::isFolderLink(const QString& link) const
+{
+    return link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/#F!"))
+            || link.startsWith(Preferences::BASE_URL + QString::fromUtf8("/folder/"));
+}
+
+bool LinkProcessor::requestFolderLink(int id)
+{
+    auto api = mFolderLinkApiPool ? mFolderLinkApiPool->acquire() : nullptr;
+    if (!api)
+    {
+        return false;
+    }
+
+    std::unique_ptr<char []> authToken(megaApi->getAccountAuth());
+    if (authToken)
+    {
+        api->setAccountAuth(authToken.get());
+    }
+
+    mFolderLinkByApi.insert(api, id);
+    mLinkRequestsInFlight++;
+    mRequestCounter++;
+    api->loginToFolder(linkList.at(id).toUtf8().constData(), delegateListener);
+    return true;
+}
+
+void LinkProcessor::onLinkResolved(int id, std::shared_ptr<MegaNode> node, int error)
+{
+    mLinkNode[id] = node;
+    linkError[id] = error;
+    mLinkResolved[id] = true;
+    mResolvedLinks++;
+    mLinkRequestsInFlight--;
+
+    emit onLinkInfoAvailable(id);
+    if (mResolvedLinks == linkList.size())
+    {
+        emit onLinkInfoRequestFinish();
     }
     else
     {
-        mRequestCounter++;
-        megaApi->getPublicNode(link.toUtf8().constData(), delegateListener);
+        requestPendingLinks();
+    }
+}
+
+void LinkProcessor::releaseFolderApi(MegaApi* api)
+{
+    mFolderLinkByApi.remove(api);
+    if (mFolderLinkApiPool)
+    {
+        mFolderLinkApiPool->release(api);
     }
 }
 
@@ -256,6 +336,15 @@ void LinkProcessor::importLinks(MegaNode* node)
     std::unique_ptr<MegaNodeList> children(megaApi->getChildren(node));
     importParentFolder = node->getHandle();
 
+    //Children of the target by name and size, to skip the links already imported
+    QSet<QPair<QString, long long>> existingChildren;
+    existingChildren.reserve(children->size());
+    for (int j = 0; j < children->size(); j++)
+    {
+        MegaNode *child = children->get(j);
+        existingChildren.insert(qMakePair(QString::fromUtf8(child->getName()), child->getSize()));
+    }
+
     for (int i = 0; i < linkList.size(); i++)
     {
         if (!mLinkNode[i])
@@ -265,22 +354,8 @@ void LinkProcessor::importLinks(MegaNode* node)
 
         if (mLinkNode[i] && linkSelected[i] && !linkError[i])
         {
-            bool dupplicate = false;
-            MegaHandle duplicateHandle = INVALID_HANDLE;
-            const char* name = mLinkNode[i]->getName();
-            long long size = mLinkNode[i]->getSize();
-
-            for (int j = 0; j < children->size(); j++)
-            {
-                MegaNode *child = children->get(j);
-                if (!strcmp(name, child->getName()) && (size == child->getSize()))
-                {
-                    dupplicate = true;
-                    duplicateHandle = child->getHandle();
-                }
-            }
-
-            if (!dupplicate)
+            const auto key = qMakePair(QString::fromUtf8(mLinkNode[i]->getName()), mLinkNode[i]->getSize());
+            if (!existingChildren.contains(key))
             {
                 remainingNodes++;
                 mRequestCounter++;
@@ -326,11 +401,6 @@ int LinkProcessor::numFailedImports()
     return importFailed;
 }
 
-int LinkProcessor::getCurrentIndex()
-{
-    return currentIndex;
-}
-
 bool LinkProcessor::atLeastOneLinkValidAndSelected() const
 {
     for (int iLink = 0; iLink < size(); iLink++)
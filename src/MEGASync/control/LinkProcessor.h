@@ -1,7 +1,9 @@
 #ifndef LINKPROCESSOR_H
 #define LINKPROCESSOR_H
 
+#include <QHash>
 #include <QObject>
+#include <QQueue>
 #include <QStringList>
 #include <QPointer>
 
@@ -10,17 +12,26 @@
 #include "megaapi.h"
 #include "QTMegaRequestListener.h"
 
+class FolderLinkApiPool;
+
+/**
+ * @brief Resolves, imports and downloads a list of public links
+ *
+ * The links are resolved in a pipeline with a bounded number of requests in flight; folder links take an
+ * instance from the FolderLinkApiPool, so several of them are logged in at the same time.
+ */
 class LinkProcessor: public QObject, public mega::MegaRequestListener
 {
     Q_OBJECT
 
 public:
-    LinkProcessor(QStringList linkList, mega::MegaApi *megaApi, mega::MegaApi *megaApiFolders);
+    LinkProcessor(QStringList linkList, mega::MegaApi *megaApi, FolderLinkApiPool *folderLinkApiPool);
     virtual ~LinkProcessor();
 
     QString getLink(int id);
     bool isSelected(int id);
     int getError(int id);
+    bool isResolved(int id) const;
     std::shared_ptr<mega::MegaNode> getNode(int id);
     int size() const;
 
@@ -34,7 +45,6 @@ public:
 
     int numSuccessfullImports();
     int numFailedImports();
-    int getCurrentIndex();
 
     bool atLeastOneLinkValidAndSelected() const;
 
@@ -42,12 +52,14 @@ public:
 
 protected:
     mega::MegaApi *megaApi;
-    mega::MegaApi *megaApiFolders;
+    QPointer<FolderLinkApiPool> mFolderLinkApiPool;
     QStringList linkList;
     QList<bool> linkSelected;
     QList<std::shared_ptr<mega::MegaNode>> mLinkNode;
     QList<int> linkError;
-    int currentIndex;
+    QList<bool> mLinkResolved;
+    int mNextLinkToRequest;
+    int mResolvedLinks;
     int remainingNodes;
     int importSuccess;
     int importFailed;
@@ -63,11 +75,26 @@ signals:
 public slots:
     virtual void onRequestFinish(mega::MegaApi* api, mega::MegaRequest *request, mega::MegaError* e);
 
+private slots:
+    void requestPendingLinks();
+
 private:
     void startDownload(mega::MegaNode* linkNode, const QString& localPath);
+    bool isFolderLink(const QString& link) const;
+    bool requestFolderLink(int id);
+    void onLinkResolved(int id, std::shared_ptr<mega::MegaNode> node, int error);
+    void releaseFolderApi(mega::MegaApi* api);
 
     QPointer<QObject> mParentHandler;
     uint32_t mRequestCounter;
+
+    int mLinkRequestsInFlight;
+    //Folder links waiting for a free API instance
+    QQueue<int> mPendingFolderLinks;
+    //Link being resolved by each folder API instance
+    QHash<mega::MegaApi*, int> mFolderLinkByApi;
+    //Links being resolved with getPublicNode; the same link can be pasted more than once
+    QMultiHash<QString, int> mFileLinksInFlight;
 };
 
 #endif // LINKPROCESSOR_H
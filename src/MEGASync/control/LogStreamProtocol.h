@@ -0,0 +1,209 @@
+#ifndef LOGSTREAMPROTOCOL_H
+#define LOGSTREAMPROTOCOL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/// Framing of the live log stream sent by MEGAsync to the MEGAlogger viewer over a local socket.
+///
+/// The stream starts with HANDSHAKE followed by frames. Every frame is a little endian uint32 with the size
+/// of the rest of the frame, a uint8 type and the body:
+///  - FRAME_LOG: uint64 timestamp (microseconds since the epoch), uint8 log level, uint16 thread name size,
+///    thread name, and the message up to the end of the frame.
+///  - FRAME_DROPPED: uint64 number of records dropped by the sender since the previous FRAME_DROPPED.
+/// Shared by both sides, so it only depends on the standard library.
+namespace LogStream
+{
+constexpr const char* SERVER_NAME = "MEGA_LOGGER";
+constexpr const char HANDSHAKE[] = {'M', 'L', 'O', 'G', 1};
+constexpr size_t HANDSHAKE_SIZE = sizeof(HANDSHAKE);
+
+// Larger frames are treated as a corrupt stream
+constexpr uint32_t MAX_FRAME_SIZE = 1024 * 1024;
+
+enum FrameType : uint8_t
+{
+    FRAME_LOG = 1,
+    FRAME_DROPPED = 2
+};
+
+struct Record
+{
+    uint64_t timestampUs = 0;
+    uint8_t level = 0;
+    std::string thread;
+    std::string message;
+};
+
+namespace Detail
+{
+inline void appendInt(std::string& out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline uint64_t readInt(const char* data, size_t bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+}
+
+inline void appendLogFrame(std::string& out, const Record& record)
+{
+    const size_t threadSize = std::min<size_t>(record.thread.size(), UINT16_MAX);
+    const size_t headerSize = 1 + 8 + 1 + 2 + threadSize;
+    const size_t messageSize = std::min<size_t>(record.message.size(), MAX_FRAME_SIZE - headerSize);
+
+    Detail::appendInt(out, headerSize + messageSize, 4);
+    out.push_back(static_cast<char>(FRAME_LOG));
+    Detail::appendInt(out, record.timestampUs, 8);
+    out.push_back(static_cast<char>(record.level));
+    Detail::appendInt(out, threadSize, 2);
+    out.append(record.thread, 0, threadSize);
+    out.append(record.message, 0, messageSize);
+}
+
+inline void appendDroppedFrame(std::string& out, uint64_t count)
+{
+    Detail::appendInt(out, 1 + 8, 4);
+    out.push_back(static_cast<char>(FRAME_DROPPED));
+    Detail::appendInt(out, count, 8);
+}
+
+/// Splits the received bytes into frames. The data can be fed in chunks of any size
+class FrameParser
+{
+public:
+    enum Result
+    {
+        NEED_MORE_DATA,
+        LOG_RECORD,
+        DROPPED_RECORDS,
+        PROTOCOL_ERROR
+    };
+
+    void feed(const char* data, size_t size)
+    {
+        // Compacts the consumed part now and then, instead of on every frame
+        if (mOffset > 0 && mOffset * 2 > mBuffer.size())
+        {
+            mBuffer.erase(0, mOffset);
+            mOffset = 0;
+        }
+        mBuffer.append(data, size);
+    }
+
+    // Fills record or dropped depending on the result
+    Result next(Record& record, uint64_t& dropped)
+    {
+        if (mError)
+        {
+            return PROTOCOL_ERROR;
+        }
+
+        if (!mHandshakeDone)
+        {
+            if (available() < HANDSHAKE_SIZE)
+            {
+                return NEED_MORE_DATA;
+            }
+            if (memcmp(mBuffer.data() + mOffset, HANDSHAKE, HANDSHAKE_SIZE))
+            {
+                return fail();
+            }
+            mOffset += HANDSHAKE_SIZE;
+            mHandshakeDone = true;
+        }
+
+        if (available() < 4)
+        {
+            return NEED_MORE_DATA;
+        }
+
+        const char* frame = mBuffer.data() + mOffset;
+        const uint64_t size = Detail::readInt(frame, 4);
+        if (size < 1 || size > MAX_FRAME_SIZE)
+        {
+            return fail();
+        }
+        if (available() < 4 + size)
+        {
+            return NEED_MORE_DATA;
+        }
+
+        const char* body = frame + 4;
+        Result result = PROTOCOL_ERROR;
+        switch (static_cast<uint8_t>(body[0]))
+        {
+        case FRAME_LOG:
+        {
+            if (size < 12)
+            {
+                return fail();
+            }
+            const uint64_t threadSize = Detail::readInt(body + 10, 2);
+            if (12 + threadSize > size)
+            {
+                return fail();
+            }
+            record.timestampUs = Detail::readInt(body + 1, 8);
+            record.level = static_cast<uint8_t>(body[9]);
+            record.thread.assign(body + 12, threadSize);
+            record.message.assign(body + 12 + threadSize, size - 12 - threadSize);
+            result = LOG_RECORD;
+            break;
+        }
+        case FRAME_DROPPED:
+            if (size != 9)
+            {
+                return fail();
+            }
+            dropped = Detail::readInt(body + 1, 8);
+            result = DROPPED_RECORDS;
+            break;
+        default:
+            return fail();
+        }
+
+        mOffset += 4 + size;
+        return result;
+    }
+
+    void reset()
+    {
+        mBuffer.clear();
+        mOffset = 0;
+        mHandshakeDone = false;
+        mError = false;
+    }
+
+private:
+    size_t available() const
+    {
+        return mBuffer.size() - mOffset;
+    }
+
+    Result fail()
+    {
+        mError = true;
+        return PROTOCOL_ERROR;
+    }
+
+    std::string mBuffer;
+    size_t mOffset = 0;
+    bool mHandshakeDone = false;
+    bool mError = false;
+};
+}
+
+#endif // LOGSTREAMPROTOCOL_H
@@ -0,0 +1,133 @@
+#include "LogStreamer.h"
+
+LogStreamer::LogStreamer()
+    : QObject(nullptr),
+      mThread(new QThread()),
+      mReconnectTimer(new QTimer(this)),
+      mSocket(new QLocalSocket(this)),
+      mConnected(false),
+      mPendingBytes(0),
+      mDroppedRecords(0)
+{
+    mReconnectTimer->setInterval(RECONNECT_INTERVAL_MS);
+    connect(mReconnectTimer, &QTimer::timeout, this, &LogStreamer::tryConnect);
+    connect(mSocket, &QLocalSocket::connected, this, &LogStreamer::onConnected);
+    connect(mSocket, &QLocalSocket::disconnected, this, &LogStreamer::onDisconnected);
+    connect(mSocket, &QLocalSocket::bytesWritten, this, &LogStreamer::updatePendingBytes);
+    connect(mThread, &QThread::started, this, &LogStreamer::tryConnect);
+    connect(mThread, &QThread::started, mReconnectTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(mThread, &QThread::finished, mReconnectTimer, &QTimer::stop, Qt::DirectConnection);
+
+    moveToThread(mThread);
+    mThread->start();
+}
+
+LogStreamer::~LogStreamer()
+{
+    mThread->quit();
+    mThread->wait();
+    delete mThread;
+}
+
+bool LogStreamer::isConnected() const
+{
+    return mConnected;
+}
+
+void LogStreamer::post(const std::vector<LogStream::Record>& records, uint64_t droppedRecords)
+{
+    mDroppedRecords += droppedRecords;
+    if (!mConnected)
+    {
+        mDroppedRecords = 0;
+        return;
+    }
+
+    std::string frames;
+    const qint64 budget = MAX_PENDING_BYTES - mPendingBytes;
+    size_t sent = 0;
+    for (; sent < records.size(); ++sent)
+    {
+        const size_t before = frames.size();
+        LogStream::appendLogFrame(frames, records[sent]);
+        if (static_cast<qint64>(frames.size()) > budget)
+        {
+            // Once full, the rest of the batch is dropped too, so the gap is reported in the right place
+            frames.resize(before);
+            break;
+        }
+    }
+
+    std::string dropped;
+    if (mDroppedRecords && sent)
+    {
+        LogStream::appendDroppedFrame(dropped, mDroppedRecords);
+        mDroppedRecords = 0;
+    }
+    mDroppedRecords += records.size() - sent;
+
+    if (frames.empty())
+    {
+        return;
+    }
+
+    bool wasEmpty;
+    {
+        QMutexLocker lock(&mOutgoingMutex);
+        wasEmpty = mOutgoing.empty();
+        mOutgoing.append(dropped).append(frames);
+    }
+    mPendingBytes += static_cast<qint64>(dropped.size() + frames.size());
+
+    if (wasEmpty)
+    {
+        QMetaObject::invokeMethod(this, "writePending", Qt::QueuedConnection);
+    }
+}
+
+void LogStreamer::tryConnect()
+{
+    if (mSocket->state() == QLocalSocket::UnconnectedState)
+    {
+        mSocket->connectToServer(QString::fromUtf8(LogStream::SERVER_NAME));
+    }
+}
+
+void LogStreamer::onConnected()
+{
+    mReconnectTimer->stop();
+    mSocket->write(LogStream::HANDSHAKE, LogStream::HANDSHAKE_SIZE);
+    mConnected = true;
+}
+
+void LogStreamer::onDisconnected()
+{
+    mConnected = false;
+    {
+        QMutexLocker lock(&mOutgoingMutex);
+        mOutgoing.clear();
+    }
+    mPendingBytes = 0;
+    mReconnectTimer->start();
+}
+
+void LogStreamer::writePending()
+{
+    std::string outgoing;
+    {
+        QMutexLocker lock(&mOutgoingMutex);
+        outgoing.swap(mOutgoing);
+    }
+
+    if (mSocket->state() == QLocalSocket::ConnectedState && !outgoing.empty())
+    {
+        mSocket->write(outgoing.data(), static_cast<qint64>(outgoing.size()));
+    }
+    updatePendingBytes();
+}
+
+void LogStreamer::updatePendingBytes()
+{
+    QMutexLocker lock(&mOutgoingMutex);
+    mPendingBytes = mSocket->bytesToWrite() + static_cast<qint64>(mOutgoing.size());
+}
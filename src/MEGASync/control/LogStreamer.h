@@ -0,0 +1,62 @@
+#ifndef LOGSTREAMER_H
+#define LOGSTREAMER_H
+
+#include "LogStreamProtocol.h"
+
+#include <QLocalSocket>
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streams the log records to the MEGAlogger viewer while it is listening
+ *
+ * The logging thread encodes the records and posts them; the socket is handled in a thread of its own, so the
+ * logging never waits for the viewer. When the viewer does not keep up and MAX_PENDING_BYTES are waiting to
+ * be sent, new records are dropped and counted, and the count is sent before the next records.
+ */
+class LogStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const qint64 MAX_PENDING_BYTES = 4 * 1024 * 1024;
+    static const int RECONNECT_INTERVAL_MS = 2000;
+
+    LogStreamer();
+    ~LogStreamer();
+
+    // Records are only worth collecting while connected
+    bool isConnected() const;
+
+    // Called from the logging thread. droppedRecords were dropped before reaching the streamer
+    void post(const std::vector<LogStream::Record>& records, uint64_t droppedRecords);
+
+private slots:
+    void tryConnect();
+    void onConnected();
+    void onDisconnected();
+    void writePending();
+    void updatePendingBytes();
+
+private:
+    QThread* mThread;
+    QTimer* mReconnectTimer;
+    QLocalSocket* mSocket;
+    std::atomic<bool> mConnected;
+    std::atomic<qint64> mPendingBytes;
+
+    QMutex mOutgoingMutex;
+    std::string mOutgoing;
+
+    // Only used from the logging thread
+    uint64_t mDroppedRecords;
+};
+
+#endif // LOGSTREAMER_H
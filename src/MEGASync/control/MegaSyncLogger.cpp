@@ -1,4 +1,5 @@
 ﻿#include "MegaSyncLogger.h"
+#include "LogStreamer.h"
 #include "Utilities.h"
 
 #include <fstream>
@@ -30,6 +31,7 @@
 //#define MEGA_LOGGER QString::fromUtf8("MEGA_LOGGER")
 //#define ENABLE_MEGASYNC_LOGS QString::fromUtf8("MEGA_ENABLE_LOGS")
 #define MAX_MESSAGE_SIZE 4096
+#define MAX_STREAM_QUEUED_RECORDS 100000
 
 #define LOG_TIME_CHARS 22
 #define LOG_LEVEL_CHARS 5
@@ -169,6 +171,11 @@ struct LoggingThread
     std::chrono::seconds logFlushPeriod = std::chrono::seconds(10);
     std::chrono::steady_clock::time_point nextFlushTime = std::chrono::steady_clock::now() + logFlushPeriod;
 
+    // Live stream to the MEGAlogger viewer. Records are only queued while it is connected
+    std::unique_ptr<LogStreamer> streamer;
+    std::vector<LogStream::Record> streamRecords;
+    uint64_t streamDropped = 0;
+
     void startLoggingThread(QString filename, QString desktopFilename)
     {
         if (!logThread)
@@ -310,9 +317,11 @@ private:
 
             LogLinkedList* newMessages = nullptr;
             bool topLevelMemoryGap = false;
+            std::vector<LogStream::Record> newStreamRecords;
+            uint64_t newStreamDropped = 0;
             {
                 std::unique_lock<std::mutex> lock(logMutex);
-                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages, &topLevelMemoryGap]() {
+                logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages, &topLevelMemoryGap, &newStreamRecords, &newStreamDropped]() {
                         if (forceRenew || logListFirst.next || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog)
                         {
                             newMessages = logListFirst.next;
@@ -320,6 +329,9 @@ private:
                             logListLast = &logListFirst;
                             topLevelMemoryGap = logListFirst.oomGap;
                             logListFirst.oomGap = false;
+                            newStreamRecords.swap(streamRecords);
+                            newStreamDropped = streamDropped;
+                            streamDropped = 0;
                             return true;
                         }
                         else return false;
@@ -430,6 +442,12 @@ private:
                 nextFlushTime = std::chrono::steady_clock::now() + logFlushPeriod;
             }
 
+            // After the file, so a slow viewer never delays the log on disk
+            if (streamer && (!newStreamRecords.empty() || newStreamDropped))
+            {
+                streamer->post(newStreamRecords, newStreamDropped);
+            }
+
             if (closeLog)
             {
                 outputFile.close();
@@ -461,6 +479,11 @@ MegaSyncLogger::MegaSyncLogger(QObject *parent, const QString& dataPath, const Q
     const auto desktopLogPath = desktopDir.filePath(QString::fromUtf8("MEGAsync.log"));
 
     g_loggingThread.reset(new LoggingThread());
+    if (getenv("MEGA_LOG_STREAM"))
+    {
+        // Opt-in, as the viewer would receive everything logged
+        g_loggingThread->streamer.reset(new LogStreamer());
+    }
     g_loggingThread->startLoggingThread(logPath, desktopLogPath);
 
     mega::MegaApi::setLogLevel(mega::MegaApi::LOG_LEVEL_MAX);
@@ -567,26 +590,6 @@ void MegaSyncLogger::log(const char*, int loglevel, const char*, const char *mes
 
 void LoggingThread::log(int loglevel, const char *message, const char **directMessages, size_t *directMessagesSizes, int numberMessages)
 {
-// todo: do we need this xml logger?
-//#ifdef LOG_TO_LOGGER
-//    //if (mConnected)
-//    {
-//        QString m = QString::fromUtf8(message);
-//        if (m.size() > MAX_MESSAGE_SIZE)
-//        {
-//            m = m.left(MAX_MESSAGE_SIZE - 3).append(QString::fromUtf8("..."));
-//        }
-//
-//        auto t = std::time(NULL);
-//        char ts[150];
-//        if (!std::strftime(ts, sizeof(ts), "%H:%M:%S", std::gmtime(&t)))    // .%f nonstandard, not available on windows
-//        {
-//            ts[0] = '\0';
-//        }
-//        emit sendLog(QString::fromUtf8(ts), loglevel, m);
-//    }
-//#endif
-
     bool direct = directMessages != nullptr;
 
     char timebuf[LOG_TIME_CHARS + 1];
@@ -616,9 +619,46 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     auto lineLen = LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen;
     bool notify = false;
 
+    LogStream::Record streamRecord;
+    bool stream = streamer && streamer->isConnected();
+    if (stream)
+    {
+        streamRecord.timestampUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
+        streamRecord.level = static_cast<uint8_t>(loglevel);
+        streamRecord.thread.assign(threadname, threadnameLen ? threadnameLen - 1 : 0); // without the separator
+        if (direct)
+        {
+            for (int i = 0; i < numberMessages && streamRecord.message.size() < MAX_MESSAGE_SIZE; i++)
+            {
+                streamRecord.message.append(directMessages[i], directMessagesSizes[i]);
+            }
+        }
+        else
+        {
+            streamRecord.message.assign(message, messageLen);
+        }
+        if (streamRecord.message.size() > MAX_MESSAGE_SIZE)
+        {
+            streamRecord.message.resize(MAX_MESSAGE_SIZE - 3);
+            streamRecord.message.append("...");
+        }
+    }
+
     {
         std::unique_ptr<std::lock_guard<std::mutex>> g(new std::lock_guard<std::mutex>(logMutex));
 
+        if (stream)
+        {
+            if (streamRecords.size() < MAX_STREAM_QUEUED_RECORDS)
+            {
+                streamRecords.push_back(std::move(streamRecord));
+            }
+            else
+            {
+                ++streamDropped;
+            }
+        }
+
         bool isRepeat = !direct && logListLast != &logListFirst &&
                         logListLast->lastmessage >= 0 &&
                         !strncmp(message, logListLast->message + logListLast->lastmessage, messageLen);
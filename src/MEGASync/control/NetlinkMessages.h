@@ -0,0 +1,100 @@
+#ifndef NETLINKMESSAGES_H
+#define NETLINKMESSAGES_H
+
+#ifdef __linux__
+
+#include <cstddef>
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+
+/// Classification of the rtnetlink notifications received by NetworkChangeWatcher.
+/// Kept apart from the socket handling, so it only depends on the kernel headers.
+namespace NetlinkMessages
+{
+enum Change
+{
+    NO_CHANGE = 0,
+    LINK_CHANGED = 1 << 0,
+    ADDRESS_CHANGED = 1 << 1
+};
+
+namespace Detail
+{
+// Wireless drivers report scan results and signal changes as RTM_NEWLINK with IFLA_WIRELESS
+inline bool isWirelessEvent(const nlmsghdr* header)
+{
+    const ifinfomsg* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    int attributesSize = static_cast<int>(IFLA_PAYLOAD(header));
+    for (const rtattr* attribute = IFLA_RTA(info); RTA_OK(attribute, attributesSize);
+         attribute = RTA_NEXT(attribute, attributesSize))
+    {
+        if (attribute->rta_type == IFLA_WIRELESS)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline int classifyLink(const nlmsghdr* header)
+{
+    if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifinfomsg)))
+    {
+        return NO_CHANGE;
+    }
+
+    const ifinfomsg* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    if ((info->ifi_flags & IFF_LOOPBACK) || (header->nlmsg_type == RTM_NEWLINK && isWirelessEvent(header)))
+    {
+        return NO_CHANGE;
+    }
+    return LINK_CHANGED;
+}
+
+inline int classifyAddress(const nlmsghdr* header)
+{
+    if (header->nlmsg_len < NLMSG_LENGTH(sizeof(ifaddrmsg)))
+    {
+        return NO_CHANGE;
+    }
+
+    const ifaddrmsg* address = static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+    if (address->ifa_scope == RT_SCOPE_HOST)
+    {
+        return NO_CHANGE;
+    }
+    return ADDRESS_CHANGED;
+}
+}
+
+// Combination of Change flags for all the messages of a datagram
+inline int classify(const void* data, size_t size)
+{
+    int changes = NO_CHANGE;
+    int remaining = static_cast<int>(size);
+    for (const nlmsghdr* header = static_cast<const nlmsghdr*>(data); NLMSG_OK(header, remaining);
+         header = NLMSG_NEXT(header, remaining))
+    {
+        switch (header->nlmsg_type)
+        {
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            changes |= Detail::classifyLink(header);
+            break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            changes |= Detail::classifyAddress(header);
+            break;
+        default:
+            break;
+        }
+    }
+    return changes;
+}
+}
+
+#endif // __linux__
+
+#endif // NETLINKMESSAGES_H
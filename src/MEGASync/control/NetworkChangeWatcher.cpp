@@ -0,0 +1,147 @@
+#include "NetworkChangeWatcher.h"
+#include "megaapi.h"
+
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include "NetlinkMessages.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+NetworkChangeWatcher::NetworkChangeWatcher(QObject* parent)
+    : QObject(parent),
+      mSocket(-1),
+      mNotifier(nullptr)
+{
+    mDebounceTimer.setSingleShot(true);
+    mDebounceTimer.setInterval(DEBOUNCE_MS);
+    connect(&mDebounceTimer, &QTimer::timeout, this, &NetworkChangeWatcher::networkChanged);
+}
+
+NetworkChangeWatcher::~NetworkChangeWatcher()
+{
+    close();
+}
+
+bool NetworkChangeWatcher::start()
+{
+#ifdef Q_OS_LINUX
+    if (isActive())
+    {
+        return true;
+    }
+
+    mSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (mSocket < 0)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                           QString::fromUtf8("Network watcher: unable to open the netlink socket: %1")
+                           .arg(QString::fromUtf8(strerror(errno))).toUtf8().constData());
+        return false;
+    }
+
+    sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(mSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                           QString::fromUtf8("Network watcher: unable to bind the netlink socket: %1")
+                           .arg(QString::fromUtf8(strerror(errno))).toUtf8().constData());
+        close();
+        return false;
+    }
+
+    mNotifier = new QSocketNotifier(mSocket, QSocketNotifier::Read, this);
+    connect(mNotifier, &QSocketNotifier::activated, this, &NetworkChangeWatcher::onSocketActivated);
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO, "Network watcher: listening to netlink notifications");
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool NetworkChangeWatcher::isActive() const
+{
+    return mSocket >= 0;
+}
+
+void NetworkChangeWatcher::onSocketActivated()
+{
+#ifdef Q_OS_LINUX
+    // Aligned for the netlink headers
+    alignas(nlmsghdr) char buffer[16384];
+    int changes = NetlinkMessages::NO_CHANGE;
+
+    while (isActive())
+    {
+        sockaddr_nl sender;
+        socklen_t senderSize = sizeof(sender);
+        ssize_t received = recvfrom(mSocket, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&sender), &senderSize);
+        if (received < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == ENOBUFS)
+            {
+                // The kernel dropped notifications, so anything may have changed
+                changes |= NetlinkMessages::LINK_CHANGED;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                                   QString::fromUtf8("Network watcher: unable to read the netlink socket: %1")
+                                   .arg(QString::fromUtf8(strerror(errno))).toUtf8().constData());
+                close();
+                emit failed();
+            }
+            break;
+        }
+
+        // Only the kernel broadcasts to these groups
+        if (sender.nl_pid == 0)
+        {
+            changes |= NetlinkMessages::classify(buffer, static_cast<size_t>(received));
+        }
+    }
+
+    if (changes != NetlinkMessages::NO_CHANGE)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG,
+                           QString::fromUtf8("Network watcher: change notified (links: %1 addresses: %2)")
+                           .arg((changes & NetlinkMessages::LINK_CHANGED) != 0)
+                           .arg((changes & NetlinkMessages::ADDRESS_CHANGED) != 0).toUtf8().constData());
+        if (!mDebounceTimer.isActive())
+        {
+            mDebounceTimer.start();
+        }
+    }
+#endif
+}
+
+void NetworkChangeWatcher::close()
+{
+    if (mNotifier)
+    {
+        mNotifier->setEnabled(false);
+        mNotifier->deleteLater();
+        mNotifier = nullptr;
+    }
+
+#ifdef Q_OS_LINUX
+    if (mSocket >= 0)
+    {
+        ::close(mSocket);
+    }
+#endif
+    mSocket = -1;
+}
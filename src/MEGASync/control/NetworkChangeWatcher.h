@@ -0,0 +1,48 @@
+#ifndef NETWORKCHANGEWATCHER_H
+#define NETWORKCHANGEWATCHER_H
+
+#include <QObject>
+#include <QTimer>
+
+class QSocketNotifier;
+
+/**
+ * @brief Notifications of the network interface and address changes
+ *
+ * Notifies as soon as a network interface or a local address changes, so the connections can be retried
+ * without waiting for the next poll of the interfaces.
+ *
+ * On Linux it listens to the rtnetlink link and IPv4/IPv6 address groups; the notifications received within
+ * DEBOUNCE_MS are reported once. On the other platforms, or if the socket can not be opened, start() returns
+ * false and the interfaces must be polled.
+ */
+class NetworkChangeWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int DEBOUNCE_MS = 250;
+
+    explicit NetworkChangeWatcher(QObject* parent = nullptr);
+    ~NetworkChangeWatcher();
+
+    bool start();
+    bool isActive() const;
+
+signals:
+    void networkChanged();
+    // The watcher stopped after an error, so changes are no longer notified
+    void failed();
+
+private slots:
+    void onSocketActivated();
+
+private:
+    void close();
+
+    int mSocket;
+    QSocketNotifier* mNotifier;
+    QTimer mDebounceTimer;
+};
+
+#endif // NETWORKCHANGEWATCHER_H
@@ -467,6 +467,7 @@ public:
 
     static int STATE_REFRESH_INTERVAL_MS;
     static int NETWORK_REFRESH_INTERVAL_MS;
+    static int NETWORK_FALLBACK_REFRESH_INTERVAL_MS;
     static int FINISHED_TRANSFER_REFRESH_INTERVAL_MS;
 
     static long long MIN_UPDATE_NOTIFICATION_INTERVAL_MS;
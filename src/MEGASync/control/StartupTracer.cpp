@@ -0,0 +1,116 @@
+#include "StartupTracer.h"
+
+#include "megaapi.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+
+namespace
+{
+// Static initialization happens before main(), so this is close to the process start
+const auto ORIGIN = std::chrono::steady_clock::now();
+
+long long microsecondsSinceOrigin(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - ORIGIN).count();
+}
+}
+
+StartupTracer::Span::Span(const char* name)
+    : mName(name),
+      mStart(std::chrono::steady_clock::now())
+{
+}
+
+StartupTracer::Span::~Span()
+{
+    const auto duration = std::chrono::steady_clock::now() - mStart;
+    instance().record(mName, mStart, std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+void StartupTracer::instant(const char* name)
+{
+    instance().record(name, std::chrono::steady_clock::now(), -1);
+}
+
+void StartupTracer::finish(const QString& traceFilePath)
+{
+    StartupTracer& tracer = instance();
+    QVector<Event> events;
+    {
+        QMutexLocker lock(&tracer.mMutex);
+        if (tracer.mFinished)
+        {
+            return;
+        }
+        tracer.mFinished = true;
+        events.swap(tracer.mEvents);
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    foreach (auto event, events)
+    {
+        QJsonObject traceEvent;
+        traceEvent[QLatin1String("name")] = QString::fromUtf8(event.name);
+        traceEvent[QLatin1String("cat")] = QLatin1String("startup");
+        traceEvent[QLatin1String("ts")] = event.startUs;
+        traceEvent[QLatin1String("pid")] = pid;
+        traceEvent[QLatin1String("tid")] = static_cast<qint64>(event.threadId);
+        if (event.durationUs < 0)
+        {
+            traceEvent[QLatin1String("ph")] = QLatin1String("i");
+            traceEvent[QLatin1String("s")] = QLatin1String("p");
+        }
+        else
+        {
+            traceEvent[QLatin1String("ph")] = QLatin1String("X");
+            traceEvent[QLatin1String("dur")] = event.durationUs;
+        }
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject trace;
+    trace[QLatin1String("traceEvents")] = traceEvents;
+    trace[QLatin1String("displayTimeUnit")] = QLatin1String("ms");
+
+    QSaveFile file(traceFilePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0
+            || !file.commit())
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                           QString::fromUtf8("Unable to write the startup trace to %1: %2")
+                           .arg(traceFilePath, file.errorString()).toUtf8().constData());
+        return;
+    }
+
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO,
+                       QString::fromUtf8("Startup trace with %1 events written to %2")
+                       .arg(events.size()).arg(traceFilePath).toUtf8().constData());
+}
+
+StartupTracer& StartupTracer::instance()
+{
+    static StartupTracer tracer;
+    return tracer;
+}
+
+StartupTracer::StartupTracer()
+    : mFinished(false)
+{
+    mEvents.reserve(64);
+}
+
+void StartupTracer::record(const char* name, std::chrono::steady_clock::time_point start, long long durationUs)
+{
+    QMutexLocker lock(&mMutex);
+    if (!mFinished)
+    {
+        mEvents.append(Event{name, microsecondsSinceOrigin(start), durationUs,
+                             reinterpret_cast<quintptr>(QThread::currentThreadId())});
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <chrono>
+
+/**
+ * @brief Trace of the startup steps
+ *
+ * Records how long the startup steps take and writes them as a trace in the Chrome trace event format, which
+ * can be opened in chrome://tracing or Perfetto.
+ *
+ * Spans are recorded from any thread until finish() writes the trace; later ones are ignored.
+ */
+class StartupTracer
+{
+public:
+    // Records the time between its construction and its destruction
+    class Span
+    {
+    public:
+        explicit Span(const char* name);
+        ~Span();
+
+    private:
+        const char* mName;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    static void instant(const char* name);
+    static void finish(const QString& traceFilePath);
+
+private:
+    struct Event
+    {
+        const char* name;
+        long long startUs;
+        long long durationUs; // -1 for instant events
+        unsigned long long threadId;
+    };
+
+    static StartupTracer& instance();
+    StartupTracer();
+
+    void record(const char* name, std::chrono::steady_clock::time_point start, long long durationUs);
+
+    QMutex mMutex;
+    QVector<Event> mEvents;
+    bool mFinished;
+};
+
+#endif // STARTUPTRACER_H
@@ -0,0 +1,570 @@
+#include "SyntheticEventGenerator.h"
+#include "SyntheticTransfer.h"
+
+#include "Utilities.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QSettings>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <Psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace mega;
+
+namespace
+{
+const QString LOAD_DRIVER_ARG = QString::fromUtf8("--load-driver");
+const char* const LOAD_DRIVER_ENV = "MEGA_LOAD_DRIVER_CONFIG";
+constexpr int TICK_MS{100};
+// Tags far above the ones assigned by the SDK, so synthetic and real transfers never collide
+constexpr int FIRST_SYNTHETIC_TAG{1 << 30};
+constexpr int FOLDER_TRANSFER_SCAN_UPDATES{20};
+constexpr int MAX_FOLDER_TRANSFERS{100};
+const int ALERT_TYPES[] = {MegaUserAlert::TYPE_NEWSHAREDNODES,
+                           MegaUserAlert::TYPE_INCOMINGPENDINGCONTACT_REQUEST,
+                           MegaUserAlert::TYPE_NEWSHARE,
+                           MegaUserAlert::TYPE_PAYMENT_SUCCEEDED};
+constexpr int ALERT_TYPES_COUNT = sizeof(ALERT_TYPES) / sizeof(ALERT_TYPES[0]);
+
+class SyntheticUserAlert : public MegaUserAlert
+{
+public:
+    SyntheticUserAlert(unsigned id, int type, int64_t timestamp)
+        : mId(id), mType(type), mTimestamp(timestamp),
+          mEmail("loaddriver" + std::to_string(id % 100) + "@mega.nz"),
+          mTitle("Synthetic alert " + std::to_string(id))
+    {
+    }
+
+    MegaUserAlert* copy() const override { return new SyntheticUserAlert(*this); }
+    unsigned getId() const override { return mId; }
+    bool getSeen() const override { return false; }
+    bool getRelevant() const override { return true; }
+    int getType() const override { return mType; }
+    MegaHandle getUserHandle() const override { return INVALID_HANDLE; }
+    MegaHandle getNodeHandle() const override { return INVALID_HANDLE; }
+    const char* getEmail() const override { return mEmail.c_str(); }
+    const char* getTitle() const override { return mTitle.c_str(); }
+    const char* getString(unsigned) const override { return mTitle.c_str(); }
+    int64_t getNumber(unsigned) const override { return 1; }
+    int64_t getTimestamp(unsigned) const override { return mTimestamp; }
+    bool isRemoved() const override { return false; }
+
+private:
+    unsigned mId;
+    int mType;
+    int64_t mTimestamp;
+    std::string mEmail;
+    std::string mTitle;
+};
+
+class SyntheticUserAlertList : public MegaUserAlertList
+{
+public:
+    SyntheticUserAlertList() = default;
+    SyntheticUserAlertList(const SyntheticUserAlertList& other)
+    {
+        for (const auto& alert : other.mAlerts)
+        {
+            mAlerts.emplace_back(alert->copy());
+        }
+    }
+
+    MegaUserAlertList* copy() const override { return new SyntheticUserAlertList(*this); }
+    MegaUserAlert* get(int i) const override
+    {
+        return (i >= 0 && i < size()) ? mAlerts[static_cast<size_t>(i)].get() : nullptr;
+    }
+    int size() const override { return static_cast<int>(mAlerts.size()); }
+    // The app releases the list without owning the alerts once they are moved to its model
+    void clear() override
+    {
+        for (auto& alert : mAlerts)
+        {
+            alert.release();
+        }
+        mAlerts.clear();
+    }
+
+    void add(MegaUserAlert* alert) { mAlerts.emplace_back(alert); }
+
+private:
+    std::vector<std::unique_ptr<MegaUserAlert>> mAlerts;
+};
+
+class SyntheticNode : public MegaNode
+{
+public:
+    SyntheticNode(MegaHandle handle, int changes)
+        : mHandle(handle), mChanges(changes),
+          mName("node_" + std::to_string(handle) + "." + SyntheticTransfer::fileExtension(static_cast<long long>(handle)))
+    {
+    }
+
+    MegaNode* copy() override { return new SyntheticNode(*this); }
+    int getType() override { return TYPE_FILE; }
+    const char* getName() override { return mName.c_str(); }
+    int64_t getSize() override { return static_cast<int64_t>(1024 * (1 + mHandle % 1000)); }
+    MegaHandle getHandle() override { return mHandle; }
+    MegaHandle getParentHandle() override { return INVALID_HANDLE; }
+    int getChanges() override { return mChanges; }
+    bool hasChanged(int changeType) override { return mChanges & changeType; }
+
+private:
+    MegaHandle mHandle;
+    int mChanges;
+    std::string mName;
+};
+}
+
+SyntheticEventGenerator* SyntheticEventGenerator::mInstance = nullptr;
+
+SyntheticEventGenerator::Config SyntheticEventGenerator::loadConfig(const QString& configPath)
+{
+    Config config;
+    QSettings settings(configPath, QSettings::IniFormat);
+    settings.beginGroup(QString::fromUtf8("LoadDriver"));
+    config.transfersPerSecond = settings.value(QString::fromUtf8("transfersPerSecond"), config.transfersPerSecond).toDouble();
+    config.transferUpdatesPerSecond = settings.value(QString::fromUtf8("transferUpdatesPerSecond"), config.transferUpdatesPerSecond).toDouble();
+    config.maxTransfers = settings.value(QString::fromUtf8("maxTransfers"), config.maxTransfers).toInt();
+    config.failedTransfersPercent = settings.value(QString::fromUtf8("failedTransfersPercent"), config.failedTransfersPercent).toInt();
+    config.folderTransfersPerSecond = settings.value(QString::fromUtf8("folderTransfersPerSecond"), config.folderTransfersPerSecond).toDouble();
+    config.userAlertsPerSecond = settings.value(QString::fromUtf8("userAlertsPerSecond"), config.userAlertsPerSecond).toDouble();
+    config.nodeUpdatesPerSecond = settings.value(QString::fromUtf8("nodeUpdatesPerSecond"), config.nodeUpdatesPerSecond).toDouble();
+    config.durationSeconds = settings.value(QString::fromUtf8("durationSeconds"), config.durationSeconds).toInt();
+    config.reportIntervalSeconds = std::max(1, settings.value(QString::fromUtf8("reportIntervalSeconds"), config.reportIntervalSeconds).toInt());
+    settings.endGroup();
+    return config;
+}
+
+SyntheticEventGenerator* SyntheticEventGenerator::create(const QStringList& args, MegaApi* megaApi)
+{
+    if (mInstance)
+    {
+        return mInstance;
+    }
+
+    QString configPath;
+    int argIndex = args.indexOf(LOAD_DRIVER_ARG);
+    if (argIndex >= 0 && argIndex + 1 < args.size())
+    {
+        configPath = args.at(argIndex + 1);
+    }
+    else if (qEnvironmentVariableIsSet(LOAD_DRIVER_ENV))
+    {
+        configPath = QString::fromLocal8Bit(qgetenv(LOAD_DRIVER_ENV));
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    if (!QFile::exists(configPath))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Load driver: config file not found, using defaults: %1")
+                     .arg(configPath).toUtf8().constData());
+    }
+
+    mInstance = new SyntheticEventGenerator(loadConfig(configPath), megaApi);
+    return mInstance;
+}
+
+SyntheticEventGenerator* SyntheticEventGenerator::instance()
+{
+    return mInstance;
+}
+
+SyntheticEventGenerator::SyntheticEventGenerator(const Config& config, MegaApi* megaApi)
+    : QObject(nullptr),
+      mConfig(config),
+      mMegaApi(megaApi),
+      mThread(new QThread()),
+      mTickTimer(new QTimer(this)),
+      mLastTick(0),
+      mLastReport(0),
+      mNextTag(FIRST_SYNTHETIC_TAG),
+      mStartedTransfers(0),
+      mNextAlertId(1),
+      mNextNodeHandle(1),
+      mTransfersRemainder(0.0),
+      mUpdatesRemainder(0.0),
+      mFoldersRemainder(0.0),
+      mAlertsRemainder(0.0),
+      mNodesRemainder(0.0),
+      mEventsSent(0),
+      mLatencyStats(std::make_shared<LatencyStats>())
+{
+    mTickTimer->setInterval(TICK_MS);
+    connect(mTickTimer, &QTimer::timeout, this, &SyntheticEventGenerator::onTick);
+    moveToThread(mThread);
+    connect(mThread, &QThread::finished, mTickTimer, &QTimer::stop, Qt::DirectConnection);
+
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                 QString::fromUtf8("Load driver enabled: %1 transfers/s, %2 updates/s, %3 max transfers, "
+                                   "%4 folder transfers/s, %5 alerts/s, %6 node updates/s")
+                 .arg(mConfig.transfersPerSecond).arg(mConfig.transferUpdatesPerSecond).arg(mConfig.maxTransfers)
+                 .arg(mConfig.folderTransfersPerSecond).arg(mConfig.userAlertsPerSecond)
+                 .arg(mConfig.nodeUpdatesPerSecond).toUtf8().constData());
+}
+
+SyntheticEventGenerator::~SyntheticEventGenerator()
+{
+    stop();
+    mThread->deleteLater();
+    if (mInstance == this)
+    {
+        mInstance = nullptr;
+    }
+}
+
+void SyntheticEventGenerator::addTransferListener(MegaTransferListener* listener)
+{
+    QMutexLocker lock(&mListenersMutex);
+    if (!mTransferListeners.contains(listener))
+    {
+        mTransferListeners.append(listener);
+    }
+}
+
+void SyntheticEventGenerator::removeTransferListener(MegaTransferListener* listener)
+{
+    QMutexLocker lock(&mListenersMutex);
+    mTransferListeners.removeAll(listener);
+}
+
+void SyntheticEventGenerator::addListener(MegaListener* listener)
+{
+    QMutexLocker lock(&mListenersMutex);
+    if (!mListeners.contains(listener))
+    {
+        mListeners.append(listener);
+    }
+}
+
+void SyntheticEventGenerator::removeListener(MegaListener* listener)
+{
+    QMutexLocker lock(&mListenersMutex);
+    mListeners.removeAll(listener);
+}
+
+void SyntheticEventGenerator::start()
+{
+    if (mThread->isRunning())
+    {
+        return;
+    }
+
+    mThread->start();
+    QMetaObject::invokeMethod(mTickTimer, "start", Qt::QueuedConnection);
+}
+
+void SyntheticEventGenerator::stop()
+{
+    if (mThread->isRunning())
+    {
+        mThread->quit();
+        mThread->wait();
+    }
+}
+
+long long SyntheticEventGenerator::getProcessMemoryUsage()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc)))
+    {
+        return static_cast<long long>(pmc.PrivateUsage);
+    }
+#elif defined(__APPLE__)
+    struct task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+    if (KERN_SUCCESS == task_info(mach_task_self(), TASK_BASIC_INFO, (task_info_t)&t_info, &t_info_count))
+    {
+        return static_cast<long long>(t_info.resident_size);
+    }
+#else
+    // Second field of statm: resident set size, in pages
+    QFile statm(QString::fromUtf8("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly))
+    {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+        {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+void SyntheticEventGenerator::onTick()
+{
+    if (!mRunningTime.isValid())
+    {
+        mRunningTime.start();
+    }
+
+    const qint64 now = mRunningTime.elapsed();
+    const double elapsedSeconds = (now - mLastTick) / 1000.0;
+    mLastTick = now;
+
+    if (mConfig.durationSeconds > 0 && now >= mConfig.durationSeconds * 1000LL)
+    {
+        report();
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Load driver: run finished");
+        mTickTimer->stop();
+        return;
+    }
+
+    startTransfers(eventsForTick(mConfig.transfersPerSecond, elapsedSeconds, mTransfersRemainder));
+    updateTransfers(eventsForTick(mConfig.transferUpdatesPerSecond, elapsedSeconds, mUpdatesRemainder));
+    updateFolderTransfers(eventsForTick(mConfig.folderTransfersPerSecond, elapsedSeconds, mFoldersRemainder));
+    sendUserAlerts(eventsForTick(mConfig.userAlertsPerSecond, elapsedSeconds, mAlertsRemainder));
+    sendNodeUpdates(eventsForTick(mConfig.nodeUpdatesPerSecond, elapsedSeconds, mNodesRemainder));
+    probeAppThreadLatency();
+
+    if (now - mLastReport >= mConfig.reportIntervalSeconds * 1000LL)
+    {
+        report();
+        mLastReport = now;
+    }
+}
+
+// Rates below one event per tick are accumulated until a whole event is due
+int SyntheticEventGenerator::eventsForTick(double rate, double elapsedSeconds, double& remainder)
+{
+    if (rate <= 0.0)
+    {
+        return 0;
+    }
+
+    remainder += rate * elapsedSeconds;
+    const double events = std::floor(remainder);
+    remainder -= events;
+    return static_cast<int>(events);
+}
+
+void SyntheticEventGenerator::startTransfers(int count)
+{
+    auto listeners = getTransferListeners();
+    for (int i = 0; i < count && mStartedTransfers < mConfig.maxTransfers; ++i, ++mStartedTransfers)
+    {
+        const int index = mStartedTransfers;
+        auto transfer = SyntheticTransfer::create(index, mNextTag++, "/loaddriver");
+        transfer->advance(MegaTransfer::STATE_QUEUED, 0);
+
+        for (auto listener : listeners)
+        {
+            listener->onTransferStart(mMegaApi, transfer.get());
+        }
+        mActiveTransfers.push_back(std::move(transfer));
+        ++mEventsSent;
+    }
+}
+
+// Updates go round robin over the active transfers, each one moving a tenth of its size
+void SyntheticEventGenerator::updateTransfers(int count)
+{
+    auto listeners = getTransferListeners();
+    for (int i = 0; i < count && !mActiveTransfers.empty(); ++i)
+    {
+        auto transfer = std::move(mActiveTransfers.front());
+        mActiveTransfers.pop_front();
+
+        const long long transferredBytes = transfer->mTransferredBytes + std::max(1LL, transfer->mTotalBytes / 10);
+        if (transferredBytes >= transfer->mTotalBytes)
+        {
+            finishTransfer(std::move(transfer));
+            continue;
+        }
+
+        transfer->advance(MegaTransfer::STATE_ACTIVE, transferredBytes);
+        for (auto listener : listeners)
+        {
+            listener->onTransferUpdate(mMegaApi, transfer.get());
+        }
+        mActiveTransfers.push_back(std::move(transfer));
+        ++mEventsSent;
+    }
+}
+
+void SyntheticEventGenerator::finishTransfer(std::unique_ptr<SyntheticTransfer> transfer)
+{
+    const bool failed = mConfig.failedTransfersPercent > 0
+            && (transfer->mTag % 100) < mConfig.failedTransfersPercent;
+    MegaError error(failed ? MegaError::API_EINCOMPLETE : MegaError::API_OK);
+    transfer->advance(failed ? MegaTransfer::STATE_FAILED : MegaTransfer::STATE_COMPLETED,
+                      failed ? transfer->mTransferredBytes : transfer->mTotalBytes);
+
+    for (auto listener : getTransferListeners())
+    {
+        listener->onTransferFinish(mMegaApi, transfer.get(), &error);
+    }
+    ++mEventsSent;
+}
+
+// Each folder transfer goes through the scan and the folder creation stages before its files start
+void SyntheticEventGenerator::updateFolderTransfers(int count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    auto listeners = getTransferListeners();
+    for (int i = 0; i < count; ++i)
+    {
+        if (mFolderTransfers.size() < MAX_FOLDER_TRANSFERS)
+        {
+            FolderTransfer folder;
+            folder.transfer = std::make_unique<SyntheticTransfer>();
+            folder.transfer->mTag = mNextTag++;
+            folder.transfer->mType = MegaTransfer::TYPE_UPLOAD;
+            folder.transfer->mFolder = true;
+            folder.transfer->mFileName = "folder_" + std::to_string(folder.transfer->mTag - FIRST_SYNTHETIC_TAG);
+            folder.transfer->mPath = "/loaddriver/" + folder.transfer->mFileName;
+            folder.stage = MegaTransfer::STAGE_SCAN;
+            folder.folderCount = 0;
+            folder.fileCount = 0;
+            folder.createdFolderCount = 0;
+            mFolderTransfers.push_back(std::move(folder));
+        }
+    }
+
+    for (auto it = mFolderTransfers.begin(); it != mFolderTransfers.end();)
+    {
+        auto& folder = *it;
+        if (folder.stage == MegaTransfer::STAGE_SCAN)
+        {
+            folder.folderCount += 10;
+            folder.fileCount += 100;
+            if (folder.folderCount >= 10 * FOLDER_TRANSFER_SCAN_UPDATES)
+            {
+                folder.stage = MegaTransfer::STAGE_CREATE_TREE;
+            }
+        }
+        else if (folder.stage == MegaTransfer::STAGE_CREATE_TREE)
+        {
+            folder.createdFolderCount = std::min(folder.folderCount, folder.createdFolderCount + 50);
+            if (folder.createdFolderCount >= folder.folderCount)
+            {
+                folder.stage = MegaTransfer::STAGE_TRANSFERRING_FILES;
+            }
+        }
+
+        for (auto listener : listeners)
+        {
+            listener->onFolderTransferUpdate(mMegaApi, folder.transfer.get(), folder.stage, folder.folderCount,
+                                             folder.createdFolderCount, folder.fileCount, nullptr, nullptr);
+        }
+        ++mEventsSent;
+
+        it = folder.stage == MegaTransfer::STAGE_TRANSFERRING_FILES ? mFolderTransfers.erase(it) : it + 1;
+    }
+}
+
+void SyntheticEventGenerator::sendUserAlerts(int count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    SyntheticUserAlertList alerts;
+    const int64_t now = QDateTime::currentSecsSinceEpoch();
+    for (int i = 0; i < count; ++i, ++mNextAlertId)
+    {
+        alerts.add(new SyntheticUserAlert(static_cast<unsigned>(mNextAlertId),
+                                          ALERT_TYPES[mNextAlertId % ALERT_TYPES_COUNT], now));
+    }
+
+    for (auto listener : getListeners())
+    {
+        listener->onUserAlertsUpdate(mMegaApi, &alerts);
+    }
+    mEventsSent += count;
+}
+
+void SyntheticEventGenerator::sendNodeUpdates(int count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    std::unique_ptr<MegaNodeList> nodes(MegaNodeList::createInstance());
+    for (int i = 0; i < count; ++i, ++mNextNodeHandle)
+    {
+        const int changes = (mNextNodeHandle % 2) ? MegaNode::CHANGE_TYPE_ATTRIBUTES : MegaNode::CHANGE_TYPE_PARENT;
+        SyntheticNode node(static_cast<MegaHandle>(mNextNodeHandle), changes);
+        nodes->addNode(&node);
+    }
+
+    for (auto listener : getListeners())
+    {
+        listener->onNodesUpdate(mMegaApi, nodes.get());
+    }
+    mEventsSent += count;
+}
+
+// Time taken by the app thread to run a queued function: how far behind the UI is with the events
+void SyntheticEventGenerator::probeAppThreadLatency()
+{
+    auto stats = mLatencyStats;
+    QElapsedTimer probe;
+    probe.start();
+    Utilities::queueFunctionInAppThread([stats, probe]()
+    {
+        const qint64 latency = probe.elapsed();
+        stats->totalMs += latency;
+        stats->samples++;
+        qint64 max = stats->maxMs;
+        while (latency > max && !stats->maxMs.compare_exchange_weak(max, latency))
+        {
+        }
+    });
+}
+
+void SyntheticEventGenerator::report()
+{
+    const qint64 now = mRunningTime.elapsed();
+    const double seconds = std::max<qint64>(1, now - mLastReport) / 1000.0;
+    const int samples = mLatencyStats->samples.exchange(0);
+    const qint64 totalLatency = mLatencyStats->totalMs.exchange(0);
+    const qint64 maxLatency = mLatencyStats->maxMs.exchange(0);
+
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO,
+                 QString::fromUtf8("Load driver: %1 events/s, %2 transfers started, %3 active, "
+                                   "app thread latency avg %4 ms max %5 ms, memory %6 MB")
+                 .arg(static_cast<long long>(mEventsSent / seconds))
+                 .arg(mStartedTransfers)
+                 .arg(static_cast<qulonglong>(mActiveTransfers.size()))
+                 .arg(samples ? totalLatency / samples : 0)
+                 .arg(maxLatency)
+                 .arg(getProcessMemoryUsage() / (1024 * 1024))
+                 .toUtf8().constData());
+    mEventsSent = 0;
+}
+
+QList<MegaTransferListener*> SyntheticEventGenerator::getTransferListeners()
+{
+    QMutexLocker lock(&mListenersMutex);
+    return mTransferListeners;
+}
+
+QList<MegaListener*> SyntheticEventGenerator::getListeners()
+{
+    QMutexLocker lock(&mListenersMutex);
+    return mListeners;
+}
@@ -0,0 +1,142 @@
+#ifndef SYNTHETICEVENTGENERATOR_H
+#define SYNTHETICEVENTGENERATOR_H
+
+#include "megaapi.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class SyntheticTransfer;
+
+/**
+ * @brief Load-driver mode
+ *
+ * Feeds the app listeners with synthetic SDK events so the transfers model, the info dialog, the transfer
+ * manager and the node selector can be stressed locally without an account holding hundreds of thousands of
+ * transfers or millions of nodes.
+ *
+ * Enabled with "--load-driver <config.ini>" or the MEGA_LOAD_DRIVER_CONFIG environment variable. While
+ * enabled, transfer listeners are registered here instead of in the MegaApi, and app listeners receive the
+ * synthetic user alerts and node updates on top of the real SDK events. Every report interval the achieved
+ * event rates, the app thread latency and the process memory are written to the log.
+ *
+ * Config file, [LoadDriver] group (rates are events per second, 0 disables the feed):
+ *     transfersPerSecond, transferUpdatesPerSecond, maxTransfers, failedTransfersPercent,
+ *     folderTransfersPerSecond, userAlertsPerSecond, nodeUpdatesPerSecond,
+ *     durationSeconds, reportIntervalSeconds
+ */
+class SyntheticEventGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        double transfersPerSecond = 1000.0;
+        double transferUpdatesPerSecond = 10000.0;
+        int maxTransfers = 500000;
+        int failedTransfersPercent = 1;
+        double folderTransfersPerSecond = 1.0;
+        double userAlertsPerSecond = 1.0;
+        double nodeUpdatesPerSecond = 100.0;
+        int durationSeconds = 0;
+        int reportIntervalSeconds = 5;
+    };
+
+    static Config loadConfig(const QString& configPath);
+
+    // Creates the generator. Returns nullptr if the load-driver mode is not requested
+    static SyntheticEventGenerator* create(const QStringList& args, mega::MegaApi* megaApi);
+    static SyntheticEventGenerator* instance();
+
+    ~SyntheticEventGenerator() override;
+
+    void addTransferListener(mega::MegaTransferListener* listener);
+    void removeTransferListener(mega::MegaTransferListener* listener);
+    void addListener(mega::MegaListener* listener);
+    void removeListener(mega::MegaListener* listener);
+
+    void start();
+    void stop();
+
+    static long long getProcessMemoryUsage();
+
+private slots:
+    void onTick();
+
+private:
+    struct FolderTransfer
+    {
+        std::unique_ptr<SyntheticTransfer> transfer;
+        int stage;
+        uint32_t folderCount;
+        uint32_t fileCount;
+        uint32_t createdFolderCount;
+    };
+
+    SyntheticEventGenerator(const Config& config, mega::MegaApi* megaApi);
+
+    static int eventsForTick(double rate, double elapsedSeconds, double& remainder);
+
+    void startTransfers(int count);
+    void updateTransfers(int count);
+    void finishTransfer(std::unique_ptr<SyntheticTransfer> transfer);
+    void updateFolderTransfers(int count);
+    void sendUserAlerts(int count);
+    void sendNodeUpdates(int count);
+    void probeAppThreadLatency();
+    void report();
+
+    QList<mega::MegaTransferListener*> getTransferListeners();
+    QList<mega::MegaListener*> getListeners();
+
+    static SyntheticEventGenerator* mInstance;
+
+    Config mConfig;
+    mega::MegaApi* mMegaApi;
+    QThread* mThread;
+    QTimer* mTickTimer;
+    QElapsedTimer mRunningTime;
+    qint64 mLastTick;
+    qint64 mLastReport;
+
+    QMutex mListenersMutex;
+    QList<mega::MegaTransferListener*> mTransferListeners;
+    QList<mega::MegaListener*> mListeners;
+
+    std::deque<std::unique_ptr<SyntheticTransfer>> mActiveTransfers;
+    std::vector<FolderTransfer> mFolderTransfers;
+    int mNextTag;
+    int mStartedTransfers;
+    long long mNextAlertId;
+    long long mNextNodeHandle;
+
+    double mTransfersRemainder;
+    double mUpdatesRemainder;
+    double mFoldersRemainder;
+    double mAlertsRemainder;
+    double mNodesRemainder;
+
+    // Stats of the current report interval. Latency probes complete in the app thread, so they
+    // keep their own reference to the stats
+    struct LatencyStats
+    {
+        std::atomic<qint64> maxMs{0};
+        std::atomic<qint64> totalMs{0};
+        std::atomic<int> samples{0};
+    };
+    long long mEventsSent;
+    std::shared_ptr<LatencyStats> mLatencyStats;
+};
+
+#endif // SYNTHETICEVENTGENERATOR_H
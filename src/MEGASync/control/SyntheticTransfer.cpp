@@ -0,0 +1,142 @@
+#include "SyntheticTransfer.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+using namespace mega;
+
+namespace
+{
+const char* const EXTENSIONS[] = {"jpg", "mp4", "pdf", "docx", "zip", "txt", "mp3", "psd", "xlsx", "bin"};
+constexpr int EXTENSIONS_COUNT = sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]);
+}
+
+constexpr long long SyntheticTransfer::SPEED_BYTES_SECOND;
+
+std::unique_ptr<SyntheticTransfer> SyntheticTransfer::create(int index, int tag, const std::string& rootFolder)
+{
+    auto transfer = std::make_unique<SyntheticTransfer>();
+    transfer->mTag = tag;
+    transfer->mType = (index % 2) ? TYPE_UPLOAD : TYPE_DOWNLOAD;
+    transfer->mPriority = 0xFFFF000000000000ULL + static_cast<unsigned long long>(index);
+    transfer->mTotalBytes = 1024LL * (1 + (index * 7919LL) % 100000);
+    transfer->mNodeHandle = static_cast<MegaHandle>(index + 1);
+    transfer->mFileName = "file_" + std::to_string(index) + "." + fileExtension(index);
+    transfer->mPath = rootFolder + "/folder_" + std::to_string(index % 100) + "/" + transfer->mFileName;
+    return transfer;
+}
+
+const char* SyntheticTransfer::fileExtension(long long index)
+{
+    return EXTENSIONS[index % EXTENSIONS_COUNT];
+}
+
+MegaTransfer* SyntheticTransfer::copy()
+{
+    return new SyntheticTransfer(*this);
+}
+
+int SyntheticTransfer::getType() const
+{
+    return mType;
+}
+
+int SyntheticTransfer::getTag() const
+{
+    return mTag;
+}
+
+int SyntheticTransfer::getFolderTransferTag() const
+{
+    return 0;
+}
+
+int SyntheticTransfer::getState() const
+{
+    return mState;
+}
+
+unsigned long long SyntheticTransfer::getPriority() const
+{
+    return mPriority;
+}
+
+long long SyntheticTransfer::getNotificationNumber() const
+{
+    return mNotificationNumber;
+}
+
+long long SyntheticTransfer::getTransferredBytes() const
+{
+    return mTransferredBytes;
+}
+
+long long SyntheticTransfer::getTotalBytes() const
+{
+    return mTotalBytes;
+}
+
+long long SyntheticTransfer::getSpeed() const
+{
+    return mSpeed;
+}
+
+long long SyntheticTransfer::getMeanSpeed() const
+{
+    return mSpeed;
+}
+
+int64_t SyntheticTransfer::getUpdateTime() const
+{
+    return mUpdateTime;
+}
+
+const char* SyntheticTransfer::getPath() const
+{
+    return mPath.c_str();
+}
+
+const char* SyntheticTransfer::getFileName() const
+{
+    return mFileName.c_str();
+}
+
+const char* SyntheticTransfer::getAppData() const
+{
+    return "";
+}
+
+MegaHandle SyntheticTransfer::getNodeHandle() const
+{
+    return mNodeHandle;
+}
+
+MegaHandle SyntheticTransfer::getParentHandle() const
+{
+    return INVALID_HANDLE;
+}
+
+bool SyntheticTransfer::isSyncTransfer() const
+{
+    return false;
+}
+
+bool SyntheticTransfer::isBackupTransfer() const
+{
+    return false;
+}
+
+bool SyntheticTransfer::isFolderTransfer() const
+{
+    return mFolder;
+}
+
+void SyntheticTransfer::advance(int state, long long transferredBytes)
+{
+    mState = state;
+    mTransferredBytes = std::min(transferredBytes, mTotalBytes);
+    mSpeed = state == STATE_ACTIVE ? SPEED_BYTES_SECOND : 0;
+    mUpdateTime = QDateTime::currentSecsSinceEpoch();
+    mNotificationNumber++;
+}
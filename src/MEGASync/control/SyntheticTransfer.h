@@ -0,0 +1,62 @@
+#ifndef SYNTHETICTRANSFER_H
+#define SYNTHETICTRANSFER_H
+
+#include "megaapi.h"
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief MegaTransfer with settable values, as delivered by the SDK transfer listener callbacks
+ *
+ * Shared by the load-driver mode and the benchmarks, so both feed the app with the same transfers.
+ */
+class SyntheticTransfer : public mega::MegaTransfer
+{
+public:
+    static constexpr long long SPEED_BYTES_SECOND{10 * 1024 * 1024};
+
+    // Reproducible transfers: the same index always gives the same name, size, type and priority
+    static std::unique_ptr<SyntheticTransfer> create(int index, int tag, const std::string& rootFolder);
+    // Extension of the file names, cycling over common file types
+    static const char* fileExtension(long long index);
+
+    MegaTransfer* copy() override;
+    int getType() const override;
+    int getTag() const override;
+    int getFolderTransferTag() const override;
+    int getState() const override;
+    unsigned long long getPriority() const override;
+    long long getNotificationNumber() const override;
+    long long getTransferredBytes() const override;
+    long long getTotalBytes() const override;
+    long long getSpeed() const override;
+    long long getMeanSpeed() const override;
+    int64_t getUpdateTime() const override;
+    const char* getPath() const override;
+    const char* getFileName() const override;
+    const char* getAppData() const override;
+    mega::MegaHandle getNodeHandle() const override;
+    mega::MegaHandle getParentHandle() const override;
+    bool isSyncTransfer() const override;
+    bool isBackupTransfer() const override;
+    bool isFolderTransfer() const override;
+
+    void advance(int state, long long transferredBytes);
+
+    int mType = TYPE_DOWNLOAD;
+    int mTag = 0;
+    int mState = STATE_QUEUED;
+    unsigned long long mPriority = 0;
+    long long mNotificationNumber = 0;
+    long long mTransferredBytes = 0;
+    long long mTotalBytes = 0;
+    long long mSpeed = 0;
+    int64_t mUpdateTime = 0;
+    bool mFolder = false;
+    std::string mPath;
+    std::string mFileName;
+    mega::MegaHandle mNodeHandle = mega::INVALID_HANDLE;
+};
+
+#endif // SYNTHETICTRANSFER_H
@@ -0,0 +1,116 @@
+#include "TransferQueueEta.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Time for a new speed to weight 63% in the average
+constexpr double TIME_CONSTANT_MS{10000.0};
+// Samples above this factor of the average are clamped to it
+constexpr double BURST_FACTOR{4.0};
+// Without samples for longer than this the queue is considered stalled
+constexpr std::chrono::milliseconds STALL_TIMEOUT{15000};
+}
+
+TransferQueueEta::TransferQueueEta()
+{
+}
+
+void TransferQueueEta::addSample(Direction direction, unsigned long long bytes,
+                                 std::chrono::milliseconds elapsed, std::chrono::milliseconds now)
+{
+    auto& estimate = mDirections[direction];
+    if (elapsed.count() <= 0 || (bytes == 0 && estimate.remainingBytes == 0))
+    {
+        // Nothing to transfer, so an idle period says nothing about the speed
+        return;
+    }
+
+    const double sampleSpeed(static_cast<double>(bytes) * 1000.0 / static_cast<double>(elapsed.count()));
+    if (!estimate.hasSample || estimate.speed <= 0.0)
+    {
+        // Seed with the first measured throughput
+        if (bytes > 0)
+        {
+            estimate.speed = sampleSpeed;
+            estimate.hasSample = true;
+            estimate.lastSample = now;
+        }
+        return;
+    }
+
+    const double alpha(1.0 - std::exp(-static_cast<double>(elapsed.count()) / TIME_CONSTANT_MS));
+    estimate.speed += alpha * (std::min(sampleSpeed, estimate.speed * BURST_FACTOR) - estimate.speed);
+    estimate.lastSample = now;
+}
+
+void TransferQueueEta::setRemainingBytes(Direction direction, unsigned long long remainingBytes)
+{
+    mDirections[direction].remainingBytes = remainingBytes;
+}
+
+void TransferQueueEta::setBandwidthLimit(Direction direction, unsigned long long bytesPerSecond)
+{
+    mDirections[direction].bandwidthLimit = bytesPerSecond;
+}
+
+void TransferQueueEta::setConnections(Direction direction, int connections)
+{
+    auto& estimate = mDirections[direction];
+    if (connections > 0 && estimate.connections > 0 && connections != estimate.connections)
+    {
+        // Start from the proportional speed instead of waiting for the average to converge
+        estimate.speed = estimate.speed * connections / estimate.connections;
+    }
+    estimate.connections = connections;
+}
+
+unsigned long long TransferQueueEta::estimatedSpeed(Direction direction, std::chrono::milliseconds now) const
+{
+    const auto& estimate = mDirections[direction];
+    if (!estimate.hasSample || now - estimate.lastSample > STALL_TIMEOUT)
+    {
+        return 0;
+    }
+
+    auto speed(static_cast<unsigned long long>(estimate.speed));
+    if (estimate.bandwidthLimit > 0)
+    {
+        speed = std::min(speed, estimate.bandwidthLimit);
+    }
+    return speed;
+}
+
+std::chrono::seconds TransferQueueEta::remainingTime(Direction direction, std::chrono::milliseconds now) const
+{
+    const auto& estimate = mDirections[direction];
+    if (estimate.remainingBytes == 0)
+    {
+        return std::chrono::seconds(0);
+    }
+
+    const auto speed(estimatedSpeed(direction, now));
+    if (speed == 0)
+    {
+        return std::chrono::seconds::max();
+    }
+
+    return std::chrono::seconds((estimate.remainingBytes + speed - 1) / speed);
+}
+
+std::chrono::seconds TransferQueueEta::remainingTime(std::chrono::milliseconds now) const
+{
+    return std::max(remainingTime(UPLOAD, now), remainingTime(DOWNLOAD, now));
+}
+
+void TransferQueueEta::reset()
+{
+    for (auto& estimate : mDirections)
+    {
+        // Limits and connections are settings, not measurements
+        estimate.speed = 0.0;
+        estimate.lastSample = std::chrono::milliseconds(0);
+        estimate.hasSample = false;
+        estimate.remainingBytes = 0;
+    }
+}
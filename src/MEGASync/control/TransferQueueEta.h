@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <chrono>
+
+/**
+ * @brief Estimates the time left to finish all the transfers of the queue in each direction
+ *
+ * The aggregate throughput is smoothed with an exponentially weighted moving average whose weight depends on
+ * the elapsed time of each sample. Samples far above the current average (bytes reported at once after a
+ * pause, small files finished in a row) are clamped, so a single burst does not make the estimate jump. The
+ * estimated speed is capped by the bandwidth limit and rescaled when the number of connections per transfer
+ * changes. No estimate is given until some throughput is measured or when the queue is stalled.
+ */
+class TransferQueueEta
+{
+public:
+    enum Direction
+    {
+        UPLOAD = 0,
+        DOWNLOAD,
+        DIRECTIONS
+    };
+
+    TransferQueueEta();
+
+    // Bytes transferred during the elapsed time until now
+    void addSample(Direction direction, unsigned long long bytes,
+                   std::chrono::milliseconds elapsed, std::chrono::milliseconds now);
+    void setRemainingBytes(Direction direction, unsigned long long remainingBytes);
+    // Bytes per second, zero for no limit
+    void setBandwidthLimit(Direction direction, unsigned long long bytesPerSecond);
+    void setConnections(Direction direction, int connections);
+
+    // Bytes per second, after the bandwidth limit
+    unsigned long long estimatedSpeed(Direction direction, std::chrono::milliseconds now) const;
+    // seconds::max() if it can not be estimated
+    std::chrono::seconds remainingTime(Direction direction, std::chrono::milliseconds now) const;
+    // Both directions run in parallel, so the queue is finished when the slowest one is
+    std::chrono::seconds remainingTime(std::chrono::milliseconds now) const;
+
+    void reset();
+
+private:
+    struct DirectionEstimate
+    {
+        double speed = 0.0;
+        std::chrono::milliseconds lastSample{0};
+        bool hasSample = false;
+        unsigned long long remainingBytes = 0;
+        unsigned long long bandwidthLimit = 0;
+        int connections = 0;
+    };
+
+    std::array<DirectionEstimate, DIRECTIONS> mDirections;
+};
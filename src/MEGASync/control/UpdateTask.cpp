@@ -1,4 +1,5 @@
 #include "UpdateTask.h"
+#include "control/BinaryPatch.h"
 #include "control/Utilities.h"
 #include "platform/Platform.h"
 #include <iostream>
@@ -8,6 +9,8 @@
 using namespace mega;
 using namespace std;
 
+static const int SIGNATURE_CHUNK_SIZE = 64 * 1024;
+
 UpdateTask::UpdateTask(MegaApi *megaApi, QString appFolder, bool isPublic, QObject *parent) :
     QObject(parent)
 {
@@ -16,6 +19,7 @@ UpdateTask::UpdateTask(MegaApi *megaApi, QString appFolder, bool isPublic, QObje
     forceInstall = false;
     running = false;
     forceCheck = false;
+    downloadingPatch = false;
     updateTimer = NULL;
     timeoutTimer = NULL;
     this->megaApi = megaApi;
@@ -155,6 +159,8 @@ void UpdateTask::initialCleanup()
     downloadURLs.clear();
     localPaths.clear();
     fileSignatures.clear();
+    patchURLs.clear();
+    downloadingPatch = false;
     currentFile = -1;
 }
 
@@ -293,6 +299,40 @@ bool UpdateTask::processUpdateFile(QNetworkReply *reply)
         downloadURLs.append(url);
         localPaths.append(localPath);
         fileSignatures.append(fileSignature);
+        patchURLs.append(QString());
+    }
+
+    //Optional list of binary patches: local path, signature of the base file and patch URL.
+    //It isn't covered by the update signature: patched files are checked against the signature
+    //of the full file and they are downloaded again if they don't match
+    while (true)
+    {
+        QString patchPath = readNextLine(reply);
+        if (!patchPath.size())
+        {
+            break;
+        }
+
+        QString baseSignature = readNextLine(reply);
+        QString patchURL = readNextLine(reply);
+        if (!baseSignature.size() || !patchURL.size())
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Invalid update info (incomplete patch entry). Ignoring patches");
+            patchURLs.fill(QString());
+            break;
+        }
+
+        int index = localPaths.indexOf(patchPath);
+        if (index < 0 || patchURLs[index].size())
+        {
+            continue;
+        }
+
+        if (alreadyInstalled(patchPath, baseSignature))
+        {
+            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromUtf8("Binary patch available for: %1").arg(patchPath).toUtf8().constData());
+            patchURLs[index] = patchURL;
+        }
     }
 
     if (!downloadURLs.size())
@@ -392,6 +432,81 @@ bool UpdateTask::processFile(QNetworkReply *reply)
     return true;
 }
 
+bool UpdateTask::processPatch(QNetworkReply *reply)
+{
+    QFile baseFile(appFolder.absoluteFilePath(localPaths[currentFile]));
+    if (!baseFile.open(QIODevice::ReadOnly))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Error opening base file for patching: %1")
+                     .arg(baseFile.fileName()).toUtf8().constData());
+        return false;
+    }
+
+    //Create the folder for the new file
+    QFile localFile(updateFolder.absoluteFilePath(localPaths[currentFile]));
+    QFileInfo info(localFile);
+    info.absoluteDir().mkpath(QString::fromAscii("."));
+
+    //Delete the file if it exists.
+    localFile.remove();
+
+    if (!localFile.open(QIODevice::WriteOnly))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Error opening local file from writting: %1").arg(info.absoluteFilePath()).toUtf8().constData());
+        return false;
+    }
+
+    //The reply is only processed once it's finished, so QNetworkReply has already buffered the
+    //whole patch in memory. Patches are small compared to the full files, as full files are
+    //buffered the same way by processFile
+    BinaryPatch::Result result = BinaryPatch::apply(&baseFile, reply, &localFile);
+    bool flushed = localFile.flush();
+    localFile.close();
+    baseFile.close();
+
+    if (result != BinaryPatch::Result::OK || !flushed)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Error applying patch to %1: %2")
+                     .arg(info.absoluteFilePath())
+                     .arg(flushed ? BinaryPatch::resultToString(result) : QString::fromUtf8("Error flushing file"))
+                     .toUtf8().constData());
+        localFile.remove();
+        return false;
+    }
+
+    //The patched file must match the signature of the full file
+    if (!alreadyDownloaded(localPaths[currentFile], fileSignatures[currentFile]))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Invalid signature of patched file: %1")
+                     .arg(info.absoluteFilePath()).toUtf8().constData());
+        localFile.remove();
+        return false;
+    }
+
+#ifdef _WIN32
+    if (isPublic)
+    {
+        Platform::getInstance()->makePubliclyReadable(QDir::toNativeSeparators(localFile.fileName()));
+    }
+#endif
+
+    return true;
+}
+
+void UpdateTask::downloadCurrentFile()
+{
+    downloadingPatch = patchURLs[currentFile].size();
+    if (downloadingPatch)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromAscii("Downloading patch: %1").arg(patchURLs[currentFile]).toUtf8().constData());
+        downloadFile(patchURLs[currentFile]);
+        return;
+    }
+
+    MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromAscii("Downloading file: %1").arg(downloadURLs[currentFile]).toUtf8().constData());
+    downloadFile(downloadURLs[currentFile]);
+}
+
 bool UpdateTask::performUpdate()
 {
     MegaApi::log(MegaApi::LOG_LEVEL_INFO, "Applying update...");
@@ -490,6 +605,25 @@ bool UpdateTask::alreadyDownloaded(QString relativePath, QString fileSignature)
 
 bool UpdateTask::alreadyExists(QString absolutePath, QString fileSignature)
 {
+    QFileInfo info(absolutePath);
+    if (!info.isFile())
+    {
+        return false;
+    }
+
+    //Files that haven't changed since the last check are not hashed again
+    FileSignatureCacheEntry& cached = signatureCache[absolutePath];
+    if (cached.size != info.size() || cached.lastModified != info.lastModified())
+    {
+        cached.size = info.size();
+        cached.lastModified = info.lastModified();
+        cached.validSignatures.clear();
+    }
+    else if (cached.validSignatures.contains(fileSignature))
+    {
+        return cached.validSignatures.value(fileSignature);
+    }
+
     MegaHashSignature tmpHash((const char *)Preferences::UPDATE_PUBLIC_KEY);
     QFile file(absolutePath);
     if (!file.open(QIODevice::ReadOnly))
@@ -497,11 +631,25 @@ bool UpdateTask::alreadyExists(QString absolutePath, QString fileSignature)
         return false;
     }
 
-    QByteArray bytes = file.readAll();
-    tmpHash.add(bytes.constData(), bytes.size());
+    //Feed the hash in fixed-size chunks to avoid loading the whole file in memory
+    char buffer[SIGNATURE_CHUNK_SIZE];
+    qint64 totalRead = 0;
+    qint64 sizeRead;
+    while ((sizeRead = file.read(buffer, sizeof(buffer))) > 0)
+    {
+        tmpHash.add(buffer, static_cast<unsigned>(sizeRead));
+        totalRead += sizeRead;
+    }
     file.close();
 
-    return tmpHash.checkSignature(fileSignature.toAscii().constData());
+    if (sizeRead < 0 || totalRead != info.size())
+    {
+        return false;
+    }
+
+    bool valid = tmpHash.checkSignature(fileSignature.toAscii().constData());
+    cached.validSignatures.insert(fileSignature, valid);
+    return valid;
 }
 
 void UpdateTask::downloadFinished(QNetworkReply *reply)
@@ -511,7 +659,19 @@ void UpdateTask::downloadFinished(QNetworkReply *reply)
 
     //Check if the request has been successful
     QVariant statusCode = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute );
-    if (!statusCode.isValid() || (statusCode.toInt() != 200) || (reply->error() != QNetworkReply::NoError))
+    bool success = statusCode.isValid() && (statusCode.toInt() == 200) && (reply->error() == QNetworkReply::NoError);
+
+    //Fall back to the full file if the patch can't be downloaded or applied
+    if (currentFile >= 0 && downloadingPatch && (!success || !processPatch(reply)))
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Unable to patch file: %1. Downloading full file")
+                     .arg(localPaths[currentFile]).toUtf8().constData());
+        patchURLs[currentFile].clear();
+        downloadCurrentFile();
+        return;
+    }
+
+    if (!success)
     {
         MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Unable to download file");
         postponeUpdate();
@@ -529,7 +689,7 @@ void UpdateTask::downloadFinished(QNetworkReply *reply)
         }
         emit installingUpdate(forceCheck);
     }
-    else
+    else if (!downloadingPatch)
     {
         //Process the file
         if (!processFile(reply))
@@ -547,8 +707,7 @@ void UpdateTask::downloadFinished(QNetworkReply *reply)
     {
         if (!alreadyDownloaded(localPaths[currentFile], fileSignatures[currentFile]))
         {
-            MegaApi::log(MegaApi::LOG_LEVEL_INFO, QString::fromAscii("Downloading file: %1").arg(downloadURLs[currentFile]).toUtf8().constData());
-            downloadFile(downloadURLs[currentFile]);
+            downloadCurrentFile();
             return;
         }
 
@@ -13,6 +13,7 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QDateTime>
+#include <QHash>
 
 #include "megaapi.h"
 #include "control/Preferences.h"
@@ -33,6 +34,8 @@ protected:
    QString readNextLine(QNetworkReply *reply);
    bool processUpdateFile(QNetworkReply *reply);
    bool processFile(QNetworkReply *reply);
+   bool processPatch(QNetworkReply *reply);
+   void downloadCurrentFile();
    bool performUpdate();
    void rollbackUpdate(int fileNum);
    void addToSignature(QString value);
@@ -43,10 +46,18 @@ protected:
    bool alreadyDownloaded(QString relativePath, QString fileSignature);
    bool alreadyExists(QString absolutePath, QString fileSignature);
 
+   struct FileSignatureCacheEntry
+   {
+       qint64 size = -1;
+       QDateTime lastModified;
+       QHash<QString, bool> validSignatures;
+   };
+
    std::shared_ptr<Preferences> preferences;
    QStringList downloadURLs;
    QStringList localPaths;
    QStringList fileSignatures;
+   QStringList patchURLs;
    QNetworkAccessManager *m_WebCtrl;
    mega::MegaHashSignature *signatureChecker;
    char signature[512];
@@ -61,8 +72,10 @@ protected:
    bool forceInstall;
    bool running;
    bool forceCheck;
+   bool downloadingPatch;
    bool isPublic;
    mega::MegaApi *megaApi;
+   QHash<QString, FileSignatureCacheEntry> signatureCache;
 
 signals:
    void updateCompleted();
@@ -0,0 +1,159 @@
+#include "UserAttributesCache.h"
+
+#include "megaapi.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+
+namespace
+{
+const quint32 FILE_MAGIC = 0x4D554143;
+const quint32 FILE_VERSION = 1;
+}
+
+namespace UserAttributes
+{
+UserAttributesCache::UserAttributesCache(const QString& filePath)
+    : mFilePath(filePath),
+      mDirty(false)
+{
+}
+
+void UserAttributesCache::load(const QString& account)
+{
+    if(account.isEmpty() || account == mAccount)
+    {
+        return;
+    }
+
+    mAccount = account;
+    mEntries.clear();
+    mDirty = false;
+
+    QFile file(mFilePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    quint32 magic(0);
+    quint32 version(0);
+    QString fileAccount;
+    quint32 count(0);
+    stream >> magic >> version;
+    if(magic != FILE_MAGIC || version != FILE_VERSION)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING, "User attributes cache: unknown file format, discarded");
+        return;
+    }
+
+    stream >> fileAccount >> count;
+    if(fileAccount != mAccount)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO, "User attributes cache: file of another account, discarded");
+        return;
+    }
+
+    for(quint32 index = 0; index < count && stream.status() == QDataStream::Ok; ++index)
+    {
+        QPair<QString, int> key;
+        Entry entry;
+        stream >> key.first >> key.second >> entry.value >> entry.updated;
+        if(stream.status() == QDataStream::Ok)
+        {
+            mEntries.insert(key, entry);
+        }
+    }
+
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_DEBUG,
+                       QString::fromUtf8("User attributes cache: %1 values loaded").arg(mEntries.size()).toUtf8().constData());
+}
+
+bool UserAttributesCache::isLoaded() const
+{
+    return !mAccount.isEmpty();
+}
+
+bool UserAttributesCache::find(const QString& user, int attribute, QByteArray& value, bool& stale) const
+{
+    auto it = mEntries.constFind(qMakePair(user, attribute));
+    if(it == mEntries.constEnd())
+    {
+        return false;
+    }
+
+    value = it->value;
+    stale = QDateTime::currentMSecsSinceEpoch() - it->updated > MAX_AGE_MS;
+    return true;
+}
+
+void UserAttributesCache::insert(const QString& user, int attribute, const QByteArray& value)
+{
+    if(!isLoaded())
+    {
+        return;
+    }
+
+    mEntries.insert(qMakePair(user, attribute), Entry{value, QDateTime::currentMSecsSinceEpoch()});
+    mDirty = true;
+}
+
+void UserAttributesCache::remove(const QString& user, int attribute)
+{
+    if(mEntries.remove(qMakePair(user, attribute)))
+    {
+        mDirty = true;
+    }
+}
+
+bool UserAttributesCache::isDirty() const
+{
+    return mDirty;
+}
+
+void UserAttributesCache::save()
+{
+    if(!mDirty || !isLoaded())
+    {
+        return;
+    }
+
+    QSaveFile file(mFilePath);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("User attributes cache: unable to write %1: %2")
+                           .arg(mFilePath, file.errorString()).toUtf8().constData());
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << FILE_MAGIC << FILE_VERSION << mAccount << static_cast<quint32>(mEntries.size());
+    for(auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it)
+    {
+        stream << it.key().first << it.key().second << it->value << it->updated;
+    }
+
+    if(stream.status() == QDataStream::Ok && file.commit())
+    {
+        mDirty = false;
+    }
+}
+
+void UserAttributesCache::clear(bool removeFile)
+{
+    mAccount.clear();
+    mEntries.clear();
+    mDirty = false;
+
+    if(removeFile)
+    {
+        QFile::remove(mFilePath);
+    }
+}
+}
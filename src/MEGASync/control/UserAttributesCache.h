@@ -0,0 +1,53 @@
+#ifndef USERATTRIBUTESCACHE_H
+#define USERATTRIBUTESCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+namespace UserAttributes
+{
+/**
+ * @brief On disk cache of the user attributes
+ *
+ * Keeps on disk the user attributes received from the API, so they are not requested again after a restart.
+ *
+ * The values are stored by user and attribute for a single account: the file of another account or with an
+ * unknown format is discarded. Values older than MAX_AGE_MS are still returned, flagged as stale, so they can
+ * be shown while they are requested again.
+ */
+class UserAttributesCache
+{
+public:
+    static const qint64 MAX_AGE_MS = 24 * 60 * 60 * 1000;
+
+    explicit UserAttributesCache(const QString& filePath);
+
+    void load(const QString& account);
+    bool isLoaded() const;
+
+    bool find(const QString& user, int attribute, QByteArray& value, bool& stale) const;
+    void insert(const QString& user, int attribute, const QByteArray& value);
+    void remove(const QString& user, int attribute);
+
+    bool isDirty() const;
+    void save();
+    // Forgets the account. The file is kept unless removeFile is set
+    void clear(bool removeFile);
+
+private:
+    struct Entry
+    {
+        QByteArray value;
+        qint64 updated;
+    };
+
+    QString mFilePath;
+    QString mAccount;
+    QHash<QPair<QString, int>, Entry> mEntries;
+    bool mDirty;
+};
+}
+
+#endif // USERATTRIBUTESCACHE_H
@@ -5,27 +5,45 @@
 
 #include "megaapi.h"
 #include "mega/types.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QTimer>
+
 #include <assert.h>
 
 
 namespace UserAttributes
 {
 UserAttributesManager::UserAttributesManager() :
-    mDelegateListener(new mega::QTMegaListener(MegaSyncApp->getMegaApi(), this))
+    mDelegateListener(new mega::QTMegaListener(MegaSyncApp->getMegaApi(), this)),
+    mCache(MegaApplication::applicationDataPath() + QDir::separator() + QString::fromLatin1("userattributes.dat")),
+    mCacheSaveScheduled(false)
 {
     MegaSyncApp->getMegaApi()->addListener(mDelegateListener.get());
 }
 
 void UserAttributesManager::reset()
 {
+    mCache.save();
+    mCache.clear(false);
     mRequests.clear();
+    mInFlightRequests.clear();
+    mQueuedRequests.clear();
+    mQueuedRequestsByKey.clear();
+    mMyEmail.clear();
+}
+
+void UserAttributesManager::clearPersistentCache()
+{
+    reset();
+    mCache.clear(true);
 }
 
 void UserAttributesManager::updateEmptyAttributesByUser(const char *user_email)
 {
     QString userEmail = QString::fromUtf8(user_email);
-    auto requests = mRequests.values(userEmail);
-    foreach(auto request, requests)
+    foreach(auto request, mRequests.value(userEmail))
     {
         request->forceRequestAttribute();
     }
@@ -38,17 +56,45 @@ void UserAttributesManager::onRequestFinish(mega::MegaApi *api, mega::MegaReques
             || reqType == mega::MegaRequest::TYPE_SET_ATTR_USER)
     {
         auto userEmail = QString::fromUtf8(incoming_request->getEmail());
+        auto key = getKey(userEmail);
+        auto paramType = incoming_request->getParamType();
+        bool isGetRequest (reqType == mega::MegaRequest::TYPE_GET_ATTR_USER);
 
         // Forward to requests related to the corresponding user
-        foreach(auto request, mRequests.values(getKey(userEmail)))
+        foreach(auto request, mRequests.value(key))
         {
-            if(request->getRequestInfo().mParamInfo.contains(incoming_request->getParamType()))
+            if(request->getRequestInfo().mParamInfo.contains(paramType))
             {
-                auto paramInfo = request->getRequestInfo().mParamInfo.value(incoming_request->getParamType());
+                auto paramInfo = request->getRequestInfo().mParamInfo.value(paramType);
                 paramInfo->setNeedsRetry(e->getErrorCode());
                 paramInfo->setPending(false);
                 request->onRequestFinish(api, incoming_request, e);
+
+                QByteArray value;
+                if(e->getErrorCode() == mega::MegaError::API_OK
+                        && request->getValueToCache(paramType, value) && getCache())
+                {
+                    mCache.insert(key, paramType, value);
+                    scheduleCacheSave();
+                }
+            }
+        }
+
+        if(isGetRequest)
+        {
+            if(e->getErrorCode() == mega::MegaError::API_ENOENT)
+            {
+                mCache.remove(key, paramType);
+                scheduleCacheSave();
+            }
+
+            auto inFlight = mInFlightRequests.find(qMakePair(key, paramType));
+            if(inFlight != mInFlightRequests.end() && --inFlight->pendingAnswers <= 0)
+            {
+                mInFlightRequests.erase(inFlight);
             }
+            expireInFlightRequests();
+            sendQueuedRequests();
         }
 
         if(e && e->getErrorCode() != mega::MegaError::API_OK)
@@ -68,7 +114,8 @@ void UserAttributesManager::onUsersUpdate(mega::MegaApi*, mega::MegaUserList *us
             if(user->isOwnChange() <= 0)
             {
                 auto userEmail = QString::fromUtf8(user->getEmail());
-                foreach(auto request, mRequests.values(getKey(userEmail)))
+                auto key = getKey(userEmail);
+                foreach(auto request, mRequests.value(key))
                 {
                     foreach(auto changeType, request->getRequestInfo().mChangedTypes.keys())
                     {
@@ -77,6 +124,8 @@ void UserAttributesManager::onUsersUpdate(mega::MegaApi*, mega::MegaUserList *us
                             auto paramType = request->getRequestInfo().mChangedTypes.value(changeType, -1);
                             if(paramType >= 0)
                             {
+                                mCache.remove(key, paramType);
+                                scheduleCacheSave();
                                 request->getRequestInfo().mParamInfo.value(paramType)->mNeedsRetry = true;
                                 request->requestUserAttribute(paramType);
                             }
@@ -88,20 +137,111 @@ void UserAttributesManager::onUsersUpdate(mega::MegaApi*, mega::MegaUserList *us
     }
 }
 
-void UserAttributesManager::forceRequestAttribute(const AttributeRequest* request) const
+void UserAttributesManager::forceRequestAttribute(const AttributeRequest* request)
 {
     if(request)
     {
         foreach(auto paramType, request->getRequestInfo().mParamInfo.keys())
         {
-            auto paramInfo = request->getRequestInfo().mParamInfo.value(paramType);
-            paramInfo->mNeedsRetry = true;
-            paramInfo->setPending(true);
-            paramInfo->requestFunc();
+            request->getRequestInfo().mParamInfo.value(paramType)->mNeedsRetry = true;
+            sendRequest(request, paramType);
+        }
+    }
+}
+
+void UserAttributesManager::sendRequest(const AttributeRequest* request, int attribute)
+{
+    auto paramInfo = request->getRequestInfo().mParamInfo.value(attribute);
+    paramInfo->setPending(true);
+
+    // The answer is forwarded to all the requests of the user waiting for the attribute
+    expireInFlightRequests();
+    RequestKey requestKey(getKey(request->getEmail()), attribute);
+    if(mInFlightRequests.contains(requestKey) || mQueuedRequestsByKey.contains(requestKey))
+    {
+        return;
+    }
+
+    mQueuedRequests.append(requestKey);
+    mQueuedRequestsByKey.insert(requestKey, QueuedRequest{paramInfo->requestFunc, paramInfo->mExpectedAnswers});
+    sendQueuedRequests();
+}
+
+void UserAttributesManager::sendQueuedRequests()
+{
+    while(!mQueuedRequests.isEmpty() && mInFlightRequests.size() < MAX_CONCURRENT_REQUESTS)
+    {
+        auto requestKey = mQueuedRequests.takeFirst();
+        auto queuedRequest = mQueuedRequestsByKey.take(requestKey);
+        mInFlightRequests.insert(requestKey, InFlightRequest{QDateTime::currentMSecsSinceEpoch(),
+                                                             queuedRequest.expectedAnswers});
+        queuedRequest.requestFunc();
+    }
+}
+
+void UserAttributesManager::expireInFlightRequests()
+{
+    const qint64 now (QDateTime::currentMSecsSinceEpoch());
+    for(auto it = mInFlightRequests.begin(); it != mInFlightRequests.end();)
+    {
+        if(now - it->sentTime > REQUEST_TIMEOUT_MS)
+        {
+            it = mInFlightRequests.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void UserAttributesManager::restoreFromCache(const QString& key, AttributeRequest* request)
+{
+    if(!getCache())
+    {
+        return;
+    }
+
+    foreach(auto paramType, request->getRequestInfo().mParamInfo.keys())
+    {
+        QByteArray value;
+        bool stale(false);
+        if(mCache.find(key, paramType, value, stale) && request->restoreCachedValue(paramType, value))
+        {
+            // Stale values are shown while they are requested again
+            request->getRequestInfo().mParamInfo.value(paramType)->mNeedsRetry = stale;
         }
     }
 }
 
+// nullptr until the account is known
+UserAttributesCache* UserAttributesManager::getCache()
+{
+    if(!mCache.isLoaded())
+    {
+        std::unique_ptr<char[]> myUserHandle (MegaSyncApp->getMegaApi()->getMyUserHandle());
+        if(!myUserHandle)
+        {
+            return nullptr;
+        }
+        mCache.load(QString::fromUtf8(myUserHandle.get()));
+    }
+    return &mCache;
+}
+
+void UserAttributesManager::scheduleCacheSave()
+{
+    if(!mCacheSaveScheduled && mCache.isDirty())
+    {
+        mCacheSaveScheduled = true;
+        QTimer::singleShot(CACHE_SAVE_DELAY_MS, MegaSyncApp, [this]()
+        {
+            mCacheSaveScheduled = false;
+            mCache.save();
+        });
+    }
+}
+
 void AttributeRequest::RequestInfo::ParamInfo::setNeedsRetry(int errCode)
 {
     mNeedsRetry = !mNoRetryErrCodes.isEmpty() &&!mNoRetryErrCodes.contains(errCode);
@@ -154,20 +294,22 @@ void AttributeRequest::requestUserAttribute(int attribute)
 {
     if(attributeRequestNeedsRetry(attribute))
     {
-        auto val = getRequestInfo().mParamInfo.value(attribute);
-        val->setPending(true);
-        val->requestFunc();
+        UserAttributesManager::instance().sendRequest(this, attribute);
     }
 }
 
-QString UserAttributesManager::getKey(const QString& userEmail) const
+QString UserAttributesManager::getKey(const QString& userEmail)
 {
     // If the email is not empty, use key 'u' for current user.
     QString key (QLatin1Char('u'));
     if (!userEmail.isEmpty())
     {
-        std::unique_ptr<char[]> currentUserEmail (MegaSyncApp->getMegaApi()->getMyEmail());
-        if (userEmail != QString::fromUtf8(currentUserEmail.get()))
+        if (mMyEmail.isEmpty())
+        {
+            std::unique_ptr<char[]> currentUserEmail (MegaSyncApp->getMegaApi()->getMyEmail());
+            mMyEmail = QString::fromUtf8(currentUserEmail.get());
+        }
+        if (userEmail != mMyEmail)
         {
             key = userEmail;
         }
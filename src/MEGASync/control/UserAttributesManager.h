@@ -1,10 +1,14 @@
 #ifndef USERATTRIBUTESMANAGER_H
 #define USERATTRIBUTESMANAGER_H
 
+#include "UserAttributesCache.h"
+
 #include <QTMegaListener.h>
 
+#include <QHash>
+#include <QList>
 #include <QObject>
-#include <QMultiMap>
+#include <QPair>
 #include <QSharedPointer>
 
 #include <memory>
@@ -22,6 +26,7 @@ public:
             QList<int> mNoRetryErrCodes; //if received err code is not in the list failed will be changed to true
             bool mNeedsRetry = true;
             bool mIsPending = false;
+            int mExpectedAnswers = 1; //answers of the SDK to a call of requestFunc
             ParamInfo(const std::function<void()>& func, QList<int> errCodes)
                 : mNoRetryErrCodes(errCodes)
                 , requestFunc(func)
@@ -64,6 +69,11 @@ public:
     void requestUserAttribute(int attribute);
     const RequestInfo& getRequestInfo() const {return mRequestInfo;}
     void initRequestInfo(){mRequestInfo = fillRequestInfo();}
+
+    // Persistent cache: the value of the attribute to store after a successful request, and the value
+    // restored when the request is created. Attributes are not cached unless overridden
+    virtual bool getValueToCache(int, QByteArray&) const {return false;}
+    virtual bool restoreCachedValue(int, const QByteArray&) {return false;}
 protected:
     QString mUserEmail;
     RequestInfo mRequestInfo;
@@ -78,7 +88,16 @@ public:
         return instance;
     }
 
+    // At most this number of attribute requests are sent to the SDK at the same time, the rest are queued
+    static const int MAX_CONCURRENT_REQUESTS = 16;
+    // A request without answer after this time does not count as in flight anymore
+    static const int REQUEST_TIMEOUT_MS = 60000;
+    static const int CACHE_SAVE_DELAY_MS = 5000;
+
+    // Saves the persistent cache and forgets the requests
     void reset();
+    // On logout: the persistent cache is removed too
+    void clearPersistentCache();
 
     template <typename AttributeClass>
     std::shared_ptr<AttributeClass> requestAttribute(const char* user_email = nullptr)
@@ -86,28 +105,24 @@ public:
         QString userEmail = QString::fromUtf8(user_email);
         QString mapKey = getKey(userEmail);
 
-        auto classType = QString::fromUtf8(AttributeClass::staticMetaObject.className());
-
-        auto userRequests = mRequests.values(mapKey);
-        foreach(auto& request, userRequests)
+        auto& userRequests = mRequests[mapKey];
+        auto request = userRequests.value(&AttributeClass::staticMetaObject);
+        if(request)
         {
-            auto requestType = QString::fromUtf8(request->metaObject()->className());
-            if(requestType == classType)
+            foreach(auto paramType, request->getRequestInfo().mParamInfo.keys())
             {
-                foreach(auto paramType, request->getRequestInfo().mParamInfo.keys())
-                {
-                    request->requestUserAttribute(paramType);
-                }
-                return std::dynamic_pointer_cast<AttributeClass>(request);
+                request->requestUserAttribute(paramType);
             }
+            return std::static_pointer_cast<AttributeClass>(request);
         }
 
-        auto request = std::make_shared<AttributeClass>(userEmail);
-        request->initRequestInfo();
-        mRequests.insert(mapKey, std::static_pointer_cast<AttributeRequest>(request));
-        request->requestAttribute();
+        auto newRequest = std::make_shared<AttributeClass>(userEmail);
+        newRequest->initRequestInfo();
+        userRequests.insert(&AttributeClass::staticMetaObject, newRequest);
+        restoreFromCache(mapKey, newRequest.get());
+        newRequest->requestAttribute();
 
-        return request;
+        return newRequest;
     }
 
     void updateEmptyAttributesByUser(const char* user_email);
@@ -118,13 +133,41 @@ private:
     void onRequestFinish(mega::MegaApi *api, mega::MegaRequest *incoming_request, mega::MegaError *e) override;
     void onUsersUpdate(mega::MegaApi *, mega::MegaUserList *users) override;
 
-    void forceRequestAttribute(const AttributeRequest*) const;
+    void forceRequestAttribute(const AttributeRequest*);
+    // Coalesces the requests of the same user and attribute
+    void sendRequest(const AttributeRequest* request, int attribute);
+    void sendQueuedRequests();
+    // Forgets the requests whose answers were not matched, so they do not block their key nor the queue
+    void expireInFlightRequests();
+
+    void restoreFromCache(const QString& key, AttributeRequest* request);
+    UserAttributesCache* getCache();
+    void scheduleCacheSave();
 
     explicit UserAttributesManager();
-    QString getKey(const QString& userEmail) const;
+    QString getKey(const QString& userEmail);
+
+    typedef QPair<QString, int> RequestKey;
+    struct InFlightRequest
+    {
+        qint64 sentTime;
+        int pendingAnswers;
+    };
+    struct QueuedRequest
+    {
+        std::function<void()> requestFunc;
+        int expectedAnswers;
+    };
 
     std::unique_ptr<mega::QTMegaListener> mDelegateListener;
-    QMultiMap<QString, std::shared_ptr<AttributeRequest>> mRequests;
+    // By user key and request class
+    QHash<QString, QHash<const QMetaObject*, std::shared_ptr<AttributeRequest>>> mRequests;
+    QHash<RequestKey, InFlightRequest> mInFlightRequests;
+    QList<RequestKey> mQueuedRequests;
+    QHash<RequestKey, QueuedRequest> mQueuedRequestsByKey;
+    UserAttributesCache mCache;
+    QString mMyEmail;
+    bool mCacheSaveScheduled;
 };
 }
 
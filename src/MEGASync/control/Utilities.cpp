@@ -1,5 +1,8 @@
 
 #include "Utilities.h"
+#include "DirectoryWalker.h"
+#include "FileExtensionTable.h"
+#include "IconCache.h"
 #include "control/Preferences.h"
 
 #include <QApplication>
@@ -23,8 +26,6 @@
 using namespace std;
 using namespace mega;
 
-QHash<QString, QString> Utilities::extensionIcons;
-QHash<QString, Utilities::FileType> Utilities::fileTypes;
 QHash<QString, QString> Utilities::languageNames;
 
 std::unique_ptr<ThreadPool> ThreadPoolSingleton::instance = nullptr;
@@ -32,6 +33,9 @@ std::unique_ptr<ThreadPool> ThreadPoolSingleton::instance = nullptr;
 const QString Utilities::SUPPORT_URL = QString::fromUtf8("https://mega.nz/contact");
 const QString Utilities::BACKUP_CENTER_URL = QString::fromLatin1("mega://#fm/devices");
 
+const QString SMALL_ICON_PREFIX = QString::fromAscii(":/images/small_");
+const QString MEDIUM_ICON_PREFIX = QString::fromAscii(":/images/drag_");
+
 const unsigned long long KB = 1024;
 const unsigned long long MB = 1024 * KB;
 const unsigned long long GB = 1024 * MB;
@@ -42,191 +46,6 @@ const QLatin1String Utilities::FORBIDDEN_CHARS("\\ / : \" * < > \? |");
 // Forbidden chars PCRE using a capture list: [\\/:"\*<>?|]
 const QRegularExpression Utilities::FORBIDDEN_CHARS_RX(QLatin1String("[\\\\/:\"*<>\?|]"));
 
-void Utilities::initializeExtensions()
-{
-    extensionIcons[QString::fromAscii("3ds")] = extensionIcons[QString::fromAscii("3dm")]  = extensionIcons[QString::fromAscii("max")] =
-                            extensionIcons[QString::fromAscii("obj")]  = QString::fromAscii("3D.png");
-
-    extensionIcons[QString::fromAscii("aep")] = extensionIcons[QString::fromAscii("aet")]  = QString::fromAscii("aftereffects.png");
-
-    extensionIcons[QString::fromAscii("mp3")] = extensionIcons[QString::fromAscii("wav")]  = extensionIcons[QString::fromAscii("3ga")]  =
-                            extensionIcons[QString::fromAscii("aif")]  = extensionIcons[QString::fromAscii("aiff")] =
-                            extensionIcons[QString::fromAscii("flac")] = extensionIcons[QString::fromAscii("iff")]  = extensionIcons[QString::fromAscii("ogg")] =
-                            extensionIcons[QString::fromAscii("m4a")]  = extensionIcons[QString::fromAscii("wma")]  =  QString::fromAscii("audio.png");
-
-    extensionIcons[QString::fromAscii("dxf")] = extensionIcons[QString::fromAscii("dwg")] =  QString::fromAscii("cad.png");
-
-
-    extensionIcons[QString::fromAscii("zip")] = extensionIcons[QString::fromAscii("rar")] = extensionIcons[QString::fromAscii("tgz")]  =
-                            extensionIcons[QString::fromAscii("gz")]  = extensionIcons[QString::fromAscii("bz2")]  =
-                            extensionIcons[QString::fromAscii("tbz")] = extensionIcons[QString::fromAscii("tar")]  =
-                            extensionIcons[QString::fromAscii("7z")]  = extensionIcons[QString::fromAscii("sitx")] =  QString::fromAscii("compressed.png");
-
-    extensionIcons[QString::fromAscii("sql")] = extensionIcons[QString::fromAscii("accdb")] = extensionIcons[QString::fromAscii("db")]  =
-                            extensionIcons[QString::fromAscii("dbf")]  = extensionIcons[QString::fromAscii("mdb")]  =
-                            extensionIcons[QString::fromAscii("pdb")] = QString::fromAscii("web_lang.png");
-
-    extensionIcons[QString::fromAscii("folder")] = QString::fromAscii("folder.png");
-
-    extensionIcons[QString::fromAscii("xls")] = extensionIcons[QString::fromAscii("xlsx")] = extensionIcons[QString::fromAscii("xlt")]  =
-                            extensionIcons[QString::fromAscii("xltm")]  = QString::fromAscii("excel.png");
-
-    extensionIcons[QString::fromAscii("exe")] = extensionIcons[QString::fromAscii("com")] = extensionIcons[QString::fromAscii("bin")]  =
-                            extensionIcons[QString::fromAscii("apk")]  = extensionIcons[QString::fromAscii("app")]  =
-                             extensionIcons[QString::fromAscii("msi")]  = extensionIcons[QString::fromAscii("cmd")]  =
-                            extensionIcons[QString::fromAscii("gadget")] = QString::fromAscii("executable.png");
-
-    extensionIcons[QString::fromAscii("fnt")] = extensionIcons[QString::fromAscii("otf")] = extensionIcons[QString::fromAscii("ttf")]  =
-                            extensionIcons[QString::fromAscii("fon")]  = QString::fromAscii("font.png");
-
-    extensionIcons[QString::fromAscii("gif")] = extensionIcons[QString::fromAscii("tiff")]  = extensionIcons[QString::fromAscii("tif")]  =
-                            extensionIcons[QString::fromAscii("bmp")]  = extensionIcons[QString::fromAscii("png")] =
-                            extensionIcons[QString::fromAscii("tga")]  = QString::fromAscii("image.png");
-
-    extensionIcons[QString::fromAscii("ai")] = extensionIcons[QString::fromAscii("ait")] = QString::fromAscii("illustrator.png");
-    extensionIcons[QString::fromAscii("jpg")] = extensionIcons[QString::fromAscii("jpeg")] = extensionIcons[QString::fromAscii("heic")] =
-                            extensionIcons[QString::fromAscii("webp")] = QString::fromAscii("image.png");
-    extensionIcons[QString::fromAscii("indd")] = QString::fromAscii("indesign.png");
-
-    extensionIcons[QString::fromAscii("jar")] = extensionIcons[QString::fromAscii("java")]  = extensionIcons[QString::fromAscii("class")]  = QString::fromAscii("web_data.png");
-
-    extensionIcons[QString::fromAscii("pdf")] = QString::fromAscii("pdf.png");
-    extensionIcons[QString::fromAscii("abr")] = extensionIcons[QString::fromAscii("psb")]  = extensionIcons[QString::fromAscii("psd")]  =
-                            QString::fromAscii("photoshop.png");
-
-    extensionIcons[QString::fromAscii("pps")] = extensionIcons[QString::fromAscii("ppt")]  = extensionIcons[QString::fromAscii("pptx")] = QString::fromAscii("powerpoint.png");
-
-    extensionIcons[QString::fromAscii("prproj")] = extensionIcons[QString::fromAscii("ppj")]  = QString::fromAscii("premiere.png");
-
-    extensionIcons[QString::fromAscii("3fr")] = extensionIcons[QString::fromAscii("arw")]  = extensionIcons[QString::fromAscii("bay")]  =
-                            extensionIcons[QString::fromAscii("cr2")]  = extensionIcons[QString::fromAscii("dcr")] =
-                            extensionIcons[QString::fromAscii("dng")] = extensionIcons[QString::fromAscii("fff")]  =
-                            extensionIcons[QString::fromAscii("mef")] = extensionIcons[QString::fromAscii("mrw")]  =
-                            extensionIcons[QString::fromAscii("nef")] = extensionIcons[QString::fromAscii("pef")]  =
-                            extensionIcons[QString::fromAscii("rw2")] = extensionIcons[QString::fromAscii("srf")]  =
-                            extensionIcons[QString::fromAscii("orf")] = extensionIcons[QString::fromAscii("rwl")]  =
-                            extensionIcons[QString::fromAscii("ari")] = extensionIcons[QString::fromAscii("braw")]  =
-                            extensionIcons[QString::fromAscii("crw")] = extensionIcons[QString::fromAscii("cr3")]  =
-                            extensionIcons[QString::fromAscii("cap")] =
-                            extensionIcons[QString::fromAscii("dcs")] = extensionIcons[QString::fromAscii("drf")]  =
-                            extensionIcons[QString::fromAscii("eip")] = extensionIcons[QString::fromAscii("erf")]  =
-                            extensionIcons[QString::fromAscii("gpr")] = extensionIcons[QString::fromAscii("iiq")]  =
-                            extensionIcons[QString::fromAscii("k25")] = extensionIcons[QString::fromAscii("kdc")]  =
-                            extensionIcons[QString::fromAscii("mdc")] = extensionIcons[QString::fromAscii("mos")]  =
-                            extensionIcons[QString::fromAscii("nrw")] = extensionIcons[QString::fromAscii("obm")]  =
-                            extensionIcons[QString::fromAscii("ptx")] = extensionIcons[QString::fromAscii("pxn")]  =
-                            extensionIcons[QString::fromAscii("r3d")] = extensionIcons[QString::fromAscii("raf")]  =
-                            extensionIcons[QString::fromAscii("raw")] = extensionIcons[QString::fromAscii("rwz")]  =
-                            extensionIcons[QString::fromAscii("sr2")] = extensionIcons[QString::fromAscii("srw")]  =
-                            extensionIcons[QString::fromAscii("tif")] = extensionIcons[QString::fromAscii("x3f")]  =
-                            QString::fromAscii("raw.png");
-
-    extensionIcons[QString::fromAscii("ods")]  = extensionIcons[QString::fromAscii("ots")]  =
-                            extensionIcons[QString::fromAscii("gsheet")]  = extensionIcons[QString::fromAscii("nb")] =
-                            extensionIcons[QString::fromAscii("xlr")] = QString::fromAscii("spreadsheet.png");
-
-    extensionIcons[QString::fromAscii("torrent")] = QString::fromAscii("torrent.png");
-    extensionIcons[QString::fromAscii("dmg")] = QString::fromAscii("dmg.png");
-
-    extensionIcons[QString::fromAscii("txt")] = extensionIcons[QString::fromAscii("rtf")]  = extensionIcons[QString::fromAscii("ans")]  =
-                            extensionIcons[QString::fromAscii("ascii")]  = extensionIcons[QString::fromAscii("log")] =
-                            extensionIcons[QString::fromAscii("odt")] = extensionIcons[QString::fromAscii("wpd")]  =
-                            QString::fromAscii("text.png");
-
-    extensionIcons[QString::fromAscii("svgz")]  = extensionIcons[QString::fromAscii("svg")]  =
-                            extensionIcons[QString::fromAscii("cdr")]  = extensionIcons[QString::fromAscii("eps")] =
-                            QString::fromAscii("vector.png");
-
-     extensionIcons[QString::fromAscii("mkv")]  = extensionIcons[QString::fromAscii("webm")]  =
-                            extensionIcons[QString::fromAscii("avi")]  = extensionIcons[QString::fromAscii("mp4")] =
-                            extensionIcons[QString::fromAscii("m4v")] = extensionIcons[QString::fromAscii("mpg")]  =
-                            extensionIcons[QString::fromAscii("mpeg")] = extensionIcons[QString::fromAscii("mov")]  =
-                            extensionIcons[QString::fromAscii("3g2")] = extensionIcons[QString::fromAscii("3gp")]  =
-                            extensionIcons[QString::fromAscii("asf")] = extensionIcons[QString::fromAscii("wmv")]  =
-                            extensionIcons[QString::fromAscii("flv")] = extensionIcons[QString::fromAscii("vob")] =
-                            QString::fromAscii("video.png");
-
-     extensionIcons[QString::fromAscii("html")]  = extensionIcons[QString::fromAscii("xml")] = extensionIcons[QString::fromAscii("shtml")]  =
-                            extensionIcons[QString::fromAscii("dhtml")] = extensionIcons[QString::fromAscii("js")] =
-                            extensionIcons[QString::fromAscii("css")]  = QString::fromAscii("web_data.png");
-
-     extensionIcons[QString::fromAscii("php")]  = extensionIcons[QString::fromAscii("php3")]  =
-                            extensionIcons[QString::fromAscii("php4")]  = extensionIcons[QString::fromAscii("php5")] =
-                            extensionIcons[QString::fromAscii("phtml")] = extensionIcons[QString::fromAscii("inc")]  =
-                            extensionIcons[QString::fromAscii("asp")] = extensionIcons[QString::fromAscii("pl")]  =
-                            extensionIcons[QString::fromAscii("cgi")] = extensionIcons[QString::fromAscii("py")]  =
-                            QString::fromAscii("web_lang.png");
-
-     extensionIcons[QString::fromAscii("doc")]  = extensionIcons[QString::fromAscii("docx")] = extensionIcons[QString::fromAscii("dotx")]  =
-                            extensionIcons[QString::fromAscii("wps")] = QString::fromAscii("word.png");
-
-     extensionIcons[QString::fromAscii("odt")]  = extensionIcons[QString::fromAscii("ods")] = extensionIcons[QString::fromAscii("odp")]  =
-                            extensionIcons[QString::fromAscii("odb")] = extensionIcons[QString::fromAscii("odg")] = QString::fromAscii("openoffice.png");
-
-     extensionIcons[QString::fromAscii("sketch")] = QString::fromAscii("sketch.png");
-     extensionIcons[QString::fromAscii("xd")] = QString::fromAscii("experiencedesign.png");
-     extensionIcons[QString::fromAscii("pages")] = QString::fromAscii("pages.png");
-     extensionIcons[QString::fromAscii("numbers")] = QString::fromAscii("numbers.png");
-     extensionIcons[QString::fromAscii("key")] = QString::fromAscii("keynote.png");
-}
-
-void Utilities::initializeFileTypes()
-{
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.wav"), QString())]
-            = FileType::TYPE_AUDIO;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.mkv"), QString())]
-            = FileType::TYPE_VIDEO;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.tar"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.torrent"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.dmg"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xd"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.sketch"), QString())]
-            = FileType::TYPE_ARCHIVE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.txt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.odt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.pdf"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.doc"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ods"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.odt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ppt"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.pages"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.numbers"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.key"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xml"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.xls"), QString())]
-            = FileType::TYPE_DOCUMENT;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.png"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.jpg"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.ai"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.abr"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.3fr"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.svg"), QString())]
-            = FileType::TYPE_IMAGE;
-    fileTypes[getExtensionPixmapName(QLatin1Literal("a.bin"), QString())]
-            = FileType::TYPE_OTHER;
-}
-
-
 void Utilities::queueFunctionInAppThread(std::function<void()> fun) {
    QObject temporary;
    QObject::connect(&temporary, &QObject::destroyed, qApp, std::move(fun), Qt::QueuedConnection);
@@ -234,25 +53,7 @@ void Utilities::queueFunctionInAppThread(std::function<void()> fun) {
 
 void Utilities::getFolderSize(QString folderPath, long long *size)
 {
-    if (!folderPath.size())
-    {
-        return;
-    }
-
-    QDir dir(folderPath);
-    QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
-    for (int i = 0; i < entries.size(); i++)
-    {
-        QFileInfo info = entries[i];
-        if (info.isFile())
-        {
-            (*size) += info.size();
-        }
-        else if (info.isDir())
-        {
-            getFolderSize(info.absoluteFilePath(), size);
-        }
-    }
+    (*size) += DirectoryWalker::totalSize(folderPath);
 }
 
 qreal Utilities::getDevicePixelRatio()
@@ -264,29 +65,41 @@ qreal Utilities::getDevicePixelRatio()
 #endif
 }
 
-QString Utilities::getExtensionPixmapName(QString fileName, QString prefix)
+QString Utilities::getExtensionPixmapName(const QString& fileName, const QString& prefix)
 {
-    if (extensionIcons.isEmpty())
-    {
-        initializeExtensions();
-        initializeFileTypes();
-    }
+    auto extension = findExtension(fileName);
+    auto icon = extension ? extension->icon : FileExtensionTable::Icon::GENERIC;
+    return prefix + QLatin1String(FileExtensionTable::ICON_NAMES[toInt(icon)]);
+}
 
-    QFileInfo f(fileName);
-    if (extensionIcons.contains(f.suffix().toLower()))
-    {
-        return QString(extensionIcons[f.suffix().toLower()]).insert(0, prefix);
-    }
-    else
-    {
-        return prefix + QString::fromAscii("generic.png");
-    }
+// The type doesn't depend on the icon set, so the prefix is not needed
+Utilities::FileType Utilities::getFileType(const QString& fileName, const QString&)
+{
+    auto extension = findExtension(fileName);
+    return extension ? FileExtensionTable::iconFileType(extension->icon) : FileType::TYPE_OTHER;
 }
 
-Utilities::FileType Utilities::getFileType(QString fileName, QString prefix)
+// Same suffix as QFileInfo::suffix, read in place from the UTF-16 data of the name
+const FileExtensionTable::Extension* Utilities::findExtension(const QString& fileName)
 {
-    auto extensionPixmapName = getExtensionPixmapName(fileName, prefix);
-    return fileTypes.value(extensionPixmapName,FileType::TYPE_OTHER);
+    const ushort* name = fileName.utf16();
+    for (int i = fileName.size() - 1; i >= 0; --i)
+    {
+        if (name[i] == '.')
+        {
+            return FileExtensionTable::find(name + i + 1, fileName.size() - i - 1);
+        }
+
+#ifdef WIN32
+        if (name[i] == '/' || name[i] == '\\')
+#else
+        if (name[i] == '/')
+#endif
+        {
+            break;
+        }
+    }
+    return nullptr;
 }
 
 QString Utilities::languageCodeToString(QString code)
@@ -352,38 +165,14 @@ QString Utilities::languageCodeToString(QString code)
 }
 
 
-struct IconCache
-{
-    std::map<QString, QIcon> mIcons;
-
-    QIcon& getDirect(QString resourceName)
-    {
-        auto i = mIcons.find(resourceName);
-        if (i == mIcons.end())
-        {
-            auto pair = mIcons.emplace(resourceName, QIcon());
-            i = pair.first;
-            i->second.addFile(resourceName, QSize(), QIcon::Normal, QIcon::Off);
-        }
-        return i->second;
-    }
-
-    QIcon& getByExtension(const QString &fileName, const QString &prefix)
-    {
-        return getDirect(Utilities::getExtensionPixmapName(fileName, prefix));
-    }
-};
-
-IconCache gIconCache;
-
 QString Utilities::getExtensionPixmapNameSmall(QString fileName)
 {
-    return getExtensionPixmapName(fileName, QString::fromAscii(":/images/small_"));
+    return getExtensionPixmapName(fileName, SMALL_ICON_PREFIX);
 }
 
 QString Utilities::getExtensionPixmapNameMedium(QString fileName)
 {
-    return getExtensionPixmapName(fileName, QString::fromAscii(":/images/drag_"));
+    return getExtensionPixmapName(fileName, MEDIUM_ICON_PREFIX);
 }
 
 double Utilities::toDoubleInUnit(unsigned long long bytes, unsigned long long unit)
@@ -494,17 +283,28 @@ unsigned long long Utilities::getNearestUnit(long long bytes)
 
 QIcon Utilities::getCachedPixmap(QString fileName)
 {
-    return gIconCache.getDirect(fileName);
+    return IconCache::instance().getIcon(fileName);
+}
+
+void Utilities::warmUpIconCache()
+{
+    QStringList resources;
+    for (auto iconName : FileExtensionTable::ICON_NAMES)
+    {
+        resources.append(SMALL_ICON_PREFIX + QLatin1String(iconName));
+        resources.append(MEDIUM_ICON_PREFIX + QLatin1String(iconName));
+    }
+    IconCache::instance().warmUp(resources, {}, getDevicePixelRatio());
 }
 
 QIcon Utilities::getExtensionPixmapSmall(QString fileName)
 {
-    return gIconCache.getDirect(getExtensionPixmapNameSmall(fileName));
+    return IconCache::instance().getIcon(getExtensionPixmapNameSmall(fileName));
 }
 
 QIcon Utilities::getExtensionPixmapMedium(QString fileName)
 {
-    return gIconCache.getDirect(getExtensionPixmapNameMedium(fileName));
+    return IconCache::instance().getIcon(getExtensionPixmapNameMedium(fileName));
 }
 
 QString Utilities::getAvatarPath(QString email)
@@ -27,6 +27,11 @@
                              chmod("/Applications/MEGAsync.app/Contents/PlugIns/MEGAShellExtFinder.appex/Contents/MacOS/MEGAShellExtFinder", S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
 #endif
 
+namespace FileExtensionTable
+{
+struct Extension;
+}
+
 #define MegaSyncApp (static_cast<MegaApplication *>(QCoreApplication::instance()))
 
 template <typename E>
@@ -361,11 +366,8 @@ public:
 
 private:
     Utilities() {}
-    static QHash<QString, QString> extensionIcons;
-    static QHash<QString, FileType> fileTypes;
     static QHash<QString, QString> languageNames;
-    static void initializeExtensions();
-    static void initializeFileTypes();
+    static const FileExtensionTable::Extension* findExtension(const QString& fileName);
     static QString getExtensionPixmapNameSmall(QString fileName);
     static QString getExtensionPixmapNameMedium(QString fileName);
     static double toDoubleInUnit(unsigned long long bytes, unsigned long long unit);
@@ -389,10 +391,12 @@ public:
     static qreal getDevicePixelRatio();
 
     static QIcon getCachedPixmap(QString fileName);
+    // Rasterizes the file type icons in the background, so views don't pay for it when first shown
+    static void warmUpIconCache();
     static QIcon getExtensionPixmapSmall(QString fileName);
     static QIcon getExtensionPixmapMedium(QString fileName);
-    static QString getExtensionPixmapName(QString fileName, QString prefix);
-    static FileType getFileType(QString fileName, QString prefix);
+    static QString getExtensionPixmapName(const QString& fileName, const QString& prefix);
+    static FileType getFileType(const QString& fileName, const QString& prefix);
 
     static long long getSystemsAvailableMemory();
 
@@ -0,0 +1,138 @@
+#include "WakeUpScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+WakeUpScheduler::WakeUpScheduler(QObject* parent)
+    : QObject(parent),
+      mIdle(false),
+      mStopped(false)
+{
+    mClock.start();
+    mTimer.setSingleShot(true);
+    // The system can align the wake-up with others
+    mTimer.setTimerType(Qt::CoarseTimer);
+    connect(&mTimer, &QTimer::timeout, this, &WakeUpScheduler::runDueTasks);
+}
+
+void WakeUpScheduler::schedule(const QString& name, qint64 intervalMs, Backoff backoff, Task task, qint64 firstDelayMs)
+{
+    mEntries.insert(name, Entry{intervalMs, backoff, task, mClock.elapsed() + (firstDelayMs < 0 ? intervalMs : firstDelayMs), 1});
+    rearm();
+}
+
+void WakeUpScheduler::scheduleOnce(const QString& name, qint64 delayMs, Task task)
+{
+    qint64 dueMs(mClock.elapsed() + delayMs);
+    auto it = mEntries.find(name);
+    if (it != mEntries.end() && it->intervalMs <= 0)
+    {
+        dueMs = std::min(dueMs, it->dueMs);
+    }
+
+    mEntries.insert(name, Entry{0, FIXED_INTERVAL, task, dueMs, 1});
+    rearm();
+}
+
+void WakeUpScheduler::unschedule(const QString& name)
+{
+    mEntries.remove(name);
+    rearm();
+}
+
+void WakeUpScheduler::runAll()
+{
+    foreach (auto name, mEntries.keys())
+    {
+        run(name);
+    }
+    rearm();
+}
+
+void WakeUpScheduler::stop()
+{
+    mStopped = true;
+    mTimer.stop();
+}
+
+void WakeUpScheduler::setIdle(bool idle)
+{
+    if (mIdle == idle)
+    {
+        return;
+    }
+    mIdle = idle;
+
+    if (!idle)
+    {
+        // Tasks postponed while idle are due again at their normal interval
+        const qint64 now(mClock.elapsed());
+        for (auto& entry : mEntries)
+        {
+            if (entry.backoffFactor > 1)
+            {
+                entry.backoffFactor = 1;
+                entry.dueMs = std::min(entry.dueMs, now + entry.intervalMs);
+            }
+        }
+        rearm();
+    }
+}
+
+void WakeUpScheduler::runDueTasks()
+{
+    const qint64 limit(mClock.elapsed() + COALESCE_WINDOW_MS);
+    foreach (auto name, mEntries.keys())
+    {
+        // A task can unschedule others
+        auto it = mEntries.constFind(name);
+        if (it != mEntries.constEnd() && it->dueMs <= limit)
+        {
+            run(name);
+        }
+    }
+    rearm();
+}
+
+void WakeUpScheduler::run(const QString& name)
+{
+    auto it = mEntries.find(name);
+    if (it == mEntries.end())
+    {
+        return;
+    }
+
+    Task task(it->task);
+    if (it->intervalMs <= 0)
+    {
+        mEntries.erase(it);
+    }
+    else
+    {
+        if (mIdle && it->backoff == BACKOFF_WHEN_IDLE)
+        {
+            it->backoffFactor = std::min(it->backoffFactor * 2, static_cast<int>(MAX_IDLE_BACKOFF));
+        }
+        it->dueMs = mClock.elapsed() + it->intervalMs * it->backoffFactor;
+    }
+
+    task();
+}
+
+void WakeUpScheduler::rearm()
+{
+    if (mStopped || mEntries.isEmpty())
+    {
+        mTimer.stop();
+        return;
+    }
+
+    qint64 nextDueMs(std::numeric_limits<qint64>::max());
+    for (const auto& entry : mEntries)
+    {
+        nextDueMs = std::min(nextDueMs, entry.dueMs);
+    }
+
+    const qint64 delayMs(std::max<qint64>(0, nextDueMs - mClock.elapsed()));
+    mTimer.start(static_cast<int>(std::min<qint64>(delayMs, std::numeric_limits<int>::max())));
+}
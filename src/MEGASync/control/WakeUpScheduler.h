@@ -0,0 +1,73 @@
+#ifndef WAKEUPSCHEDULER_H
+#define WAKEUPSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+/**
+ * @brief Runs the periodic tasks of the application from a single timer
+ *
+ * The timer is only armed for the next task due, and the tasks due within COALESCE_WINDOW_MS of it run in the
+ * same wake-up. While the application is idle, the interval of the tasks that allow it doubles after every
+ * run, up to MAX_IDLE_BACKOFF times the normal one; any activity restores the normal intervals.
+ */
+class WakeUpScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int COALESCE_WINDOW_MS = 1000;
+    static const int MAX_IDLE_BACKOFF = 8;
+
+    enum Backoff
+    {
+        FIXED_INTERVAL,
+        BACKOFF_WHEN_IDLE
+    };
+
+    using Task = std::function<void()>;
+
+    explicit WakeUpScheduler(QObject* parent = nullptr);
+
+    // Replaces the task with the same name. The first run is after firstDelayMs, or after the interval if negative
+    void schedule(const QString& name, qint64 intervalMs, Backoff backoff, Task task, qint64 firstDelayMs = -1);
+    // Runs once. If already scheduled, the earliest time is kept
+    void scheduleOnce(const QString& name, qint64 delayMs, Task task);
+    void unschedule(const QString& name);
+
+    // Runs all the tasks now, and the periodic ones again after their interval
+    void runAll();
+    void stop();
+
+public slots:
+    void setIdle(bool idle);
+
+private slots:
+    void runDueTasks();
+
+private:
+    struct Entry
+    {
+        qint64 intervalMs;
+        Backoff backoff;
+        Task task;
+        qint64 dueMs;
+        int backoffFactor;
+    };
+
+    void run(const QString& name);
+    void rearm();
+
+    QTimer mTimer;
+    QElapsedTimer mClock;
+    QMap<QString, Entry> mEntries;
+    bool mIdle;
+    bool mStopped;
+};
+
+#endif // WAKEUPSCHEDULER_H
@@ -8,19 +8,35 @@ SOURCES += $$PWD/HTTPServer.cpp \
     $$PWD/DownloadQueueController.cpp \
     $$PWD/Preferences.cpp \
     $$PWD/LinkProcessor.cpp \
+    $$PWD/FolderLinkApiPool.cpp \
+    $$PWD/FingerprintCache.cpp \
+    $$PWD/DirectoryWalker.cpp \
+    $$PWD/DebrisCollector.cpp \
+    $$PWD/StartupTracer.cpp \
+    $$PWD/DeferredInitQueue.cpp \
+    $$PWD/LogStreamer.cpp \
+    $$PWD/AppStateStore.cpp \
+    $$PWD/WakeUpScheduler.cpp \
+    $$PWD/NetworkChangeWatcher.cpp \
     $$PWD/MegaUploader.cpp \
     $$PWD/TransferRemainingTime.cpp \
+    $$PWD/TransferQueueEta.cpp \
     $$PWD/UpdateTask.cpp \
+    $$PWD/BinaryPatch.cpp \
     $$PWD/EncryptedSettings.cpp \
     $$PWD/CrashHandler.cpp \
     $$PWD/ExportProcessor.cpp \
     $$PWD/UserAttributesManager.cpp \
+    $$PWD/UserAttributesCache.cpp \
     $$PWD/Utilities.cpp \
+    $$PWD/IconCache.cpp \
     $$PWD/ThreadPool.cpp \
     $$PWD/MegaDownloader.cpp \
     $$PWD/MegaSyncLogger.cpp \
     $$PWD/ConnectivityChecker.cpp \
     $$PWD/TransferBatch.cpp \
+    $$PWD/SyntheticEventGenerator.cpp \
+    $$PWD/SyntheticTransfer.cpp \
     $$PWD/TextDecorator.cpp \
     $$PWD/qrcodegen.c \
 
@@ -30,19 +46,38 @@ HEADERS  +=  $$PWD/HTTPServer.h \
     $$PWD/DownloadQueueController.h \
     $$PWD/Preferences.h \
     $$PWD/LinkProcessor.h \
+    $$PWD/FolderLinkApiPool.h \
+    $$PWD/FingerprintCache.h \
+    $$PWD/DirectoryWalker.h \
+    $$PWD/DebrisCollector.h \
+    $$PWD/StartupTracer.h \
+    $$PWD/DeferredInitQueue.h \
+    $$PWD/LogStreamProtocol.h \
+    $$PWD/LogStreamer.h \
+    $$PWD/AppStateStore.h \
+    $$PWD/WakeUpScheduler.h \
+    $$PWD/NetlinkMessages.h \
+    $$PWD/NetworkChangeWatcher.h \
     $$PWD/MegaUploader.h \
     $$PWD/TransferRemainingTime.h \
+    $$PWD/TransferQueueEta.h \
     $$PWD/UpdateTask.h \
+    $$PWD/BinaryPatch.h \
     $$PWD/EncryptedSettings.h \
     $$PWD/CrashHandler.h \
     $$PWD/ExportProcessor.h \
     $$PWD/UserAttributesManager.h \
+    $$PWD/UserAttributesCache.h \
     $$PWD/Utilities.h \
+    $$PWD/FileExtensionTable.h \
+    $$PWD/IconCache.h \
     $$PWD/ThreadPool.h \
     $$PWD/MegaDownloader.h \
     $$PWD/MegaSyncLogger.h \
     $$PWD/ConnectivityChecker.h \
     $$PWD/TransferBatch.h \
+    $$PWD/SyntheticEventGenerator.h \
+    $$PWD/SyntheticTransfer.h \
     $$PWD/TextDecorator.h \
     $$PWD/Version.h \
     $$PWD/qrcodegen.h \
@@ -249,9 +249,14 @@ void ImportMegaLinksDialog::changeEvent(QEvent *event)
     if (event->type() == QEvent::LanguageChange)
     {
         ui->retranslateUi(this);
-        int totalImports = mLinkProcessor->getCurrentIndex();
-        for (int i = 0; i < totalImports; i++)
-            this->onLinkInfoAvailable(i);
+        //Links are resolved in any order
+        for (int i = 0; i < mLinkProcessor->size(); i++)
+        {
+            if (mLinkProcessor->isResolved(i))
+            {
+                this->onLinkInfoAvailable(i);
+            }
+        }
     }
     QDialog::changeEvent(event);
 }
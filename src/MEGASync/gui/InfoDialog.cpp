@@ -63,7 +63,17 @@ void InfoDialog::pauseResumeHovered(QMouseEvent *event)
 
 void InfoDialog::generalAreaHovered(QMouseEvent *event)
 {
-    QToolTip::showText(event->globalPos(), tr("Open Transfer Manager"));
+    QString toolTip(tr("Open Transfer Manager"));
+
+    auto remainingTime(app->getTransfersModel() ? app->getTransfersModel()->getQueueRemainingTime()
+                                                : std::chrono::seconds::zero());
+    if(remainingTime > std::chrono::seconds::zero() && remainingTime < std::chrono::seconds::max())
+    {
+        toolTip.append(QString::fromUtf8("\n")
+                       + tr("%1 left").arg(Utilities::getTimeString(remainingTime.count(), true, false)));
+    }
+
+    QToolTip::showText(event->globalPos(), toolTip);
 }
 void InfoDialog::dlAreaHovered(QMouseEvent *event)
 {
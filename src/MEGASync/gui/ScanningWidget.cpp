@@ -72,13 +72,15 @@ void ScanningWidget::onReceiveStatusUpdate(const FolderTransferUpdateEvent &even
         case mega::MegaTransfer::STAGE_SCAN:
         {
             mUi->lStepTitle->setText(tr("Scanning"));
-            mUi->lStepDescription->setText(buildScanDescription(event.foldercount, event.filecount));
+            mUi->lStepDescription->setText(buildScanDescription(event.foldercount, event.filecount)
+                                           + buildStageProgress(event));
             break;
         }
         case mega::MegaTransfer::STAGE_CREATE_TREE:
         {
             mUi->lStepTitle->setText(tr("Creating folders"));
-            mUi->lStepDescription->setText(tr("%1/%2").arg(event.createdfoldercount).arg(event.foldercount));
+            mUi->lStepDescription->setText(tr("%1/%2").arg(event.createdfoldercount).arg(event.foldercount)
+                                           + buildStageProgress(event));
             break;
         }
     }
@@ -115,6 +117,22 @@ QString ScanningWidget::buildScanDescription(const uint32_t folderCount, const u
     return tr("found %1, %2").arg(folderStr, fileStr);
 }
 
+// " (150/s, 2 m left)", empty until there is a throughput
+QString ScanningWidget::buildStageProgress(const FolderTransferUpdateEvent& event)
+{
+    if(event.entriesPerSecond < 1.0)
+    {
+        return QString();
+    }
+
+    QString progress = tr("%1/s").arg(Utilities::getQuantityString(static_cast<unsigned long long>(event.entriesPerSecond)));
+    if(event.remainingSeconds >= 0)
+    {
+        progress = tr("%1, %2 left").arg(progress, Utilities::getTimeString(event.remainingSeconds, true, false));
+    }
+    return QString::fromLatin1(" (%1)").arg(progress);
+}
+
 void ScanningWidget::setRole(QObject *object, const char *name)
 {
     object->setProperty("role", QString::fromLatin1(name));
@@ -37,6 +37,7 @@ private:
     void startAnimation();
 
     static QString buildScanDescription(const uint32_t folderCount, const uint32_t fileCount);
+    static QString buildStageProgress(const FolderTransferUpdateEvent& event);
 
     static void setRole(QObject* object, const char* name);
 
@@ -3,6 +3,7 @@
 #include "QMegaMessageBox.h"
 #include "ui_SettingsDialog.h"
 #include "control/Utilities.h"
+#include "control/DirectoryWalker.h"
 #include "platform/Platform.h"
 #include "AddExclusionDialog.h"
 #include "BandwidthSettings.h"
@@ -76,8 +77,8 @@ long long calculateCacheSize()
             QString syncPath = syncSetting->getLocalFolder();
             if (!syncPath.isEmpty())
             {
-                Utilities::getFolderSize(syncPath + QDir::separator()
-                                         + QString::fromUtf8(MEGA_DEBRIS_FOLDER), &cacheSize);
+                cacheSize += DirectoryWalker::totalSize(syncPath + QDir::separator()
+                                                        + QString::fromUtf8(MEGA_DEBRIS_FOLDER));
             }
         }
     }
@@ -650,11 +651,6 @@ void SettingsDialog::loadSettings()
 
 // General -----------------------------------------------------------------------------------------
 
-void deleteCache()
-{
-    MegaSyncApp->cleanLocalCaches(true);
-}
-
 void deleteRemoteCache(MegaApi* mMegaApi)
 {
     MegaNode* n = mMegaApi->getNodeByPath("//bin/SyncDebris");
@@ -905,7 +901,8 @@ void SettingsDialog::on_bClearCache_clicked()
     {
         if(msg->result() == QMessageBox::Yes)
         {
-            QtConcurrent::run(deleteCache);
+            // Only queues the folders, they are deleted in the background
+            MegaSyncApp->cleanLocalCaches(true);
             mCacheSize = 0;
             onCacheSizeAvailable();
         }
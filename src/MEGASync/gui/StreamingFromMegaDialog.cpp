@@ -24,7 +24,7 @@ const uint8_t StreamingFromMegaDialog::NODE_ID = 0;
 
 using namespace mega;
 
-StreamingFromMegaDialog::StreamingFromMegaDialog(mega::MegaApi *megaApi, mega::MegaApi* megaApiFolders, QWidget *parent) :
+StreamingFromMegaDialog::StreamingFromMegaDialog(mega::MegaApi *megaApi, FolderLinkApiPool* folderLinkApiPool, QWidget *parent) :
     QDialog(parent),
     ui(::mega::make_unique<Ui::StreamingFromMegaDialog>()),
     mLinkProcessor(nullptr),
@@ -37,7 +37,7 @@ StreamingFromMegaDialog::StreamingFromMegaDialog(mega::MegaApi *megaApi, mega::M
     this->setWindowFlags(flags);
 
     this->megaApi = megaApi;
-    this->mMegaApiFolders = megaApiFolders;
+    this->mFolderLinkApiPool = folderLinkApiPool;
     this->megaApi->httpServerSetMaxBufferSize(MAX_STREAMING_BUFFER_SIZE);
 
     int port = 4443;
@@ -139,7 +139,7 @@ void StreamingFromMegaDialog::requestNodeToLinkProcessor()
         return;
     }
 
-    mLinkProcessor = new LinkProcessor(QStringList() << mPublicLink, megaApi, mMegaApiFolders);
+    mLinkProcessor = new LinkProcessor(QStringList() << mPublicLink, megaApi, mFolderLinkApiPool);
     mLinkProcessor->setParentHandler(this);
     connect(mLinkProcessor, &LinkProcessor::onLinkInfoRequestFinish, this, &StreamingFromMegaDialog::onLinkInfoAvailable);
 
@@ -25,7 +25,7 @@ public:
     enum class LinkStatus {LOADING=0, CORRECT, WARNING, TRANSFER_OVER_QUOTA};
     enum class LastStreamingSelection {NOT_SELECTED=0, FROM_LOCAL_NODE, FROM_PUBLIC_NODE};
 
-    explicit StreamingFromMegaDialog(mega::MegaApi *megaApi,mega::MegaApi* megaApiFolders, QWidget *parent = 0);
+    explicit StreamingFromMegaDialog(mega::MegaApi *megaApi, FolderLinkApiPool* folderLinkApiPool, QWidget *parent = 0);
     ~StreamingFromMegaDialog();
 
     void onTransferTemporaryError(mega::MegaApi *api, mega::MegaTransfer *transfer, mega::MegaError* e) override;
@@ -52,7 +52,7 @@ private:
     std::unique_ptr<Ui::StreamingFromMegaDialog> ui;
     LinkProcessor* mLinkProcessor;
     mega::MegaApi *megaApi;
-    mega::MegaApi* mMegaApiFolders;
+    FolderLinkApiPool* mFolderLinkApiPool;
     std::unique_ptr<mega::QTMegaTransferListener> delegateTransferListener;
     std::shared_ptr<mega::MegaNode> mSelectedMegaNode;
     QString streamURL;
@@ -2,6 +2,7 @@
 #include "node_selector/model/NodeSelectorModelSpecialised.h"
 #include "MegaApplication.h"
 #include "Utilities.h"
+#include "IconCache.h"
 #include "Preferences.h"
 #include "syncs/control/SyncInfo.h"
 #include "UserAttributesRequests/CameraUploadFolder.h"
@@ -1052,43 +1053,31 @@ QIcon NodeSelectorModel::getFolderIcon(NodeSelectorModelItem *item) const
                 if(node->getHandle() == mCameraFolderAttribute->getCameraUploadFolderHandle()
                         || node->getHandle() == mCameraFolderAttribute->getCameraUploadFolderSecondaryHandle())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/icons/folder/small-camera-sync.png"), QSize(), QIcon::Normal);
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-camera-sync-disabled.png"), QSize(), QIcon::Disabled);
-                    return icon;;
+                    return IconCache::instance().getIcon(QLatin1String("://images/icons/folder/small-camera-sync.png"),
+                                                         QLatin1String("://images/icons/folder/small-folder-camera-sync-disabled.png"));
                 }
                 else if(node->getHandle() == mMyChatFilesFolderAttribute->getMyChatFilesFolderHandle())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/icons/folder/small-chat-files.png"), QSize(), QIcon::Normal);
-                    icon.addFile(QLatin1String("://images/icons/folder/small-chat-files-disabled.png"), QSize(), QIcon::Disabled);
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/icons/folder/small-chat-files.png"),
+                                                         QLatin1String("://images/icons/folder/small-chat-files-disabled.png"));
                 }
                 else if (node->isInShare())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-incoming.png"), QSize(), QIcon::Normal);
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-incoming-disabled.png"), QSize(), QIcon::Disabled);
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/icons/folder/small-folder-incoming.png"),
+                                                         QLatin1String("://images/icons/folder/small-folder-incoming-disabled.png"));
                 }
                 else if (node->isOutShare())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-outgoing.png"), QSize(), QIcon::Normal);
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-outgoing-disabled.png"), QSize(), QIcon::Disabled);
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/icons/folder/small-folder-outgoing.png"),
+                                                         QLatin1String("://images/icons/folder/small-folder-outgoing-disabled.png"));
                 }
                 else if(node->getHandle() == MegaSyncApp->getRootNode()->getHandle())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/ico-cloud-drive.png"));
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/ico-cloud-drive.png"));
                 }
                 else if(item->isVault())
                 {
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/node_selector/Backups_small_ico.png"));
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/node_selector/Backups_small_ico.png"));
                 }
                 else
                 {
@@ -1099,20 +1088,18 @@ QIcon NodeSelectorModel::getFolderIcon(NodeSelectorModelItem *item) const
                         if (nodeDeviceId == QString::fromUtf8(MegaSyncApp->getMegaApi()->getDeviceId()))
                         {
 #ifdef Q_OS_WINDOWS
-                            const QIcon thisDeviceIcon (QLatin1String("://images/icons/pc/pc-win_24.png"));
+                            const QIcon thisDeviceIcon (IconCache::instance().getIcon(QLatin1String("://images/icons/pc/pc-win_24.png")));
 #elif defined(Q_OS_MACOS)
-                            const QIcon thisDeviceIcon (QLatin1String("://images/icons/pc/pc-mac_24.png"));
+                            const QIcon thisDeviceIcon (IconCache::instance().getIcon(QLatin1String("://images/icons/pc/pc-mac_24.png")));
 #elif defined(Q_OS_LINUX)
-                            const QIcon thisDeviceIcon (QLatin1String("://images/icons/pc/pc-linux_24.png"));
+                            const QIcon thisDeviceIcon (IconCache::instance().getIcon(QLatin1String("://images/icons/pc/pc-linux_24.png")));
 #endif
                             return thisDeviceIcon;
                         }
-                        return QIcon(QLatin1String("://images/icons/pc/pc_24.png"));
+                        return IconCache::instance().getIcon(QLatin1String("://images/icons/pc/pc_24.png"));
                     }
-                    QIcon icon;
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder.png"), QSize(), QIcon::Normal);
-                    icon.addFile(QLatin1String("://images/icons/folder/small-folder-disabled.png"), QSize(), QIcon::Disabled);
-                    return icon;
+                    return IconCache::instance().getIcon(QLatin1String("://images/icons/folder/small-folder.png"),
+                                                         QLatin1String("://images/icons/folder/small-folder-disabled.png"));
                 }
             }
             else
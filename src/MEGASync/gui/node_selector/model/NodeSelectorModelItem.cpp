@@ -321,8 +321,7 @@ void NodeSelectorModelItem::calculateSyncStatus()
         break;
     }
     }
-    auto syncedFolders = SyncInfo::instance()->getMegaFolderHandles(SyncInfo::AllHandledSyncTypes);
-    if(syncedFolders.contains(mNode->getHandle()))
+    if(SyncInfo::instance()->isSyncedMegaFolder(mNode->getHandle()))
     {
         mStatus = Status::SYNC;
         return;
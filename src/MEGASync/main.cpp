@@ -4,6 +4,7 @@
 #include "qtlockedfile/qtlockedfile.h"
 #include "control/AppStatsEvents.h"
 #include "control/CrashHandler.h"
+#include "control/StartupTracer.h"
 #include "ScaleFactorManager.h"
 #include "PowerOptions.h"
 
@@ -489,7 +490,10 @@ int main(int argc, char *argv[])
     }
 
 #ifndef DEBUG
-    CrashHandler::instance()->Init(QDir::toNativeSeparators(crashPath));
+    {
+        StartupTracer::Span span("crash handler init");
+        CrashHandler::instance()->Init(QDir::toNativeSeparators(crashPath));
+    }
 #endif
 
     QtLockedFile singleInstanceChecker(appLockPath);
@@ -560,27 +564,43 @@ int main(int argc, char *argv[])
         freeStaticResources();
         return 0;
     }
-    Platform::getInstance()->initialize(argc, argv);
+    {
+        StartupTracer::Span span("platform init");
+        Platform::getInstance()->initialize(argc, argv);
+    }
 
+    {
+        StartupTracer::Span span("register fonts");
 #if !defined(__APPLE__) && !defined (_WIN32)
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/OpenSans-Regular.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/OpenSans-Semibold.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/OpenSans-Regular.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/OpenSans-Semibold.ttf"));
 
-    QFont font(QString::fromUtf8("Open Sans"), 8);
-    app.setFont(font);
+        QFont font(QString::fromUtf8("Open Sans"), 8);
+        app.setFont(font);
 #endif
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Light.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Bold.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Regular.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Semibold.ttf"));
-
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Light.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Bold.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Regular.ttf"));
-    QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Semibold.ttf"));
-
-    app.initialize();
-    app.start();
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Light.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Bold.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Regular.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/Lato-Semibold.ttf"));
+    }
+
+    // Only used by the plans in the upgrade dialog
+    app.getDeferredInitQueue()->enqueue(DeferredInitQueue::PRIORITY_LOW, "register plan fonts", []()
+    {
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Light.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Bold.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Regular.ttf"));
+        QFontDatabase::addApplicationFont(QString::fromUtf8("://fonts/SourceSansPro-Semibold.ttf"));
+    });
+
+    {
+        StartupTracer::Span span("MegaApplication::initialize");
+        app.initialize();
+    }
+    {
+        StartupTracer::Span span("MegaApplication::start");
+        app.start();
+    }
 
     int toret = app.exec();
 
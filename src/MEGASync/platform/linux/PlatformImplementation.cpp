@@ -212,58 +212,7 @@ QString PlatformImplementation::getDefaultOpenApp(QString extension)
 
 QString PlatformImplementation::getDefaultOpenAppByMimeType(QString mimeType)
 {
-    QString getDefaultAppDesktopFileName = QString::fromUtf8("xdg-mime query default ") + mimeType;
-
-    QProcess process;
-    process.start(getDefaultAppDesktopFileName,
-                  QIODevice::ReadWrite | QIODevice::Text);
-    if(!process.waitForFinished(5000))
-    {
-        return QString();
-    }
-
-    QString desktopFileName = QString::fromUtf8(process.readAllStandardOutput());
-    desktopFileName = desktopFileName.trimmed();
-    desktopFileName.replace(QString::fromUtf8(";"), QString::fromUtf8(""));
-    if (!desktopFileName.size())
-    {
-        return QString();
-    }
-
-    QFileInfo desktopFile(QString::fromUtf8("/usr/share/applications/") + desktopFileName);
-    if (!desktopFile.exists())
-    {
-        return QString();
-    }
-
-    QFile f(desktopFile.absoluteFilePath());
-    if (!f.open(QFile::ReadOnly | QFile::Text))
-    {
-        return QString();
-    }
-
-    QTextStream in(&f);
-    QStringList contents = in.readAll().split(QString::fromUtf8("\n"));
-    contents = contents.filter(QRegExp(QString::fromUtf8("^Exec=")));
-    if (!contents.size())
-    {
-        return QString();
-    }
-
-    QString line = contents.first();
-    int index = line.indexOf(QChar::fromAscii('%'));
-    int size = -1;
-    if (index != -1)
-    {
-        size = index - 6;
-    }
-
-    if (!size)
-    {
-        return QString();
-    }
-
-    return line.mid(5, size);
+    return mMimeResolver.defaultAppCommand(mimeType);
 }
 
 bool PlatformImplementation::getValue(const char * const name, const bool default_value)
@@ -351,57 +300,36 @@ bool PlatformImplementation::registerUpdateJob()
 // for communications with the webclient
 bool PlatformImplementation::shouldRunHttpServer()
 {
-    QStringList data = getListRunningProcesses();
-    if (data.size() > 1)
-    {
-        for (int i = 1; i < data.size(); i++)
-        {
-            // The MEGA webclient sends request to MEGAsync to improve the
-            // user experience. We check if web browsers are running because
-            // otherwise it isn't needed to run the local web server for this purpose.
-            // Here is the list or web browsers that allow HTTP communications
-            // with 127.0.0.1 inside HTTPS webs.
-            QString command = data.at(i).trimmed();
-            if (command.contains(QString::fromUtf8("firefox"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("chrome"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("chromium"), Qt::CaseInsensitive)
-                    )
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    // The MEGA webclient sends request to MEGAsync to improve the
+    // user experience. We check if web browsers are running because
+    // otherwise it isn't needed to run the local web server for this purpose.
+    // Here is the list or web browsers that allow HTTP communications
+    // with 127.0.0.1 inside HTTPS webs.
+    static const QStringList browsers {
+        QString::fromUtf8("firefox"),
+        QString::fromUtf8("chrome"),
+        QString::fromUtf8("chromium")
+    };
+    return isAnyProcessRunning(browsers);
 }
 
 // Check if it's needed to start the local HTTPS server
 // for communications with the webclient
 bool PlatformImplementation::shouldRunHttpsServer()
 {
-    QStringList data = getListRunningProcesses();
-
-    if (data.size() > 1)
-    {
-        for (int i = 1; i < data.size(); i++)
-        {
-            // The MEGA webclient sends request to MEGAsync to improve the
-            // user experience. We check if web browsers are running because
-            // otherwise it isn't needed to run the local web server for this purpose.
-            // Here is the list or web browsers that don't allow HTTP communications
-            // with 127.0.0.1 inside HTTPS webs and therefore require a HTTPS server.
-            QString command = data.at(i).trimmed();
-            if (command.contains(QString::fromUtf8("safari"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("iexplore"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("opera"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("iceweasel"), Qt::CaseInsensitive)
-                    || command.contains(QString::fromUtf8("konqueror"), Qt::CaseInsensitive)
-                    )
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    // The MEGA webclient sends request to MEGAsync to improve the
+    // user experience. We check if web browsers are running because
+    // otherwise it isn't needed to run the local web server for this purpose.
+    // Here is the list or web browsers that don't allow HTTP communications
+    // with 127.0.0.1 inside HTTPS webs and therefore require a HTTPS server.
+    static const QStringList browsers {
+        QString::fromUtf8("safari"),
+        QString::fromUtf8("iexplore"),
+        QString::fromUtf8("opera"),
+        QString::fromUtf8("iceweasel"),
+        QString::fromUtf8("konqueror")
+    };
+    return isAnyProcessRunning(browsers);
 }
 
 bool PlatformImplementation::isUserActive()
@@ -469,33 +397,11 @@ void PlatformImplementation::fileAndFolderSelector(QString title, QString defaul
     AbstractPlatform::fileAndFolderSelector(title, defaultDir, multiSelection, parent, func);
 }
 
-QStringList PlatformImplementation::getListRunningProcesses()
+// Only the processes started since the previous check are read from /proc
+bool PlatformImplementation::isAnyProcessRunning(const QStringList& patterns)
 {
-    QProcess p;
-    p.start(QString::fromUtf8("ps ax -o comm"));
-    p.waitForFinished(2000);
-    QString output = QString::fromUtf8(p.readAllStandardOutput().constData());
-    QString e = QString::fromUtf8(p.readAllStandardError().constData());
-    if (e.size())
-    {
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error for \"ps ax -o comm\" command:");
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, e.toUtf8().constData());
-    }
-
-    p.start(QString::fromUtf8("/bin/bash -c \"readlink /proc/*/exe\""));
-    p.waitForFinished(2000);
-    QString output2 = QString::fromUtf8(p.readAllStandardOutput().constData());
-    e = QString::fromUtf8(p.readAllStandardError().constData());
-    if (e.size())
-    {
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error for \"readlink /proc/*/exe\" command:");
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, e.toUtf8().constData());
-    }
-    QStringList data = output.split(QString::fromUtf8("\n"));
-
-    data.append(output2.split(QString::fromUtf8("\n")));
-
-    return data;
+    mProcessScanner.scan();
+    return mProcessScanner.isAnyRunning(patterns);
 }
 
 xcb_atom_t PlatformImplementation::getAtom(xcb_connection_t * const connection, const char *name)
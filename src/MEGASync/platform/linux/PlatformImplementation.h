@@ -5,6 +5,8 @@
 
 #include "ExtServer.h"
 #include "NotifyServer.h"
+#include "ProcFsScanner.h"
+#include "XdgMimeResolver.h"
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
 
@@ -45,11 +47,13 @@ public:
     virtual void fileAndFolderSelector(QString title, QString defaultDir, bool multiSelection, QWidget *parent, std::function<void(QStringList)> func) override;
 
 private:
-    QStringList getListRunningProcesses();
+    bool isAnyProcessRunning(const QStringList& patterns);
     static xcb_atom_t getAtom(xcb_connection_t * const connection, const char *name);
 
     ExtServer *ext_server = nullptr;
     NotifyServer *notify_server = nullptr;
+    ProcFsScanner mProcessScanner;
+    XdgMimeResolver mMimeResolver;
     QString autostart_dir;
     QString desktop_file;
     QString set_icon;
@@ -0,0 +1,201 @@
+#include "ProcFsScanner.h"
+
+#include "megaapi.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+// Layout of the records returned by getdents64, not exported by glibc
+struct LinuxDirent64
+{
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Enough for a few hundred entries per call
+const size_t DIRENTS_BUFFER_SIZE = 32 * 1024;
+
+pid_t parsePid(const char* name)
+{
+    pid_t pid = 0;
+    for(; *name; ++name)
+    {
+        if(*name < '0' || *name > '9')
+        {
+            return 0;
+        }
+        pid = pid * 10 + (*name - '0');
+    }
+    return pid;
+}
+}
+
+QList<ProcFsScanner::Process> ProcFsScanner::scan()
+{
+    QList<Process> started;
+
+    int procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(procFd < 0)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Unable to open /proc: %1")
+                           .arg(QString::fromUtf8(strerror(errno))).toUtf8().constData());
+        return started;
+    }
+
+    QHash<pid_t, Process> running;
+    running.reserve(mProcesses.size());
+
+    alignas(LinuxDirent64) char buffer[DIRENTS_BUFFER_SIZE];
+    long bytesRead;
+    while((bytesRead = syscall(SYS_getdents64, procFd, buffer, sizeof(buffer))) > 0)
+    {
+        for(long offset = 0; offset < bytesRead;)
+        {
+            auto entry = reinterpret_cast<LinuxDirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+
+            if(entry->d_type != DT_DIR)
+            {
+                continue;
+            }
+
+            pid_t pid = parsePid(entry->d_name);
+            if(pid <= 0)
+            {
+                continue;
+            }
+
+            //Pids are recycled, a known pid with another start time is a new process
+            unsigned long long startTime = readStartTime(procFd, pid);
+            auto known = mProcesses.constFind(pid);
+            if(known != mProcesses.constEnd() && known->startTime == startTime)
+            {
+                running.insert(pid, known.value());
+            }
+            else
+            {
+                Process process = readProcess(procFd, pid);
+                process.startTime = startTime;
+                running.insert(pid, process);
+                started.append(process);
+            }
+        }
+    }
+
+    if(bytesRead < 0)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Error listing /proc: %1")
+                           .arg(QString::fromUtf8(strerror(errno))).toUtf8().constData());
+    }
+
+    close(procFd);
+    mProcesses.swap(running);
+    return started;
+}
+
+bool ProcFsScanner::matches(const Process& process, const QStringList& patterns)
+{
+    foreach(auto pattern, patterns)
+    {
+        if(process.name.contains(pattern, Qt::CaseInsensitive)
+                || process.executable.contains(pattern, Qt::CaseInsensitive))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ProcFsScanner::isAnyRunning(const QStringList& patterns) const
+{
+    foreach(auto process, mProcesses)
+    {
+        if(matches(process, patterns))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Processes can exit at any moment, so the fields that can't be read are left empty
+ProcFsScanner::Process ProcFsScanner::readProcess(int procFd, pid_t pid)
+{
+    Process process;
+    process.pid = pid;
+    process.startTime = 0;
+
+    char path[32];
+    snprintf(path, sizeof(path), "%d/comm", pid);
+    int commFd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if(commFd >= 0)
+    {
+        char comm[64];
+        ssize_t length = read(commFd, comm, sizeof(comm));
+        if(length > 0)
+        {
+            process.name = QString::fromUtf8(comm, static_cast<int>(length)).trimmed();
+        }
+        close(commFd);
+    }
+
+    snprintf(path, sizeof(path), "%d/exe", pid);
+    char executable[PATH_MAX];
+    ssize_t length = readlinkat(procFd, path, executable, sizeof(executable));
+    if(length > 0)
+    {
+        process.executable = QString::fromUtf8(executable, static_cast<int>(length));
+    }
+
+    return process;
+}
+
+// Field 22 of /proc/<pid>/stat. The name in field 2 can contain spaces and parentheses, so the
+// fields are counted from the last parenthesis
+unsigned long long ProcFsScanner::readStartTime(int procFd, pid_t pid)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "%d/stat", pid);
+    int statFd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if(statFd < 0)
+    {
+        return 0;
+    }
+
+    char stat[1024];
+    ssize_t length = read(statFd, stat, sizeof(stat) - 1);
+    close(statFd);
+    if(length <= 0)
+    {
+        return 0;
+    }
+    stat[length] = '\0';
+
+    const char* field = strrchr(stat, ')');
+    if(!field)
+    {
+        return 0;
+    }
+
+    //Fields 3 to 21 are skipped
+    for(int skipped = 0; skipped < 20 && field; ++skipped)
+    {
+        field = strchr(field + 1, ' ');
+    }
+    return field ? strtoull(field + 1, nullptr, 10) : 0;
+}
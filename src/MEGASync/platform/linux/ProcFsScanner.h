@@ -0,0 +1,43 @@
+#ifndef PROCFSSCANNER_H
+#define PROCFSSCANNER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <sys/types.h>
+
+/**
+ * @brief Lists the running processes by reading /proc directly, without spawning any command
+ *
+ * The scan is incremental: the name and the executable of a process are only read the first time its pid and
+ * start time are seen, so calling scan() periodically to detect new processes costs little more than listing
+ * /proc and reading the start time of each process.
+ */
+class ProcFsScanner
+{
+public:
+    struct Process
+    {
+        pid_t pid;
+        unsigned long long startTime;  // Clock ticks since boot, tells apart the processes reusing a pid
+        QString name;        // From /proc/<pid>/comm
+        QString executable;  // Target of /proc/<pid>/exe, empty if it can't be read
+    };
+
+    // Updates the list of running processes and returns the ones that were not running in the previous scan
+    QList<Process> scan();
+
+    // Case insensitive substring match of any of the patterns with the name or the executable
+    static bool matches(const Process& process, const QStringList& patterns);
+    bool isAnyRunning(const QStringList& patterns) const;
+
+private:
+    static Process readProcess(int procFd, pid_t pid);
+    static unsigned long long readStartTime(int procFd, pid_t pid);
+
+    QHash<pid_t, Process> mProcesses;
+};
+
+#endif // PROCFSSCANNER_H
@@ -0,0 +1,293 @@
+#include "XdgMimeResolver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTextStream>
+
+namespace
+{
+const QString DESKTOP_ENTRY_GROUP = QString::fromUtf8("[Desktop Entry]");
+const QString DEFAULT_APPS_GROUP = QString::fromUtf8("[Default Applications]");
+const QString ADDED_ASSOCIATIONS_GROUP = QString::fromUtf8("[Added Associations]");
+const QString REMOVED_ASSOCIATIONS_GROUP = QString::fromUtf8("[Removed Associations]");
+
+QStringList envPaths(const char* name, const QString& defaultValue)
+{
+    QString value = QString::fromLocal8Bit(qgetenv(name));
+    if(value.isEmpty())
+    {
+        value = defaultValue;
+    }
+    return value.split(QLatin1Char(':'), QString::SkipEmptyParts);
+}
+
+QStringList splitList(const QString& value)
+{
+    return value.split(QLatin1Char(';'), QString::SkipEmptyParts);
+}
+
+// Calls the function with the group, key and value of every entry of a desktop entry style file
+template <typename Function>
+void forEachEntry(const QString& path, Function function)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        return;
+    }
+
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    QString group;
+    while(!in.atEnd())
+    {
+        const QString line = in.readLine().trimmed();
+        if(line.isEmpty() || line.startsWith(QLatin1Char('#')))
+        {
+            continue;
+        }
+
+        if(line.startsWith(QLatin1Char('[')))
+        {
+            group = line;
+            continue;
+        }
+
+        const int separator = line.indexOf(QLatin1Char('='));
+        if(separator > 0)
+        {
+            function(group, line.left(separator).trimmed(), line.mid(separator + 1).trimmed());
+        }
+    }
+}
+}
+
+XdgMimeResolver::XdgMimeResolver(QObject* parent)
+    : QObject(parent),
+      mWatcher(nullptr),
+      mIndexed(false)
+{
+}
+
+QString XdgMimeResolver::defaultAppCommand(const QString& mimeType)
+{
+    if(!mIndexed)
+    {
+        rebuild();
+    }
+
+    auto cached = mResolved.constFind(mimeType);
+    if(cached != mResolved.constEnd())
+    {
+        return cached.value();
+    }
+
+    const QString command = resolve(mimeType);
+    mResolved.insert(mimeType, command);
+    return command;
+}
+
+void XdgMimeResolver::onWatchedPathChanged()
+{
+    // Several files usually change at once, the index is rebuilt on the next query
+    mIndexed = false;
+}
+
+void XdgMimeResolver::rebuild()
+{
+    if(!mWatcher)
+    {
+        mWatcher = new QFileSystemWatcher(this);
+        connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &XdgMimeResolver::onWatchedPathChanged);
+        // Files edited in place do not change their directory
+        connect(mWatcher, &QFileSystemWatcher::fileChanged, this, &XdgMimeResolver::onWatchedPathChanged);
+    }
+    else
+    {
+        const QStringList watched = mWatcher->directories() + mWatcher->files();
+        if(!watched.isEmpty())
+        {
+            mWatcher->removePaths(watched);
+        }
+    }
+
+    mDefaults.clear();
+    mAdded.clear();
+    mRemoved.clear();
+    mDesktopEntries.clear();
+    mDesktopIdsByMimeType.clear();
+    mResolved.clear();
+
+    // mimeapps.list lookup order, from the highest priority
+    const QStringList desktops = currentDesktops();
+    foreach(auto dir, configDirs())
+    {
+        foreach(auto desktop, desktops)
+        {
+            readMimeAppsList(dir + QString::fromUtf8("/%1-mimeapps.list").arg(desktop));
+        }
+        readMimeAppsList(dir + QString::fromUtf8("/mimeapps.list"));
+        watch(dir);
+    }
+
+    foreach(auto dir, dataDirs())
+    {
+        const QString applicationsDir = dir + QString::fromUtf8("/applications");
+        foreach(auto desktop, desktops)
+        {
+            readMimeAppsList(applicationsDir + QString::fromUtf8("/%1-mimeapps.list").arg(desktop));
+        }
+        readMimeAppsList(applicationsDir + QString::fromUtf8("/mimeapps.list"));
+        // Deprecated, but still the only file written by some desktops
+        readMimeAppsList(applicationsDir + QString::fromUtf8("/defaults.list"));
+
+        indexDesktopFiles(applicationsDir, QString());
+    }
+
+    mIndexed = true;
+}
+
+void XdgMimeResolver::readMimeAppsList(const QString& path)
+{
+    if(!QFileInfo::exists(path))
+    {
+        return;
+    }
+    mWatcher->addPath(path);
+
+    forEachEntry(path, [this](const QString& group, const QString& mimeType, const QString& value)
+    {
+        if(group == DEFAULT_APPS_GROUP)
+        {
+            mDefaults[mimeType].append(splitList(value));
+        }
+        else if(group == ADDED_ASSOCIATIONS_GROUP)
+        {
+            mAdded[mimeType].append(splitList(value));
+        }
+        else if(group == REMOVED_ASSOCIATIONS_GROUP)
+        {
+            mRemoved[mimeType].append(splitList(value));
+        }
+    });
+}
+
+// The id of applications/foo/bar.desktop is foo-bar.desktop
+void XdgMimeResolver::indexDesktopFiles(const QString& applicationsDir, const QString& subdir)
+{
+    QDir dir(subdir.isEmpty() ? applicationsDir : applicationsDir + QLatin1Char('/') + subdir);
+    if(!dir.exists())
+    {
+        return;
+    }
+    watch(dir.path());
+
+    const QString idPrefix = subdir.isEmpty() ? QString() : QString(subdir).replace(QLatin1Char('/'), QLatin1Char('-')) + QLatin1Char('-');
+    foreach(auto fileName, dir.entryList(QStringList(QString::fromUtf8("*.desktop")), QDir::Files))
+    {
+        const QString id = idPrefix + fileName;
+        if(mDesktopEntries.contains(id))
+        {
+            continue;
+        }
+
+        DesktopEntry entry;
+        bool hidden = false;
+        forEachEntry(dir.filePath(fileName), [&entry, &hidden](const QString& group, const QString& key, const QString& value)
+        {
+            if(group != DESKTOP_ENTRY_GROUP)
+            {
+                return;
+            }
+
+            if(key == QLatin1String("Exec"))
+            {
+                // Field codes are replaced by the caller arguments
+                const int fieldCode = value.indexOf(QLatin1Char('%'));
+                entry.command = (fieldCode < 0 ? value : value.left(fieldCode)).trimmed();
+            }
+            else if(key == QLatin1String("MimeType"))
+            {
+                entry.mimeTypes = splitList(value);
+            }
+            else if(key == QLatin1String("Hidden"))
+            {
+                hidden = (value == QLatin1String("true"));
+            }
+        });
+
+        // A hidden entry still shadows the ones with the same id in the lower priority directories
+        if(hidden)
+        {
+            entry.command.clear();
+        }
+
+        mDesktopEntries.insert(id, entry);
+        foreach(auto mimeType, entry.mimeTypes)
+        {
+            mDesktopIdsByMimeType[mimeType].append(id);
+        }
+    }
+
+    foreach(auto child, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        indexDesktopFiles(applicationsDir, subdir.isEmpty() ? child : subdir + QLatin1Char('/') + child);
+    }
+}
+
+void XdgMimeResolver::watch(const QString& dir)
+{
+    if(QFileInfo(dir).isDir())
+    {
+        mWatcher->addPath(dir);
+    }
+}
+
+QString XdgMimeResolver::resolve(const QString& mimeType) const
+{
+    auto command = [this](const QString& id)
+    {
+        return mDesktopEntries.value(id).command;
+    };
+
+    foreach(auto id, mDefaults.value(mimeType))
+    {
+        const QString result = command(id);
+        if(!result.isEmpty())
+        {
+            return result;
+        }
+    }
+
+    const QStringList removed = mRemoved.value(mimeType);
+    foreach(auto id, mAdded.value(mimeType) + mDesktopIdsByMimeType.value(mimeType))
+    {
+        const QString result = command(id);
+        if(!result.isEmpty() && !removed.contains(id))
+        {
+            return result;
+        }
+    }
+
+    return QString();
+}
+
+QStringList XdgMimeResolver::configDirs()
+{
+    return envPaths("XDG_CONFIG_HOME", QDir::homePath() + QString::fromUtf8("/.config"))
+            + envPaths("XDG_CONFIG_DIRS", QString::fromUtf8("/etc/xdg"));
+}
+
+QStringList XdgMimeResolver::dataDirs()
+{
+    return envPaths("XDG_DATA_HOME", QDir::homePath() + QString::fromUtf8("/.local/share"))
+            + envPaths("XDG_DATA_DIRS", QString::fromUtf8("/usr/local/share:/usr/share"));
+}
+
+QStringList XdgMimeResolver::currentDesktops()
+{
+    const QString desktops = QString::fromLocal8Bit(qgetenv("XDG_CURRENT_DESKTOP")).toLower();
+    return desktops.split(QLatin1Char(':'), QString::SkipEmptyParts);
+}
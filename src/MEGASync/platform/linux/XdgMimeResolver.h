@@ -0,0 +1,64 @@
+#ifndef XDGMIMERESOLVER_H
+#define XDGMIMERESOLVER_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QFileSystemWatcher;
+
+/**
+ * @brief Default application for a MIME type, read from the XDG files
+ *
+ * Finds the default application for a MIME type following the XDG specifications, reading mimeapps.list and
+ * the .desktop files of the XDG config and data directories (user ones included) instead of running xdg-mime.
+ *
+ * The files are parsed once and indexed; the index is rebuilt on the next query after any of the watched
+ * directories changes. Must be used from the GUI thread.
+ */
+class XdgMimeResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XdgMimeResolver(QObject* parent = nullptr);
+
+    // Command of the default application without its field codes (%f, %U...), empty if there is none
+    QString defaultAppCommand(const QString& mimeType);
+
+private slots:
+    void onWatchedPathChanged();
+
+private:
+    struct DesktopEntry
+    {
+        QString command;
+        QStringList mimeTypes;
+    };
+
+    void rebuild();
+    void readMimeAppsList(const QString& path);
+    void indexDesktopFiles(const QString& applicationsDir, const QString& subdir);
+    void watch(const QString& dir);
+    QString resolve(const QString& mimeType) const;
+
+    static QStringList configDirs();
+    static QStringList dataDirs();
+    static QStringList currentDesktops();
+
+    QFileSystemWatcher* mWatcher;
+    bool mIndexed;
+
+    // Desktop file ids, in priority order, from the mimeapps.list files
+    QHash<QString, QStringList> mDefaults;
+    QHash<QString, QStringList> mAdded;
+    QHash<QString, QStringList> mRemoved;
+    // Desktop file id to entry. Only the first one found in the data directories is kept
+    QHash<QString, DesktopEntry> mDesktopEntries;
+    // Desktop file ids declaring each MIME type, in data directory order
+    QHash<QString, QStringList> mDesktopIdsByMimeType;
+    QHash<QString, QString> mResolved;
+};
+
+#endif // XDGMIMERESOLVER_H
@@ -56,10 +56,14 @@ unix:!macx {
         $$PWD/linux/ExtServer.cpp \
         $$PWD/linux/NotifyServer.cpp \
         $$PWD/linux/PowerOptions.cpp \
-        $$PWD/linux/PlatformStrings.cpp
+        $$PWD/linux/PlatformStrings.cpp \
+        $$PWD/linux/ProcFsScanner.cpp \
+        $$PWD/linux/XdgMimeResolver.cpp
     HEADERS += $$PWD/linux/PlatformImplementation.h \
         $$PWD/linux/ExtServer.h \
-        $$PWD/linux/NotifyServer.h
+        $$PWD/linux/NotifyServer.h \
+        $$PWD/linux/ProcFsScanner.h \
+        $$PWD/linux/XdgMimeResolver.h
 
     LIBS += -lssl -lcrypto -ldl -lxcb
     DEFINES += USE_DBUS
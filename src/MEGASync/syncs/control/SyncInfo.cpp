@@ -35,8 +35,12 @@ SyncInfo::SyncInfo() : QObject(),
     preferences (Preferences::instance()),
     mIsFirstTwoWaySyncDone (preferences->isFirstSyncDone()),
     mIsFirstBackupDone (preferences->isFirstBackupDone()),
+    mIndexValid (false),
     syncMutex (QMutex::Recursive)
 {
+    // Emitted with syncMutex held, right after the change
+    connect(this, &SyncInfo::syncStateChanged, this, &SyncInfo::invalidateIndex, Qt::DirectConnection);
+    connect(this, &SyncInfo::syncRemoved, this, &SyncInfo::invalidateIndex, Qt::DirectConnection);
 }
 
 bool SyncInfo::hasUnattendedDisabledSyncs(const QVector<SyncType>& types) const
@@ -111,6 +115,7 @@ void SyncInfo::removeAllFolders()
     configuredSyncsMap.clear();
     syncsSettingPickedFromOldConfig.clear();
     unattendedDisabledSyncs.clear();
+    invalidateIndex();
 }
 
 void SyncInfo::activateSync(std::shared_ptr<SyncSettings> syncSetting)
@@ -317,6 +322,7 @@ void SyncInfo::reset()
     configuredSyncsMap.clear();
     syncsSettingPickedFromOldConfig.clear();
     unattendedDisabledSyncs.clear();
+    invalidateIndex();
     mIsFirstTwoWaySyncDone = false;
     mIsFirstBackupDone = false;
 }
@@ -463,14 +469,17 @@ QStringList SyncInfo::getMegaFolders(const QVector<SyncType>& types)
 QStringList SyncInfo::getLocalFolders(const QVector<SyncType>& types)
 {
     QMutexLocker qm(&syncMutex);
-    QStringList value;
+    updateIndex();
+
+    if (types.size() == 1)
+    {
+        return mLocalFoldersByType.value(types.first());
+    }
 
+    QStringList value;
     for (auto type : types)
     {
-        for (auto &cs : configuredSyncs[type])
-        {
-            value.append(configuredSyncsMap[cs]->getLocalFolder());
-        }
+        value.append(mLocalFoldersByType.value(type));
     }
     return value;
 }
@@ -478,16 +487,8 @@ QStringList SyncInfo::getLocalFolders(const QVector<SyncType>& types)
 QMap<QString, SyncInfo::SyncType> SyncInfo::getLocalFoldersAndTypeMap()
 {
     QMutexLocker qm(&syncMutex);
-    QMap<QString, SyncType> ret;
-
-    for (auto type : SyncInfo::AllHandledSyncTypes)
-    {
-        for (auto &cs : configuredSyncs[type])
-        {
-            ret.insert(configuredSyncsMap[cs]->getLocalFolder(), type);
-        }
-    }
-    return ret;
+    updateIndex();
+    return mLocalFoldersAndTypes;
 }
 
 QList<MegaHandle> SyncInfo::getMegaFolderHandles(const QVector<SyncType>& types)
@@ -504,6 +505,13 @@ QList<MegaHandle> SyncInfo::getMegaFolderHandles(const QVector<SyncType>& types)
     return value;
 }
 
+bool SyncInfo::isSyncedMegaFolder(MegaHandle handle)
+{
+    QMutexLocker qm(&syncMutex);
+    updateIndex();
+    return mSyncedMegaFolderHandles.contains(handle);
+}
+
 std::shared_ptr<SyncSettings> SyncInfo::getSyncSetting(int num, mega::MegaSync::SyncType type)
 {
     QMutexLocker qm(&syncMutex);
@@ -534,6 +542,55 @@ std::shared_ptr<SyncSettings> SyncInfo::getSyncSettingByTag(MegaHandle tag)
     return nullptr;
 }
 
+std::shared_ptr<SyncSettings> SyncInfo::getSyncSettingByLocalPath(const QString& path)
+{
+    QMutexLocker qm(&syncMutex);
+    updateIndex();
+    return configuredSyncsMap.value(mLocalPathIndex.findContaining(path), nullptr);
+}
+
+void SyncInfo::invalidateIndex()
+{
+    QMutexLocker qm(&syncMutex);
+    mIndexValid = false;
+}
+
+void SyncInfo::updateIndex()
+{
+    if (mIndexValid)
+    {
+        return;
+    }
+
+    mLocalPathIndex.clear();
+    mSyncedMegaFolderHandles.clear();
+    mLocalFoldersByType.clear();
+    mLocalFoldersAndTypes.clear();
+
+    for (auto it = configuredSyncs.cbegin(); it != configuredSyncs.cend(); ++it)
+    {
+        auto& localFolders (mLocalFoldersByType[it.key()]);
+        for (auto backupId : it.value())
+        {
+            auto cs (configuredSyncsMap.value(backupId, nullptr));
+            if (!cs)
+            {
+                continue;
+            }
+
+            QString localFolder (cs->getLocalFolder());
+            localFolders.append(localFolder);
+            mLocalPathIndex.insert(localFolder, backupId);
+            mSyncedMegaFolderHandles.insert(cs->getMegaHandle());
+            if (AllHandledSyncTypes.contains(it.key()))
+            {
+                mLocalFoldersAndTypes.insert(localFolder, it.key());
+            }
+        }
+    }
+    mIndexValid = true;
+}
+
 void SyncInfo::saveUnattendedDisabledSyncs()
 {
     if (preferences->logged())
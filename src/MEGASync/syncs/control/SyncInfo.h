@@ -1,6 +1,7 @@
 #pragma once
 
 #include "syncs/control/SyncSettings.h"
+#include "syncs/control/SyncPathIndex.h"
 
 #include "megaapi.h"
 
@@ -51,6 +52,15 @@ private:
 
     void saveUnattendedDisabledSyncs();
 
+    // Lookups derived from configuredSyncs. Rebuilt on the first query after a sync changes
+    void invalidateIndex();
+    void updateIndex();
+    bool mIndexValid;
+    SyncPathIndex mLocalPathIndex;
+    QSet<mega::MegaHandle> mSyncedMegaFolderHandles;
+    QMap<SyncType, QStringList> mLocalFoldersByType;
+    QMap<QString, SyncType> mLocalFoldersAndTypes;
+
 protected:
     QMutex syncMutex;
 
@@ -91,6 +101,8 @@ public:
     // Getters
     std::shared_ptr<SyncSettings> getSyncSetting(int num, SyncType type);
     std::shared_ptr<SyncSettings> getSyncSettingByTag(mega::MegaHandle tag);
+    // The sync whose local folder is the path or contains it
+    std::shared_ptr<SyncSettings> getSyncSettingByLocalPath(const QString& path);
     QList<std::shared_ptr<SyncSettings>> getSyncSettingsByType(const QVector<SyncType>& types);
     QList<std::shared_ptr<SyncSettings>> getSyncSettingsByType(SyncType type)
         {return getSyncSettingsByType(QVector<SyncType>({type}));}
@@ -131,6 +143,7 @@ public:
     QList<mega::MegaHandle> getMegaFolderHandles(const QVector<SyncType>& types);
     QList<mega::MegaHandle> getMegaFolderHandles(SyncType type)
         {return getMegaFolderHandles(QVector<SyncType>({type}));}
+    bool isSyncedMegaFolder(mega::MegaHandle handle);
     //cloudDrive = true: only cloud drive mega folders. If false will return only inshare syncs.
     QStringList getCloudDriveSyncMegaFolders(bool cloudDrive = true);
     static QSet<QString> getRemoteBackupFolderNames();
@@ -0,0 +1,89 @@
+#include "SyncPathIndex.h"
+
+#include <QDir>
+
+SyncPathIndex::SyncPathIndex()
+    : mSize(0)
+{
+}
+
+void SyncPathIndex::insert(const QString& localFolder, mega::MegaHandle backupId)
+{
+    Node* node (&mRoot);
+    for (const auto& key : components(localFolder))
+    {
+        auto& child = node->children[key];
+        if (!child)
+        {
+            child.reset(new Node());
+        }
+        node = child.get();
+    }
+
+    if (node->backupId == mega::INVALID_HANDLE)
+    {
+        ++mSize;
+    }
+    node->backupId = backupId;
+}
+
+void SyncPathIndex::clear()
+{
+    mRoot.children.clear();
+    mRoot.backupId = mega::INVALID_HANDLE;
+    mSize = 0;
+}
+
+bool SyncPathIndex::isEmpty() const
+{
+    return mSize == 0;
+}
+
+mega::MegaHandle SyncPathIndex::findContaining(const QString& path) const
+{
+    mega::MegaHandle backupId (mega::INVALID_HANDLE);
+    find(components(path), &backupId);
+    return backupId;
+}
+
+bool SyncPathIndex::hasSyncBelow(const QString& path) const
+{
+    const Node* node (find(components(path), nullptr));
+    return node && !node->children.empty();
+}
+
+QStringList SyncPathIndex::components(const QString& path)
+{
+#if defined(WIN32) || defined(__APPLE__)
+    const QString key (QDir::fromNativeSeparators(path).toCaseFolded());
+#else
+    const QString key (QDir::fromNativeSeparators(path));
+#endif
+    return key.split(QLatin1Char('/'), QString::SkipEmptyParts);
+}
+
+// The node of the path, nullptr if it is not in the trie. Collects the deepest sync on the way
+const SyncPathIndex::Node* SyncPathIndex::find(const QStringList& keys, mega::MegaHandle* deepestBackupId) const
+{
+    const Node* node (&mRoot);
+    for (const auto& key : keys)
+    {
+        if (deepestBackupId && node->backupId != mega::INVALID_HANDLE)
+        {
+            *deepestBackupId = node->backupId;
+        }
+
+        auto it (node->children.find(key));
+        if (it == node->children.end())
+        {
+            return nullptr;
+        }
+        node = it->second.get();
+    }
+
+    if (deepestBackupId && node->backupId != mega::INVALID_HANDLE)
+    {
+        *deepestBackupId = node->backupId;
+    }
+    return node;
+}
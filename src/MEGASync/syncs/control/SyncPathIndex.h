@@ -0,0 +1,46 @@
+#pragma once
+
+#include "megaapi.h"
+
+#include <QString>
+#include <QStringList>
+
+#include <map>
+#include <memory>
+
+/**
+ * @brief Index of the synced local folders
+ *
+ * Finds which sync contains a local path walking the components of the path once, instead
+ * of comparing the path with every synced folder. Native and '/' separators are accepted.
+ * On Windows and macOS the components are compared case insensitively, like their file systems do.
+ *
+ */
+
+class SyncPathIndex
+{
+public:
+    SyncPathIndex();
+
+    void insert(const QString& localFolder, mega::MegaHandle backupId);
+    void clear();
+    bool isEmpty() const;
+
+    // Sync whose folder is the path or one of its ancestors (the deepest one), INVALID_HANDLE if none
+    mega::MegaHandle findContaining(const QString& path) const;
+    // Whether a synced folder is below the path, the path itself excluded
+    bool hasSyncBelow(const QString& path) const;
+
+private:
+    struct Node
+    {
+        std::map<QString, std::unique_ptr<Node>> children;
+        mega::MegaHandle backupId = mega::INVALID_HANDLE;
+    };
+
+    static QStringList components(const QString& path);
+    const Node* find(const QStringList& keys, mega::MegaHandle* deepestBackupId) const;
+
+    Node mRoot;
+    int mSize;
+};
@@ -17,6 +17,7 @@ SOURCES += $$PWD/gui/Backups/AddBackupDialog.cpp \
            $$PWD/model/BackupItemModel.cpp \
            $$PWD/model/SyncItemModel.cpp \
            $$PWD/control/SyncInfo.cpp \
+           $$PWD/control/SyncPathIndex.cpp \
            $$PWD/control/SyncController.cpp \
            $$PWD/control/SyncSettings.cpp
 
@@ -37,6 +38,7 @@ HEADERS += $$PWD/gui/Backups/AddBackupDialog.h \
            $$PWD/model/SyncItemModel.h \
            $$PWD/control/SyncController.h \
            $$PWD/control/SyncInfo.h \
+           $$PWD/control/SyncPathIndex.h \
            $$PWD/control/SyncSettings.h
 
 win32 {
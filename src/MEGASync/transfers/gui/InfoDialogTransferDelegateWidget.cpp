@@ -258,7 +258,9 @@ TransferBaseDelegateWidget::ActionHoverType InfoDialogTransferDelegateWidget::mo
                     //Double check that the mFailedTransfer is OK
                     if(getData()->isFailed())
                     {
-                        mUi->lActionTransfer->setToolTip(tr("Failed: %1").arg(QString::fromStdString(getData()->mFailedTransfer->getLastError().getErrorString())));
+                        mUi->lActionTransfer->setToolTip(tr("Failed: %1").arg(getData()->mFailedTransfer
+                                                                              ? QString::fromStdString(getData()->mFailedTransfer->getLastError().getErrorString())
+                                                                              : QString::fromUtf8(MegaError::getErrorString(getData()->mErrorCode))));
                     }
 
                     if(update)
@@ -327,7 +329,7 @@ void InfoDialogTransferDelegateWidget::finishTransfer()
     mUi->sTransferState->setCurrentWidget(mUi->completedTransfer);
     if (getData()->mErrorCode < 0)
     {
-        mUi->lActionTransfer->setIcon(QIcon(QString::fromAscii("://images/error.png")));
+        mUi->lActionTransfer->setIcon(Utilities::getCachedPixmap(QString::fromAscii("://images/error.png")));
         mUi->lActionTransfer->setIconSize(QSize(24,24));
         mUi->lElapsedTime->setStyleSheet(QString::fromUtf8("color: #F0373A"));
 
@@ -346,7 +348,7 @@ void InfoDialogTransferDelegateWidget::finishTransfer()
     }
     else
     {
-        mUi->lActionTransfer->setIcon(QIcon(QString::fromAscii("://images/success.png")));
+        mUi->lActionTransfer->setIcon(Utilities::getCachedPixmap(QString::fromAscii("://images/success.png")));
         mUi->lActionTransfer->setIconSize(QSize(24,24));
         updateFinishedIco(getData()->mType, false);
     }
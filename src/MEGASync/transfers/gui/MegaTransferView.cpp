@@ -1067,13 +1067,13 @@ void MegaTransferView::moveToTopClicked()
                 return;
             }
 
+            QList<int> rows;
             for (int item = 0; item < indexes.size(); ++item)
             {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
-
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << sourceIndex.row(), QModelIndex(), -1);
+                rows.append(proxy->mapToSource(indexes.at(item)).row());
             }
+
+            sourceModel->moveTransfersToFirst(rows);
         }
     }
 
@@ -1221,13 +1221,13 @@ void MegaTransferView::moveToBottomClicked()
                 return;
             }
 
+            QList<int> rows;
             for (int item = 0; item < indexes.size(); ++item)
             {
-                auto index = indexes.at(item);
-                auto sourceIndex = proxy->mapToSource(index);
-
-                sourceModel->moveTransferPriority(QModelIndex(), QList<int>() << sourceIndex.row(), QModelIndex(), -2);
+                rows.append(proxy->mapToSource(indexes.at(item)).row());
             }
+
+            sourceModel->moveTransfersToLast(rows);
         }
     }
 
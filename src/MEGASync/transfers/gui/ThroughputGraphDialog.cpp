@@ -0,0 +1,181 @@
+#include "ThroughputGraphDialog.h"
+
+#include "Preferences.h"
+#include "QMegaMessageBox.h"
+#include "TransferItem.h"
+#include "Utilities.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QDir>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace
+{
+const int GRAPH_MARGIN = 8;
+const int LEGEND_HEIGHT = 20;
+}
+
+/// Plots the bytes per second of each bucket, the newest at the right border
+class ThroughputGraph : public QWidget
+{
+public:
+    ThroughputGraph(TransferThroughputHistory* history, QWidget* parent)
+        : QWidget(parent),
+          mHistory(history),
+          mResolution(TransferThroughputHistory::SECONDS)
+    {
+        setMinimumSize(480, 200);
+        connect(history, &TransferThroughputHistory::samplesUpdated, this, [this](){update();});
+    }
+
+    void setResolution(TransferThroughputHistory::Resolution resolution)
+    {
+        mResolution = resolution;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.fillRect(rect(), palette().base());
+
+        const QRectF plot(rect().adjusted(GRAPH_MARGIN, GRAPH_MARGIN + LEGEND_HEIGHT, -GRAPH_MARGIN, -GRAPH_MARGIN));
+        const auto samples = mHistory ? mHistory->getSamples(mResolution) : QVector<TransferThroughputHistory::Sample>();
+        const int bucketSeconds(TransferThroughputHistory::bucketSeconds(mResolution));
+        const qint64 span(static_cast<qint64>(TransferThroughputHistory::capacity(mResolution)) * bucketSeconds);
+        const qint64 now(QDateTime::currentMSecsSinceEpoch() / 1000);
+
+        auto preferences = Preferences::instance();
+        const double uploadLimit(preferences->uploadLimitKB() > 0 ? preferences->uploadLimitKB() * 1024.0 : 0.0);
+        const double downloadLimit(preferences->downloadLimitKB() > 0 ? preferences->downloadLimitKB() * 1024.0 : 0.0);
+
+        double maxRate(qMax(uploadLimit, downloadLimit));
+        foreach(auto sample, samples)
+        {
+            maxRate = qMax(maxRate, static_cast<double>(qMax(sample.bytes[TransferThroughputHistory::UPLOAD],
+                                                             sample.bytes[TransferThroughputHistory::DOWNLOAD])) / bucketSeconds);
+        }
+        maxRate = qMax(maxRate, 1024.0);
+
+        auto toPoint = [&](qint64 time, double rate)
+        {
+            const double x(plot.right() - plot.width() * static_cast<double>(now - time) / span);
+            return QPointF(qMax(plot.left(), x), plot.bottom() - plot.height() * rate / maxRate);
+        };
+
+        painter.setPen(QPen(palette().mid().color(), 1));
+        painter.drawRect(plot);
+
+        auto drawLimit = [&](double limit, const QColor& color)
+        {
+            if(limit > 0.0)
+            {
+                painter.setPen(QPen(color, 1, Qt::DashLine));
+                const double y(toPoint(now, limit).y());
+                painter.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+            }
+        };
+        drawLimit(uploadLimit, UPLOAD_TRANSFER_COLOR);
+        drawLimit(downloadLimit, DOWNLOAD_TRANSFER_COLOR);
+
+        auto drawSeries = [&](TransferThroughputHistory::Direction direction, const QColor& color)
+        {
+            QPainterPath path;
+            foreach(auto sample, samples)
+            {
+                const QPointF point(toPoint(sample.time, static_cast<double>(sample.bytes[direction]) / bucketSeconds));
+                if(path.isEmpty())
+                {
+                    path.moveTo(point);
+                }
+                else
+                {
+                    path.lineTo(point);
+                }
+            }
+            painter.setPen(QPen(color, 1.5));
+            painter.drawPath(path);
+        };
+        drawSeries(TransferThroughputHistory::DOWNLOAD, DOWNLOAD_TRANSFER_COLOR);
+        drawSeries(TransferThroughputHistory::UPLOAD, UPLOAD_TRANSFER_COLOR);
+
+        const QRect legend(GRAPH_MARGIN, 0, width() - 2 * GRAPH_MARGIN, LEGEND_HEIGHT + GRAPH_MARGIN);
+        painter.setPen(UPLOAD_TRANSFER_COLOR);
+        painter.drawText(legend, Qt::AlignLeft | Qt::AlignVCenter, ThroughputGraphDialog::tr("Upload"));
+        painter.setPen(DOWNLOAD_TRANSFER_COLOR);
+        painter.drawText(legend, Qt::AlignHCenter | Qt::AlignVCenter, ThroughputGraphDialog::tr("Download"));
+        painter.setPen(palette().text().color());
+        painter.drawText(legend, Qt::AlignRight | Qt::AlignVCenter,
+                         Utilities::getSizeString(static_cast<unsigned long long>(maxRate)) + QLatin1String("/s"));
+    }
+
+private:
+    QPointer<TransferThroughputHistory> mHistory;
+    TransferThroughputHistory::Resolution mResolution;
+};
+
+ThroughputGraphDialog::ThroughputGraphDialog(TransferThroughputHistory* history, QWidget* parent)
+    : QDialog(parent),
+      mHistory(history),
+      mGraph(new ThroughputGraph(history, this)),
+      mResolution(new QComboBox(this))
+{
+    setWindowTitle(tr("Transfer speed history"));
+
+    mResolution->addItem(tr("Last 10 minutes"), TransferThroughputHistory::SECONDS);
+    mResolution->addItem(tr("Last 24 hours"), TransferThroughputHistory::MINUTES);
+    mResolution->addItem(tr("Last 30 days"), TransferThroughputHistory::HOURS);
+    connect(mResolution, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &ThroughputGraphDialog::onResolutionChanged);
+
+    auto exportButton = new QPushButton(tr("Export CSV"), this);
+    connect(exportButton, &QPushButton::clicked, this, &ThroughputGraphDialog::onExportClicked);
+
+    auto controls = new QHBoxLayout();
+    controls->addWidget(mResolution);
+    controls->addStretch();
+    controls->addWidget(exportButton);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(mGraph, 1);
+}
+
+void ThroughputGraphDialog::onResolutionChanged(int index)
+{
+    mGraph->setResolution(static_cast<TransferThroughputHistory::Resolution>(mResolution->itemData(index).toInt()));
+}
+
+void ThroughputGraphDialog::onExportClicked()
+{
+    if(!mHistory)
+    {
+        return;
+    }
+
+    const QString defaultName(QString::fromLatin1("MEGA-throughput-%1.csv")
+                              .arg(QDateTime::currentDateTime().toString(QString::fromLatin1("yyyyMMdd-HHmmss"))));
+    const QString filePath(QFileDialog::getSaveFileName(this, tr("Export CSV"),
+                                                        QDir::home().filePath(defaultName),
+                                                        tr("CSV files (*.csv)")));
+    if(!filePath.isEmpty())
+    {
+        auto resolution(static_cast<TransferThroughputHistory::Resolution>(mResolution->currentData().toInt()));
+        if(!mHistory->exportCsv(filePath, resolution))
+        {
+            QMegaMessageBox::MessageBoxInfo info;
+            info.title = QMegaMessageBox::errorTitle();
+            info.text = tr("The throughput history could not be exported to %1.").arg(QDir::toNativeSeparators(filePath));
+            info.parent = this;
+            QMegaMessageBox::critical(info);
+        }
+    }
+}
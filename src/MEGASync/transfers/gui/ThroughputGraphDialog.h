@@ -0,0 +1,35 @@
+#ifndef THROUGHPUTGRAPHDIALOG_H
+#define THROUGHPUTGRAPHDIALOG_H
+
+#include "TransferThroughputHistory.h"
+
+#include <QDialog>
+#include <QPointer>
+
+class QComboBox;
+class ThroughputGraph;
+
+/**
+ * @brief Graph of the throughput history
+ *
+ * Shows the upload and download throughput history as a graph, with the bandwidth limits, and exports it to
+ * CSV.
+ */
+class ThroughputGraphDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ThroughputGraphDialog(TransferThroughputHistory* history, QWidget* parent = nullptr);
+
+private slots:
+    void onResolutionChanged(int index);
+    void onExportClicked();
+
+private:
+    QPointer<TransferThroughputHistory> mHistory;
+    ThroughputGraph* mGraph;
+    QComboBox* mResolution;
+};
+
+#endif // THROUGHPUTGRAPHDIALOG_H
@@ -2,6 +2,7 @@
 #include "Utilities.h"
 #include "MegaApplication.h"
 #include "TransfersModel.h"
+#include "TransferHistoryStore.h"
 
 using namespace mega;
 
@@ -57,24 +58,65 @@ const TransferData::TransferStates TransferData::ACTIVE_STATES_MASK = TransferDa
             TransferData::TransferState::TRANSFER_ACTIVE |
             TransferData::TransferState::TRANSFER_COMPLETING);
 
+TransferData::TransferData(mega::MegaTransfer* transfer, const TransferData* staticData)
+    : mType(staticData->mType), mTag(staticData->mTag), mFolderTransferTag(staticData->mFolderTransferTag),
+      mFileType(staticData->mFileType), mParentHandle(staticData->mParentHandle),
+      mFilename(staticData->mFilename), mPath(staticData->mPath)
+{
+    updateDynamicFields(transfer);
+}
+
+void TransferData::reuse(mega::MegaTransfer* transfer, const TransferData* staticData)
+{
+    mType = staticData->mType;
+    mTag = staticData->mTag;
+    mFolderTransferTag = staticData->mFolderTransferTag;
+    mFileType = staticData->mFileType;
+    mParentHandle = staticData->mParentHandle;
+    mFilename = staticData->mFilename;
+    mPath = staticData->mPath;
+    mNodeAccess = 0;
+    mHistoryId = -1;
+
+    updateDynamicFields(transfer);
+}
+
 void TransferData::update(mega::MegaTransfer* transfer)
 {
-    auto megaApi = MegaSyncApp->getMegaApi();
-    if(transfer && megaApi)
-    {   
-        mTag = transfer->getTag();
+    if(transfer)
+    {
+        updateStaticFields(transfer);
+        updateDynamicFields(transfer);
+    }
+}
 
-        mPath = QString::fromUtf8(transfer->getPath());
-        mFolderTransferTag = transfer->getFolderTransferTag();
+void TransferData::updateStaticFields(mega::MegaTransfer* transfer)
+{
+    mTag = transfer->getTag();
 
-        mFilename = QString::fromUtf8(transfer->getFileName());
-        mType = static_cast<TransferData::TransferType>(1 << transfer->getType());
-        if (transfer->isSyncTransfer())
-        {
-            mType |= TransferData::TRANSFER_SYNC;
-        }
+    mPath = QString::fromUtf8(transfer->getPath());
+    mFolderTransferTag = transfer->getFolderTransferTag();
 
-        mFileType = Utilities::getFileType(mFilename, QString());
+    mFilename = QString::fromUtf8(transfer->getFileName());
+    mType = static_cast<TransferData::TransferType>(1 << transfer->getType());
+    if (transfer->isSyncTransfer())
+    {
+        mType |= TransferData::TRANSFER_SYNC;
+    }
+
+    mFileType = Utilities::getFileType(mFilename, QString());
+    mParentHandle = transfer->getParentHandle();
+}
+
+void TransferData::updateDynamicFields(mega::MegaTransfer* transfer)
+{
+    auto megaApi = MegaSyncApp->getMegaApi();
+    if(transfer && megaApi)
+    {
+        //A reused data must end as a new one, so the priority offsets of setState are applied again
+        mState = TransferState::TRANSFER_NONE;
+        mPreviousState = TransferState::TRANSFER_NONE;
+        mMeanSpeed = 0;
 
         //Update priority before setState as the setState changes the priority
         mPriority = transfer->getPriority();
@@ -128,7 +170,6 @@ void TransferData::update(mega::MegaTransfer* transfer)
             mErrorValue = megaError->getValue();
         }
 
-        mParentHandle = transfer->getParentHandle();
         mNodeHandle = transfer->getNodeHandle();
     }
 }
@@ -381,14 +422,15 @@ bool TransferData::isCompleting() const
 
 bool TransferData::isFailed() const
 {
-    return mState & TRANSFER_FAILED && mFailedTransfer;
+    //Transfers read from the history have no MegaTransfer to keep
+    return mState & TRANSFER_FAILED && (mFailedTransfer || isFromHistory());
 }
 
 bool TransferData::canBeRetried() const
 {
     auto result(false);
 
-    if(!isFailed())
+    if(!isFailed() || !mFailedTransfer)
     {
         return result;
     }
@@ -420,6 +462,11 @@ bool TransferData::isCancelled() const
     return mState & TRANSFER_CANCELLED;
 }
 
+bool TransferData::isFromHistory() const
+{
+    return mTag >= TransferHistoryStore::FIRST_HISTORY_TAG;
+}
+
 bool TransferData::isFinished() const
 {
     return mState & FINISHED_STATES_MASK;
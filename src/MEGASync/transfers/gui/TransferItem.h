@@ -60,6 +60,9 @@ public:
     static const TransferTypes TYPE_MASK;
 
     TransferData(mega::MegaTransfer* transfer = nullptr){update(transfer);}
+    //Takes the fields that do not change during the transfer (names, paths, types) from staticData.
+    //The QStrings are implicitly shared, so nothing is converted or allocated for them
+    TransferData(mega::MegaTransfer* transfer, const TransferData* staticData);
     ~TransferData(){}
 
     TransferData(TransferData const* dr) :
@@ -73,10 +76,15 @@ public:
         mFileType(dr->mFileType),
         mParentHandle (dr->mParentHandle), mNodeHandle (dr->mNodeHandle), mFailedTransfer(dr->mFailedTransfer),
         mFilename(dr->mFilename), mNodeAccess(mega::MegaShare::ACCESS_UNKNOWN),
+        mHistoryId(dr->mHistoryId),
         mPath(dr->mPath), mFinishedTime(dr->mFinishedTime),mState(dr->mState), mIgnorePauseQueueState(dr->mIgnorePauseQueueState)
     {}
 
     void update(mega::MegaTransfer* transfer);
+    //Makes a data that nobody references anymore equal to a new TransferData(transfer, staticData)
+    void reuse(mega::MegaTransfer* transfer, const TransferData* staticData);
+    //Only the fields that change on every event (state, bytes, speed, priority, errors)
+    void updateDynamicFields(mega::MegaTransfer* transfer);
     bool hasChanged(QExplicitlySharedDataPointer<TransferData> data);
     void removeFailedTransfer();
 
@@ -105,6 +113,8 @@ public:
     std::shared_ptr<mega::MegaTransfer> mFailedTransfer;
     QString                             mFilename;
     int                                 mNodeAccess = 0;
+    //Id in the TransferHistoryStore, -1 if the transfer has not been saved
+    int                                 mHistoryId = -1;
 
     void setState(const TransferState& state);
     void setPreviousState(const TransferState& state);
@@ -133,6 +143,7 @@ public:
     bool isFailed() const;
     bool canBeRetried() const;
     bool isCancelled() const;
+    bool isFromHistory() const;
     int64_t getRawFinishedTime() const;
     int64_t getSecondsSinceFinished() const;
     QDateTime getFinishedDateTime() const;
@@ -140,6 +151,10 @@ public:
     QString getFullFormattedFinishedTime() const;
 
 private:
+    friend class TransferHistoryStore;
+
+    void updateStaticFields(mega::MegaTransfer* transfer);
+
     QString         mPath;
     int64_t         mFinishedTime = 0;
     TransferState   mState = TransferState::TRANSFER_NONE;
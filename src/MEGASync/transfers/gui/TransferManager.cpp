@@ -8,6 +8,7 @@
 #include "MegaTransferView.h"
 #include "OverQuotaDialog.h"
 #include "DialogOpener.h"
+#include "ThroughputGraphDialog.h"
 
 #include <QMouseEvent>
 #include <QScrollBar>
@@ -19,6 +20,8 @@ using namespace mega;
 
 const int TransferManager::SPEED_REFRESH_PERIOD_MS;
 const int TransferManager::STATS_REFRESH_PERIOD_MS;
+const int TransferManager::BATCH_PROGRESS_MIN_TRANSFERS;
+const int TransferManager::BATCH_PROGRESS_DELAY_MS;
 
 const char* ALL_TRANSFERS_TITLE = "All transfers";
 const char* UPLOADS_TITLE = "Uploads";
@@ -161,6 +164,14 @@ TransferManager::TransferManager(TransfersWidget::TM_TAB tab, MegaApi *megaApi)
     connect(mModel, &TransfersModel::pauseStateChangedByTransferResume,
             this, &TransferManager::onPauseStateChangedByTransferResume);
 
+    auto batchScheduler = mModel->getBatchScheduler();
+    connect(batchScheduler, &TransferBatchScheduler::operationStarted,
+            this, &TransferManager::onBatchOperationStarted);
+    connect(batchScheduler, &TransferBatchScheduler::operationProgress,
+            this, &TransferManager::onBatchOperationProgress);
+    connect(batchScheduler, &TransferBatchScheduler::operationFinished,
+            this, &TransferManager::onBatchOperationFinished);
+
     connect(this, &TransferManager::retryAllTransfers,
             findChild<MegaTransferView*>(), &MegaTransferView::onRetryVisibleTransfers);
 
@@ -213,6 +224,10 @@ TransferManager::TransferManager(TransfersWidget::TM_TAB tab, MegaApi *megaApi)
     sizePolicy.setRetainSizeWhenHidden(true);
     mUi->wUpSpeed->setSizePolicy(sizePolicy);
 
+    //The speed icons open the speed history
+    connect(mUi->lUpSpeedIcon, &QPushButton::clicked, this, &TransferManager::showThroughputGraph);
+    connect(mUi->lDownSpeedIcon, &QPushButton::clicked, this, &TransferManager::showThroughputGraph);
+
     // Connect to storage quota signals
     connect(MegaSyncApp, &MegaApplication::storageStateChanged,
             this, &TransferManager::onStorageStateChanged,
@@ -852,6 +867,12 @@ void TransferManager::onTransferQuotaExceededUpdate()
 }
 
 
+void TransferManager::showThroughputGraph()
+{
+    QPointer<ThroughputGraphDialog> throughputDialog = new ThroughputGraphDialog(mModel->getThroughputHistory());
+    DialogOpener::showNonModalDialog(throughputDialog);
+}
+
 void TransferManager::refreshSpeed()
 {
     mUi->wUpSpeed->setVisible(mTransfersCount.pendingUploads);
@@ -1506,3 +1527,42 @@ void TransferManager::updateTransferWidget(QWidget* widgetToShow)
         }
     }
 }
+
+void TransferManager::onBatchOperationStarted(const QString& description, int total)
+{
+    if(total < BATCH_PROGRESS_MIN_TRANSFERS)
+    {
+        return;
+    }
+
+    if(!mBatchProgress)
+    {
+        mBatchProgress = new QProgressDialog(this);
+        mBatchProgress->setWindowModality(Qt::WindowModal);
+        mBatchProgress->setMinimumDuration(BATCH_PROGRESS_DELAY_MS);
+        mBatchProgress->setAutoClose(false);
+        mBatchProgress->setAutoReset(false);
+        connect(mBatchProgress.data(), &QProgressDialog::canceled, mModel->getBatchScheduler(), &TransferBatchScheduler::cancel);
+    }
+
+    mBatchProgress->setLabelText(description);
+    mBatchProgress->setMaximum(total);
+    mBatchProgress->setValue(0);
+}
+
+void TransferManager::onBatchOperationProgress(int processed, int total)
+{
+    if(mBatchProgress && mBatchProgress->maximum() == total)
+    {
+        mBatchProgress->setValue(processed);
+    }
+}
+
+void TransferManager::onBatchOperationFinished()
+{
+    if(mBatchProgress)
+    {
+        mBatchProgress->deleteLater();
+        mBatchProgress = nullptr;
+    }
+}
@@ -17,6 +17,8 @@
 #include <QTimer>
 #include <QDialog>
 #include <QMenu>
+#include <QPointer>
+#include <QProgressDialog>
 
 namespace Ui {
 class TransferManager;
@@ -75,6 +77,9 @@ protected:
 private:
     static const int SPEED_REFRESH_PERIOD_MS = 700;
     static const int STATS_REFRESH_PERIOD_MS = 1000;
+    // Bulk operations on fewer transfers finish too fast to need a progress dialog
+    static const int BATCH_PROGRESS_MIN_TRANSFERS = 1000;
+    static const int BATCH_PROGRESS_DELAY_MS = 500;
 
     Ui::TransferManager* mUi;
     mega::MegaApi* mMegaApi;
@@ -103,6 +108,7 @@ private:
     Ui::TransferManagerDragBackDrop* mUiDragBackDrop;
     QWidget* mDragBackDrop;
     TransferScanCancelUi* mTransferScanCancelUi = nullptr;
+    QPointer<QProgressDialog> mBatchProgress;
 
     int mStorageQuotaState;
     QuotaState mTransferQuotaState;
@@ -171,12 +177,17 @@ private slots:
     void onVerticalScrollBarVisibilityChanged(bool state);
 
     void refreshSpeed();
+    void showThroughputGraph();
     void refreshView();
 
     void updateTransferWidget(QWidget* widgetToShow);
     void onScanningAnimationUpdate();
 
     void onTransferQuotaExceededUpdate();
+
+    void onBatchOperationStarted(const QString& description, int total);
+    void onBatchOperationProgress(int processed, int total);
+    void onBatchOperationFinished();
 };
 
 #endif // TRANSFERMANAGER_H
@@ -29,6 +29,7 @@ TransfersWidget::TransfersWidget(QWidget* parent) :
 
     //Align header pause/cancel buttons to view pause/cancel button
     connect(ui->tvTransfers, &MegaTransferView::verticalScrollBarVisibilityChanged, this, &TransfersWidget::onVerticalScrollBarVisibilityChanged);
+    connect(ui->tvTransfers->verticalScrollBar(), &QScrollBar::valueChanged, this, &TransfersWidget::onVerticalScrollBarValueChanged);
     connect(ui->tvTransfers, &MegaTransferView::pauseResumeTransfersByContextMenu, this, &TransfersWidget::onPauseResumeTransfer);
     connect(ui->tvTransfers, &MegaTransferView::allCancelled, this, &TransfersWidget::changeToAllTransfersTab);
 
@@ -572,6 +573,15 @@ void TransfersWidget::onVerticalScrollBarVisibilityChanged(bool state)
     }
 }
 
+void TransfersWidget::onVerticalScrollBarValueChanged(int value)
+{
+    //The older transfers fetched while scrolling down are not kept once the user is back to the top
+    if(value == ui->tvTransfers->verticalScrollBar()->minimum())
+    {
+        mModel->releaseFetchedHistoryRows();
+    }
+}
+
 QString TransfersWidget::getClearTooltip(TM_TAB tab)
 {
     switch(tab)
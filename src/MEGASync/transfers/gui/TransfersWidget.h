@@ -103,6 +103,7 @@ private slots:
     void onCancelClearButtonPressedOnDelegate();
     void onRetryButtonPressedOnDelegate();
     void onVerticalScrollBarVisibilityChanged(bool state);
+    void onVerticalScrollBarValueChanged(int value);
     void onCheckPauseResumeButton();
     void togglePauseResumeButton(bool state);
     void onCheckCancelClearButton();
@@ -0,0 +1,108 @@
+#include "TransferBatchScheduler.h"
+
+#include <megaapi.h>
+
+TransferBatchScheduler::TransferBatchScheduler(QObject* parent)
+    : QObject(parent),
+      mRunning(false)
+{
+    mSliceTimer.setSingleShot(true);
+    mSliceTimer.setInterval(0);
+    connect(&mSliceTimer, &QTimer::timeout, this, &TransferBatchScheduler::processSlice);
+}
+
+void TransferBatchScheduler::schedule(const QString& description, const QList<TransferTag>& tags,
+                                      ChunkProcessor processChunk, FinishedCallback finished)
+{
+    Operation operation;
+    operation.description = description;
+    operation.tags = tags;
+    operation.processChunk = processChunk;
+    operation.finished = finished;
+    mOperations.enqueue(operation);
+
+    if(!mRunning)
+    {
+        startNextOperation();
+        //The first slice runs right away, so small operations are done when this method returns
+        mSliceTimer.stop();
+        processSlice();
+    }
+}
+
+void TransferBatchScheduler::cancel()
+{
+    if(!mRunning)
+    {
+        return;
+    }
+
+    mSliceTimer.stop();
+
+    QString message = QString::fromUtf8("Transfer batch scheduler: cancelled \"%1\" after %2 of %3 transfers, %4 operations dropped")
+            .arg(mOperations.head().description).arg(mOperations.head().processed)
+            .arg(mOperations.head().tags.size()).arg(mOperations.size() - 1);
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO, message.toUtf8().constData());
+
+    while(!mOperations.isEmpty())
+    {
+        finishOperation(true);
+    }
+    mRunning = false;
+}
+
+bool TransferBatchScheduler::isRunning() const
+{
+    return mRunning;
+}
+
+void TransferBatchScheduler::processSlice()
+{
+    if(mOperations.isEmpty())
+    {
+        mRunning = false;
+        return;
+    }
+
+    auto& operation = mOperations.head();
+    mSliceTime.start();
+
+    while(operation.processed < operation.tags.size() && mSliceTime.elapsed() < TIME_SLICE_MS)
+    {
+        auto chunk = operation.tags.mid(operation.processed, CHUNK_SIZE);
+        operation.processChunk(chunk);
+        operation.processed += chunk.size();
+    }
+
+    emit operationProgress(operation.processed, operation.tags.size());
+
+    if(operation.processed < operation.tags.size())
+    {
+        mSliceTimer.start();
+    }
+    else
+    {
+        finishOperation(false);
+        startNextOperation();
+    }
+}
+
+void TransferBatchScheduler::startNextOperation()
+{
+    mRunning = !mOperations.isEmpty();
+    if(mRunning)
+    {
+        emit operationStarted(mOperations.head().description, mOperations.head().tags.size());
+        mSliceTimer.start();
+    }
+}
+
+void TransferBatchScheduler::finishOperation(bool cancelled)
+{
+    auto operation = mOperations.dequeue();
+    if(operation.finished)
+    {
+        operation.finished(cancelled);
+    }
+    emit operationFinished(cancelled);
+}
@@ -0,0 +1,72 @@
+#ifndef TRANSFERBATCHSCHEDULER_H
+#define TRANSFERBATCHSCHEDULER_H
+
+#include "TransferItem.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+/**
+ * @brief Scheduler of the bulk transfer operations
+ *
+ * Runs bulk transfer operations (cancel, pause/resume, move) requested on thousands of transfers without
+ * freezing the GUI nor keeping the SDK busy with our requests for seconds.
+ *
+ * Operations are queued and run one after the other in the GUI thread. The tags of an operation are processed
+ * in chunks of CHUNK_SIZE, and the event loop runs again as soon as a slice has taken TIME_SLICE_MS, so the
+ * SDK mutex is taken for a bounded time each time. The running operation and the queued ones can be
+ * cancelled; the finished callback is still called so the caller can leave the SDK in a consistent state.
+ */
+class TransferBatchScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ChunkProcessor = std::function<void(const QList<TransferTag>&)>;
+    using FinishedCallback = std::function<void(bool cancelled)>;
+
+    static const int CHUNK_SIZE = 100;
+    static const int TIME_SLICE_MS = 15;
+
+    explicit TransferBatchScheduler(QObject* parent = nullptr);
+
+    void schedule(const QString& description, const QList<TransferTag>& tags,
+                  ChunkProcessor processChunk, FinishedCallback finished = nullptr);
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void operationStarted(const QString& description, int total);
+    void operationProgress(int processed, int total);
+    void operationFinished(bool cancelled);
+
+private slots:
+    void processSlice();
+
+private:
+    struct Operation
+    {
+        QString description;
+        QList<TransferTag> tags;
+        ChunkProcessor processChunk;
+        FinishedCallback finished;
+        int processed = 0;
+    };
+
+    void startNextOperation();
+    void finishOperation(bool cancelled);
+
+    QQueue<Operation> mOperations;
+    bool mRunning;
+    QTimer mSliceTimer;
+    QElapsedTimer mSliceTime;
+};
+
+#endif // TRANSFERBATCHSCHEDULER_H
@@ -0,0 +1,555 @@
+#include "TransferHistoryStore.h"
+
+#include "control/Preferences.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace
+{
+const quint32 HISTORY_MAGIC = 0x4D544853; // "MTHS"
+const quint32 HISTORY_VERSION = 1;
+const qint64 HEADER_SIZE = 2 * sizeof(quint32);
+const quint8 RECORD_TRANSFER = 1;
+const quint8 RECORD_REMOVED = 2;
+// Anything bigger is a corrupted size
+const quint32 MAX_RECORD_SIZE = 1 << 20;
+// Below this number of tombstones the file is not worth compacting
+const int MIN_TOMBSTONES_TO_COMPACT = 1000;
+const QDataStream::Version STREAM_VERSION = QDataStream::Qt_5_6;
+}
+
+TransferHistoryStore::TransferHistoryStore()
+    : mRemovedEntries(0),
+      mTombstones(0)
+{
+}
+
+TransferHistoryStore::~TransferHistoryStore()
+{
+    close();
+}
+
+bool TransferHistoryStore::open(const QString& filePath)
+{
+    QMutexLocker lock(&mMutex);
+
+    if(mFile.isOpen())
+    {
+        mFile.close();
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    mFile.setFileName(filePath);
+    if(!mFile.open(QIODevice::ReadWrite))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Transfer history: unable to open %1: %2")
+                           .arg(filePath, mFile.errorString()).toUtf8().constData());
+        return false;
+    }
+
+    if(!load())
+    {
+        mFile.close();
+        return false;
+    }
+
+    if(mTombstones > MIN_TOMBSTONES_TO_COMPACT && mTombstones > mEntries.size() - mRemovedEntries)
+    {
+        compact();
+    }
+
+    mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_INFO,
+                       QString::fromUtf8("Transfer history: %1 transfers loaded from %2 KB")
+                       .arg(mEntries.size() - mRemovedEntries).arg(mFile.size() / 1024).toUtf8().constData());
+    return true;
+}
+
+void TransferHistoryStore::close()
+{
+    QMutexLocker lock(&mMutex);
+
+    if(mFile.isOpen())
+    {
+        mFile.flush();
+        mFile.close();
+    }
+
+    mEntries.clear();
+    mIdsByNodeHandle.clear();
+    mIdsByName.clear();
+    mIdsByFinishedTime.clear();
+    mRemovedEntries = 0;
+    mTombstones = 0;
+}
+
+bool TransferHistoryStore::isOpen() const
+{
+    QMutexLocker lock(&mMutex);
+    return mFile.isOpen();
+}
+
+int TransferHistoryStore::append(const TransferData& transfer)
+{
+    QMutexLocker lock(&mMutex);
+
+    if(!mFile.isOpen())
+    {
+        return -1;
+    }
+
+    const qint64 finishedTime(Preferences::instance()->getMsDiffTimeWithSDK() + transfer.getRawFinishedTime());
+    const qint64 offset(writeRecord(serialize(transfer, finishedTime)));
+    if(offset < 0)
+    {
+        return -1;
+    }
+
+    addEntry(Entry{offset, finishedTime, transfer.mNodeHandle, nameHash(transfer.mFilename),
+                   transfer.getState() == TransferData::TRANSFER_FAILED});
+    return mEntries.size() - 1;
+}
+
+void TransferHistoryStore::remove(int historyId)
+{
+    QMutexLocker lock(&mMutex);
+
+    if(!mFile.isOpen() || !isValid(historyId))
+    {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(STREAM_VERSION);
+    stream << RECORD_REMOVED << mEntries.at(historyId).offset;
+
+    if(writeRecord(payload) >= 0)
+    {
+        removeEntry(historyId);
+        mTombstones++;
+    }
+}
+
+void TransferHistoryStore::removeAll(bool failed)
+{
+    QList<int> historyIds;
+    {
+        QMutexLocker lock(&mMutex);
+        for(int historyId = 0; historyId < mEntries.size(); ++historyId)
+        {
+            if(isValid(historyId) && mEntries.at(historyId).failed == failed)
+            {
+                historyIds.append(historyId);
+            }
+        }
+    }
+
+    if(historyIds.size() == count())
+    {
+        clear();
+        return;
+    }
+
+    for(auto historyId : historyIds)
+    {
+        remove(historyId);
+    }
+}
+
+void TransferHistoryStore::clear()
+{
+    QMutexLocker lock(&mMutex);
+
+    if(!mFile.isOpen())
+    {
+        return;
+    }
+
+    mFile.resize(0);
+    writeHeader();
+
+    mEntries.clear();
+    mIdsByNodeHandle.clear();
+    mIdsByName.clear();
+    mIdsByFinishedTime.clear();
+    mRemovedEntries = 0;
+    mTombstones = 0;
+}
+
+void TransferHistoryStore::flush()
+{
+    QMutexLocker lock(&mMutex);
+    if(mFile.isOpen())
+    {
+        mFile.flush();
+    }
+}
+
+int TransferHistoryStore::count() const
+{
+    QMutexLocker lock(&mMutex);
+    return mEntries.size() - mRemovedEntries;
+}
+
+int TransferHistoryStore::lastHistoryId() const
+{
+    QMutexLocker lock(&mMutex);
+    return mEntries.size() - 1;
+}
+
+QList<QExplicitlySharedDataPointer<TransferData>> TransferHistoryStore::readOlder(int& beforeId, int maxCount)
+{
+    QMutexLocker lock(&mMutex);
+
+    QList<QExplicitlySharedDataPointer<TransferData>> transfers;
+    int historyId(qMin(beforeId, mEntries.size()) - 1);
+    for(; historyId >= 0 && transfers.size() < maxCount; --historyId)
+    {
+        if(isValid(historyId))
+        {
+            if(auto transfer = readTransfer(historyId))
+            {
+                transfers.append(transfer);
+            }
+        }
+    }
+    beforeId = historyId + 1;
+
+    return transfers;
+}
+
+QExplicitlySharedDataPointer<TransferData> TransferHistoryStore::read(int historyId)
+{
+    QMutexLocker lock(&mMutex);
+    return isValid(historyId) ? readTransfer(historyId) : QExplicitlySharedDataPointer<TransferData>();
+}
+
+QList<int> TransferHistoryStore::findByNodeHandle(mega::MegaHandle handle) const
+{
+    QMutexLocker lock(&mMutex);
+    return mIdsByNodeHandle.values(handle);
+}
+
+QList<int> TransferHistoryStore::findByName(const QString& name)
+{
+    QMutexLocker lock(&mMutex);
+
+    // The hash may collide, so the names are checked against the records
+    QList<int> historyIds;
+    foreach(auto historyId, mIdsByName.values(nameHash(name)))
+    {
+        auto transfer = readTransfer(historyId);
+        if(transfer && transfer->mFilename.compare(name, Qt::CaseInsensitive) == 0)
+        {
+            historyIds.append(historyId);
+        }
+    }
+    return historyIds;
+}
+
+QList<int> TransferHistoryStore::findByFinishedTime(qint64 from, qint64 to) const
+{
+    QMutexLocker lock(&mMutex);
+
+    QList<int> historyIds;
+    for(auto it = mIdsByFinishedTime.lowerBound(from); it != mIdsByFinishedTime.end() && it.key() <= to; ++it)
+    {
+        historyIds.append(it.value());
+    }
+    return historyIds;
+}
+
+bool TransferHistoryStore::load()
+{
+    mEntries.clear();
+    mIdsByNodeHandle.clear();
+    mIdsByName.clear();
+    mIdsByFinishedTime.clear();
+    mRemovedEntries = 0;
+    mTombstones = 0;
+
+    if(mFile.size() < HEADER_SIZE)
+    {
+        mFile.resize(0);
+        return writeHeader();
+    }
+
+    mFile.seek(0);
+    QDataStream stream(&mFile);
+    stream.setVersion(STREAM_VERSION);
+
+    quint32 magic(0);
+    quint32 version(0);
+    stream >> magic >> version;
+    if(magic != HISTORY_MAGIC || version != HISTORY_VERSION)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING, "Transfer history: unknown file format, discarding it");
+        mFile.resize(0);
+        return writeHeader();
+    }
+
+    QHash<qint64, int> idsByOffset;
+    qint64 offset(HEADER_SIZE);
+    while(offset < mFile.size())
+    {
+        QByteArray payload(readRecord(offset));
+        if(payload.isEmpty())
+        {
+            // An interrupted append, the rest of the file can't be trusted
+            mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_WARNING,
+                               QString::fromUtf8("Transfer history: truncating corrupted tail at %1").arg(offset)
+                               .toUtf8().constData());
+            mFile.resize(offset);
+            break;
+        }
+
+        quint8 kind(0);
+        QDataStream record(payload);
+        record.setVersion(STREAM_VERSION);
+        record >> kind;
+
+        if(kind == RECORD_TRANSFER)
+        {
+            qint64 finishedTime(0);
+            if(auto transfer = deserialize(payload, &finishedTime))
+            {
+                idsByOffset.insert(offset, mEntries.size());
+                addEntry(Entry{offset, finishedTime, transfer->mNodeHandle, nameHash(transfer->mFilename),
+                               transfer->getState() == TransferData::TRANSFER_FAILED});
+            }
+        }
+        else if(kind == RECORD_REMOVED)
+        {
+            qint64 removedOffset(-1);
+            record >> removedOffset;
+            auto historyId(idsByOffset.value(removedOffset, -1));
+            if(historyId >= 0)
+            {
+                removeEntry(historyId);
+            }
+            mTombstones++;
+        }
+
+        offset += sizeof(quint32) + payload.size();
+    }
+
+    return true;
+}
+
+// Rewrites the live records in a new file, which replaces the current one only once it is complete
+bool TransferHistoryStore::compact()
+{
+    const QString filePath(mFile.fileName());
+    QSaveFile compacted(filePath);
+    if(!compacted.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&compacted);
+    stream.setVersion(STREAM_VERSION);
+    stream << HISTORY_MAGIC << HISTORY_VERSION;
+
+    for(int historyId = 0; historyId < mEntries.size(); ++historyId)
+    {
+        if(isValid(historyId))
+        {
+            QByteArray payload(readRecord(mEntries.at(historyId).offset));
+            stream << static_cast<quint32>(payload.size());
+            stream.writeRawData(payload.constData(), payload.size());
+        }
+    }
+
+    mFile.close();
+    const bool committed(compacted.commit());
+
+    mega::MegaApi::log(committed ? mega::MegaApi::LOG_LEVEL_INFO : mega::MegaApi::LOG_LEVEL_ERROR,
+                       QString::fromUtf8("Transfer history: compaction of %1 tombstones %2")
+                       .arg(mTombstones).arg(QString::fromUtf8(committed ? "done" : "failed")).toUtf8().constData());
+
+    if(!mFile.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+    return load();
+}
+
+bool TransferHistoryStore::writeHeader()
+{
+    mFile.seek(0);
+    QDataStream stream(&mFile);
+    stream.setVersion(STREAM_VERSION);
+    stream << HISTORY_MAGIC << HISTORY_VERSION;
+    return stream.status() == QDataStream::Ok;
+}
+
+// Returns the offset of the record, -1 on error
+qint64 TransferHistoryStore::writeRecord(const QByteArray& payload)
+{
+    const qint64 offset(mFile.size());
+    mFile.seek(offset);
+
+    QDataStream stream(&mFile);
+    stream.setVersion(STREAM_VERSION);
+    stream << static_cast<quint32>(payload.size());
+    stream.writeRawData(payload.constData(), payload.size());
+
+    if(stream.status() != QDataStream::Ok)
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Transfer history: write error: %1").arg(mFile.errorString())
+                           .toUtf8().constData());
+        mFile.resize(offset);
+        return -1;
+    }
+    return offset;
+}
+
+// Returns an empty payload if the record is incomplete
+QByteArray TransferHistoryStore::readRecord(qint64 offset)
+{
+    if(!mFile.seek(offset))
+    {
+        return QByteArray();
+    }
+
+    QDataStream stream(&mFile);
+    stream.setVersion(STREAM_VERSION);
+
+    quint32 size(0);
+    stream >> size;
+    if(stream.status() != QDataStream::Ok || size == 0 || size > MAX_RECORD_SIZE
+            || offset + static_cast<qint64>(sizeof(quint32) + size) > mFile.size())
+    {
+        return QByteArray();
+    }
+
+    QByteArray payload(static_cast<int>(size), Qt::Uninitialized);
+    if(stream.readRawData(payload.data(), payload.size()) != payload.size())
+    {
+        return QByteArray();
+    }
+    return payload;
+}
+
+void TransferHistoryStore::addEntry(const Entry& entry)
+{
+    const int historyId(mEntries.size());
+    mEntries.append(entry);
+    mIdsByNodeHandle.insert(entry.nodeHandle, historyId);
+    mIdsByName.insert(entry.nameHash, historyId);
+    mIdsByFinishedTime.insert(entry.finishedTime, historyId);
+}
+
+void TransferHistoryStore::removeEntry(int historyId)
+{
+    auto& entry(mEntries[historyId]);
+    mIdsByNodeHandle.remove(entry.nodeHandle, historyId);
+    mIdsByName.remove(entry.nameHash, historyId);
+    mIdsByFinishedTime.remove(entry.finishedTime, historyId);
+    entry.offset = -1;
+    mRemovedEntries++;
+}
+
+bool TransferHistoryStore::isValid(int historyId) const
+{
+    return historyId >= 0 && historyId < mEntries.size() && mEntries.at(historyId).offset >= 0;
+}
+
+QExplicitlySharedDataPointer<TransferData> TransferHistoryStore::readTransfer(int historyId)
+{
+    auto transfer = deserialize(readRecord(mEntries.at(historyId).offset));
+    if(transfer)
+    {
+        transfer->mHistoryId = historyId;
+        transfer->mTag = FIRST_HISTORY_TAG + historyId;
+        transfer->mFinishedTime -= Preferences::instance()->getMsDiffTimeWithSDK();
+    }
+    return transfer;
+}
+
+QByteArray TransferHistoryStore::serialize(const TransferData& transfer, qint64 finishedTime)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(STREAM_VERSION);
+
+    stream << RECORD_TRANSFER
+           << finishedTime
+           << static_cast<quint64>(transfer.mNodeHandle)
+           << static_cast<quint64>(transfer.mParentHandle)
+           << static_cast<qint32>(transfer.mType)
+           << static_cast<qint32>(transfer.getState())
+           << static_cast<qint32>(transfer.mErrorCode)
+           << static_cast<qint64>(transfer.mErrorValue)
+           << static_cast<quint64>(transfer.mTotalSize)
+           << static_cast<quint64>(transfer.mTransferredBytes)
+           << static_cast<quint64>(transfer.mSpeed)
+           << static_cast<qint32>(transfer.mFileType)
+           << transfer.mFilename
+           << transfer.mPath;
+
+    return payload;
+}
+
+// The finished time is left as stored, in deciseconds since epoch
+QExplicitlySharedDataPointer<TransferData> TransferHistoryStore::deserialize(const QByteArray& payload, qint64* finishedTime)
+{
+    QDataStream stream(payload);
+    stream.setVersion(STREAM_VERSION);
+
+    quint8 kind(0);
+    qint64 time(0);
+    quint64 nodeHandle(0);
+    quint64 parentHandle(0);
+    qint32 type(0);
+    qint32 state(0);
+    qint32 errorCode(0);
+    qint64 errorValue(0);
+    quint64 totalSize(0);
+    quint64 transferredBytes(0);
+    quint64 speed(0);
+    qint32 fileType(0);
+    QString filename;
+    QString path;
+
+    stream >> kind >> time >> nodeHandle >> parentHandle >> type >> state >> errorCode >> errorValue
+           >> totalSize >> transferredBytes >> speed >> fileType >> filename >> path;
+
+    if(kind != RECORD_TRANSFER || stream.status() != QDataStream::Ok)
+    {
+        return QExplicitlySharedDataPointer<TransferData>();
+    }
+
+    QExplicitlySharedDataPointer<TransferData> transfer(new TransferData());
+    transfer->mNodeHandle = nodeHandle;
+    transfer->mParentHandle = parentHandle;
+    transfer->mType = TransferData::TransferTypes(QFlag(type));
+    transfer->mErrorCode = errorCode;
+    transfer->mErrorValue = errorValue;
+    transfer->mTotalSize = totalSize;
+    transfer->mTransferredBytes = transferredBytes;
+    transfer->mSpeed = speed;
+    transfer->mMeanSpeed = speed;
+    transfer->mFileType = static_cast<Utilities::FileType>(fileType);
+    transfer->mFilename = filename;
+    transfer->mPath = path;
+    transfer->mFinishedTime = time;
+    transfer->setState(static_cast<TransferData::TransferState>(state));
+    transfer->resetStateHasChanged();
+
+    if(finishedTime)
+    {
+        *finishedTime = time;
+    }
+    return transfer;
+}
+
+uint TransferHistoryStore::nameHash(const QString& name)
+{
+    return qHash(name.toLower());
+}
@@ -0,0 +1,92 @@
+#ifndef TRANSFERHISTORYSTORE_H
+#define TRANSFERHISTORYSTORE_H
+
+#include "TransferItem.h"
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+
+/**
+ * @brief On disk store of the finished transfers
+ *
+ * Keeps the completed and failed transfers of an account on disk, so the history is not lost on restart and
+ * does not need to be kept in memory.
+ *
+ * Records are appended to a single file and never rewritten; removing a transfer appends a tombstone. The
+ * file is scanned once on open to build an index by finish time, node handle and name, and it is compacted
+ * when the tombstones outnumber the transfers. History ids are the positions in the index, so they are only
+ * valid until the store is closed.
+ */
+class TransferHistoryStore
+{
+public:
+    // Tags given to the transfers read from the history, far from the SDK ones
+    static const TransferTag FIRST_HISTORY_TAG = 0x70000000;
+
+    TransferHistoryStore();
+    ~TransferHistoryStore();
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const;
+
+    // Return the history id given to the transfer, -1 if it could not be stored
+    int append(const TransferData& transfer);
+    void remove(int historyId);
+    void removeAll(bool failed);
+    void clear();
+    void flush();
+
+    int count() const;
+    int lastHistoryId() const;
+
+    // Up to maxCount transfers with an id lower than beforeId, the newest first. beforeId is updated
+    // to continue reading from the last transfer read
+    QList<QExplicitlySharedDataPointer<TransferData>> readOlder(int& beforeId, int maxCount);
+    QExplicitlySharedDataPointer<TransferData> read(int historyId);
+
+    QList<int> findByNodeHandle(mega::MegaHandle handle) const;
+    QList<int> findByName(const QString& name);
+    // Finish times in deciseconds since epoch
+    QList<int> findByFinishedTime(qint64 from, qint64 to) const;
+
+private:
+    struct Entry
+    {
+        // Offset of the record in the file, -1 once removed
+        qint64 offset;
+        qint64 finishedTime;
+        mega::MegaHandle nodeHandle;
+        uint nameHash;
+        bool failed;
+    };
+
+    bool load();
+    bool compact();
+    bool writeHeader();
+    qint64 writeRecord(const QByteArray& payload);
+    QByteArray readRecord(qint64 offset);
+    void addEntry(const Entry& entry);
+    void removeEntry(int historyId);
+    bool isValid(int historyId) const;
+    QExplicitlySharedDataPointer<TransferData> readTransfer(int historyId);
+
+    static QByteArray serialize(const TransferData& transfer, qint64 finishedTime);
+    static QExplicitlySharedDataPointer<TransferData> deserialize(const QByteArray& payload, qint64* finishedTime = nullptr);
+    static uint nameHash(const QString& name);
+
+    mutable QMutex mMutex;
+    QFile mFile;
+    QVector<Entry> mEntries;
+    QMultiHash<mega::MegaHandle, int> mIdsByNodeHandle;
+    QMultiHash<uint, int> mIdsByName;
+    QMultiMap<qint64, int> mIdsByFinishedTime;
+    int mRemovedEntries;
+    int mTombstones;
+};
+
+#endif // TRANSFERHISTORYSTORE_H
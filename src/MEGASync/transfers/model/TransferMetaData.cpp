@@ -52,14 +52,17 @@ bool TransferMetaData::isRetriedFolder(mega::MegaTransfer* transfer)
     }
     else
     {
-        foreach(auto folder, mFolders)
+        auto tagIt = mFolderTagsByPath.constFind(QString::fromUtf8(transfer->getPath()));
+        if(tagIt != mFolderTagsByPath.constEnd())
         {
-            if(folder->id.path == QString::fromUtf8(transfer->getPath()))
+            TransferMetaDataItemId previousId(tagIt.value(), mega::INVALID_HANDLE);
+            auto folder = mFolders.value(previousId);
+            if(folder)
             {
-                mFolders.remove(folder->id);
+                removeFolder(folder->id);
                 //Update id with new tag (retried tag)
                 TransferMetaDataItemId id(transfer->getTag(), folder->id.handle, folder->id.name, folder->id.path);
-                mFolders.insert(id, folder);
+                insertFolder(id, folder);
                 return true;
             }
         }
@@ -68,6 +71,30 @@ bool TransferMetaData::isRetriedFolder(mega::MegaTransfer* transfer)
     return false;
 }
 
+void TransferMetaData::insertFolder(const TransferMetaDataItemId& id, const std::shared_ptr<TransferMetaDataFolderItem>& folder)
+{
+    mFolders.insert(id, folder);
+    if(!id.path.isEmpty())
+    {
+        mFolderTagsByPath.insert(id.path, id.tag);
+    }
+    TransferMetaDataContainer::addFolderTag(id.tag, mAppId);
+}
+
+void TransferMetaData::removeFolder(const TransferMetaDataItemId& id)
+{
+    auto folder = mFolders.take(id);
+    if(folder)
+    {
+        auto tagIt = mFolderTagsByPath.find(folder->id.path);
+        if(tagIt != mFolderTagsByPath.end() && tagIt.value() == folder->id.tag)
+        {
+            mFolderTagsByPath.erase(tagIt);
+        }
+        TransferMetaDataContainer::removeFolderTag(folder->id.tag, mAppId);
+    }
+}
+
 void TransferMetaData::remove()
 {
     TransferMetaDataContainer::removeAppData(mAppId);
@@ -110,7 +137,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
         auto value = mFolders.value(id);
         if(value)
         {
-            mFolders.remove(id);
+            removeFolder(id);
 
             value->id = id;
             TransferData::TransferState state(TransferData::TRANSFER_NONE);
@@ -138,7 +165,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 //Update Key
                 else
                 {
-                    mFolders.insert(id, value);
+                    insertFolder(id, value);
                 }
             }
             else
@@ -153,7 +180,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                     }
                     else
                     {
-                        nonExistData->mFolders.insert(id, value);
+                        nonExistData->insertFolder(id, value);
                     }
                 }
             }
@@ -445,7 +472,7 @@ void TransferMetaData::addFileFromFolder(int folderTag, int fileTag)
     if(!folderItem)
     {
         folderItem = std::make_shared<TransferMetaDataFolderItem>(folderId);
-        mFolders.insert(folderId,folderItem);
+        insertFolder(folderId, folderItem);
 
         addInitialPendingTopLevelTransferFromOtherSession(true);
     }
@@ -501,7 +528,16 @@ void TransferMetaData::checkAndSendNotification()
                 nonExistData->mFiles.nonExistFailedTransfers = nonExistFiles;
 
                 nonExistData->mEmptyFolders = mEmptyFolders;
-                nonExistData->mFolders = mFolders;
+
+                //Through removeFolder and insertFolder, so the folder tag index points to the copied folders
+                foreach(auto folderId, nonExistData->mFolders.keys())
+                {
+                    nonExistData->removeFolder(folderId);
+                }
+                for(auto folderIt = mFolders.cbegin(); folderIt != mFolders.cend(); ++folderIt)
+                {
+                    nonExistData->insertFolder(folderIt.key(), folderIt.value());
+                }
 
                 nonExistData->mFiles.setHasChanged(false);
 
@@ -626,7 +662,7 @@ void TransferMetaData::start(mega::MegaTransfer *transfer)
         {
             TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
             auto folderItem = std::make_shared<TransferMetaDataFolderItem>(id);
-            mFolders.insert(id,folderItem);
+            insertFolder(id, folderItem);
         }
         else
         {
@@ -655,10 +691,7 @@ void TransferMetaData::retryFileFromFolderFailingItem(int fileTag, int folderTag
     if(removed != 0)
     {
         TransferMetaDataItemId folderId(folderTag, mega::INVALID_HANDLE);
-        if(mFolders.contains(folderId))
-        {
-            mFolders.remove(folderId);
-        }
+        removeFolder(folderId);
 
         addInitialPendingTopLevelTransfer();
     }
@@ -954,7 +987,10 @@ bool UploadTransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaErro
 //////////CONTAINER AND MANAGER
 
 QHash<unsigned long long, std::shared_ptr<TransferMetaData>> TransferMetaDataContainer::transferAppData = QHash<unsigned long long, std::shared_ptr<TransferMetaData>>();
-QMutex TransferMetaDataContainer::mMutex;
+QReadWriteLock TransferMetaDataContainer::mLock;
+QHash<int, unsigned long long> TransferMetaDataContainer::mAppIdByFolderTag = QHash<int, unsigned long long>();
+QMultiHash<unsigned long long, int> TransferMetaDataContainer::mFolderTagsByAppId = QMultiHash<unsigned long long, int>();
+QReadWriteLock TransferMetaDataContainer::mFolderTagsLock;
 
 bool TransferMetaDataContainer::start(mega::MegaTransfer *transfer)
 {
@@ -1017,7 +1053,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
         {
             if(!transfer->isFolderTransfer())
             {
-                QMutexLocker lock(&mMutex);
+                QWriteLocker lock(&mLock);
                 data->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
             }
 
@@ -1027,7 +1063,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 if(nonExistData)
                 {
                     {
-                        QMutexLocker lock(&mMutex);
+                        QWriteLocker lock(&mLock);
                         nonExistData->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
                     }
 
@@ -1047,7 +1083,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
         if(data)
         {
             {
-                QMutexLocker lock(&mMutex);
+                QWriteLocker lock(&mLock);
                 data->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(),transfer->getNodeHandle());
             }
 
@@ -1057,7 +1093,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 if(nonExistData)
                 {
                     {
-                        QMutexLocker lock(&mMutex);
+                        QWriteLocker lock(&mLock);
                         nonExistData->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(), transfer->getNodeHandle());
                     }
 
@@ -1074,7 +1110,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
 
 bool TransferMetaDataContainer::addAppData(unsigned long long appId, std::shared_ptr<TransferMetaData> data)
 {
-    QMutexLocker lock(&mMutex);
+    QWriteLocker lock(&mLock);
     return transferAppData.insert(appId, data) != transferAppData.end();
 }
 
@@ -1083,8 +1119,53 @@ void TransferMetaDataContainer::removeAppData(unsigned long long appId)
     auto data = TransferMetaDataContainer::getAppDataById(appId);
     if(data)
     {
-        QMutexLocker lock(&mMutex);
-        transferAppData.remove(appId);
+        {
+            QWriteLocker lock(&mLock);
+            transferAppData.remove(appId);
+        }
+
+        QWriteLocker tagsLock(&mFolderTagsLock);
+        foreach(auto tag, mFolderTagsByAppId.values(appId))
+        {
+            auto it = mAppIdByFolderTag.find(tag);
+            if(it != mAppIdByFolderTag.end() && it.value() == appId)
+            {
+                mAppIdByFolderTag.erase(it);
+            }
+        }
+        mFolderTagsByAppId.remove(appId);
+    }
+}
+
+void TransferMetaDataContainer::addFolderTag(int tag, unsigned long long appId)
+{
+    if(tag > 0)
+    {
+        QWriteLocker lock(&mFolderTagsLock);
+        auto previousAppId = mAppIdByFolderTag.value(tag, appId);
+        if(previousAppId != appId)
+        {
+            mFolderTagsByAppId.remove(previousAppId, tag);
+        }
+        mAppIdByFolderTag.insert(tag, appId);
+        if(!mFolderTagsByAppId.contains(appId, tag))
+        {
+            mFolderTagsByAppId.insert(appId, tag);
+        }
+    }
+}
+
+void TransferMetaDataContainer::removeFolderTag(int tag, unsigned long long appId)
+{
+    if(tag > 0)
+    {
+        QWriteLocker lock(&mFolderTagsLock);
+        auto it = mAppIdByFolderTag.find(tag);
+        if(it != mAppIdByFolderTag.end() && it.value() == appId)
+        {
+            mAppIdByFolderTag.erase(it);
+        }
+        mFolderTagsByAppId.remove(appId, tag);
     }
 }
 
@@ -6,6 +6,7 @@
 #include <QPair>
 #include <QPointer>
 #include <QMutex>
+#include <QReadWriteLock>
 
 #include <Preferences.h>
 #include "TransferItem.h"
@@ -329,6 +330,12 @@ protected:
     TransferMetaDataItemsByState<TransferMetaDataFolderItem> mEmptyFolders;
     int getEmptyFolders(const QMap<TransferMetaDataItemId, std::shared_ptr<TransferMetaDataFolderItem> > &folders) const;
 
+    //Every change to mFolders goes through these methods, so the container folder tag index is kept up to date
+    void insertFolder(const TransferMetaDataItemId& id, const std::shared_ptr<TransferMetaDataFolderItem>& folder);
+    void removeFolder(const TransferMetaDataItemId& id);
+    //Local path -> current folder tag. Used to find the retried folders, which get a new tag
+    QHash<QString, int> mFolderTagsByPath;
+
     int mTransferDirection;
     bool mCreateRootFolder;
     unsigned long long mAppId;
@@ -418,7 +425,7 @@ public:
     static void retryTransfer(mega::MegaTransfer* transfer, unsigned long long appDataId);
     static void retryAllPressed()
     {
-        QMutexLocker lock(&mMutex);
+        QWriteLocker lock(&mLock);
         foreach(auto& appdata, transferAppData)
         {
             appdata->retryAllPressed();
@@ -447,7 +454,7 @@ public:
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppDataById(unsigned long long appId)
     {
-        QMutexLocker lock(&mMutex);
+        QReadLocker lock(&mLock);
         auto data = transferAppData.value(appId);
         return std::dynamic_pointer_cast<TYPE>(data);
     }
@@ -466,22 +473,26 @@ public:
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppDataByFolderTransferTag(int tag)
     {
-        QMutexLocker lock(&mMutex);
-        TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
-        foreach(auto& appdata, transferAppData)
+        unsigned long long appId(0);
         {
-            if(appdata->isRetriedFolder(id))
+            QReadLocker lock(&mFolderTagsLock);
+            auto it = mAppIdByFolderTag.constFind(tag);
+            if(it == mAppIdByFolderTag.constEnd())
             {
-                return std::dynamic_pointer_cast<TYPE>(appdata);
+                return nullptr;
             }
+            appId = it.value();
         }
 
-        return nullptr;
+        return getAppDataById<TYPE>(appId);
     }
 
     static bool addAppData(unsigned long long appId, std::shared_ptr<TransferMetaData> data);
     static void removeAppData(unsigned long long appId);
 
+    static void addFolderTag(int tag, unsigned long long appId);
+    static void removeFolderTag(int tag, unsigned long long appId);
+
     template <typename TYPE, typename... A>
     static std::shared_ptr<TYPE> createTransferMetaData(A &&...args)
     {
@@ -512,7 +523,15 @@ public:
 
 private:
     static QHash<unsigned long long, std::shared_ptr<TransferMetaData>> transferAppData;
-    static QMutex mMutex;
+    //Lookups are far more frequent than insertions and removals, mainly from nested files of folder transfers
+    static QReadWriteLock mLock;
+
+    //Folder transfer tag -> appId of the TransferMetaData containing the folder, and the reverse index to
+    //drop the tags of a removed TransferMetaData. Guarded by its own lock, as folders are added and removed
+    //by TransferMetaData methods which may run with mLock held
+    static QHash<int, unsigned long long> mAppIdByFolderTag;
+    static QMultiHash<unsigned long long, int> mFolderTagsByAppId;
+    static QReadWriteLock mFolderTagsLock;
 };
 
 #endif // TRANSFERMETADATA_H
@@ -0,0 +1,148 @@
+#include "TransferTagSet.h"
+
+namespace
+{
+const int BITS_PER_WORD = 64;
+
+qint64 wordStart(qint64 tag)
+{
+    // Rounded towards minus infinity, tags can be negative
+    return (tag >= 0 ? tag : tag - (BITS_PER_WORD - 1)) / BITS_PER_WORD * BITS_PER_WORD;
+}
+}
+
+TransferTagSet::TransferTagSet()
+    : mFirstTag(0),
+      mSize(0)
+{
+}
+
+bool TransferTagSet::insert(TransferTag tag)
+{
+    if(!isInBitmap(tag) && !growBitmap(tag))
+    {
+        if(mOutliers.contains(tag))
+        {
+            return false;
+        }
+        mOutliers.insert(tag);
+        mSize++;
+        return true;
+    }
+
+    const qint64 bit(tag - mFirstTag);
+    quint64& word(mWords[static_cast<int>(bit / BITS_PER_WORD)]);
+    const quint64 mask(quint64(1) << (bit % BITS_PER_WORD));
+    if(word & mask)
+    {
+        return false;
+    }
+    word |= mask;
+    mSize++;
+    return true;
+}
+
+bool TransferTagSet::remove(TransferTag tag)
+{
+    if(isInBitmap(tag))
+    {
+        const qint64 bit(tag - mFirstTag);
+        quint64& word(mWords[static_cast<int>(bit / BITS_PER_WORD)]);
+        const quint64 mask(quint64(1) << (bit % BITS_PER_WORD));
+        if(word & mask)
+        {
+            word &= ~mask;
+            mSize--;
+            return true;
+        }
+    }
+    else if(mOutliers.remove(tag))
+    {
+        mSize--;
+        return true;
+    }
+
+    return false;
+}
+
+bool TransferTagSet::contains(TransferTag tag) const
+{
+    if(isInBitmap(tag))
+    {
+        const qint64 bit(tag - mFirstTag);
+        return mWords.at(static_cast<int>(bit / BITS_PER_WORD)) & (quint64(1) << (bit % BITS_PER_WORD));
+    }
+
+    return mOutliers.contains(tag);
+}
+
+int TransferTagSet::size() const
+{
+    return mSize;
+}
+
+bool TransferTagSet::isEmpty() const
+{
+    return mSize == 0;
+}
+
+void TransferTagSet::clear()
+{
+    mWords.fill(0);
+    mOutliers.clear();
+    mSize = 0;
+}
+
+bool TransferTagSet::isInBitmap(TransferTag tag) const
+{
+    return tag >= mFirstTag && tag < mFirstTag + static_cast<qint64>(mWords.size()) * BITS_PER_WORD;
+}
+
+bool TransferTagSet::growBitmap(TransferTag tag)
+{
+    if(mWords.isEmpty())
+    {
+        mFirstTag = wordStart(tag);
+        mWords.resize(1);
+        return true;
+    }
+
+    const qint64 lastTag(mFirstTag + static_cast<qint64>(mWords.size()) * BITS_PER_WORD);
+    const qint64 newFirstTag(qMin(mFirstTag, wordStart(tag)));
+    const qint64 newLastTag(qMax(lastTag, wordStart(tag) + BITS_PER_WORD));
+    if(newLastTag - newFirstTag > MAX_BITMAP_TAGS)
+    {
+        return false;
+    }
+
+    if(newFirstTag < mFirstTag)
+    {
+        mWords.insert(0, static_cast<int>((mFirstTag - newFirstTag) / BITS_PER_WORD), 0);
+        mFirstTag = newFirstTag;
+    }
+    else
+    {
+        // Grown by half to keep amortized constant time insertions of increasing tags
+        const int neededWords(static_cast<int>((newLastTag - mFirstTag) / BITS_PER_WORD));
+        const int maxWords(MAX_BITMAP_TAGS / BITS_PER_WORD);
+        mWords.resize(qMin(maxWords, qMax(neededWords, mWords.size() + mWords.size() / 2)));
+    }
+
+    // Outliers now covered by the bitmap are moved into it
+    auto outlier = mOutliers.begin();
+    while(outlier != mOutliers.end())
+    {
+        if(isInBitmap(*outlier))
+        {
+            const qint64 bit(*outlier - mFirstTag);
+            mWords[static_cast<int>(bit / BITS_PER_WORD)] |= quint64(1) << (bit % BITS_PER_WORD);
+            outlier = mOutliers.erase(outlier);
+        }
+        else
+        {
+            ++outlier;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef TRANSFERTAGSET_H
+#define TRANSFERTAGSET_H
+
+#include "TransferItem.h"
+
+#include <QSet>
+#include <QVector>
+
+/**
+ * @brief Set of transfer tags with a constant time size
+ *
+ * SDK tags of a session are consecutive, so the tags are kept in a bitmap covering the range between the
+ * lowest and the highest tag inserted (300k transfers take less than 40 KB). Tags that would make the bitmap
+ * span more than MAX_BITMAP_TAGS are kept apart in a QSet.
+ */
+class TransferTagSet
+{
+public:
+    static const int MAX_BITMAP_TAGS = 1 << 24;
+
+    TransferTagSet();
+
+    // Return true if the set has changed
+    bool insert(TransferTag tag);
+    bool remove(TransferTag tag);
+
+    bool contains(TransferTag tag) const;
+    int size() const;
+    bool isEmpty() const;
+
+    // The bitmap memory is kept to be reused when the set is filled again
+    void clear();
+
+private:
+    bool isInBitmap(TransferTag tag) const;
+    bool growBitmap(TransferTag tag);
+
+    QVector<quint64> mWords;
+    // Tag of the first bit of mWords. Multiple of 64
+    qint64 mFirstTag;
+    QSet<TransferTag> mOutliers;
+    int mSize;
+};
+
+#endif // TRANSFERTAGSET_H
@@ -0,0 +1,220 @@
+#include "TransferThroughputHistory.h"
+
+#include <megaapi.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+namespace
+{
+const int SAMPLE_INTERVAL_MS = 1000;
+// Seconds without bytes before the sampling stops
+const int IDLE_TICKS_TO_STOP = 10;
+
+// 10 minutes of seconds, 24 hours of minutes and 30 days of hours
+const int BUCKET_SECONDS[TransferThroughputHistory::RESOLUTIONS] = {1, 60, 3600};
+const int CAPACITY[TransferThroughputHistory::RESOLUTIONS] = {600, 1440, 720};
+}
+
+TransferThroughputHistory::TransferThroughputHistory(QObject* parent)
+    : QObject(parent),
+      mSampling(false),
+      mIdleTicks(0)
+{
+    for(auto& pendingBytes : mPendingBytes)
+    {
+        pendingBytes = 0;
+    }
+
+    for(int resolution = 0; resolution < RESOLUTIONS; ++resolution)
+    {
+        mRings[resolution].samples.resize(CAPACITY[resolution]);
+    }
+
+    mSampleTimer.setInterval(SAMPLE_INTERVAL_MS);
+    connect(&mSampleTimer, &QTimer::timeout, this, &TransferThroughputHistory::onSampleTimer);
+}
+
+void TransferThroughputHistory::addBytes(Direction direction, long long bytes)
+{
+    if(bytes <= 0)
+    {
+        return;
+    }
+
+    mPendingBytes[direction].fetch_add(static_cast<quint64>(bytes), std::memory_order_relaxed);
+
+    //The timer lives in the GUI thread
+    if(!mSampling.exchange(true))
+    {
+        QMetaObject::invokeMethod(&mSampleTimer, "start", Qt::QueuedConnection);
+    }
+}
+
+QVector<TransferThroughputHistory::Sample> TransferThroughputHistory::getSamples(Resolution resolution) const
+{
+    const Ring& ring(mRings[resolution]);
+
+    //The bucket in progress is left out, its interval would be shorter than the others
+    QVector<Sample> samples;
+    samples.reserve(ring.size);
+    for(int pos = 0; pos < ring.size; ++pos)
+    {
+        samples.append(ring.samples.at((ring.first + pos) % ring.samples.size()));
+    }
+    return samples;
+}
+
+bool TransferThroughputHistory::exportCsv(const QString& filePath, Resolution resolution) const
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        mega::MegaApi::log(mega::MegaApi::LOG_LEVEL_ERROR,
+                           QString::fromUtf8("Throughput history: unable to export to %1: %2")
+                           .arg(filePath, file.errorString()).toUtf8().constData());
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "time_utc,interval_seconds,upload_bytes,download_bytes\n";
+    foreach(auto sample, getSamples(resolution))
+    {
+        stream << QDateTime::fromMSecsSinceEpoch(sample.time * 1000).toUTC().toString(Qt::ISODate) << ','
+               << BUCKET_SECONDS[resolution] << ','
+               << sample.bytes[UPLOAD] << ','
+               << sample.bytes[DOWNLOAD] << '\n';
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+int TransferThroughputHistory::bucketSeconds(Resolution resolution)
+{
+    return BUCKET_SECONDS[resolution];
+}
+
+int TransferThroughputHistory::capacity(Resolution resolution)
+{
+    return CAPACITY[resolution];
+}
+
+void TransferThroughputHistory::onSampleTimer()
+{
+    //The bytes received since the last tick belong to the second that has just ended
+    Sample sample{QDateTime::currentMSecsSinceEpoch() / 1000 - 1,
+                  {mPendingBytes[UPLOAD].exchange(0), mPendingBytes[DOWNLOAD].exchange(0)}};
+    addToBucket(SECONDS, sample);
+
+    if(sample.bytes[UPLOAD] == 0 && sample.bytes[DOWNLOAD] == 0)
+    {
+        if(++mIdleTicks >= IDLE_TICKS_TO_STOP)
+        {
+            mIdleTicks = 0;
+            mSampleTimer.stop();
+            closeBuckets();
+            mSampling = false;
+
+            //Bytes added while stopping would not restart the timer
+            if((mPendingBytes[UPLOAD] || mPendingBytes[DOWNLOAD]) && !mSampling.exchange(true))
+            {
+                mSampleTimer.start();
+            }
+        }
+    }
+    else
+    {
+        mIdleTicks = 0;
+    }
+
+    emit secondSampled(sample.bytes[UPLOAD], sample.bytes[DOWNLOAD]);
+    emit samplesUpdated();
+}
+
+//Completed buckets are pushed to the ring and added to the next resolution
+void TransferThroughputHistory::addToBucket(Resolution resolution, const Sample& sample)
+{
+    Ring& ring(mRings[resolution]);
+    const qint64 bucketStart(sample.time - sample.time % BUCKET_SECONDS[resolution]);
+
+    if(ring.current.time == bucketStart)
+    {
+        ring.current.bytes[UPLOAD] += sample.bytes[UPLOAD];
+        ring.current.bytes[DOWNLOAD] += sample.bytes[DOWNLOAD];
+        return;
+    }
+
+    if(ring.current.time >= 0)
+    {
+        push(resolution, ring.current);
+        if(resolution + 1 < RESOLUTIONS)
+        {
+            addToBucket(static_cast<Resolution>(resolution + 1), ring.current);
+        }
+    }
+
+    ring.current = Sample{bucketStart, {sample.bytes[UPLOAD], sample.bytes[DOWNLOAD]}};
+}
+
+void TransferThroughputHistory::push(Resolution resolution, const Sample& sample)
+{
+    Ring& ring(mRings[resolution]);
+    const int capacity(ring.samples.size());
+    const int bucket(BUCKET_SECONDS[resolution]);
+
+    auto append = [&ring, capacity](const Sample& newSample)
+    {
+        ring.samples[(ring.first + ring.size) % capacity] = newSample;
+        if(ring.size < capacity)
+        {
+            ring.size++;
+        }
+        else
+        {
+            ring.first = (ring.first + 1) % capacity;
+        }
+    };
+
+    if(ring.size > 0)
+    {
+        //A bucket closed when the sampling stopped, which goes on after it started again
+        Sample& last(ring.samples[(ring.first + ring.size - 1) % capacity]);
+        if(last.time == sample.time)
+        {
+            last.bytes[UPLOAD] += sample.bytes[UPLOAD];
+            last.bytes[DOWNLOAD] += sample.bytes[DOWNLOAD];
+            return;
+        }
+
+        //Buckets without samples while the sampling was stopped
+        const qint64 missing(qMin<qint64>((sample.time - last.time) / bucket - 1, capacity - 1));
+        for(qint64 gap = missing; gap > 0; --gap)
+        {
+            append(Sample{sample.time - gap * bucket, {0, 0}});
+        }
+    }
+
+    append(sample);
+}
+
+//Without new seconds the coarser buckets in progress would not be pushed until the sampling starts again
+void TransferThroughputHistory::closeBuckets()
+{
+    for(int resolution = 0; resolution < RESOLUTIONS; ++resolution)
+    {
+        Ring& ring(mRings[resolution]);
+        if(ring.current.time < 0)
+        {
+            continue;
+        }
+
+        push(static_cast<Resolution>(resolution), ring.current);
+        if(resolution + 1 < RESOLUTIONS)
+        {
+            addToBucket(static_cast<Resolution>(resolution + 1), ring.current);
+        }
+        ring.current.time = -1;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef TRANSFERTHROUGHPUTHISTORY_H
+#define TRANSFERTHROUGHPUTHISTORY_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+
+/**
+ * @brief History of the transfer throughput
+ *
+ * Keeps the bytes transferred per second, minute and hour in each direction, to see the sustained throughput,
+ * the stalls and the effect of the bandwidth limits over time.
+ *
+ * The transfer listener thread only adds to atomic counters. Once per second they are moved in the GUI thread
+ * to fixed size rings, which are downsampled to the coarser resolutions. The sampling stops when no bytes are
+ * received for a while, closing the buckets in progress so every view is up to date, and the skipped buckets
+ * are filled with zeros when it starts again.
+ */
+class TransferThroughputHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Direction
+    {
+        UPLOAD = 0,
+        DOWNLOAD,
+        DIRECTIONS
+    };
+
+    enum Resolution
+    {
+        SECONDS = 0,
+        MINUTES,
+        HOURS,
+        RESOLUTIONS
+    };
+
+    struct Sample
+    {
+        // Seconds since epoch of the start of the bucket
+        qint64 time;
+        quint64 bytes[DIRECTIONS];
+    };
+
+    explicit TransferThroughputHistory(QObject* parent = nullptr);
+
+    // Thread safe, lock free
+    void addBytes(Direction direction, long long bytes);
+
+    // Oldest first, the bucket in progress while sampling is not included
+    QVector<Sample> getSamples(Resolution resolution) const;
+    bool exportCsv(const QString& filePath, Resolution resolution) const;
+
+    static int bucketSeconds(Resolution resolution);
+    static int capacity(Resolution resolution);
+
+signals:
+    // Bytes of the second that has just been sampled
+    void secondSampled(quint64 uploadBytes, quint64 downloadBytes);
+    void samplesUpdated();
+
+private slots:
+    void onSampleTimer();
+
+private:
+    struct Ring
+    {
+        QVector<Sample> samples;
+        int first = 0;
+        int size = 0;
+        Sample current = Sample{-1, {0, 0}};
+    };
+
+    void addToBucket(Resolution resolution, const Sample& sample);
+    void push(Resolution resolution, const Sample& sample);
+    void closeBuckets();
+
+    std::atomic<quint64> mPendingBytes[DIRECTIONS];
+    std::atomic<bool> mSampling;
+    QTimer mSampleTimer;
+    int mIdleTicks;
+    Ring mRings[RESOLUTIONS];
+};
+
+#endif // TRANSFERTHROUGHPUTHISTORY_H
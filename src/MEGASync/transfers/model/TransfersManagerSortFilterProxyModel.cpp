@@ -77,6 +77,12 @@ void TransfersManagerSortFilterProxyModel::setSourceModel(QAbstractItemModel *so
 {
     connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
             this, &TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved, Qt::DirectConnection);
+    connect(sourceModel, &QAbstractItemModel::rowsInserted,
+            this, &TransfersManagerSortFilterProxyModel::onRowsInserted, Qt::DirectConnection);
+    connect(sourceModel, &QAbstractItemModel::dataChanged,
+            this, &TransfersManagerSortFilterProxyModel::onDataChanged, Qt::DirectConnection);
+    connect(sourceModel, &QAbstractItemModel::modelReset,
+            this, &TransfersManagerSortFilterProxyModel::resetAllCounters, Qt::DirectConnection);
 
     QSortFilterProxyModel::setSourceModel(sourceModel);
 }
@@ -123,6 +129,8 @@ void TransfersManagerSortFilterProxyModel::invalidateModel()
     QFuture<void> filtered = QtConcurrent::run([this](){
         startProcessingInOtherThread();
 
+        //The model is only invalidated when the filters change
+        recountTransfers();
         invalidate();
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
         invalidateFilter();
@@ -253,101 +261,123 @@ void TransfersManagerSortFilterProxyModel::updateFilters()
 
 bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
-    bool accept(false);
-
     QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
     const auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
 
-    if(d && d->mTag >= 0)
-    {
-        accept = (d->getState() & mTransferStates)
-                 && (d->mType & mTransferTypes)
-                 && (toInt(d->mFileType) & mFileTypes);
-
-        if(!mFilterText.isEmpty())
-        {
-            auto containsText = d->mFilename.contains(mFilterText,Qt::CaseInsensitive);
-            accept &= containsText;
+    return d && d->mTag >= 0 && acceptsTransfer(d);
+}
 
-            if(containsText)
-            {
-                if (d->mType & TransferData::TRANSFER_UPLOAD && !mUlNumber.contains(d->mTag))
-                {
-                    mUlNumber.insert(d->mTag);
-                }
-                else if (d->mType & TransferData::TRANSFER_DOWNLOAD && !mDlNumber.contains(d->mTag))
-                {
-                    mDlNumber.insert(d->mTag);
-                }
-            }
-        }
+bool TransfersManagerSortFilterProxyModel::acceptsTransfer(const QExplicitlySharedDataPointer<TransferData>& d) const
+{
+    return (d->getState() & mTransferStates)
+            && (d->mType & mTransferTypes)
+            && (toInt(d->mFileType) & mFileTypes)
+            && (mFilterText.isEmpty() || d->mFilename.contains(mFilterText, Qt::CaseInsensitive));
+}
 
-        bool isActive(false);
+//Counters are kept up to date from the source model signals, and only recounted when the filters change
+void TransfersManagerSortFilterProxyModel::updateTransfersCounters(const QExplicitlySharedDataPointer<TransferData>& d) const
+{
+    bool accept (acceptsTransfer(d));
 
-        //Not needed to add the logic when the d is a sync transfer, as the sync state is permanent
-        if(accept && (!d->isCompleted() && !d->isCompleting()))
+    if(!mFilterText.isEmpty() && d->mFilename.contains(mFilterText,Qt::CaseInsensitive))
+    {
+        if (d->mType & TransferData::TRANSFER_UPLOAD)
         {
-            //As the active state can change in time, add both logics to add or remove
-            if(d->isActiveOrPending())
-            {
-                mActiveTransfers.insert(d->mTag);
-                isActive = true;
-            }
-
-            //As the No sync does not change in time, the remove logic is not added
-            if(!d->isSyncTransfer())
-            {
-                mNoSyncTransfers.insert(d->mTag);
-            }
+            mUlNumber.insert(d->mTag);
         }
-
-        if(!isActive)
+        else if (d->mType & TransferData::TRANSFER_DOWNLOAD)
         {
-            removeActiveTransferFromCounter(d->mTag);
+            mDlNumber.insert(d->mTag);
         }
+    }
 
-        if(accept && (d->isActiveOrPending() && d->isCompleting()))
-        {
-            mCompletingTransfers.insert(d->mTag);
-        }
-        else
-        {
-            removeCompletingTransferFromCounter(d->mTag);
-        }
+    bool isActive(false);
 
-        if(accept && d->isPaused())
-        {
-            mPausedTransfers.insert(d->mTag);
-        }
-        else
+    //Not needed to add the logic when the d is a sync transfer, as the sync state is permanent
+    if(accept && (!d->isCompleted() && !d->isCompleting()))
+    {
+        //As the active state can change in time, add both logics to add or remove
+        if(d->isActiveOrPending())
         {
-            removePausedTransferFromCounter(d->mTag);
+            mActiveTransfers.insert(d->mTag);
+            isActive = true;
         }
 
-        if(accept && ((d->isCompleted() && !d->isFailed())))
+        //As the No sync does not change in time, the remove logic is not added
+        if(!d->isSyncTransfer())
         {
-            mCompletedTransfers.insert(d->mTag);
-        }
-        else
-        {
-            removeCompletedTransferFromCounter(d->mTag);
+            mNoSyncTransfers.insert(d->mTag);
         }
+    }
+
+    if(!isActive)
+    {
+        removeActiveTransferFromCounter(d->mTag);
+    }
+
+    if(accept && (d->isActiveOrPending() && d->isCompleting()))
+    {
+        mCompletingTransfers.insert(d->mTag);
+    }
+    else
+    {
+        removeCompletingTransferFromCounter(d->mTag);
+    }
+
+    if(accept && d->isPaused())
+    {
+        mPausedTransfers.insert(d->mTag);
+    }
+    else
+    {
+        removePausedTransferFromCounter(d->mTag);
+    }
 
-        if(accept && d->isFailed())
+    if(accept && ((d->isCompleted() && !d->isFailed())))
+    {
+        mCompletedTransfers.insert(d->mTag);
+    }
+    else
+    {
+        removeCompletedTransferFromCounter(d->mTag);
+    }
+
+    if(accept && d->isFailed())
+    {
+        mFailedTransfers.insert(d->mTag);
+        if(!d->canBeRetried())
         {
-            mFailedTransfers.insert(d->mTag);
-            if(!d->canBeRetried())
-            {
-                mPermanentFailedTransfers.insert(d->mTag);
-            }
+            mPermanentFailedTransfers.insert(d->mTag);
         }
-        else
+    }
+    else
+    {
+        removeFailedTransferFromCounter(d->mTag);
+    }
+}
+
+void TransfersManagerSortFilterProxyModel::updateTransfersCounters(const QModelIndex& parent, int first, int last)
+{
+    for(int row = first; row <= last; ++row)
+    {
+        QModelIndex index = sourceModel()->index(row, 0, parent);
+        const auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
+
+        if(d && d->mTag >= 0)
         {
-            removeFailedTransferFromCounter(d->mTag);
+            updateTransfersCounters(d);
         }
     }
+}
 
-    return accept;
+void TransfersManagerSortFilterProxyModel::recountTransfers()
+{
+    auto rows (sourceModel()->rowCount());
+    if(rows > 0)
+    {
+        updateTransfersCounters(QModelIndex(), 0, rows - 1);
+    }
 }
 
 bool TransfersManagerSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
@@ -395,6 +425,16 @@ bool TransfersManagerSortFilterProxyModel::lessThan(const QModelIndex &left, con
 }
 
 
+void TransfersManagerSortFilterProxyModel::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    updateTransfersCounters(parent, first, last);
+}
+
+void TransfersManagerSortFilterProxyModel::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    updateTransfersCounters(topLeft.parent(), topLeft.row(), bottomRight.row());
+}
+
 //It is called from a QtConcurrent thread
 void TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
 {
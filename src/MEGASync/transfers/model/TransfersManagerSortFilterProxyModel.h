@@ -2,6 +2,7 @@
 #define TRANSFERSSORTFILTERPROXYMODEL_H
 
 #include "TransferItem.h"
+#include "TransferTagSet.h"
 #include "TransfersSortFilterProxyBaseModel.h"
 
 #include <QSortFilterProxyModel>
@@ -91,18 +92,20 @@ protected:
         SortCriterion mSortCriterion;
         Qt::SortOrder mSortOrder;
 
-        mutable QSet<int> mDlNumber;
-        mutable QSet<int> mUlNumber;
-        mutable QSet<int> mNoSyncTransfers;
-        mutable QSet<int> mActiveTransfers;
-        mutable QSet<int> mPausedTransfers;
-        mutable QSet<int> mCompletedTransfers;
-        mutable QSet<int> mCompletingTransfers;
-        mutable QSet<int> mFailedTransfers;
-        mutable QSet<int> mPermanentFailedTransfers;
+        mutable TransferTagSet mDlNumber;
+        mutable TransferTagSet mUlNumber;
+        mutable TransferTagSet mNoSyncTransfers;
+        mutable TransferTagSet mActiveTransfers;
+        mutable TransferTagSet mPausedTransfers;
+        mutable TransferTagSet mCompletedTransfers;
+        mutable TransferTagSet mCompletingTransfers;
+        mutable TransferTagSet mFailedTransfers;
+        mutable TransferTagSet mPermanentFailedTransfers;
 
 private slots:
         void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+        void onRowsInserted(const QModelIndex& parent, int first, int last);
+        void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
         void onModelSortedFiltered();
 
 private:
@@ -118,6 +121,10 @@ private:
         void removeFailedTransferFromCounter(TransferTag tag) const;
         void removeCompletingTransferFromCounter(TransferTag tag) const;
         bool updateTransfersCounterFromTag(QExplicitlySharedDataPointer<TransferData> transfer) const;
+        bool acceptsTransfer(const QExplicitlySharedDataPointer<TransferData>& d) const;
+        void updateTransfersCounters(const QExplicitlySharedDataPointer<TransferData>& d) const;
+        void updateTransfersCounters(const QModelIndex& parent, int first, int last);
+        void recountTransfers();
 
         void startProcessingInOtherThread();
         void finishProcessingInOtherThread();
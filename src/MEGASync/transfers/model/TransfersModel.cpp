@@ -11,8 +11,11 @@
 #include "TransferMetaData.h"
 #include <QMegaMessageBox.h>
 #include "MegaTransferView.h"
+#include "SyntheticEventGenerator.h"
 
+#include <QCryptographicHash>
 #include <QSharedData>
+#include <QFile>
 
 #include <algorithm>
 
@@ -29,9 +32,11 @@ const int START_THRESHOLD_THREAD = 50;
 const int FAILED_THRESHOLD_THREAD = 100;
 const int PAUSE_RESUME_THRESHOLD_THREAD = 300;
 const int CLEAR_THRESHOLD_THREAD = 300;
+const int HISTORY_PAGE_SIZE = 200;
+const int MAX_POOLED_DATA = 500;
 
 //LISTENER THREAD
-TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
+TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS), mThroughputHistory(nullptr)
 {}
 
 TransferThread::TransfersToProcess TransferThread::processTransfers()
@@ -70,6 +75,28 @@ void TransferThread::clear()
 
     mTransfersToProcess.clear();
     mTransfersCount.clear();
+    mStaticDataByTag.clear();
+    mRemovedUpdateData.reset();
+    mDataPool.clear();
+}
+
+void TransferThread::recycleData(const QList<QExplicitlySharedDataPointer<TransferData>>& replacedData)
+{
+    QMutexLocker lock(&mCacheMutex);
+
+    for(auto& data : replacedData)
+    {
+        if(mDataPool.size() >= MAX_POOLED_DATA)
+        {
+            break;
+        }
+
+        //Only referenced by the list, so no view or thread is reading it
+        if(data && data->ref.loadAcquire() == 1)
+        {
+            mDataPool.append(data);
+        }
+    }
 }
 
 QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers)
@@ -106,7 +133,37 @@ QList<QExplicitlySharedDataPointer<TransferData>> TransferThread::extractFromCac
 
 QExplicitlySharedDataPointer<TransferData> TransferThread::createData(MegaTransfer *transfer, MegaError* e)
 {
-    QExplicitlySharedDataPointer<TransferData> d (new TransferData(transfer));
+    QExplicitlySharedDataPointer<TransferData> d;
+
+    if(mRemovedUpdateData && mRemovedUpdateData->mTag == transfer->getTag())
+    {
+        //Nobody else references it, as it was never sent to the model
+        d.swap(mRemovedUpdateData);
+        d->updateDynamicFields(transfer);
+    }
+    else
+    {
+        auto staticData = mStaticDataByTag.value(transfer->getTag());
+        if(staticData)
+        {
+            if(!mDataPool.isEmpty())
+            {
+                d = mDataPool.takeLast();
+                d->reuse(transfer, staticData.constData());
+            }
+            else
+            {
+                d = new TransferData(transfer, staticData.constData());
+            }
+        }
+        else
+        {
+            d = new TransferData(transfer);
+            mStaticDataByTag.insert(transfer->getTag(), d);
+        }
+    }
+
+    mRemovedUpdateData.reset();
     updateFailedTransfer(d, transfer, e);
 
     return d;
@@ -125,8 +182,8 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSub
 
         if(item->mNotificationNumber < transfer->getNotificationNumber())
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            //The cached data has not been sent to the model yet, so it is updated in place
+            item->updateDynamicFields(transfer);
         }
 
         return item;
@@ -142,8 +199,8 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSub
         auto item = dataMap.value(transfer->getTag());
         if(item->mNotificationNumber < transfer->getNotificationNumber())
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            //The cached data has not been sent to the model yet, so it is updated in place
+            item->updateDynamicFields(transfer);
         }
 
         return item;
@@ -159,7 +216,8 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRem
         auto item = dataMap.value(transfer->getTag());
         if(item->mNotificationNumber < transfer->getNotificationNumber())
         {
-            dataMap.remove(transfer->getTag());
+            //The caller creates the new data, maybe in another cache, reusing this one
+            mRemovedUpdateData = dataMap.take(transfer->getTag());
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
@@ -290,6 +348,8 @@ void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
             return;
         }
 
+        addThroughput(transfer);
+
         {
             QMutexLocker counterLock(&mCountersMutex);
             if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
@@ -325,9 +385,14 @@ void TransferThread::onTransferFinish(MegaApi*, MegaTransfer *transfer, MegaErro
     { 
         if(isIgnored(transfer, true))
         {
+            //No more events are received for this tag
+            QMutexLocker cacheLock(&mCacheMutex);
+            mStaticDataByTag.remove(transfer->getTag());
             return;
         }
 
+        addThroughput(transfer);
+
         //This method is run in other thread, but all the logic related to TransferMetaData should be run in the GUI thread
         auto idResult = TransferMetaDataContainer::appDataToId(transfer->getAppData());
         if (idResult.first || transfer->getFolderTransferTag() > 0)
@@ -467,6 +532,9 @@ void TransferThread::onTransferFinish(MegaApi*, MegaTransfer *transfer, MegaErro
                     }
                 }
             }
+
+            //No more events are received for this tag
+            mStaticDataByTag.remove(transfer->getTag());
         }
     }
 }
@@ -482,6 +550,8 @@ void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer,
             return;
         }
 
+        addThroughput(transfer);
+
         {
             QMutexLocker counterLock(&mCountersMutex);
             if(transfer->getType() == MegaTransfer::TYPE_UPLOAD)
@@ -741,6 +811,21 @@ void TransferThread::resetCompletedDownloads(QList<QExplicitlySharedDataPointer<
     }
 }
 
+void TransferThread::setThroughputHistory(TransferThroughputHistory* throughputHistory)
+{
+    mThroughputHistory = throughputHistory;
+}
+
+void TransferThread::addThroughput(MegaTransfer* transfer)
+{
+    if(mThroughputHistory && !transfer->isFolderTransfer())
+    {
+        mThroughputHistory->addBytes(transfer->getType() == MegaTransfer::TYPE_UPLOAD ? TransferThroughputHistory::UPLOAD
+                                                                                       : TransferThroughputHistory::DOWNLOAD,
+                                     transfer->getDeltaSize());
+    }
+}
+
 void TransferThread::setMaxTransfersToProcess(uint16_t max)
 {
     mMaxTransfersToProcess = max;
@@ -763,7 +848,13 @@ TransfersModel::TransfersModel(QObject *parent) :
     mCancelledFrom(nullptr),
     mSyncsInRowsToCancel(false),
     mIgnoreMoveSignal(false),
-    mInverseMoveSignal(false)
+    mInverseMoveSignal(false),
+    mBatchScheduler(new TransferBatchScheduler(this)),
+    mThroughputHistory(new TransferThroughputHistory(this)),
+    mHistoryReady(false),
+    mHistoryCursor(0),
+    mHistoryRowsInMemory(0),
+    mMaxHistoryRowsInMemory(static_cast<int>(Preferences::MAX_COMPLETED_ITEMS))
 {
     qRegisterMetaType<QList<QPersistentModelIndex>>("QList<QPersistentModelIndex>");
     qRegisterMetaType<QAbstractItemModel::LayoutChangeHint>("QAbstractItemModel::LayoutChangeHint");
@@ -775,10 +866,19 @@ TransfersModel::TransfersModel(QObject *parent) :
 
     mTransferEventThread = new QThread();
     mTransferEventWorker = new TransferThread();
+    mTransferEventWorker->setThroughputHistory(mThroughputHistory);
     mTransferEventWorker->moveToThread(mTransferEventThread);
     mDelegateListener = new QTMegaTransferListener(mMegaApi, mTransferEventWorker);
     mDelegateListener->moveToThread(mTransferEventThread);
-    mMegaApi->addTransferListener(mDelegateListener);
+    // In load-driver mode the transfers come from the synthetic generator instead of the SDK
+    if (auto loadDriver = SyntheticEventGenerator::instance())
+    {
+        loadDriver->addTransferListener(mDelegateListener);
+    }
+    else
+    {
+        mMegaApi->addTransferListener(mDelegateListener);
+    }
 
     //Update transfers state for the first time
     updateTransfersCount();
@@ -796,6 +896,8 @@ TransfersModel::TransfersModel(QObject *parent) :
     connect(&mUpdateTransferWatcher, &QFutureWatcher<void>::finished, this, &TransfersModel::onUpdateTransfersFinished);
     connect(&mClearTransferWatcher, &QFutureWatcher<void>::finished, this, &TransfersModel::onClearTransfersFinished);
     connect(&mAskForMostPriorityTransfersWatcher, &QFutureWatcher<QPair<int,int>>::finished, this, &TransfersModel::onAskForMostPriorityTransfersFinished);
+    connect(&mHistoryOpenWatcher, &QFutureWatcher<bool>::finished, this, &TransfersModel::onHistoryStoreOpened);
+    connect(mThroughputHistory, &TransferThroughputHistory::secondSampled, this, &TransfersModel::onThroughputSampled);
 
     connect(mTransferEventThread, &QThread::finished, mTransferEventThread, &QObject::deleteLater, Qt::DirectConnection);
     connect(mTransferEventThread, &QThread::finished, mTransferEventWorker, &QObject::deleteLater, Qt::DirectConnection);
@@ -812,6 +914,13 @@ TransfersModel::~TransfersModel()
     mTransfers.clear();
     mTransferEventThread->quit();
 
+    mHistoryOpenWatcher.waitForFinished();
+    mHistoryStore.close();
+
+    if (auto loadDriver = SyntheticEventGenerator::instance())
+    {
+        loadDriver->removeTransferListener(mDelegateListener);
+    }
     mMegaApi->removeTransferListener(mDelegateListener);
 }
 
@@ -884,6 +993,38 @@ QModelIndex TransfersModel::index(int row, int column, const QModelIndex&) const
     return (row < rowCount(DEFAULT_IDX)) ?  createIndex(row, column) : DEFAULT_IDX;
 }
 
+bool TransfersModel::canFetchMore(const QModelIndex& parent) const
+{
+    return parent == DEFAULT_IDX && mHistoryReady && mHistoryCursor > 0;
+}
+
+//Older history rows are added at the end, a page at a time, when the views reach the last row
+void TransfersModel::fetchMore(const QModelIndex& parent)
+{
+    if(!canFetchMore(parent) || !mModelMutex.tryLock())
+    {
+        return;
+    }
+
+    auto transfers = mHistoryStore.readOlder(mHistoryCursor, HISTORY_PAGE_SIZE);
+    if(!transfers.isEmpty())
+    {
+        auto totalRows = rowCount(DEFAULT_IDX);
+        beginInsertRows(DEFAULT_IDX, totalRows, totalRows + transfers.size() - 1);
+        foreach(auto transfer, transfers)
+        {
+            addTransfer(transfer);
+        }
+        endInsertRows();
+
+        mHistoryRowsInMemory += transfers.size();
+        mMaxHistoryRowsInMemory += transfers.size();
+        modelHasChanged(true);
+    }
+
+    mModelMutex.unlock();
+}
+
 void TransfersModel::onProcessTransfers()
 {
     if(mTransfersToProcess.isEmpty())
@@ -1047,6 +1188,16 @@ void TransfersModel::onProcessTransfers()
     {
         modelHasChanged(false);
 
+        if(!mHistoryReady)
+        {
+            openHistoryStore();
+        }
+        else
+        {
+            mHistoryStore.flush();
+            evictHistoryRows();
+        }
+
         if(isUiBlockedModeActive())
         {
             setUiBlockedMode(false);
@@ -1101,6 +1252,7 @@ void TransfersModel::processStartTransfers(QList<QExplicitlySharedDataPointer<Tr
 void TransfersModel::startTransfer(QExplicitlySharedDataPointer<TransferData> transfer)
 {
     addTransfer(transfer);
+    saveToHistory(transfer);
 
     auto state (transfer->getState());
 
@@ -1114,19 +1266,29 @@ void TransfersModel::startTransfer(QExplicitlySharedDataPointer<TransferData> tr
     }
 }
 
-void TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row)
+QExplicitlySharedDataPointer<TransferData> TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row)
 {
     checkActiveTransfer(transfer->mTag, transfer->isActive());
 
     mDataMutex.lockForWrite();
+    auto replacedData = mTransfers.at(row);
+    if(transfer->mHistoryId < 0)
+    {
+        transfer->mHistoryId = replacedData->mHistoryId;
+    }
     mTransfers[row] = transfer;
     mDataMutex.unlock();
+
+    saveToHistory(transfer);
+
+    return replacedData;
 }
 
 void TransfersModel::processUpdateTransfers()
 {
     QList<QExplicitlySharedDataPointer<TransferData>> alreadyUploadCompletedTransfers;
     QList<QExplicitlySharedDataPointer<TransferData>> alreadyDownloadCompletedTransfers;
+    QList<QExplicitlySharedDataPointer<TransferData>> replacedData;
 
     for (auto it = mTransfersToProcess.updateTransfersByTag.begin(); it != mTransfersToProcess.updateTransfersByTag.end();)
     {   
@@ -1140,7 +1302,7 @@ void TransfersModel::processUpdateTransfers()
             if(!mCompletedTransfersByTag.contains(itValue->mNodeHandle))
             {
                 itValue->setPreviousState(d->getState());
-                updateTransfer(itValue, row);
+                replacedData.append(updateTransfer(itValue, row));
                 sendDataChanged(row);
                 itValue->resetStateHasChanged();
 
@@ -1154,6 +1316,9 @@ void TransfersModel::processUpdateTransfers()
 
     mTransferEventWorker->resetCompletedUploads(alreadyUploadCompletedTransfers);
     mTransferEventWorker->resetCompletedDownloads(alreadyDownloadCompletedTransfers);
+
+    //After the loop, as its local copies also referenced them
+    mTransferEventWorker->recycleData(replacedData);
 }
 
 void TransfersModel::processFailedTransfers()
@@ -1709,7 +1874,10 @@ void TransfersModel::cancelAllTransfers(QWidget* canceledFrom)
     }
     mModelMutex.unlock();
 
-    //Cancel little by little??? CAnceling everythin blocks the SDK
+    //Scheduled bulk operations are not needed anymore, as every transfer is going to be cancelled
+    mBatchScheduler->cancel();
+
+    //A single request per type: the SDK cancels the transfers in its own thread
     mMegaApi->cancelTransfers(MegaTransfer::TYPE_UPLOAD);
     mMegaApi->cancelTransfers(MegaTransfer::TYPE_DOWNLOAD);
 }
@@ -1773,19 +1941,14 @@ void TransfersModel::cancelAndClearTransfers(const QModelIndexList& indexes, QWi
 
     if(!toCancel.isEmpty())
     {
-        auto counter(0);
         // Now cancel transfers
-        for (auto item : toCancel)
+        mBatchScheduler->schedule(tr("Cancelling transfers"), toCancel, [this](const QList<TransferTag>& tags)
         {
-            mMegaApi->cancelTransferByTag(item);
-
-            //This is done to avoid GUI freezes
-            if(++counter == 100)
+            for (auto tag : tags)
             {
-                counter = 0;
-                MegaSyncApp->processEvents();
+                mMegaApi->cancelTransferByTag(tag);
             }
-        }
+        });
     }
 }
 
@@ -1890,6 +2053,11 @@ void TransfersModel::clearAllTransfers()
     }
 
     clearTransfers(uploadToClear, downloadToClear);
+
+    //Including the completed transfers which are only on disk
+    mHistoryStore.removeAll(false);
+    //The history ids start again from 0 when the whole file is cleared
+    mHistoryCursor = qMin(mHistoryCursor, mHistoryStore.lastHistoryId() + 1);
 }
 
 void TransfersModel::clearTransfers(const QModelIndexList& indexes)
@@ -1982,16 +2150,35 @@ void TransfersModel::performClearTransfers(const QMap<QModelIndex, QExplicitlySh
 {
     QModelIndexList itemsToRemove;
 
+    //Transfers read from the history were not counted in this session
+    auto countedTransfers = [this](const QList<QExplicitlySharedDataPointer<TransferData>>& transfers)
+    {
+        QList<QExplicitlySharedDataPointer<TransferData>> counted;
+        foreach(auto transfer, transfers)
+        {
+            if(transfer->mHistoryId >= 0)
+            {
+                mHistoryStore.remove(transfer->mHistoryId);
+            }
+
+            if(!transfer->isFromHistory())
+            {
+                counted.append(transfer);
+            }
+        }
+        return counted;
+    };
+
     if(!uploads.isEmpty())
     {
-        mTransferEventWorker->resetCompletedUploads(uploads.values());
+        mTransferEventWorker->resetCompletedUploads(countedTransfers(uploads.values()));
 
         itemsToRemove.append(uploads.keys());
     }
 
     if(!downloads.isEmpty())
     {
-        mTransferEventWorker->resetCompletedDownloads(downloads.values());
+        mTransferEventWorker->resetCompletedDownloads(countedTransfers(downloads.values()));
 
         itemsToRemove.append(downloads.keys());
     }
@@ -2011,49 +2198,30 @@ void TransfersModel::pauseTransfers(const QModelIndexList& indexes, bool pauseSt
     {
         setUiBlockedModeByCounter(indexes.size());
 
-        if(indexes.size() > PAUSE_RESUME_THRESHOLD_THREAD)
-        {
-            QtConcurrent::run([this, indexes, pauseState]()
-            {
-                blockModelSignals(true);
-                performPauseResumeVisibleTransfers(indexes, pauseState, false);
-                blockModelSignals(false);
-
-                emit pauseStateChanged(mAreAllPaused);
-            });
-        }
-        else
-        {
-            performPauseResumeVisibleTransfers(indexes, pauseState, true);
-        }
-    }
-}
+        QList<TransferTag> tags;
 
-int TransfersModel::performPauseResumeVisibleTransfers(const QModelIndexList& indexes, bool pauseState, bool useEventUpdater)
-{
-    EventUpdater updater(indexes.size(), 1000);
-    auto tagsUpdated(0);
-
-    QMutexLocker lock(&mModelMutex);
-
-    for (auto index : indexes)
-    {
-        auto d = getTransfer(index.row());
-        if((pauseState && d->getState() & TransferData::PAUSABLE_STATES_MASK)
-                || (!pauseState && d->getState() & TransferData::TRANSFER_PAUSED))
+        mModelMutex.lock();
+        for (auto index : indexes)
         {
-            pauseResumeTransferByTag(d->mTag, pauseState);
+            auto d = getTransfer(index.row());
+            if(d && ((pauseState && d->getState() & TransferData::PAUSABLE_STATES_MASK)
+                    || (!pauseState && d->getState() & TransferData::TRANSFER_PAUSED)))
+            {
+                tags.append(d->mTag);
+            }
         }
+        mModelMutex.unlock();
 
-        tagsUpdated++;
-
-        if(useEventUpdater)
+        auto notifyPauseState(indexes.size() > PAUSE_RESUME_THRESHOLD_THREAD);
+        schedulePauseResume(pauseState ? tr("Pausing transfers") : tr("Resuming transfers"), tags, pauseState,
+                            [this, notifyPauseState](bool)
         {
-            updater.update(tagsUpdated);
-        }
+            if(notifyPauseState)
+            {
+                emit pauseStateChanged(mAreAllPaused);
+            }
+        });
     }
-
-    return tagsUpdated;
 }
 
 void TransfersModel::blockModelSignals(bool state)
@@ -2064,84 +2232,66 @@ void TransfersModel::blockModelSignals(bool state)
 void TransfersModel::pauseResumeAllTransfers(bool state)
 {
     mAreAllPaused = state;
-    auto activeTransfers = rowCount();
 
-    //Provisional active transfers, just used to know if UI will be blocked
-    //The final count can be +- 30 transfers
-    if(activeTransfers > PAUSE_RESUME_THRESHOLD_THREAD)
-    {
-        QtConcurrent::run([this, activeTransfers]()
-        {
-            blockModelSignals(true);
-            auto tagsUpdated = performPauseResumeAllTransfers(activeTransfers, false);
-            blockModelSignals(false);
+    QList<TransferTag> tags;
 
-            setUiBlockedModeByCounter(tagsUpdated);
-        });
-    }
-    else
+    mDataMutex.lockForRead();
+    for(const auto& item : qAsConst(mTransfers))
     {
-        auto tagsUpdated = performPauseResumeAllTransfers(activeTransfers, true);
-        setUiBlockedModeByCounter(tagsUpdated);
+        if((state && item->getState() & TransferData::PAUSABLE_STATES_MASK)
+                || (!state && item->getState() & TransferData::TRANSFER_PAUSED))
+        {
+            tags.append(item->mTag);
+        }
     }
-}
-
-int TransfersModel::performPauseResumeAllTransfers(int activeTransfers, bool useEventUpdater)
-{
-    auto tagsUpdated(0);
-
-    QMutexLocker lock(&mModelMutex);
-
-    mDataMutex.lockForRead();
-    auto transfersCopied = mTransfers;
     mDataMutex.unlock();
 
+    setUiBlockedModeByCounter(tags.size());
+
     if (mAreAllPaused)
     {
-        //This needs to be done before retrying all the transfers one by one
+        //This needs to be done before pausing all the transfers one by one
         mMegaApi->pauseTransfers(mAreAllPaused);
 
-        EventUpdater updater(activeTransfers, 200);
-
-        std::for_each(transfersCopied.crbegin(), transfersCopied.crend(), [this, &tagsUpdated, updater, useEventUpdater](QExplicitlySharedDataPointer<TransferData> item)
-                      mutable {
-
-            if(item->getState() & TransferData::PAUSABLE_STATES_MASK)
-            {
-                pauseResumeTransferByTag(item->mTag, mAreAllPaused);
-                tagsUpdated++;
-            }
-
-            if(useEventUpdater)
-            {
-                updater.update(tagsUpdated);
-            }
-        });
+        //The transfers with less priority are paused first
+        std::reverse(tags.begin(), tags.end());
+        schedulePauseResume(tr("Pausing transfers"), tags, true);
     }
     else
     {
-        EventUpdater updater(activeTransfers, 200);
-
-        std::for_each(transfersCopied.cbegin(), transfersCopied.cend(), [this, &tagsUpdated, updater, useEventUpdater](QExplicitlySharedDataPointer<TransferData> item)
-                      mutable {
+        schedulePauseResume(tr("Resuming transfers"), tags, false, [this](bool)
+        {
+            //This needs to be done after resuming all the transfers one by one
+            mMegaApi->pauseTransfers(mAreAllPaused);
+        });
+    }
+}
 
-            if(item->getState() & TransferData::TRANSFER_PAUSED)
-            {
-                pauseResumeTransferByTag(item->mTag, mAreAllPaused);
-                tagsUpdated++;
-            }
+void TransfersModel::schedulePauseResume(const QString& description, const QList<TransferTag>& tags, bool pauseState,
+                                         TransferBatchScheduler::FinishedCallback finished)
+{
+    //Big operations keep the UI blocked until the SDK updates arrive, so the rows are not refreshed one by one
+    auto blockSignalsWhileProcessing(tags.size() > PAUSE_RESUME_THRESHOLD_THREAD);
 
-            if(useEventUpdater)
-            {
-                updater.update(tagsUpdated);
-            }
-        });
+    mBatchScheduler->schedule(description, tags, [this, pauseState, blockSignalsWhileProcessing](const QList<TransferTag>& chunk)
+    {
+        if(blockSignalsWhileProcessing)
+        {
+            blockModelSignals(true);
+        }
 
-        //This needs to be done after pausing all the transfers one by one
-        mMegaApi->pauseTransfers(mAreAllPaused);
-    }
+        mModelMutex.lock();
+        for (auto tag : chunk)
+        {
+            pauseResumeTransferByTag(tag, pauseState);
+        }
+        mModelMutex.unlock();
 
-    return tagsUpdated;
+        if(blockSignalsWhileProcessing)
+        {
+            blockModelSignals(false);
+        }
+    }, finished);
 }
 
 void TransfersModel::pauseResumeTransferByTag(TransferTag tag, bool pauseState)
@@ -2234,6 +2384,11 @@ void TransfersModel::updateTransfersCount()
     mTransfersCount = mTransferEventWorker->getTransfersCount();
     mLastTransfersCount = mTransferEventWorker->getLastTransfersCount();
 
+    mQueueEta.setRemainingBytes(TransferQueueEta::UPLOAD,
+                                static_cast<unsigned long long>(std::max(0LL, mTransfersCount.totalUploadBytes - mTransfersCount.completedUploadBytes)));
+    mQueueEta.setRemainingBytes(TransferQueueEta::DOWNLOAD,
+                                static_cast<unsigned long long>(std::max(0LL, mTransfersCount.totalDownloadBytes - mTransfersCount.completedDownloadBytes)));
+
     emit transfersCountUpdated();
 }
 
@@ -2330,6 +2485,11 @@ void TransfersModel::removeTransfer(int row)
     {
         auto transfer = mTransfers.takeAt(row);
         mTagByOrder.remove(transfer->mTag);
+
+        if(transfer->mHistoryId >= 0)
+        {
+            mHistoryRowsInMemory--;
+        }
     }
     mDataMutex.unlock();
 }
@@ -2648,6 +2808,88 @@ bool TransfersModel::moveTransferPriority(const QModelIndex &sourceParent, const
     return result;
 }
 
+void TransfersModel::moveTransfersToFirst(const QList<int>& rows)
+{
+    scheduleMoveTransfers(rows, true);
+}
+
+void TransfersModel::moveTransfersToLast(const QList<int>& rows)
+{
+    scheduleMoveTransfers(rows, false);
+}
+
+void TransfersModel::scheduleMoveTransfers(const QList<int>& rows, bool toFirst)
+{
+    QList<TransferTag> tags;
+
+    mModelMutex.lock();
+    for (auto row : rows)
+    {
+        auto d = getTransfer(row);
+        if(d && d->mTag)
+        {
+            tags.append(d->mTag);
+        }
+    }
+    mModelMutex.unlock();
+
+    //Same condition as the synchronous move to first or last, captured as the flags can change before the chunks run
+    auto emitMoveSignal(!mIgnoreMoveSignal && !mInverseMoveSignal);
+    mBatchScheduler->schedule(toFirst ? tr("Moving transfers to the top") : tr("Moving transfers to the bottom"), tags,
+                              [this, toFirst, emitMoveSignal](const QList<TransferTag>& chunk)
+    {
+        for (auto tag : chunk)
+        {
+            if(toFirst)
+            {
+                mMegaApi->moveTransferToFirstByTag(tag);
+            }
+            else
+            {
+                mMegaApi->moveTransferToLastByTag(tag);
+            }
+
+            if(emitMoveSignal)
+            {
+                emit rowsAboutToBeMoved(tag);
+            }
+        }
+    });
+}
+
+TransferBatchScheduler* TransfersModel::getBatchScheduler() const
+{
+    return mBatchScheduler;
+}
+
+TransferThroughputHistory* TransfersModel::getThroughputHistory() const
+{
+    return mThroughputHistory;
+}
+
+std::chrono::seconds TransfersModel::getQueueRemainingTime() const
+{
+    return mQueueEta.remainingTime(std::chrono::milliseconds(QDateTime::currentMSecsSinceEpoch()));
+}
+
+void TransfersModel::onThroughputSampled(quint64 uploadBytes, quint64 downloadBytes)
+{
+    //Limits of zero or less are not fixed limits
+    auto limitBytes = [](int limitKB)
+    {
+        return limitKB > 0 ? static_cast<unsigned long long>(limitKB) * 1024 : 0ULL;
+    };
+
+    mQueueEta.setBandwidthLimit(TransferQueueEta::UPLOAD, limitBytes(mPreferences->uploadLimitKB()));
+    mQueueEta.setBandwidthLimit(TransferQueueEta::DOWNLOAD, limitBytes(mPreferences->downloadLimitKB()));
+    mQueueEta.setConnections(TransferQueueEta::UPLOAD, mPreferences->parallelUploadConnections());
+    mQueueEta.setConnections(TransferQueueEta::DOWNLOAD, mPreferences->parallelDownloadConnections());
+
+    const std::chrono::milliseconds now(QDateTime::currentMSecsSinceEpoch());
+    mQueueEta.addSample(TransferQueueEta::UPLOAD, uploadBytes, std::chrono::seconds(1), now);
+    mQueueEta.addSample(TransferQueueEta::DOWNLOAD, downloadBytes, std::chrono::seconds(1), now);
+}
+
 void TransfersModel::resetModel()
 {
     QMutexLocker lock(&mModelMutex);
@@ -2655,6 +2897,7 @@ void TransfersModel::resetModel()
     beginResetModel();
 
     mTransfersCount.clear();
+    mQueueEta.reset();
     mTransferEventWorker->clear();
     mTransfersToProcess.clear();
     mTransfersProcessChanged = 0;
@@ -2666,9 +2909,163 @@ void TransfersModel::resetModel()
     mTagByOrder.clear();
     mDataMutex.unlock();
 
+    //The next account opens its own history
+    mHistoryOpenWatcher.waitForFinished();
+    mHistoryStore.close();
+    //The history of the account is not kept after the logout
+    if(!mHistoryFilePath.isEmpty())
+    {
+        QFile::remove(mHistoryFilePath);
+        mHistoryFilePath.clear();
+    }
+    mHistoryReady = false;
+    mHistoryCursor = 0;
+    mHistoryRowsInMemory = 0;
+    mMaxHistoryRowsInMemory = static_cast<int>(Preferences::MAX_COMPLETED_ITEMS);
+
     endResetModel();
 }
 
+void TransfersModel::openHistoryStore()
+{
+    if(!mHistoryFilePath.isEmpty() || !mPreferences->logged())
+    {
+        return;
+    }
+
+    //One file per account
+    auto emailHash = QCryptographicHash::hash(mPreferences->email().toLower().toUtf8(), QCryptographicHash::Md5);
+    mHistoryFilePath = MegaApplication::applicationDataPath() + QDir::separator()
+            + QString::fromLatin1("transfers_history_%1.dat").arg(QString::fromLatin1(emailHash.toHex()));
+
+    //Large histories take a while to index
+    auto filePath(mHistoryFilePath);
+    mHistoryOpenWatcher.setFuture(QtConcurrent::run([this, filePath]()
+    {
+        return mHistoryStore.open(filePath);
+    }));
+}
+
+void TransfersModel::onHistoryStoreOpened()
+{
+    if(mHistoryFilePath.isEmpty() || !mHistoryOpenWatcher.result())
+    {
+        return;
+    }
+
+    {
+        QMutexLocker lock(&mModelMutex);
+
+        mHistoryCursor = mHistoryStore.lastHistoryId() + 1;
+        mHistoryReady = true;
+
+        //Transfers finished while the history was being opened
+        for(int row = 0; row < rowCount(DEFAULT_IDX); ++row)
+        {
+            saveToHistory(getTransfer(row));
+        }
+    }
+
+    //The most recent history is shown right away
+    fetchMore(DEFAULT_IDX);
+}
+
+void TransfersModel::saveToHistory(QExplicitlySharedDataPointer<TransferData> transfer)
+{
+    if(!mHistoryReady || !transfer || transfer->mHistoryId >= 0)
+    {
+        return;
+    }
+
+    auto state(transfer->getState());
+    if(state == TransferData::TRANSFER_COMPLETED
+            || (state == TransferData::TRANSFER_FAILED && !transfer->isSyncTransfer()))
+    {
+        transfer->mHistoryId = mHistoryStore.append(*transfer);
+        if(transfer->mHistoryId >= 0)
+        {
+            mHistoryRowsInMemory++;
+        }
+    }
+}
+
+//The oldest finished rows are removed from the model, they can be fetched again from disk
+void TransfersModel::evictHistoryRows()
+{
+    if(mHistoryRowsInMemory <= mMaxHistoryRowsInMemory + HISTORY_PAGE_SIZE || !mModelMutex.tryLock())
+    {
+        return;
+    }
+
+    QList<QPair<int, int>> historyIdsAndRows;
+    mDataMutex.lockForRead();
+    for(int row = 0; row < mTransfers.size(); ++row)
+    {
+        if(mTransfers.at(row)->mHistoryId >= 0 && mTransfers.at(row)->isFinished())
+        {
+            historyIdsAndRows.append(qMakePair(mTransfers.at(row)->mHistoryId, row));
+        }
+    }
+    mDataMutex.unlock();
+
+    std::sort(historyIdsAndRows.begin(), historyIdsAndRows.end());
+
+    QModelIndexList indexesToEvict;
+    QList<QExplicitlySharedDataPointer<TransferData>> countedUploads;
+    QList<QExplicitlySharedDataPointer<TransferData>> countedDownloads;
+    auto rowsToEvict(historyIdsAndRows.size() - mMaxHistoryRowsInMemory);
+    for(int pos = 0; pos < rowsToEvict; ++pos)
+    {
+        auto row(historyIdsAndRows.at(pos).second);
+        indexesToEvict.append(index(row, 0));
+        mHistoryCursor = qMax(mHistoryCursor, historyIdsAndRows.at(pos).first + 1);
+
+        //Rows of this session are counted, but they come back from the history as uncounted rows
+        auto transfer(getTransfer(row));
+        if(!transfer->isFromHistory())
+        {
+            if(transfer->mType & TransferData::TRANSFER_UPLOAD)
+            {
+                countedUploads.append(transfer);
+            }
+            else
+            {
+                countedDownloads.append(transfer);
+            }
+        }
+    }
+
+    if(indexesToEvict.isEmpty())
+    {
+        mModelMutex.unlock();
+        return;
+    }
+
+    if(!countedUploads.isEmpty())
+    {
+        mTransferEventWorker->resetCompletedUploads(countedUploads);
+    }
+    if(!countedDownloads.isEmpty())
+    {
+        mTransferEventWorker->resetCompletedDownloads(countedDownloads);
+    }
+
+    removeRows(indexesToEvict);
+    mModelMutex.unlock();
+
+    updateTransfersCount();
+    modelHasChanged(true);
+}
+
+void TransfersModel::releaseFetchedHistoryRows()
+{
+    if(mMaxHistoryRowsInMemory > static_cast<int>(Preferences::MAX_COMPLETED_ITEMS))
+    {
+        mMaxHistoryRowsInMemory = static_cast<int>(Preferences::MAX_COMPLETED_ITEMS);
+        evictHistoryRows();
+    }
+}
+
 Qt::ItemFlags TransfersModel::flags(const QModelIndex& index) const
 {
     if (index.isValid())
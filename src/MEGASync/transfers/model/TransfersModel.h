@@ -5,6 +5,10 @@
 #include "TransferItem.h"
 #include "TransferMetaData.h"
 #include "TransferRemainingTime.h"
+#include "TransferQueueEta.h"
+#include "TransferBatchScheduler.h"
+#include "TransferHistoryStore.h"
+#include "TransferThroughputHistory.h"
 #include "control/Preferences.h"
 
 #include <megaapi.h>
@@ -15,6 +19,7 @@
 #include <QFutureWatcher>
 #include <QReadWriteLock>
 
+#include <atomic>
 #include <set>
 #include <memory>
 
@@ -127,8 +132,11 @@ public:
     void resetCompletedUploads(QList<QExplicitlySharedDataPointer<TransferData> > transfersToReset);
     void resetCompletedDownloads(QList<QExplicitlySharedDataPointer<TransferData>> transfersToReset);
     void resetCompletedTransfers();
+    //The data replaced in the model; the ones nobody else references are reused for the next updates
+    void recycleData(const QList<QExplicitlySharedDataPointer<TransferData>>& replacedData);
 
     void setMaxTransfersToProcess(uint16_t max);
+    void setThroughputHistory(TransferThroughputHistory* throughputHistory);
 
     TransfersToProcess processTransfers();
     void clear();
@@ -144,6 +152,7 @@ private:
     bool isRetriedFolder(mega::MegaTransfer* transfer);
     bool isCompletedFromFolderRetry(mega::MegaTransfer* transfer);
     bool isIgnored(mega::MegaTransfer* transfer, bool removeCache = false);
+    void addThroughput(mega::MegaTransfer* transfer);
     void updateFailedTransfer(QExplicitlySharedDataPointer<TransferData> data, mega::MegaTransfer* transfer,
                               mega::MegaError* e);
 
@@ -183,6 +192,15 @@ private:
 
     QList<int> mRetriedFolder;
     QList<int> mIgnoredFiles;
+
+    //First data created for each unfinished transfer; the next ones take from it the names, paths and types
+    QHash<TransferTag, QExplicitlySharedDataPointer<TransferData>> mStaticDataByTag;
+    //Update removed from the cache by checkIfRepeatedAndRemove, reused by the next createData of the same tag
+    QExplicitlySharedDataPointer<TransferData> mRemovedUpdateData;
+    //Data given back by the model, so the updates do not allocate a new one each time
+    QList<QExplicitlySharedDataPointer<TransferData>> mDataPool;
+
+    TransferThroughputHistory* mThroughputHistory;
 };
 
 class TransfersModel : public QAbstractItemModel
@@ -204,6 +222,10 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     QModelIndex parent(const QModelIndex& index) const override;
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    //The rows fetched from the history can be evicted again, e.g. when the views are back to the top
+    void releaseFetchedHistoryRows();
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
     bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
                   const QModelIndex &destinationParent, int destinationChild) override;
@@ -212,6 +234,8 @@ public:
     void inverseMoveRowsSignal(bool state);
     bool moveTransferPriority(const QModelIndex& sourceParent, const QList<int>& rows,
                   const QModelIndex& destinationParent, int destinationChild);
+    void moveTransfersToFirst(const QList<int>& rows);
+    void moveTransfersToLast(const QList<int>& rows);
 
     void resetModel();
 
@@ -258,7 +282,7 @@ public:
     long long failedTransfers();
 
     void startTransfer(QExplicitlySharedDataPointer<TransferData> transfer);
-    void updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row);
+    QExplicitlySharedDataPointer<TransferData> updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row);
 
     void pauseModelProcessing(bool value);
 
@@ -286,6 +310,11 @@ public:
 
     QList<int> getDragAndDropRows(const QMimeData* data);
 
+    TransferBatchScheduler* getBatchScheduler() const;
+    TransferThroughputHistory* getThroughputHistory() const;
+    // Time left to finish all the transfers, seconds::max() if unknown
+    std::chrono::seconds getQueueRemainingTime() const;
+
 signals:
     void pauseStateChanged(bool pauseState);
     void transferPauseStateChanged();
@@ -322,6 +351,8 @@ private slots:
     void onUpdateTransfersFinished();
     void onAskForMostPriorityTransfersFinished();
     void onKeepPCAwake();
+    void onHistoryStoreOpened();
+    void onThroughputSampled(quint64 uploadBytes, quint64 downloadBytes);
 
 private:
     void removeRows(QModelIndexList &indexesToRemove);
@@ -345,8 +376,13 @@ private:
 
     void mostPriorityTransferMayChanged(bool state);
 
-    int performPauseResumeAllTransfers(int activeTransfers, bool useEventUpdater);
-    int performPauseResumeVisibleTransfers(const QModelIndexList& indexes, bool pauseState, bool useEventUpdater);
+    void schedulePauseResume(const QString& description, const QList<TransferTag>& tags, bool pauseState,
+                             TransferBatchScheduler::FinishedCallback finished = nullptr);
+    void scheduleMoveTransfers(const QList<int>& rows, bool toFirst);
+
+    void openHistoryStore();
+    void saveToHistory(QExplicitlySharedDataPointer<TransferData> transfer);
+    void evictHistoryRows();
 
     void openFolder(const QFileInfo& info);
 
@@ -395,6 +431,21 @@ private:
     bool mIgnoreMoveSignal;
     bool mInverseMoveSignal;
 
+    TransferBatchScheduler* mBatchScheduler;
+    TransferThroughputHistory* mThroughputHistory;
+    TransferQueueEta mQueueEta;
+
+    TransferHistoryStore mHistoryStore;
+    QFutureWatcher<bool> mHistoryOpenWatcher;
+    QString mHistoryFilePath;
+    bool mHistoryReady;
+    //History rows with a lower id are only on disk
+    int mHistoryCursor;
+    //Also changed by the update threads, when the transfers are saved to the history
+    std::atomic<int> mHistoryRowsInMemory;
+    //Grows with the rows fetched by the user, so they are not evicted right away
+    int mMaxHistoryRowsInMemory;
+
     QSet<int> mRetriedFolderTags;
 };
 
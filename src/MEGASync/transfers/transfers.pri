@@ -12,6 +12,10 @@ SOURCES += $$PWD/model/TransfersModel.cpp \
            $$PWD/model/InfoDialogTransfersProxyModel.cpp \
            $$PWD/model/TransfersManagerSortFilterProxyModel.cpp \
            $$PWD/model/TransferMetaData.cpp \
+           $$PWD/model/TransferTagSet.cpp \
+           $$PWD/model/TransferBatchScheduler.cpp \
+           $$PWD/model/TransferHistoryStore.cpp \
+           $$PWD/model/TransferThroughputHistory.cpp \
            $$PWD/gui/InfoDialogTransferDelegateWidget.cpp \
            $$PWD/gui/InfoDialogTransfersWidget.cpp \
            $$PWD/gui/MegaTransferDelegate.cpp  \
@@ -25,6 +29,7 @@ SOURCES += $$PWD/model/TransfersModel.cpp \
            $$PWD/gui/TransfersSummaryWidget.cpp \
            $$PWD/gui/TransferScanCancelUi.cpp \
            $$PWD/gui/TransferWidgetHeaderItem.cpp \
+           $$PWD/gui/ThroughputGraphDialog.cpp \
            $$PWD/gui/TransfersWidget.cpp
 
 HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
@@ -37,6 +42,10 @@ HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
            $$PWD/model/TransfersSortFilterProxyBaseModel.h \
            $$PWD/model/TransfersModel.h \
            $$PWD/model/TransferMetaData.h \
+           $$PWD/model/TransferTagSet.h \
+           $$PWD/model/TransferBatchScheduler.h \
+           $$PWD/model/TransferHistoryStore.h \
+           $$PWD/model/TransferThroughputHistory.h \
            $$PWD/gui/InfoDialogTransferDelegateWidget.h \
            $$PWD/gui/InfoDialogTransfersWidget.h \
            $$PWD/gui/MegaTransferDelegate.h  \
@@ -50,6 +59,7 @@ HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
            $$PWD/gui/TransfersSummaryWidget.h \
            $$PWD/gui/TransferScanCancelUi.h \
            $$PWD/gui/TransferWidgetHeaderItem.h \
+           $$PWD/gui/ThroughputGraphDialog.h \
            $$PWD/gui/TransfersWidget.h
 
 win32 {
@@ -24,5 +24,6 @@ const char UPDATE_FILENAME[] = "v.txt";
 const char UPDATE_FOLDER_NAME[] = "eupdate";
 const char BACKUP_FOLDER_NAME[] = "ebackup";
 const char VERSION_FILE_NAME[] = "megasync.version";
+const size_t SIGNATURE_CHUNK_SIZE = 64 * 1024;
 
 #endif // PREFERENCES_H
@@ -702,44 +702,66 @@ bool UpdateTask::alreadyDownloaded(string relativePath, string fileSignature)
 
 bool UpdateTask::alreadyExists(string absolutePath, string fileSignature)
 {
+    long long fileSize;
+    if (!getFileSize(absolutePath.c_str(), &fileSize))
+    {
+        return false;
+    }
+
     string updatePublicKey = UPDATE_PUBLIC_KEY;
     if (getenv("MEGA_UPDATE_PUBLIC_KEY"))
     {
         updatePublicKey = getenv("MEGA_UPDATE_PUBLIC_KEY");
     }
     SignatureChecker tmpHash(updatePublicKey.c_str());
-    char *buffer;
-    long fileLength;
     FILE * pFile = mega_fopen(absolutePath.c_str(), "rb");
     if (pFile == NULL)
     {
         return false;
     }
 
-    //Get size of file and rewind FILE pointer
-    fseek(pFile, 0, SEEK_END);
-    fileLength = ftell(pFile);
-    rewind(pFile);
+    //Feed the hash in fixed-size chunks to avoid loading the whole file in memory
+    char buffer[SIGNATURE_CHUNK_SIZE];
+    long long totalRead = 0;
+    size_t sizeRead;
+    while ((sizeRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        tmpHash.add(buffer, sizeRead);
+        totalRead += sizeRead;
+    }
 
-    buffer = (char *)malloc(fileLength);
-    if (buffer == NULL)
+    bool readError = ferror(pFile) != 0;
+    fclose(pFile);
+    if (readError || totalRead != fileSize)
     {
-        fclose(pFile);
         return false;
     }
 
-    size_t sizeRead = fread(buffer, 1, fileLength, pFile);
-    if (sizeRead != fileLength)
+    return tmpHash.checkSignature(fileSignature.data());
+}
+
+bool UpdateTask::getFileSize(const char *path, long long *size)
+{
+#ifdef _WIN32
+    string wpath;
+    utf8ToUtf16(path, &wpath);
+    wpath.append("", 1);
+
+    struct _stat64 statbuf;
+    if (_wstat64((LPCWSTR)wpath.data(), &statbuf))
     {
-        fclose(pFile);
         return false;
     }
+#else
+    struct stat statbuf;
+    if (stat(path, &statbuf))
+    {
+        return false;
+    }
+#endif
 
-    tmpHash.add(buffer, sizeRead);
-    fclose(pFile);
-    free(buffer);
-
-    return tmpHash.checkSignature(fileSignature.data());
+    *size = statbuf.st_size;
+    return true;
 }
 
 string UpdateTask::readNextLine(FILE *fd)
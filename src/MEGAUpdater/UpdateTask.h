@@ -73,6 +73,7 @@ protected:
     bool alreadyInstalled(std::string relativePath, std::string fileSignature);
     bool alreadyDownloaded(std::string relativePath, std::string fileSignature);
     bool alreadyExists(std::string absolutePath, std::string fileSignature);
+    bool getFileSize(const char* path, long long* size);
     bool performUpdate();
     void rollbackUpdate(int fileNum);
     void initialCleanup();
@@ -0,0 +1,44 @@
+#include <catch.hpp>
+#include "EncryptedSettings.h"
+
+#include <QTemporaryDir>
+
+namespace
+{
+constexpr int KEYS_NUMBER{100};
+}
+
+TEST_CASE("EncryptedSettings reads", "[benchmark][settings]")
+{
+    QTemporaryDir settingsDir;
+    REQUIRE(settingsDir.isValid());
+
+    EncryptedSettings settings(settingsDir.filePath(QLatin1String("benchmark.cfg")));
+    QStringList keys;
+    for (int i = 0; i < KEYS_NUMBER; ++i)
+    {
+        keys.append(QString::fromUtf8("key%1").arg(i));
+        settings.setValue(keys.last(), QString::fromUtf8("value for the key number %1").arg(i));
+    }
+    settings.sync();
+
+    BENCHMARK("Read 100 existing keys")
+    {
+        int size{0};
+        for (const auto& key : keys)
+        {
+            size += settings.value(key).toString().size();
+        }
+        return size;
+    };
+
+    BENCHMARK("Read 100 missing keys")
+    {
+        int valid{0};
+        for (const auto& key : keys)
+        {
+            valid += settings.value(key + QLatin1String("_missing"), 0).toInt();
+        }
+        return valid;
+    };
+}
@@ -0,0 +1,78 @@
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+#include <catch.hpp>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+
+#include "control/Preferences.h"
+
+/// Catch reporter that writes the benchmark results as a JSON document, so results of different
+/// versions can be compared with scripts. Durations are in nanoseconds.
+class JsonBenchmarkReporter : public Catch::StreamingReporterBase<JsonBenchmarkReporter>
+{
+public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription()
+    {
+        return "Reports benchmark results as JSON";
+    }
+
+    void assertionStarting(Catch::AssertionInfo const&) override
+    {
+    }
+
+    bool assertionEnded(Catch::AssertionStats const& assertionStats) override
+    {
+        if (!assertionStats.assertionResult.isOk())
+        {
+            mFailedAssertions++;
+        }
+        return true;
+    }
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override
+    {
+        QJsonObject benchmark;
+        benchmark[QLatin1String("test")] = QString::fromStdString(currentTestCaseInfo->name);
+        benchmark[QLatin1String("name")] = QString::fromStdString(stats.info.name);
+        benchmark[QLatin1String("samples")] = stats.info.samples;
+        benchmark[QLatin1String("iterations")] = stats.info.iterations;
+        benchmark[QLatin1String("mean")] = stats.mean.point.count();
+        benchmark[QLatin1String("meanLowerBound")] = stats.mean.lower_bound.count();
+        benchmark[QLatin1String("meanUpperBound")] = stats.mean.upper_bound.count();
+        benchmark[QLatin1String("standardDeviation")] = stats.standardDeviation.point.count();
+        benchmark[QLatin1String("outliers")] = stats.outliers.total();
+        mBenchmarks.append(benchmark);
+    }
+
+    void benchmarkFailed(std::string const& error) override
+    {
+        QJsonObject benchmark;
+        benchmark[QLatin1String("test")] = QString::fromStdString(currentTestCaseInfo->name);
+        benchmark[QLatin1String("error")] = QString::fromStdString(error);
+        mBenchmarks.append(benchmark);
+    }
+
+    void testRunEnded(Catch::TestRunStats const& testRunStats) override
+    {
+        QJsonObject result;
+        result[QLatin1String("version")] = Preferences::VERSION_STRING;
+        result[QLatin1String("versionCode")] = Preferences::VERSION_CODE;
+        result[QLatin1String("platform")] = QSysInfo::prettyProductName();
+        result[QLatin1String("cpu")] = QSysInfo::currentCpuArchitecture();
+        result[QLatin1String("failedAssertions")] = mFailedAssertions;
+        result[QLatin1String("benchmarks")] = mBenchmarks;
+
+        stream << QJsonDocument(result).toJson().constData() << std::endl;
+        StreamingReporterBase::testRunEnded(testRunStats);
+    }
+
+private:
+    QJsonArray mBenchmarks;
+    int mFailedAssertions = 0;
+};
+
+CATCH_REGISTER_REPORTER("json", JsonBenchmarkReporter)
@@ -0,0 +1,19 @@
+TARGET = MEGASyncBenchmarks
+
+CONFIG += qt console warn_on depend_includepath
+
+CONFIG += c++14
+CONFIG += building_tests
+
+DEFINES += CATCH_CONFIG_ENABLE_BENCHMARKING
+
+include(../../src/MEGASync/MEGASync.pro)
+include(../3rdparty/catch/catch.pri)
+SOURCES += JsonBenchmarkReporter.cpp \
+           MegaApiMock.cpp \
+           TransfersModel.Benchmark.cpp \
+           MegaSyncLogger.Benchmark.cpp \
+           EncryptedSettings.Benchmark.cpp \
+           Utilities.Benchmark.cpp \
+           main.cpp
+HEADERS += MegaApiMock.h
@@ -0,0 +1,11 @@
+#include "MegaApiMock.h"
+#include "SyntheticTransfer.h"
+
+MegaApiMock::MegaApiMock() : mega::MegaApi("appKey")
+{
+}
+
+long long MegaApiMock::getCurrentSpeed(int)
+{
+    return SyntheticTransfer::SPEED_BYTES_SECOND;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "megaapi.h"
+
+/// Offline replacement of the SDK api used by the benchmarks. The api is never logged in, so no
+/// request reaches the network; only the calls used by the transfers model are overridden.
+class MegaApiMock : public mega::MegaApi
+{
+public:
+    MegaApiMock();
+    long long getCurrentSpeed(int type) override;
+};
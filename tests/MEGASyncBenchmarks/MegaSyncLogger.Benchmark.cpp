@@ -0,0 +1,40 @@
+#include <catch.hpp>
+#include "MegaSyncLogger.h"
+
+#include <string>
+
+namespace
+{
+constexpr int LOG_LINES_NUMBER{10000};
+
+void logLines(const char* message)
+{
+    for (int i = 0; i < LOG_LINES_NUMBER; ++i)
+    {
+        g_megaSyncLogger->log("", mega::MegaApi::LOG_LEVEL_DEBUG, nullptr, message
+#ifdef ENABLE_LOG_PERFORMANCE
+                              , nullptr, nullptr, 0
+#endif
+                              );
+    }
+}
+}
+
+TEST_CASE("MegaSyncLogger throughput", "[benchmark][logger]")
+{
+    // The logger is created by MegaApplication
+    REQUIRE(g_megaSyncLogger);
+
+    const std::string shortMessage{"Transfer finished: file_1234.jpg"};
+    const std::string longMessage(2048, 'x');
+
+    BENCHMARK("Log 10k short lines")
+    {
+        logLines(shortMessage.c_str());
+    };
+
+    BENCHMARK("Log 10k 2KB lines")
+    {
+        logLines(longMessage.c_str());
+    };
+}
@@ -0,0 +1,164 @@
+#include <catch.hpp>
+#include "SyntheticTransfer.h"
+#include "TransfersModel.h"
+#include "TransfersManagerSortFilterProxyModel.h"
+
+#include <QEventLoop>
+
+#include <vector>
+
+namespace
+{
+constexpr int TRANSFERS_NUMBER{10000};
+
+std::vector<std::unique_ptr<SyntheticTransfer>> createTransfers(int state, int number = TRANSFERS_NUMBER)
+{
+    std::vector<std::unique_ptr<SyntheticTransfer>> transfers;
+    transfers.reserve(static_cast<size_t>(number));
+    for (int i = 0; i < number; ++i)
+    {
+        auto transfer = SyntheticTransfer::create(i, i + 1, "/benchmarks");
+        long long transferredBytes = state == mega::MegaTransfer::STATE_COMPLETED ? transfer->mTotalBytes
+                                                                                   : transfer->mTotalBytes / 2;
+        transfer->advance(state, transferredBytes);
+        transfers.push_back(std::move(transfer));
+    }
+    return transfers;
+}
+
+QList<QExplicitlySharedDataPointer<TransferData>> createTransfersData(int state)
+{
+    QList<QExplicitlySharedDataPointer<TransferData>> data;
+    for (const auto& transfer : createTransfers(state))
+    {
+        data.append(QExplicitlySharedDataPointer<TransferData>(new TransferData(transfer.get())));
+    }
+    return data;
+}
+
+int drain(TransferThread& thread)
+{
+    int processed{0};
+    auto transfers = thread.processTransfers();
+    while (!transfers.isEmpty())
+    {
+        processed += transfers.startTransfersByTag.size() + transfers.updateTransfersByTag.size()
+                     + transfers.failedTransfersByTag.size() + transfers.canceledTransfersByTag.size();
+        transfers = thread.processTransfers();
+    }
+    return processed;
+}
+
+void waitForProxy(TransfersManagerSortFilterProxyModel& proxy)
+{
+    if (proxy.isModelProcessing())
+    {
+        QEventLoop loop;
+        QObject::connect(&proxy, &TransfersManagerSortFilterProxyModel::modelChanged, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+}
+}
+
+TEST_CASE("TransferThread event ingestion", "[benchmark][transfers]")
+{
+    mega::MegaError noError(mega::MegaError::API_OK);
+    const auto queued = createTransfers(mega::MegaTransfer::STATE_QUEUED);
+    const auto active = createTransfers(mega::MegaTransfer::STATE_ACTIVE);
+    const auto completed = createTransfers(mega::MegaTransfer::STATE_COMPLETED);
+
+    BENCHMARK("Start, update and finish 10k transfers")
+    {
+        TransferThread thread;
+        for (const auto& transfer : queued)
+        {
+            thread.onTransferStart(nullptr, transfer.get());
+        }
+        int processed = drain(thread);
+
+        for (const auto& transfer : active)
+        {
+            thread.onTransferUpdate(nullptr, transfer.get());
+        }
+        processed += drain(thread);
+
+        for (const auto& transfer : completed)
+        {
+            thread.onTransferFinish(nullptr, transfer.get(), &noError);
+        }
+        return processed + drain(thread);
+    };
+}
+
+TEST_CASE("TransfersModel bulk operations", "[benchmark][transfers]")
+{
+    TransfersModel model;
+    const auto started = createTransfersData(mega::MegaTransfer::STATE_QUEUED);
+    const auto updated = createTransfersData(mega::MegaTransfer::STATE_ACTIVE);
+
+    BENCHMARK("Start and clear 10k transfers")
+    {
+        for (const auto& transfer : started)
+        {
+            model.startTransfer(transfer);
+        }
+        auto rows = model.rowCount();
+        model.resetModel();
+        return rows;
+    };
+
+    for (const auto& transfer : started)
+    {
+        model.startTransfer(transfer);
+    }
+
+    BENCHMARK("Update 10k transfers")
+    {
+        for (const auto& transfer : updated)
+        {
+            model.updateTransfer(transfer, model.getRowByTransferTag(transfer->mTag));
+        }
+        return model.rowCount();
+    };
+
+    model.resetModel();
+}
+
+TEST_CASE("Transfer Manager proxy sort and filter", "[benchmark][transfers]")
+{
+    TransfersModel model;
+    for (const auto& transfer : createTransfersData(mega::MegaTransfer::STATE_ACTIVE))
+    {
+        model.startTransfer(transfer);
+    }
+
+    TransfersManagerSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.initProxyModel(SortCriterion::PRIORITY, Qt::DescendingOrder);
+    waitForProxy(proxy);
+
+    BENCHMARK("Sort 10k transfers by name")
+    {
+        proxy.sort(static_cast<int>(SortCriterion::NAME), Qt::AscendingOrder);
+        waitForProxy(proxy);
+        return proxy.rowCount();
+    };
+
+    BENCHMARK("Sort 10k transfers by size")
+    {
+        proxy.sort(static_cast<int>(SortCriterion::TOTAL_SIZE), Qt::DescendingOrder);
+        waitForProxy(proxy);
+        return proxy.rowCount();
+    };
+
+    BENCHMARK("Filter 10k transfers by text")
+    {
+        proxy.setFilterFixedString(QLatin1String("file_12"));
+        waitForProxy(proxy);
+        proxy.setFilterFixedString(QString());
+        waitForProxy(proxy);
+        return proxy.rowCount();
+    };
+
+    model.resetModel();
+}
@@ -0,0 +1,63 @@
+#include <catch.hpp>
+#include "Utilities.h"
+
+namespace
+{
+constexpr int FILE_NAMES_NUMBER{10000};
+constexpr int LOOKUPS_NUMBER{1000000};
+
+QStringList createFileNames()
+{
+    const QStringList extensions{QLatin1String("jpg"), QLatin1String("MP4"), QLatin1String("pdf"),
+                                 QLatin1String("docx"), QLatin1String("tar.gz"), QLatin1String("txt"),
+                                 QLatin1String("unknownext"), QLatin1String("PSD"), QString()};
+    QStringList fileNames;
+    for (int i = 0; i < FILE_NAMES_NUMBER; ++i)
+    {
+        auto extension = extensions.at(i % extensions.size());
+        fileNames.append(QString::fromUtf8("file_%1").arg(i)
+                         + (extension.isEmpty() ? QString() : QString::fromUtf8(".") + extension));
+    }
+    return fileNames;
+}
+}
+
+TEST_CASE("Utilities::getFileType", "[benchmark][utilities]")
+{
+    const auto fileNames = createFileNames();
+
+    BENCHMARK("Get file type of 10k file names")
+    {
+        int images{0};
+        for (const auto& fileName : fileNames)
+        {
+            images += Utilities::getFileType(fileName, QString()) == Utilities::FileType::TYPE_IMAGE;
+        }
+        return images;
+    };
+}
+
+TEST_CASE("Utilities::getFileType lookups", "[benchmark][utilities]")
+{
+    const auto fileNames = createFileNames();
+
+    BENCHMARK("1M file type lookups")
+    {
+        int images{0};
+        for (int i = 0; i < LOOKUPS_NUMBER; ++i)
+        {
+            images += Utilities::getFileType(fileNames.at(i % FILE_NAMES_NUMBER), QString()) == Utilities::FileType::TYPE_IMAGE;
+        }
+        return images;
+    };
+
+    BENCHMARK("1M icon name lookups")
+    {
+        int size{0};
+        for (int i = 0; i < LOOKUPS_NUMBER; ++i)
+        {
+            size += Utilities::getExtensionPixmapName(fileNames.at(i % FILE_NAMES_NUMBER), QString()).size();
+        }
+        return size;
+    };
+}
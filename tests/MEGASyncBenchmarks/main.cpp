@@ -0,0 +1,28 @@
+#include "MegaApplication.h"
+#include "MegaApiMock.h"
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <QTemporaryDir>
+
+int main( int argc, char* argv[] )
+{
+    MegaApplication app(argc, argv);
+
+    // Benchmarks run offline, with preferences stored in a temporary folder
+    QTemporaryDir dataDir;
+    Preferences::instance()->initialize(dataDir.path());
+    MegaApiMock megaApi;
+    app.setMegaApi(&megaApi);
+
+    Catch::Session session;
+    session.configData().reporterName = "json";
+    int result = session.applyCommandLine(argc, argv);
+    if (result == 0)
+    {
+        result = session.run();
+    }
+
+    app.setMegaApi(nullptr);
+    return ( result < 0xff ? result : 0xff );
+}
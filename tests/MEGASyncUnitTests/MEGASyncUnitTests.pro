@@ -11,5 +11,13 @@ include(../3rdparty/trompeloeil/trompeloeil.pri)
 SOURCES += GuestWidgetTest.cpp \
            Utilities.test.cpp \
            control/TransferRemainingTime.Test.cpp \
+           control/TransferQueueEta.Test.cpp \
+           control/BinaryPatch.Test.cpp \
+           control/DirectoryWalker.Test.cpp \
+           control/LogStreamProtocol.Test.cpp \
+           control/NetlinkMessages.Test.cpp \
+           control/UserAttributesCache.Test.cpp \
+           syncs/SyncPathIndex.Test.cpp \
+           transfers/TransferTagSet.Test.cpp \
            ScaleFactorManager.Test.cpp \
            main.cpp
@@ -52,3 +52,21 @@ TEST_CASE("Create time string")
     constexpr auto secondsPrecision{false};
     REQUIRE(Utilities::getTimeString((5*minuteSeconds) + 7, secondsPrecision).toStdString() == expected);
 }
+
+TEST_CASE("Get file type and icon from the file extension")
+{
+    CHECK(Utilities::getFileType(QLatin1String("song.mp3"), QString()) == Utilities::FileType::TYPE_AUDIO);
+    CHECK(Utilities::getFileType(QLatin1String("movie.MKV"), QString()) == Utilities::FileType::TYPE_VIDEO);
+    CHECK(Utilities::getFileType(QLatin1String("backup.tar.gz"), QString()) == Utilities::FileType::TYPE_ARCHIVE);
+    CHECK(Utilities::getFileType(QLatin1String("notes.xml"), QString()) == Utilities::FileType::TYPE_DOCUMENT);
+    CHECK(Utilities::getFileType(QLatin1String("photo.Tif"), QString()) == Utilities::FileType::TYPE_IMAGE);
+    CHECK(Utilities::getFileType(QLatin1String("setup.bin"), QString()) == Utilities::FileType::TYPE_OTHER);
+    CHECK(Utilities::getFileType(QLatin1String("README"), QString()) == Utilities::FileType::TYPE_OTHER);
+    CHECK(Utilities::getFileType(QLatin1String("folder.pdf/file"), QString()) == Utilities::FileType::TYPE_OTHER);
+    CHECK(Utilities::getFileType(QString::fromUtf8("résumé.ódt"), QString()) == Utilities::FileType::TYPE_OTHER);
+
+    CHECK(Utilities::getExtensionPixmapName(QLatin1String("report.ODT"), QLatin1String(":/images/small_")).toStdString()
+          == ":/images/small_openoffice.png");
+    CHECK(Utilities::getExtensionPixmapName(QLatin1String(".bashrc"), QString()).toStdString() == "generic.png");
+    CHECK(Utilities::getExtensionPixmapName(QLatin1String("file."), QString()).toStdString() == "generic.png");
+}
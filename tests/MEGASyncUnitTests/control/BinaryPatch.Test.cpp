@@ -0,0 +1,124 @@
+#include <catch.hpp>
+#include "BinaryPatch.h"
+
+#include <QBuffer>
+
+#include <random>
+
+namespace
+{
+QByteArray generateData(int size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<char>(distribution(generator));
+    }
+    return data;
+}
+
+QByteArray createPatch(const QByteArray& base, const QByteArray& target)
+{
+    QByteArray patch;
+    QBuffer patchBuffer(&patch);
+    patchBuffer.open(QIODevice::WriteOnly);
+    REQUIRE(BinaryPatch::create(base, target, &patchBuffer));
+    return patch;
+}
+
+BinaryPatch::Result applyPatch(QByteArray base, QByteArray patch, QByteArray& output)
+{
+    QBuffer baseBuffer(&base);
+    baseBuffer.open(QIODevice::ReadOnly);
+    QBuffer patchBuffer(&patch);
+    patchBuffer.open(QIODevice::ReadOnly);
+    output.clear();
+    QBuffer outputBuffer(&output);
+    outputBuffer.open(QIODevice::WriteOnly);
+    return BinaryPatch::apply(&baseBuffer, &patchBuffer, &outputBuffer);
+}
+
+void checkRoundTrip(const QByteArray& base, const QByteArray& target)
+{
+    QByteArray output;
+    REQUIRE(applyPatch(base, createPatch(base, target), output) == BinaryPatch::Result::OK);
+    REQUIRE(output == target);
+}
+}
+
+TEST_CASE("Binary patch rebuilds the target file")
+{
+    const QByteArray base{generateData(200 * 1024, 1)};
+
+    SECTION("Identical files")
+    {
+        checkRoundTrip(base, base);
+    }
+
+    SECTION("Bytes inserted in the middle")
+    {
+        QByteArray target{base};
+        target.insert(50000, generateData(1234, 2));
+        checkRoundTrip(base, target);
+    }
+
+    SECTION("Bytes removed and modified")
+    {
+        QByteArray target{base};
+        target.remove(1000, 4096);
+        target.replace(90000, 300, generateData(300, 3));
+        checkRoundTrip(base, target);
+    }
+
+    SECTION("Appended and truncated files")
+    {
+        checkRoundTrip(base, base + generateData(70000, 4));
+        checkRoundTrip(base, base.left(12345));
+    }
+
+    SECTION("Unrelated and empty files")
+    {
+        checkRoundTrip(base, generateData(100 * 1024, 5));
+        checkRoundTrip(QByteArray(), base);
+        checkRoundTrip(base, QByteArray());
+    }
+}
+
+TEST_CASE("Binary patch of a similar file is small")
+{
+    const QByteArray base{generateData(1024 * 1024, 6)};
+    QByteArray target{base};
+    target.replace(300000, 100, generateData(100, 7));
+    target.insert(700000, generateData(500, 8));
+
+    const QByteArray patch{createPatch(base, target)};
+    REQUIRE(patch.size() < 4096);
+}
+
+TEST_CASE("Invalid binary patches are rejected")
+{
+    const QByteArray base{generateData(64 * 1024, 9)};
+    QByteArray target{base};
+    target.insert(1000, generateData(2000, 10));
+    const QByteArray patch{createPatch(base, target)};
+    QByteArray output;
+
+    SECTION("Invalid header")
+    {
+        QByteArray invalid{patch};
+        invalid[0] = 'X';
+        REQUIRE(applyPatch(base, invalid, output) == BinaryPatch::Result::INVALID_HEADER);
+    }
+
+    SECTION("Truncated patch")
+    {
+        REQUIRE(applyPatch(base, patch.left(patch.size() / 2), output) == BinaryPatch::Result::CORRUPT_PATCH);
+    }
+
+    SECTION("Base file doesn't match the patch")
+    {
+        REQUIRE(applyPatch(base.left(1000), patch, output) == BinaryPatch::Result::CORRUPT_PATCH);
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+#include "DirectoryWalker.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+
+namespace
+{
+void createFile(const QString& path, int size)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(size, 'x'));
+}
+}
+
+TEST_CASE("Directory walker visits directories after their contents")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    QDir dir(root.path());
+    REQUIRE(dir.mkpath(QString::fromUtf8("a/b")));
+    createFile(dir.filePath(QString::fromUtf8("a/b/file")), 10);
+    createFile(dir.filePath(QString::fromUtf8("a/.hidden")), 20);
+    createFile(dir.filePath(QString::fromUtf8("top")), 30);
+
+    QStringList visited;
+    REQUIRE(DirectoryWalker::walk(root.path(), [&visited, &dir](const QFileInfo& info)
+    {
+        visited.append(dir.relativeFilePath(info.absoluteFilePath()));
+        return true;
+    }));
+
+    REQUIRE(visited.size() == 5);
+    REQUIRE(visited.contains(QString::fromUtf8("a/.hidden")));
+    REQUIRE(visited.indexOf(QString::fromUtf8("a/b/file")) < visited.indexOf(QString::fromUtf8("a/b")));
+    REQUIRE(visited.indexOf(QString::fromUtf8("a/b")) < visited.indexOf(QString::fromUtf8("a")));
+
+    REQUIRE(DirectoryWalker::totalSize(root.path()) == 60);
+}
+
+TEST_CASE("Directory walker can remove the entries it visits and be stopped")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    QDir dir(root.path());
+    REQUIRE(dir.mkpath(QString::fromUtf8("a/b")));
+    createFile(dir.filePath(QString::fromUtf8("a/b/file")), 10);
+    createFile(dir.filePath(QString::fromUtf8("a/other")), 10);
+
+    int visits(0);
+    REQUIRE_FALSE(DirectoryWalker::walk(root.path(), [&visits](const QFileInfo&)
+    {
+        return ++visits < 2;
+    }));
+    REQUIRE(visits == 2);
+
+    REQUIRE(DirectoryWalker::walk(root.path(), [](const QFileInfo& info)
+    {
+        return info.isDir() ? QDir().rmdir(info.absoluteFilePath()) : QFile::remove(info.absoluteFilePath());
+    }));
+    REQUIRE(QDir(root.path()).entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden).isEmpty());
+}
@@ -0,0 +1,87 @@
+#include <catch.hpp>
+#include "LogStreamProtocol.h"
+
+#include <string>
+
+using namespace LogStream;
+
+namespace
+{
+std::string stream(const Record& record, uint64_t dropped)
+{
+    std::string data(HANDSHAKE, HANDSHAKE_SIZE);
+    appendLogFrame(data, record);
+    appendDroppedFrame(data, dropped);
+    return data;
+}
+}
+
+TEST_CASE("Log stream frames are parsed back")
+{
+    Record sent;
+    sent.timestampUs = 1650000000123456ULL;
+    sent.level = 4;
+    sent.thread = "140234";
+    sent.message = std::string("Transfer finished\n\0binary", 25);
+
+    const std::string data = stream(sent, 42);
+
+    // Fed byte by byte, frames only come out once complete
+    FrameParser parser;
+    Record received;
+    uint64_t dropped = 0;
+    int records = 0;
+    for (char c : data)
+    {
+        parser.feed(&c, 1);
+        for (;;)
+        {
+            auto result = parser.next(received, dropped);
+            REQUIRE(result != FrameParser::PROTOCOL_ERROR);
+            if (result == FrameParser::NEED_MORE_DATA)
+            {
+                break;
+            }
+            ++records;
+        }
+    }
+
+    REQUIRE(records == 2);
+    REQUIRE(received.timestampUs == sent.timestampUs);
+    REQUIRE(received.level == sent.level);
+    REQUIRE(received.thread == sent.thread);
+    REQUIRE(received.message == sent.message);
+    REQUIRE(dropped == 42);
+}
+
+TEST_CASE("Log stream rejects corrupt data")
+{
+    Record received;
+    uint64_t dropped = 0;
+
+    SECTION("Wrong handshake")
+    {
+        FrameParser parser;
+        parser.feed("<log>", 5);
+        REQUIRE(parser.next(received, dropped) == FrameParser::PROTOCOL_ERROR);
+    }
+
+    SECTION("Thread name longer than the frame")
+    {
+        Record record;
+        record.thread = "thread";
+        std::string data(HANDSHAKE, HANDSHAKE_SIZE);
+        appendLogFrame(data, record);
+        data[HANDSHAKE_SIZE + 4 + 10] = 100;
+
+        FrameParser parser;
+        parser.feed(data.data(), data.size());
+        REQUIRE(parser.next(received, dropped) == FrameParser::PROTOCOL_ERROR);
+        // The parser stays failed
+        REQUIRE(parser.next(received, dropped) == FrameParser::PROTOCOL_ERROR);
+
+        parser.reset();
+        parser.feed(HANDSHAKE, HANDSHAKE_SIZE);
+        REQUIRE(parser.next(received, dropped) == FrameParser::NEED_MORE_DATA);
+    }
+}
@@ -0,0 +1,110 @@
+#include <catch.hpp>
+#include "NetlinkMessages.h"
+
+#ifdef __linux__
+
+#include <cstring>
+#include <vector>
+
+using namespace NetlinkMessages;
+
+namespace
+{
+struct Datagram
+{
+    std::vector<char> data;
+
+    template<typename T>
+    void append(unsigned short type, const T& payload, unsigned short attributeType = 0)
+    {
+        const size_t attributeSize = attributeType ? RTA_SPACE(0) : 0;
+        const size_t size = NLMSG_LENGTH(sizeof(T)) + attributeSize;
+        const size_t offset = data.size();
+        data.resize(offset + NLMSG_ALIGN(size), 0);
+
+        nlmsghdr* header = reinterpret_cast<nlmsghdr*>(data.data() + offset);
+        header->nlmsg_len = static_cast<unsigned>(size);
+        header->nlmsg_type = type;
+        memcpy(NLMSG_DATA(header), &payload, sizeof(T));
+
+        if (attributeType)
+        {
+            rtattr* attribute = reinterpret_cast<rtattr*>(static_cast<char*>(NLMSG_DATA(header)) + NLMSG_ALIGN(sizeof(T)));
+            attribute->rta_len = RTA_LENGTH(0);
+            attribute->rta_type = attributeType;
+        }
+    }
+
+    int classify() const
+    {
+        // Copied to aligned storage, as received from the socket
+        std::vector<nlmsghdr> aligned(data.size() / sizeof(nlmsghdr) + 1);
+        memcpy(aligned.data(), data.data(), data.size());
+        return NetlinkMessages::classify(aligned.data(), data.size());
+    }
+};
+
+ifinfomsg link(unsigned flags)
+{
+    ifinfomsg info;
+    memset(&info, 0, sizeof(info));
+    info.ifi_index = 2;
+    info.ifi_flags = flags;
+    return info;
+}
+
+ifaddrmsg address(unsigned char family, unsigned char scope)
+{
+    ifaddrmsg address;
+    memset(&address, 0, sizeof(address));
+    address.ifa_family = family;
+    address.ifa_scope = scope;
+    address.ifa_index = 2;
+    return address;
+}
+}
+
+TEST_CASE("Link and address notifications are reported")
+{
+    Datagram datagram;
+    datagram.append(RTM_NEWLINK, link(IFF_UP | IFF_RUNNING));
+    REQUIRE(datagram.classify() == LINK_CHANGED);
+
+    datagram.append(RTM_DELADDR, address(AF_INET6, RT_SCOPE_UNIVERSE));
+    REQUIRE(datagram.classify() == (LINK_CHANGED | ADDRESS_CHANGED));
+
+    Datagram removed;
+    removed.append(RTM_DELLINK, link(0));
+    removed.append(RTM_NEWADDR, address(AF_INET, RT_SCOPE_LINK));
+    REQUIRE(removed.classify() == (LINK_CHANGED | ADDRESS_CHANGED));
+}
+
+TEST_CASE("Irrelevant notifications are ignored")
+{
+    Datagram datagram;
+    datagram.append(RTM_NEWLINK, link(IFF_UP | IFF_LOOPBACK));
+    datagram.append(RTM_NEWADDR, address(AF_INET, RT_SCOPE_HOST));
+    datagram.append(RTM_NEWLINK, link(IFF_UP | IFF_RUNNING), IFLA_WIRELESS);
+    datagram.append(RTM_NEWROUTE, rtmsg());
+    REQUIRE(datagram.classify() == NO_CHANGE);
+
+    // A link removal is reported even with wireless information
+    datagram.append(RTM_DELLINK, link(IFF_UP), IFLA_WIRELESS);
+    REQUIRE(datagram.classify() == LINK_CHANGED);
+}
+
+TEST_CASE("Truncated notifications are ignored")
+{
+    Datagram datagram;
+    datagram.append(RTM_NEWADDR, address(AF_INET, RT_SCOPE_UNIVERSE));
+    REQUIRE(datagram.classify() == ADDRESS_CHANGED);
+
+    REQUIRE(NetlinkMessages::classify(datagram.data.data(), NLMSG_HDRLEN - 1) == NO_CHANGE);
+
+    // Header claiming more data than the payload of an address message
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(datagram.data.data());
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(ifaddrmsg) - 1);
+    REQUIRE(datagram.classify() == NO_CHANGE);
+}
+
+#endif
@@ -0,0 +1,119 @@
+#include <catch.hpp>
+#include "TransferQueueEta.h"
+
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Replays a trace of bytes transferred per second, consuming them from the remaining bytes
+std::chrono::milliseconds replay(TransferQueueEta& eta, TransferQueueEta::Direction direction,
+                                 const std::vector<unsigned long long>& bytesPerSecond,
+                                 unsigned long long& remainingBytes, std::chrono::milliseconds now = 0ms)
+{
+    for(const auto bytes : bytesPerSecond)
+    {
+        now += 1s;
+        remainingBytes -= std::min(bytes, remainingBytes);
+        eta.setRemainingBytes(direction, remainingBytes);
+        eta.addSample(direction, bytes, 1s, now);
+    }
+    return now;
+}
+}
+
+TEST_CASE("Queue remaining time is unknown until some throughput is measured")
+{
+    TransferQueueEta eta;
+    REQUIRE(eta.remainingTime(0ms) == 0s);
+
+    eta.setRemainingBytes(TransferQueueEta::DOWNLOAD, 1000);
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, 0ms) == std::chrono::seconds::max());
+
+    // Zero samples before the transfers start do not give an estimate either
+    eta.addSample(TransferQueueEta::DOWNLOAD, 0, 1s, 1s);
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, 1s) == std::chrono::seconds::max());
+
+    eta.addSample(TransferQueueEta::DOWNLOAD, 100, 1s, 2s);
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, 2s) == 10s);
+}
+
+TEST_CASE("Queue remaining time follows a steady trace")
+{
+    TransferQueueEta eta;
+    unsigned long long remaining(100000);
+    const std::vector<unsigned long long> trace(20, 1000);
+
+    const auto now = replay(eta, TransferQueueEta::UPLOAD, trace, remaining);
+
+    REQUIRE(remaining == 80000);
+    REQUIRE(eta.estimatedSpeed(TransferQueueEta::UPLOAD, now) == 1000);
+    REQUIRE(eta.remainingTime(TransferQueueEta::UPLOAD, now) == 80s);
+    // Nothing pending in the other direction
+    REQUIRE(eta.remainingTime(now) == 80s);
+}
+
+TEST_CASE("Queue remaining time is not thrown off by bursts")
+{
+    TransferQueueEta eta;
+    unsigned long long remaining(10000000);
+    // Bytes reported at once after a pause, and a few small files finished in a row
+    const std::vector<unsigned long long> trace{10000, 10000, 10000, 10000, 0, 0, 600000,
+                                                10000, 10000, 10000, 90000, 10000, 10000};
+
+    const auto now = replay(eta, TransferQueueEta::DOWNLOAD, trace, remaining);
+
+    // Without clamping, the 600000 sample alone would take the average over 60000
+    const auto speed = eta.estimatedSpeed(TransferQueueEta::DOWNLOAD, now);
+    REQUIRE(speed > 9000);
+    REQUIRE(speed < 20000);
+}
+
+TEST_CASE("Queue remaining time grows when the throughput stalls")
+{
+    TransferQueueEta eta;
+    unsigned long long remaining(1000000);
+    auto now = replay(eta, TransferQueueEta::DOWNLOAD, std::vector<unsigned long long>(30, 10000), remaining);
+    const auto before = eta.remainingTime(TransferQueueEta::DOWNLOAD, now);
+
+    now = replay(eta, TransferQueueEta::DOWNLOAD, std::vector<unsigned long long>(10, 0), remaining, now);
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, now) > before);
+
+    // When the samples stop coming the queue is stalled
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, now + 20s) == std::chrono::seconds::max());
+    REQUIRE(eta.remainingTime(now + 20s) == std::chrono::seconds::max());
+}
+
+TEST_CASE("Queue remaining time respects the bandwidth limit and the connections")
+{
+    TransferQueueEta eta;
+    unsigned long long remaining(100000);
+    eta.setConnections(TransferQueueEta::UPLOAD, 3);
+    const auto now = replay(eta, TransferQueueEta::UPLOAD, std::vector<unsigned long long>(10, 3000), remaining);
+    REQUIRE(eta.remainingTime(TransferQueueEta::UPLOAD, now) == 24s);
+
+    eta.setBandwidthLimit(TransferQueueEta::UPLOAD, 1000);
+    REQUIRE(eta.remainingTime(TransferQueueEta::UPLOAD, now) == 70s);
+
+    eta.setBandwidthLimit(TransferQueueEta::UPLOAD, 0);
+    eta.setConnections(TransferQueueEta::UPLOAD, 6);
+    REQUIRE(eta.estimatedSpeed(TransferQueueEta::UPLOAD, now) == 6000);
+    REQUIRE(eta.remainingTime(TransferQueueEta::UPLOAD, now) == 12s);
+}
+
+TEST_CASE("Queue remaining time is the slowest direction")
+{
+    TransferQueueEta eta;
+    unsigned long long uploadRemaining(50000);
+    unsigned long long downloadRemaining(50000);
+    replay(eta, TransferQueueEta::UPLOAD, std::vector<unsigned long long>(5, 1000), uploadRemaining);
+    const auto now = replay(eta, TransferQueueEta::DOWNLOAD, std::vector<unsigned long long>(5, 5000), downloadRemaining);
+
+    REQUIRE(eta.remainingTime(TransferQueueEta::UPLOAD, now) == 45s);
+    REQUIRE(eta.remainingTime(TransferQueueEta::DOWNLOAD, now) == 5s);
+    REQUIRE(eta.remainingTime(now) == 45s);
+
+    eta.reset();
+    REQUIRE(eta.remainingTime(now) == 0s);
+}
@@ -0,0 +1,90 @@
+#include <catch.hpp>
+#include "UserAttributesCache.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+using UserAttributes::UserAttributesCache;
+
+TEST_CASE("User attributes cache keeps the values of its account")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString path (dir.filePath(QString::fromLatin1("userattributes.dat")));
+    const QString user (QString::fromLatin1("contact@example.com"));
+
+    {
+        UserAttributesCache cache(path);
+
+        // Values are not kept until the account is known
+        cache.insert(user, 1, "ignored");
+        REQUIRE_FALSE(cache.isDirty());
+
+        cache.load(QString::fromLatin1("account1"));
+        cache.insert(user, 1, "First");
+        cache.insert(user, 2, QByteArray());
+        cache.insert(QString::fromLatin1("u"), 1, "Me");
+        cache.remove(QString::fromLatin1("u"), 1);
+        REQUIRE(cache.isDirty());
+        cache.save();
+        REQUIRE_FALSE(cache.isDirty());
+    }
+
+    SECTION("Values are loaded back")
+    {
+        UserAttributesCache cache(path);
+        cache.load(QString::fromLatin1("account1"));
+
+        QByteArray value;
+        bool stale (true);
+        REQUIRE(cache.find(user, 1, value, stale));
+        REQUIRE(value == "First");
+        REQUIRE_FALSE(stale);
+
+        // Empty values are cached too
+        REQUIRE(cache.find(user, 2, value, stale));
+        REQUIRE(value.isEmpty());
+
+        REQUIRE_FALSE(cache.find(QString::fromLatin1("u"), 1, value, stale));
+    }
+
+    SECTION("The file of another account is discarded")
+    {
+        UserAttributesCache cache(path);
+        cache.load(QString::fromLatin1("account2"));
+
+        QByteArray value;
+        bool stale (false);
+        REQUIRE_FALSE(cache.find(user, 1, value, stale));
+    }
+
+    SECTION("The file is removed on request")
+    {
+        UserAttributesCache cache(path);
+        cache.load(QString::fromLatin1("account1"));
+        cache.clear(true);
+
+        REQUIRE_FALSE(cache.isLoaded());
+        REQUIRE_FALSE(QFile::exists(path));
+    }
+}
+
+TEST_CASE("User attributes cache discards unknown formats")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString path (dir.filePath(QString::fromLatin1("userattributes.dat")));
+
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write("not a cache file");
+    file.close();
+
+    UserAttributesCache cache(path);
+    cache.load(QString::fromLatin1("account1"));
+    REQUIRE(cache.isLoaded());
+
+    QByteArray value;
+    bool stale (false);
+    REQUIRE_FALSE(cache.find(QString::fromLatin1("u"), 1, value, stale));
+}
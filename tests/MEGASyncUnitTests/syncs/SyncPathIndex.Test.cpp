@@ -0,0 +1,51 @@
+#include <catch.hpp>
+#include "syncs/control/SyncPathIndex.h"
+
+TEST_CASE("Sync path index finds the sync that contains a path")
+{
+    SyncPathIndex index;
+    REQUIRE(index.isEmpty());
+    REQUIRE(index.findContaining(QString::fromUtf8("/home/user")) == mega::INVALID_HANDLE);
+
+    index.insert(QString::fromUtf8("/home/user/Documents"), 1);
+    index.insert(QString::fromUtf8("/home/user/Pictures/"), 2);
+    index.insert(QString::fromUtf8("/data/backup/old/nested"), 3);
+    REQUIRE_FALSE(index.isEmpty());
+
+    SECTION("Sync folders and their contents")
+    {
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Documents")) == 1);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Documents/a/b.txt")) == 1);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Pictures")) == 2);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user//Pictures/x.jpg")) == 2);
+    }
+
+    SECTION("Paths outside the syncs")
+    {
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user")) == mega::INVALID_HANDLE);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/DocumentsOld")) == mega::INVALID_HANDLE);
+        REQUIRE(index.findContaining(QString::fromUtf8("/data/backup/old")) == mega::INVALID_HANDLE);
+    }
+
+    SECTION("Nested syncs resolve to the deepest one")
+    {
+        index.insert(QString::fromUtf8("/home/user/Documents/Work"), 4);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Documents/Work/report.pdf")) == 4);
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Documents/Personal")) == 1);
+    }
+
+    SECTION("Syncs below a path")
+    {
+        REQUIRE(index.hasSyncBelow(QString::fromUtf8("/home")));
+        REQUIRE(index.hasSyncBelow(QString::fromUtf8("/data/backup")));
+        REQUIRE_FALSE(index.hasSyncBelow(QString::fromUtf8("/home/user/Documents")));
+        REQUIRE_FALSE(index.hasSyncBelow(QString::fromUtf8("/tmp")));
+    }
+
+    SECTION("Clear")
+    {
+        index.clear();
+        REQUIRE(index.isEmpty());
+        REQUIRE(index.findContaining(QString::fromUtf8("/home/user/Documents")) == mega::INVALID_HANDLE);
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch.hpp>
+#include "TransferTagSet.h"
+
+#include <QSet>
+
+#include <random>
+
+TEST_CASE("Transfer tag set keeps the same tags as a QSet")
+{
+    std::mt19937 generator(42);
+    TransferTagSet tags;
+    QSet<int> expected;
+
+    auto check = [&tags, &expected](int tag, bool changed, bool expectedChanged)
+    {
+        REQUIRE(changed == expectedChanged);
+        REQUIRE(tags.contains(tag) == expected.contains(tag));
+        REQUIRE(tags.size() == expected.size());
+    };
+
+    SECTION("Consecutive tags, inserted in any order")
+    {
+        std::uniform_int_distribution<int> distribution(1000, 5000);
+        for (int i = 0; i < 20000; ++i)
+        {
+            const int tag(distribution(generator));
+            if (generator() % 3)
+            {
+                check(tag, tags.insert(tag), !expected.contains(tag));
+                expected.insert(tag);
+            }
+            else
+            {
+                check(tag, tags.remove(tag), expected.remove(tag));
+            }
+        }
+    }
+
+    SECTION("Tags far from the others")
+    {
+        const QList<int> farTags{5, 1 << 30, (1 << 30) + 1, 200, TransferTagSet::MAX_BITMAP_TAGS + 300, 7};
+        for (const auto tag : farTags)
+        {
+            check(tag, tags.insert(tag), !expected.contains(tag));
+            expected.insert(tag);
+        }
+        for (const auto tag : farTags)
+        {
+            check(tag, tags.insert(tag), false);
+        }
+        for (const auto tag : farTags)
+        {
+            check(tag, tags.remove(tag), expected.remove(tag));
+        }
+        REQUIRE(tags.isEmpty());
+    }
+
+    SECTION("Cleared set")
+    {
+        for (int tag = 1; tag < 1000; ++tag)
+        {
+            tags.insert(tag);
+        }
+        tags.clear();
+        REQUIRE(tags.isEmpty());
+        REQUIRE_FALSE(tags.contains(10));
+        REQUIRE(tags.insert(10));
+        REQUIRE(tags.size() == 1);
+    }
+}